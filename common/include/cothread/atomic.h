@@ -0,0 +1,101 @@
+/**
+ * @brief		This file contains the atomic operations used internally.
+ * @file
+ */
+
+/**
+ * @defgroup	doxy_cothread_atomic	atomic operations
+ */
+
+#ifndef __COTHREAD_ATOMIC_H__
+#define __COTHREAD_ATOMIC_H__
+
+#include <cothread/config.h>
+
+#if		(0	\
+		|| (COTHREAD_CC_ID_GCC		== COTHREAD_CC_ID)	\
+		|| (COTHREAD_CC_ID_CLANG	== COTHREAD_CC_ID)	\
+		|| (COTHREAD_CC_ID_MINGW	== COTHREAD_CC_ID)	\
+		)
+	/// @ingroup doxy_cothread_atomic
+	/// @{
+	#define COTHREAD_ATOMIC_LOAD_RLX(_ptr)			__atomic_load_n((_ptr), __ATOMIC_RELAXED)				///< @brief	Loads a value, relaxed.
+	#define COTHREAD_ATOMIC_STORE_RLX(_ptr, _val)	__atomic_store_n((_ptr), (_val), __ATOMIC_RELAXED)		///< @brief	Stores a value, relaxed.
+	#define COTHREAD_ATOMIC_LOAD_ACQ(_ptr)			__atomic_load_n((_ptr), __ATOMIC_ACQUIRE)				///< @brief	Loads a value with acquire semantics.
+	#define COTHREAD_ATOMIC_STORE_REL(_ptr, _val)	__atomic_store_n((_ptr), (_val), __ATOMIC_RELEASE)		///< @brief	Stores a value with release semantics.
+	#define COTHREAD_ATOMIC_XCHG_ACQ(_ptr, _val)	__atomic_exchange_n((_ptr), (_val), __ATOMIC_ACQUIRE)	///< @brief	Exchanges a value with acquire semantics.
+	#define COTHREAD_ATOMIC_LOAD(_ptr)				__atomic_load_n((_ptr), __ATOMIC_SEQ_CST)				///< @brief	Loads a value, sequentially consistent.
+	#define COTHREAD_ATOMIC_STORE(_ptr, _val)		__atomic_store_n((_ptr), (_val), __ATOMIC_SEQ_CST)		///< @brief	Stores a value, sequentially consistent.
+	#define COTHREAD_ATOMIC_FETCH_ADD(_ptr, _val)	__atomic_fetch_add((_ptr), (_val), __ATOMIC_SEQ_CST)	///< @brief	Adds to a value and returns the previous one, sequentially consistent.
+	#define COTHREAD_ATOMIC_LOAD_PTR(_ptr)			__atomic_load_n((_ptr), __ATOMIC_SEQ_CST)				///< @brief	Loads a pointer, sequentially consistent.
+	#define COTHREAD_ATOMIC_XCHG_PTR(_ptr, _val)	__atomic_exchange_n((_ptr), (_val), __ATOMIC_SEQ_CST)	///< @brief	Exchanges a pointer, sequentially consistent.
+	#define COTHREAD_ATOMIC_CAS_PTR(_ptr, _old, _new)	__sync_bool_compare_and_swap((_ptr), (_old), (_new))	///< @brief	Replaces a pointer if it equals the old one and says so, sequentially consistent.
+	/// @}
+
+	#if		((COTHREAD_ARCH_ID_X86 == COTHREAD_ARCH_ID) || (COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID))
+		#define COTHREAD_CPU_RELAX()	__builtin_ia32_pause()				///< @brief	Tells the CPU the thread is spinning.
+	#elif	(COTHREAD_ARCH_ID_AARCH64 == COTHREAD_ARCH_ID)
+		#define COTHREAD_CPU_RELAX()	__asm__ __volatile__ ("yield")		///< @brief	Tells the CPU the thread is spinning.
+	#endif
+#elif	(COTHREAD_CC_ID_CL == COTHREAD_CC_ID)
+	#include <intrin.h>
+
+	// On x86 & x86_64, plain volatile accesses are already ordered by the hardware,
+	// the compiler barrier is enough to prevent MSVC from reordering them.
+	#define COTHREAD_ATOMIC_LOAD_RLX(_ptr)			(*(_ptr))
+	#define COTHREAD_ATOMIC_STORE_RLX(_ptr, _val)	{ *(_ptr) = (_val); }
+	#define COTHREAD_ATOMIC_LOAD_ACQ(_ptr)			_cothread_atomic_load_acq((_ptr))
+	#define COTHREAD_ATOMIC_STORE_REL(_ptr, _val)	{ _ReadWriteBarrier(); *(_ptr) = (_val); }
+	#define COTHREAD_ATOMIC_XCHG_ACQ(_ptr, _val)	_InterlockedExchange((_ptr), (_val))
+	#define COTHREAD_ATOMIC_LOAD(_ptr)				_InterlockedOr((_ptr), 0)
+	#define COTHREAD_ATOMIC_STORE(_ptr, _val)		((void)_InterlockedExchange((_ptr), (_val)))
+	#define COTHREAD_ATOMIC_FETCH_ADD(_ptr, _val)	_InterlockedExchangeAdd((_ptr), (_val))
+	#define COTHREAD_ATOMIC_LOAD_PTR(_ptr)			_InterlockedCompareExchangePointer((void* volatile*)(_ptr), NULL, NULL)
+	#define COTHREAD_ATOMIC_XCHG_PTR(_ptr, _val)	_InterlockedExchangePointer((void* volatile*)(_ptr), (_val))
+	#define COTHREAD_ATOMIC_CAS_PTR(_ptr, _old, _new)	((void*)(_old) == _InterlockedCompareExchangePointer((void* volatile*)(_ptr), (_new), (_old)))
+	#define COTHREAD_CPU_RELAX()					_mm_pause()
+
+	/** @cond */
+	static __inline long _cothread_atomic_load_acq(volatile long* ptr) { const long val = *ptr; _ReadWriteBarrier(); return val; }
+	/** @endcond */
+#endif
+
+/**
+ * @brief		The spinlock type.
+ * @ingroup		doxy_cothread_atomic
+ */
+typedef volatile long	cothread_spinlock_t;
+
+/**
+ * @brief		The spinlock initializer.
+ * @ingroup		doxy_cothread_atomic
+ */
+#define COTHREAD_SPINLOCK_INITIALIZER	0
+
+/**
+ * @brief		Locks the specified spinlock.
+ * @param		[in]	lock	The spinlock to lock.
+ * @ingroup		doxy_cothread_atomic
+ */
+static inline void
+cothread_spinlock_lock(cothread_spinlock_t* lock)
+{
+	while (0 != COTHREAD_ATOMIC_XCHG_ACQ(lock, 1)) {
+		while (0 != COTHREAD_ATOMIC_LOAD_ACQ(lock)) {
+			COTHREAD_CPU_RELAX();
+		}
+	}
+}
+
+/**
+ * @brief		Unlocks the specified spinlock.
+ * @param		[in]	lock	The spinlock to unlock.
+ * @ingroup		doxy_cothread_atomic
+ */
+static inline void
+cothread_spinlock_unlock(cothread_spinlock_t* lock)
+{
+	COTHREAD_ATOMIC_STORE_REL(lock, 0);
+}
+
+#endif /* __COTHREAD_ATOMIC_H__ */
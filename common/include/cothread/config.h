@@ -164,4 +164,24 @@
 	#define	COTHREAD_LINK
 #endif
 
+/**
+ * @brief		Declares a thread-local variable.
+ * @ingroup		doxy_cothread_config
+ */
+#if		(COTHREAD_CC_ID_CL == COTHREAD_CC_ID)
+	#define COTHREAD_THREAD_LOCAL	__declspec(thread)
+#else
+	#define COTHREAD_THREAD_LOCAL	__thread
+#endif
+
+/**
+ * @brief		Prevents the compiler from inlining the function it qualifies.
+ * @ingroup		doxy_cothread_config
+ */
+#if		(COTHREAD_CC_ID_CL == COTHREAD_CC_ID)
+	#define COTHREAD_NOINLINE	__declspec(noinline)
+#else
+	#define COTHREAD_NOINLINE	__attribute__ ((noinline))
+#endif
+
 #endif /* __COTHREAD_CONFIG_H__ */
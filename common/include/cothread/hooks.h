@@ -0,0 +1,76 @@
+/**
+ * @brief		This file contains the switch hooks.
+ * @file
+ */
+
+/**
+ * @defgroup	doxy_cothread_hooks		switch hooks
+ */
+
+#ifndef __COTHREAD_HOOKS_H__
+#define __COTHREAD_HOOKS_H__
+
+#include <cothread/config.h>
+#include <cothread/features.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothread_hooks
+/// @{
+typedef struct _cothread_hooks_t	cothread_hooks_t;	///< @brief	The switch hooks type.
+/// @}
+
+/**
+ * @brief		The switch hook.
+ * @param		[in]	cothread	The cothread whose callee is resumed or suspended (a backend cothread, e.g. a @c cothreadj_t.)
+ * @param		[in]	user_data	The user data of the hooks.
+ * @note		The resume hook runs right before the callee code resumes (or starts), the suspend hook right after
+ *				it pauses (or returns), both in the OS thread the callee runs in.
+ * @ingroup		doxy_cothread_hooks
+ */
+typedef void (COTHREAD_CALL * cothread_hook_cb_t) (void* cothread, void* user_data);
+
+/**
+ * @brief		The switch hooks type.
+ * @ingroup		doxy_cothread_hooks
+ */
+struct _cothread_hooks_t
+{
+	cothread_hook_cb_t	on_resume;	///< @brief	Called each time the callee is resumed (or started), NULL if none.
+	cothread_hook_cb_t	on_suspend;	///< @brief	Called each time the callee is suspended (or returns), NULL if none.
+	void*				user_data;	///< @brief	Any user data given to the hooks.
+};
+
+#if COTHREAD_WITH_HOOKS
+/**
+ * @brief		Calls the global, then the per-cothread resume hooks.
+ * @param		[in]	_global		The global hooks, may be NULL.
+ * @param		[in]	_local		The per-cothread hooks, may be NULL.
+ * @param		[in]	_cothread	The cothread.
+ * @ingroup		doxy_cothread_hooks
+ */
+#define COTHREAD_HOOKS_RESUME(_global, _local, _cothread)	{										\
+	const cothread_hooks_t*	_gh	= (_global);														\
+	const cothread_hooks_t*	_lh	= (_local);															\
+	if ((NULL != _gh) && (NULL != _gh->on_resume))	{ _gh->on_resume((_cothread), _gh->user_data); }	\
+	if ((NULL != _lh) && (NULL != _lh->on_resume))	{ _lh->on_resume((_cothread), _lh->user_data); }	\
+}
+
+/**
+ * @brief		Calls the per-cothread, then the global suspend hooks (the reverse order of the resume ones.)
+ * @param		[in]	_global		The global hooks, may be NULL.
+ * @param		[in]	_local		The per-cothread hooks, may be NULL.
+ * @param		[in]	_cothread	The cothread.
+ * @ingroup		doxy_cothread_hooks
+ */
+#define COTHREAD_HOOKS_SUSPEND(_global, _local, _cothread)	{										\
+	const cothread_hooks_t*	_gh	= (_global);														\
+	const cothread_hooks_t*	_lh	= (_local);															\
+	if ((NULL != _lh) && (NULL != _lh->on_suspend))	{ _lh->on_suspend((_cothread), _lh->user_data); }	\
+	if ((NULL != _gh) && (NULL != _gh->on_suspend))	{ _gh->on_suspend((_cothread), _gh->user_data); }	\
+}
+#else
+	#define COTHREAD_HOOKS_RESUME(_global, _local, _cothread)
+	#define COTHREAD_HOOKS_SUSPEND(_global, _local, _cothread)
+#endif
+
+#endif /* __COTHREAD_HOOKS_H__ */
@@ -0,0 +1,35 @@
+/**
+ * @brief		This file contains the USDT probes.
+ * @file
+ */
+
+/**
+ * @defgroup	doxy_cothread_probes	USDT probes
+ */
+
+#ifndef __COTHREAD_PROBES_H__
+#define __COTHREAD_PROBES_H__
+
+#include <cothread/config.h>
+#include <cothread/features.h>
+
+#if COTHREAD_WITH_USDT
+#include <sys/sdt.h>
+
+/**
+ * @brief		Fires the specified USDT probe.
+ * @details		The probe is a single nop instruction described in the .note.stapsdt section,
+ *				which tools such as bpftrace, perf or systemtap patch when they attach to it.
+ * @param		[in]	_provider	The probe provider (a bare identifier.)
+ * @param		[in]	_name		The probe name (a bare identifier.)
+ * @param		[in]	_cothread	The cothread.
+ * @param		[in]	_user_val	The user value.
+ * @ingroup		doxy_cothread_probes
+ */
+#define COTHREAD_PROBE(_provider, _name, _cothread, _user_val)	\
+	DTRACE_PROBE2(_provider, _name, (_cothread), (_user_val))
+#else
+	#define COTHREAD_PROBE(_provider, _name, _cothread, _user_val)
+#endif
+
+#endif /* __COTHREAD_PROBES_H__ */
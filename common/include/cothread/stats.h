@@ -0,0 +1,176 @@
+/**
+ * @brief		This file contains the per-cothread statistics.
+ * @file
+ */
+
+/**
+ * @defgroup	doxy_cothread_stats		statistics
+ */
+
+#ifndef __COTHREAD_STATS_H__
+#define __COTHREAD_STATS_H__
+
+#include <cothread/config.h>
+#include <cothread/features.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothread_stats
+/// @{
+typedef struct _cothread_stats_t		cothread_stats_t;		///< @brief	The statistics type.
+typedef struct _cothread_stats_list_t	cothread_stats_list_t;	///< @brief	The list of live statistics type.
+/// @}
+
+/**
+ * @brief		The statistics type.
+ * @note		The counters are only written by the OS thread running the callee, and read from any thread
+ *				with relaxed atomic operations.
+ * @ingroup		doxy_cothread_stats
+ */
+struct _cothread_stats_t
+{
+	uint64_t			nb_resumes;		///< @brief	The number of times the callee was resumed.
+	uint64_t			nb_ticks;		///< @brief	The cumulative time spent running the callee, in ticks (see @ref cothread_ticks_now.)
+	uint64_t			last_resume;	///< @brief	The tick the callee was resumed at for the last time, zero if never.
+	const void*			owner;			///< @brief	The cothread the statistics belong to.
+	const char*			dbg_name;		///< @brief	The callee debug name, may be NULL.
+	cothread_stats_t*	next;			///< @brief	The next statistics in the list of live ones.
+	cothread_stats_t**	pprev;			///< @brief	The link pointing to the statistics in the list of live ones, NULL if not linked.
+};
+
+#if COTHREAD_WITH_STATS
+#include <cothread/atomic.h>
+#include <cothread/ticks.h>
+
+/**
+ * @brief		The list of live statistics type.
+ * @ingroup		doxy_cothread_stats
+ */
+struct _cothread_stats_list_t
+{
+	cothread_spinlock_t	lock;	///< @brief	Protects the list.
+	cothread_stats_t*	head;	///< @brief	The first statistics of the list.
+};
+
+/**
+ * @brief		The list of live statistics initializer.
+ * @ingroup		doxy_cothread_stats
+ */
+#define COTHREAD_STATS_LIST_INITIALIZER	{ COTHREAD_SPINLOCK_INITIALIZER, NULL }
+
+/**
+ * @brief		Initializes the specified statistics, not linked in any list.
+ * @param		[in]	stats		The statistics to initialize.
+ * @param		[in]	owner		The cothread the statistics belong to.
+ * @param		[in]	dbg_name	The callee debug name, may be NULL.
+ * @ingroup		doxy_cothread_stats
+ */
+static inline void
+cothread_stats_init(cothread_stats_t* stats, const void* owner, const char* dbg_name)
+{
+	stats->nb_resumes	= 0;
+	stats->nb_ticks		= 0;
+	stats->last_resume	= 0;
+	stats->owner		= owner;
+	stats->dbg_name		= dbg_name;
+	stats->next			= NULL;
+	stats->pprev		= NULL;
+}
+
+/**
+ * @brief		Links the specified statistics in the specified list, if not done yet.
+ * @param		[in]	list		The list of live statistics.
+ * @param		[in]	stats		The initialized statistics to link.
+ * @ingroup		doxy_cothread_stats
+ */
+static inline void
+cothread_stats_register(cothread_stats_list_t* list, cothread_stats_t* stats)
+{
+	cothread_spinlock_lock(&(list->lock));
+	if (NULL == stats->pprev) {
+		stats->next		= list->head;
+		stats->pprev	= &(list->head);
+		if (NULL != list->head) {
+			list->head->pprev	= &(stats->next);
+		}
+		list->head	= stats;
+	}
+	cothread_spinlock_unlock(&(list->lock));
+}
+
+/**
+ * @brief		Unlinks the specified statistics from the specified list, if linked.
+ * @param		[in]	list		The list of live statistics.
+ * @param		[in]	stats		The initialized statistics to unlink.
+ * @ingroup		doxy_cothread_stats
+ */
+static inline void
+cothread_stats_unregister(cothread_stats_list_t* list, cothread_stats_t* stats)
+{
+	cothread_spinlock_lock(&(list->lock));
+	if (NULL != stats->pprev) {
+		*(stats->pprev)	= stats->next;
+		if (NULL != stats->next) {
+			stats->next->pprev	= stats->pprev;
+		}
+		stats->next		= NULL;
+		stats->pprev	= NULL;
+	}
+	cothread_spinlock_unlock(&(list->lock));
+}
+
+/**
+ * @brief		Copies the statistics of the specified list.
+ * @param		[in]	list		The list of live statistics.
+ * @param		[out]	stats		The array to copy the statistics to, may be NULL if @e nb_stats is zero.
+ * @param		[in]	nb_stats	The number of entries of the array.
+ * @return		Returns the number of live statistics, which may be greater than @e nb_stats.
+ * @ingroup		doxy_cothread_stats
+ */
+static inline size_t
+cothread_stats_copy(cothread_stats_list_t* list, cothread_stats_t* stats, size_t nb_stats)
+{
+	size_t	nb	= 0;
+	cothread_spinlock_lock(&(list->lock));
+	for (const cothread_stats_t* it = list->head; NULL != it; it = it->next, nb++) {
+		if (nb < nb_stats) {
+			stats[nb].nb_resumes	= COTHREAD_ATOMIC_LOAD_RLX(&(it->nb_resumes));
+			stats[nb].nb_ticks		= COTHREAD_ATOMIC_LOAD_RLX(&(it->nb_ticks));
+			stats[nb].last_resume	= COTHREAD_ATOMIC_LOAD_RLX(&(it->last_resume));
+			stats[nb].owner			= it->owner;
+			stats[nb].dbg_name		= it->dbg_name;
+			stats[nb].next			= NULL;
+			stats[nb].pprev			= NULL;
+		}
+	}
+	cothread_spinlock_unlock(&(list->lock));
+	return nb;
+}
+
+/**
+ * @brief		Accounts a resume of the callee.
+ * @param		[in]	_stats	The statistics to update.
+ * @ingroup		doxy_cothread_stats
+ */
+#define COTHREAD_STATS_RESUME(_stats)	{												\
+	cothread_stats_t*	_st	= (_stats);													\
+	COTHREAD_ATOMIC_STORE_RLX(&(_st->nb_resumes), _st->nb_resumes + 1);				\
+	COTHREAD_ATOMIC_STORE_RLX(&(_st->last_resume), cothread_ticks_now());				\
+}
+
+/**
+ * @brief		Accounts a pause of the callee.
+ * @param		[in]	_stats	The statistics to update.
+ * @ingroup		doxy_cothread_stats
+ */
+#define COTHREAD_STATS_PAUSE(_stats)	{												\
+	cothread_stats_t*	_st	= (_stats);													\
+	COTHREAD_ATOMIC_STORE_RLX(&(_st->nb_ticks), _st->nb_ticks + (cothread_ticks_now() - _st->last_resume));	\
+}
+#else
+	#define COTHREAD_STATS_RESUME(_stats)
+	#define COTHREAD_STATS_PAUSE(_stats)
+#endif
+
+#endif /* __COTHREAD_STATS_H__ */
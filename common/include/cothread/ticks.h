@@ -0,0 +1,57 @@
+/**
+ * @brief		This file contains the tick counter.
+ * @file
+ */
+
+/**
+ * @defgroup	doxy_cothread_ticks		ticks
+ */
+
+#ifndef __COTHREAD_TICKS_H__
+#define __COTHREAD_TICKS_H__
+
+#include <cothread/config.h>
+#include <stdint.h>
+#include <time.h>
+
+#if		((COTHREAD_ARCH_ID_X86 == COTHREAD_ARCH_ID) || (COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID))
+	#if (COTHREAD_CC_ID_CL == COTHREAD_CC_ID)
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+#endif
+
+/**
+ * @brief		Returns the current time, the clock shared by the libraries (and to convert ticks to nanoseconds.)
+ * @return		Returns the current time, in nanoseconds.
+ * @ingroup		doxy_cothread_ticks
+ */
+static inline uint64_t
+cothread_ticks_ns(void)
+{
+	struct timespec	ts;
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	timespec_get(&ts, TIME_UTC);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief		Returns the current tick.
+ * @return		Returns the time stamp counter on x86 & x86_64, the time of @ref cothread_ticks_ns otherwise.
+ * @ingroup		doxy_cothread_ticks
+ */
+static inline uint64_t
+cothread_ticks_now(void)
+{
+#if		((COTHREAD_ARCH_ID_X86 == COTHREAD_ARCH_ID) || (COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID))
+	return __rdtsc();
+#else
+	return cothread_ticks_ns();
+#endif
+}
+
+#endif /* __COTHREAD_TICKS_H__ */
@@ -0,0 +1,195 @@
+/**
+ * @brief		This file contains the switch events tracing, shared by the libraries sources.
+ * @file
+ * @note		This header is not installed: the rings are reached through the @c cothreadj_trace_xxx
+ *				and @c cothreadt_trace_xxx functions only.
+ */
+
+/**
+ * @defgroup	doxy_cothread_trace		tracing
+ */
+
+#ifndef __COTHREAD_TRACE_H__
+#define __COTHREAD_TRACE_H__
+
+#include <cothread/config.h>
+#include <cothread/features.h>
+#include <cothread/types.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothread_trace
+/// @{
+typedef struct _cothread_trace_event_t	cothread_trace_event_t;	///< @brief	The switch event type.
+typedef struct _cothread_trace_ring_t	cothread_trace_ring_t;	///< @brief	The per-thread ring of switch events type.
+typedef struct _cothread_trace_t		cothread_trace_t;		///< @brief	The tracer type.
+/// @}
+
+/**
+ * @brief		The number of events each per-thread ring retains (a power of two.)
+ * @ingroup		doxy_cothread_trace
+ */
+#define COTHREAD_TRACE_NB_EVENTS	4096
+
+/// @ingroup doxy_cothread_trace
+/// @{
+#define COTHREAD_TRACE_RESUME		0	///< @brief	The callee is resumed.
+#define COTHREAD_TRACE_PAUSE		1	///< @brief	The callee is paused.
+#define COTHREAD_TRACE_START		2	///< @brief	The callee entry point is called.
+#define COTHREAD_TRACE_COMPLETE		3	///< @brief	The callee entry point has returned.
+/// @}
+
+/**
+ * @brief		The switch event type.
+ * @ingroup		doxy_cothread_trace
+ */
+struct _cothread_trace_event_t
+{
+	uint64_t		ticks;		///< @brief	The tick the event occurred at (see @ref cothread_ticks_now.)
+	const void*		cothread;	///< @brief	The cothread.
+	const char*		dbg_name;	///< @brief	The callee debug name, may be NULL.
+	uintptr_t		type;		///< @brief	The event type (see @ref COTHREAD_TRACE_RESUME.)
+};
+
+/**
+ * @brief		The per-thread ring of switch events type.
+ * @note		The ring has a single producer, the OS thread owning it, and keeps the most recent events.
+ * @ingroup		doxy_cothread_trace
+ */
+struct _cothread_trace_ring_t
+{
+	cothread_trace_ring_t*	next;		///< @brief	The next ring of the tracer.
+	volatile long			nb_events;	///< @brief	The number of events ever recorded, modulo @c LONG_MAX.
+	cothread_trace_event_t	events[COTHREAD_TRACE_NB_EVENTS];	///< @brief	The events.
+};
+
+#if COTHREAD_WITH_TRACE
+#include <cothread/atomic.h>
+#include <cothread/ticks.h>
+#include <limits.h>
+
+/**
+ * @brief		The tracer type.
+ * @ingroup		doxy_cothread_trace
+ */
+struct _cothread_trace_t
+{
+	cothread_spinlock_t		lock;		///< @brief	Protects the list of rings.
+	cothread_trace_ring_t*	rings;		///< @brief	The rings, one per OS thread which recorded an event since the last release.
+	volatile long			enabled;	///< @brief	Says whether the events are recorded or not.
+	volatile long			gen;		///< @brief	The generation of the rings, bumped once they are released.
+	uint64_t				ticks0;		///< @brief	The tick the tracing started at.
+	uint64_t				ns0;		///< @brief	The time the tracing started at, in nanoseconds.
+};
+
+/**
+ * @brief		The thread-local reference to the ring of an OS thread type.
+ * @ingroup		doxy_cothread_trace
+ */
+typedef struct
+{
+	cothread_trace_ring_t*	ring;		///< @brief	The ring, NULL until the first event of the OS thread.
+	long					gen;		///< @brief	The generation of the tracer the ring was allocated in.
+} cothread_trace_slot_t;
+
+/**
+ * @brief		The tracer initializer.
+ * @ingroup		doxy_cothread_trace
+ */
+#define COTHREAD_TRACE_INITIALIZER	{ COTHREAD_SPINLOCK_INITIALIZER, NULL, 0, 0, 0, 0 }
+
+/**
+ * @brief		Allocates the ring of the calling OS thread.
+ * @param		[in]	trace	The tracer.
+ * @param		[in]	slot	The thread-local reference to the ring of the calling OS thread.
+ * @return		Returns the ring, NULL if it cannot be allocated.
+ * @ingroup		doxy_cothread_trace
+ */
+extern COTHREAD_LINK_HIDDEN cothread_trace_ring_t*	COTHREAD_CALL cothread_trace_ring_new	(cothread_trace_t* trace, cothread_trace_slot_t* slot);
+
+/**
+ * @brief		Starts recording the events, the previously recorded ones are discarded.
+ * @param		[in]	trace	The tracer.
+ * @ingroup		doxy_cothread_trace
+ */
+extern COTHREAD_LINK_HIDDEN void					COTHREAD_CALL cothread_trace_start		(cothread_trace_t* trace);
+
+/**
+ * @brief		Stops recording the events.
+ * @param		[in]	trace	The tracer.
+ * @ingroup		doxy_cothread_trace
+ */
+extern COTHREAD_LINK_HIDDEN void					COTHREAD_CALL cothread_trace_stop		(cothread_trace_t* trace);
+
+/**
+ * @brief		Writes the recorded events to the specified stream, in the Chrome trace event JSON format.
+ * @param		[in]	trace	The tracer.
+ * @param		[in]	strm	The stream to write the events to.
+ * @param		[in]	pid		The process identifier to write the events with.
+ * @param		[in]	name	The process name to write the events with.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if the events cannot be gathered.
+ *				.
+ * @ingroup		doxy_cothread_trace
+ */
+extern COTHREAD_LINK_HIDDEN cothread_err_t			COTHREAD_CALL cothread_trace_dump		(cothread_trace_t* trace, FILE* strm, unsigned long pid, const char* name);
+
+/**
+ * @brief		Frees the rings of every OS thread, each one allocating a new ring on its next event.
+ * @param		[in]	trace	The tracer, stopped, which no OS thread is recording an event in anymore.
+ * @ingroup		doxy_cothread_trace
+ */
+extern COTHREAD_LINK_HIDDEN void					COTHREAD_CALL cothread_trace_release	(cothread_trace_t* trace);
+
+/**
+ * @brief		Records an event in the ring of the calling OS thread.
+ * @param		[in]	trace		The tracer.
+ * @param		[in]	slot		The thread-local reference to the ring of the calling OS thread, allocated on first use.
+ * @param		[in]	type		The event type (see @ref COTHREAD_TRACE_RESUME.)
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	dbg_name	The callee debug name, may be NULL.
+ * @ingroup		doxy_cothread_trace
+ */
+static inline void
+cothread_trace_record(cothread_trace_t* trace, cothread_trace_slot_t* slot, uintptr_t type, const void* cothread, const char* dbg_name)
+{
+	//---Is the tracing enabled ?---//
+	if (0 == trace->enabled) {
+		return;
+	}
+
+	//---Get the ring, a new one if the previous one was released---//
+	cothread_trace_ring_t*	r	= slot->ring;
+	if (((NULL == r) || (slot->gen != trace->gen)) && (NULL == (r = cothread_trace_ring_new(trace, slot)))) {
+		return;
+	}
+
+	//---Fill the next event & publish it---//
+	const unsigned long		idx	= (unsigned long)r->nb_events;
+	cothread_trace_event_t*	ev	= r->events + (idx & (COTHREAD_TRACE_NB_EVENTS - 1));
+	ev->ticks		= cothread_ticks_now();
+	ev->cothread	= cothread;
+	ev->dbg_name	= dbg_name;
+	ev->type		= type;
+	COTHREAD_ATOMIC_STORE_REL(&(r->nb_events), (long)((idx + 1) & (unsigned long)LONG_MAX));
+}
+
+/**
+ * @brief		Records the specified event.
+ * @param		[in]	_trace		The tracer.
+ * @param		[in]	_slot		The thread-local reference to the ring of the calling OS thread.
+ * @param		[in]	_type		The event type (see @ref COTHREAD_TRACE_RESUME.)
+ * @param		[in]	_cothread	The cothread.
+ * @param		[in]	_dbg_name	The callee debug name, may be NULL.
+ * @ingroup		doxy_cothread_trace
+ */
+#define COTHREAD_TRACE(_trace, _slot, _type, _cothread, _dbg_name)	\
+	cothread_trace_record((_trace), (_slot), (_type), (_cothread), (_dbg_name))
+#else
+	#define COTHREAD_TRACE(_trace, _slot, _type, _cothread, _dbg_name)
+#endif
+
+#endif /* __COTHREAD_TRACE_H__ */
@@ -18,6 +18,7 @@ enum _cothread_err_t
 {
 	cothread_err_ok,		///< @brief	No error.
 	cothread_err_notsup,	///< @brief	Operation not supported.
+	cothread_err_nomem,		///< @brief	Not enough resources.
 };
 
 /**
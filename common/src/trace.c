@@ -0,0 +1,189 @@
+/**
+ * @brief		This file contains the switch events tracing definitions.
+ * @file
+ *
+ * The tracer is shared by the backends, each one recording its events through the inline
+ * @ref cothread_trace_record function: only the allocation of the rings & their dump live here.
+ */
+
+#include <cothread/trace.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief		Compares the specified events by cothread, then by tick.
+ * @param		[in]	a	The first event.
+ * @param		[in]	b	The second event.
+ * @return		Returns a negative, zero or positive value as for the strcmp function.
+ * @ingroup		doxy_cothread_trace
+ */
+static int
+cothread_trace_cmp(const void* a, const void* b)
+{
+	const cothread_trace_event_t*	ea	= (const cothread_trace_event_t*)a;
+	const cothread_trace_event_t*	eb	= (const cothread_trace_event_t*)b;
+	if (ea->cothread != eb->cothread) {
+		return ((uintptr_t)ea->cothread < (uintptr_t)eb->cothread) ? -1 : +1;
+	} else if (ea->ticks != eb->ticks) {
+		return (ea->ticks < eb->ticks) ? -1 : +1;
+	}
+	return 0;
+}
+
+/**
+ * @brief		Writes the specified string as a JSON string to the specified stream.
+ * @param		[in]	strm	The stream to write the string to.
+ * @param		[in]	str		The string to write.
+ * @ingroup		doxy_cothread_trace
+ */
+static void
+cothread_trace_dump_str(FILE* strm, const char* str)
+{
+	fputc('"', strm);
+	for (; '\0' != str[0]; str++) {
+		if (('"' == str[0]) || ('\\' == str[0])) {
+			fprintf(strm, "\\%c", str[0]);
+		} else if (0x20 > (unsigned char)str[0]) {
+			fprintf(strm, "\\u%04x", (unsigned int)(unsigned char)str[0]);
+		} else {
+			fputc(str[0], strm);
+		}
+	}
+	fputc('"', strm);
+}
+
+extern COTHREAD_LINK_HIDDEN cothread_trace_ring_t* COTHREAD_CALL
+cothread_trace_ring_new(cothread_trace_t* trace, cothread_trace_slot_t* slot)
+{
+	cothread_trace_ring_t*	ring	= (cothread_trace_ring_t*)malloc(sizeof(cothread_trace_ring_t));
+	if (NULL != ring) {
+		ring->nb_events	= 0;
+		cothread_spinlock_lock(&(trace->lock));
+		ring->next		= trace->rings;
+		trace->rings	= ring;
+		slot->ring		= ring;
+		slot->gen		= trace->gen;
+		cothread_spinlock_unlock(&(trace->lock));
+	}
+	return ring;
+}
+
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothread_trace_start(cothread_trace_t* trace)
+{
+	cothread_spinlock_lock(&(trace->lock));
+	for (cothread_trace_ring_t* ring = trace->rings; NULL != ring; ring = ring->next) {
+		COTHREAD_ATOMIC_STORE_REL(&(ring->nb_events), 0);
+	}
+	trace->ticks0	= cothread_ticks_now();
+	trace->ns0		= cothread_ticks_ns();
+	cothread_spinlock_unlock(&(trace->lock));
+	COTHREAD_ATOMIC_STORE_REL(&(trace->enabled), 1);
+}
+
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothread_trace_stop(cothread_trace_t* trace)
+{
+	COTHREAD_ATOMIC_STORE_REL(&(trace->enabled), 0);
+}
+
+extern COTHREAD_LINK_HIDDEN cothread_err_t COTHREAD_CALL
+cothread_trace_dump(cothread_trace_t* trace, FILE* strm, unsigned long pid, const char* name)
+{
+	//---Definitions---//
+	cothread_trace_event_t*	events;
+	size_t					nb_events	= 0;
+	size_t					nb_rings	= 0;
+
+	//---Allocate room for all the rings---//
+	cothread_spinlock_lock(&(trace->lock));
+	for (const cothread_trace_ring_t* ring = trace->rings; NULL != ring; ring = ring->next) {
+		nb_rings++;
+	}
+	if (NULL == (events = (cothread_trace_event_t*)malloc((0 != nb_rings ? nb_rings : 1) * COTHREAD_TRACE_NB_EVENTS * sizeof(cothread_trace_event_t)))) {
+		cothread_spinlock_unlock(&(trace->lock));
+		return cothread_err_nomem;
+	}
+
+	//---Copy the events which are not being overwritten---//
+	for (const cothread_trace_ring_t* ring = trace->rings; NULL != ring; ring = ring->next) {
+		const unsigned long	end		= (unsigned long)COTHREAD_ATOMIC_LOAD_ACQ(&(ring->nb_events));
+		const unsigned long	begin	= (COTHREAD_TRACE_NB_EVENTS < end) ? end - COTHREAD_TRACE_NB_EVENTS : 0;
+		const size_t		first	= nb_events;
+		for (unsigned long idx = begin; idx != end; idx++) {
+			events[nb_events++]	= ring->events[idx & (COTHREAD_TRACE_NB_EVENTS - 1)];
+		}
+
+		//---Forget the events overwritten meanwhile---//
+		const unsigned long	end2	= (unsigned long)COTHREAD_ATOMIC_LOAD_ACQ(&(ring->nb_events));
+		if ((end2 - begin) > COTHREAD_TRACE_NB_EVENTS) {
+			const size_t	nb_lost	= (size_t)(end2 - begin - COTHREAD_TRACE_NB_EVENTS);
+			const size_t	nb_kept	= (nb_lost < nb_events - first) ? nb_events - first - nb_lost : 0;
+			memmove(events + first, events + nb_events - nb_kept, nb_kept * sizeof(cothread_trace_event_t));
+			nb_events	= first + nb_kept;
+		}
+	}
+	const uint64_t	ticks0	= trace->ticks0;
+	const uint64_t	ns0		= trace->ns0;
+	cothread_spinlock_unlock(&(trace->lock));
+
+	//---Compute the tick duration---//
+	const uint64_t	ticks1		= cothread_ticks_now();
+	const uint64_t	ns1			= cothread_ticks_ns();
+	const double	ns_per_tick	= ((ticks1 > ticks0) && (ns1 > ns0)) ? (double)(ns1 - ns0) / (double)(ticks1 - ticks0) : 1.0;
+
+	//---Write one track per cothread---//
+	qsort(events, nb_events, sizeof(cothread_trace_event_t), cothread_trace_cmp);
+	fprintf(strm, "{\"traceEvents\":[\n{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%lu,\"args\":{\"name\":", pid);
+	cothread_trace_dump_str(strm, name);
+	fputs("}}", strm);
+	const char*	sep	= ",\n";
+	for (size_t i = 0; i < nb_events; i++) {
+		const cothread_trace_event_t*	ev	= events + i;
+		const unsigned long long		tid	= (unsigned long long)(uintptr_t)ev->cothread;
+		const double					us	= (double)(int64_t)(ev->ticks - ticks0) * ns_per_tick / 1000.0;
+
+		//---Name the track on its first event---//
+		if ((0 == i) || (ev->cothread != ev[-1].cothread)) {
+			fprintf(strm, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%lu,\"tid\":%llu,\"args\":{\"name\":", sep, pid, tid);
+			if (NULL != ev->dbg_name) {
+				cothread_trace_dump_str(strm, ev->dbg_name);
+			} else {
+				fprintf(strm, "\"%p\"", ev->cothread);
+			}
+			fputs("}}", strm);
+		}
+
+		//---Write the event---//
+		switch (ev->type) {
+			case COTHREAD_TRACE_RESUME:		fprintf(strm, "%s{\"ph\":\"B\",\"name\":\"running\",\"pid\":%lu,\"tid\":%llu,\"ts\":%.3f}", sep, pid, tid, us);	break;
+			case COTHREAD_TRACE_PAUSE:		fprintf(strm, "%s{\"ph\":\"E\",\"pid\":%lu,\"tid\":%llu,\"ts\":%.3f}", sep, pid, tid, us);							break;
+			case COTHREAD_TRACE_START:		fprintf(strm, "%s{\"ph\":\"i\",\"s\":\"t\",\"name\":\"start\",\"pid\":%lu,\"tid\":%llu,\"ts\":%.3f}", sep, pid, tid, us);		break;
+			case COTHREAD_TRACE_COMPLETE:	fprintf(strm, "%s{\"ph\":\"i\",\"s\":\"t\",\"name\":\"complete\",\"pid\":%lu,\"tid\":%llu,\"ts\":%.3f}", sep, pid, tid, us);
+											fprintf(strm, "%s{\"ph\":\"E\",\"pid\":%lu,\"tid\":%llu,\"ts\":%.3f}", sep, pid, tid, us);							break;
+		}
+	}
+	fputs("\n],\"displayTimeUnit\":\"ns\"}\n", strm);
+
+	//---Return---//
+	free(events);
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothread_trace_release(cothread_trace_t* trace)
+{
+	//---Unlink the rings, the OS threads referencing one of them allocating a new one---//
+	cothread_spinlock_lock(&(trace->lock));
+	cothread_trace_ring_t*	ring	= trace->rings;
+	trace->rings	= NULL;
+	trace->gen++;
+	cothread_spinlock_unlock(&(trace->lock));
+
+	//---Free them---//
+	while (NULL != ring) {
+		cothread_trace_ring_t*	next	= ring->next;
+		free(ring);
+		ring	= next;
+	}
+}
@@ -0,0 +1,228 @@
+/**
+ * @brief		This file contains a benchmark measuring the dispatch overhead of the cothread facade.
+ * @file
+ *
+ * usage: cothread_benchmark_dispatch [nb_pings [nb_thread_pings]]
+ *
+ * For each compiled in backend, the ping-pong between a caller & its callee is measured through the
+ * backend API, then through the facade: the difference is the dispatch overhead.
+ * Configure with a single backend (e.g. -D COTHREAD_WITH_BACKEND_T=FALSE -D COTHREAD_WITH_BACKEND_U=FALSE)
+ * to measure the facade once the dispatch is compiled out. The thread backend being far slower,
+ * it runs a smaller number of pings.
+ */
+
+#include <cothread/cothread.h>
+#include <cothread/ticks.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 8 * 1024)
+#define STOP_VAL	(-1)	// the value making the callees return.
+/// @endcond
+
+/// @cond
+static cothread_stack_t	stack_g[STACK_SZ];	// the callee stack.
+/// @endcond
+
+/**
+ * @brief		Prints the specified measure.
+ * @param		[in]	api			The measured API.
+ * @param		[in]	backend		The backend.
+ * @param		[in]	ns			The elapsed time, in nanoseconds.
+ * @param		[in]	nb_pings	The number of pings.
+ */
+static void
+report(const char* api, cothread_backend_t backend, uint64_t ns, size_t nb_pings)
+{
+	printf("%-9s %-8s %10.2f ns/switch\n", cothread_backend_name(backend), api, (double)ns / (2.0 * (double)nb_pings));
+}
+
+/**
+ * @brief		The facade callee entry point, which sends back the received values until told to stop.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns @ref STOP_VAL.
+ */
+static int COTHREAD_CALL
+facade_cb(cothread_t* cothread, int user_val)
+{
+	do {
+		user_val	= cothread_yield(cothread, user_val);
+	} while (STOP_VAL != user_val);
+	return user_val;
+}
+
+/**
+ * @brief		Runs the ping-pong through the facade.
+ * @param		[in]	backend		The backend.
+ * @param		[in]	nb_pings	The number of pings.
+ */
+static void
+run_facade(cothread_backend_t backend, size_t nb_pings)
+{
+	//---Initialize the cothread---//
+	cothread_attr_t	attr;
+	cothread_t		cothread;
+	cothread_attr_init(&attr, stack_g, sizeof(stack_g), facade_cb);
+	cothread_attr_set_backend(&attr, backend);
+	if (cothread_err_ok != cothread_init(&cothread, &attr)) {
+		fprintf(stderr, "cannot initialize the %s cothread\n", cothread_backend_name(backend));
+		exit(EXIT_FAILURE);
+	}
+
+	//---Ping-pong, then stop the callee---//
+	const uint64_t	ns0	= cothread_ticks_ns();
+	for (size_t i = 0; i < nb_pings; i++) {
+		cothread_yield(&cothread, 1);
+	}
+	report("facade", backend, cothread_ticks_ns() - ns0, nb_pings);
+	cothread_yield(&cothread, STOP_VAL);
+	cothread_uninit(&cothread);
+}
+
+#if COTHREAD_WITH_BACKEND_J
+/**
+ * @brief		The cothreadj callee entry point, which sends back the received values until told to stop.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns @ref STOP_VAL.
+ */
+static int COTHREAD_CALL
+cothreadj_cb(cothreadj_t* cothread, int user_val)
+{
+	do {
+		user_val	= cothreadj_yield(cothread, user_val);
+	} while (STOP_VAL != user_val);
+	return user_val;
+}
+
+/**
+ * @brief		Runs the ping-pong through the cothreadj API.
+ * @param		[in]	nb_pings	The number of pings.
+ */
+static void
+run_cothreadj(size_t nb_pings)
+{
+	cothreadj_attr_t	attr;
+	cothreadj_t			cothread;
+	cothreadj_attr_init(&attr, stack_g, sizeof(stack_g), cothreadj_cb);
+	cothreadj_init(&cothread, &attr);
+	const uint64_t	ns0	= cothread_ticks_ns();
+	for (size_t i = 0; i < nb_pings; i++) {
+		cothreadj_yield(&cothread, 1);
+	}
+	report("backend", cothread_backend_cothreadj, cothread_ticks_ns() - ns0, nb_pings);
+	cothreadj_yield(&cothread, STOP_VAL);
+	cothreadj_uninit(&cothread);
+}
+#endif
+
+#if COTHREAD_WITH_BACKEND_T
+/**
+ * @brief		The cothreadt callee entry point, which yields back until told to stop.
+ * @param		[in]	cothread	The cothread, whose user data is the stop flag.
+ */
+static void COTHREAD_CALL
+cothreadt_cb(cothreadt_t* cothread)
+{
+	const volatile int*	stop	= (const volatile int*)cothreadt_get_user_data(cothread);
+	while (0 == stop[0]) {
+		cothreadt_yield(cothread);
+	}
+}
+
+/**
+ * @brief		Runs the ping-pong through the cothreadt API.
+ * @param		[in]	nb_pings	The number of pings.
+ */
+static void
+run_cothreadt(size_t nb_pings)
+{
+	cothreadt_attr_t	attr;
+	cothreadt_t			cothread;
+	volatile int		stop	= 0;
+	cothreadt_attr_init(&attr, cothreadt_cb);
+	if (cothread_err_ok != cothreadt_init(&cothread, &attr)) {
+		fprintf(stderr, "cannot initialize the cothreadt cothread\n");
+		exit(EXIT_FAILURE);
+	}
+	cothreadt_set_user_data(&cothread, (void*)&stop);
+	const uint64_t	ns0	= cothread_ticks_ns();
+	for (size_t i = 0; i < nb_pings; i++) {
+		cothreadt_yield(&cothread);
+	}
+	report("backend", cothread_backend_cothreadt, cothread_ticks_ns() - ns0, nb_pings);
+	stop	= 1;
+	cothreadt_yield(&cothread);
+	cothreadt_uninit(&cothread);
+}
+#endif
+
+#if COTHREAD_WITH_BACKEND_U
+/**
+ * @brief		The cothreadu callee entry point, which sends back the received values until told to stop.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns @ref STOP_VAL.
+ */
+static int COTHREAD_CALL
+cothreadu_cb(cothreadu_t* cothread, int user_val)
+{
+	do {
+		user_val	= cothreadu_yield(cothread, user_val);
+	} while (STOP_VAL != user_val);
+	return user_val;
+}
+
+/**
+ * @brief		Runs the ping-pong through the cothreadu API.
+ * @param		[in]	nb_pings	The number of pings.
+ */
+static void
+run_cothreadu(size_t nb_pings)
+{
+	cothreadu_attr_t	attr;
+	cothreadu_t			cothread;
+	cothreadu_attr_init(&attr, stack_g, sizeof(stack_g), cothreadu_cb);
+	if (cothread_err_ok != cothreadu_init(&cothread, &attr)) {
+		fprintf(stderr, "cannot initialize the cothreadu cothread\n");
+		exit(EXIT_FAILURE);
+	}
+	const uint64_t	ns0	= cothread_ticks_ns();
+	for (size_t i = 0; i < nb_pings; i++) {
+		cothreadu_yield(&cothread, 1);
+	}
+	report("backend", cothread_backend_cothreadu, cothread_ticks_ns() - ns0, nb_pings);
+	cothreadu_yield(&cothread, STOP_VAL);
+	cothreadu_uninit(&cothread);
+}
+#endif
+
+extern int
+main(int argc, char* argv[])
+{
+	//---Parse the arguments---//
+	const size_t	nb_pings		= (1 < argc) ? (size_t)strtoul(argv[1], NULL, 0) : 10000000;
+	const size_t	nb_thread_pings	= (2 < argc) ? (size_t)strtoul(argv[2], NULL, 0) : 100000;
+	if ((0 == nb_pings) || (0 == nb_thread_pings)) {
+		fprintf(stderr, "usage: %s [nb_pings [nb_thread_pings]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	//---Run---//
+	printf("%d backend(s) compiled in, %s dispatch\n", COTHREAD_NB_BACKENDS, (1 < COTHREAD_NB_BACKENDS) ? "runtime" : "no");
+#if COTHREAD_WITH_BACKEND_J
+	run_cothreadj(nb_pings);
+	run_facade(cothread_backend_cothreadj, nb_pings);
+#endif
+#if COTHREAD_WITH_BACKEND_T
+	run_cothreadt(nb_thread_pings);
+	run_facade(cothread_backend_cothreadt, nb_thread_pings);
+#endif
+#if COTHREAD_WITH_BACKEND_U
+	run_cothreadu(nb_pings);
+	run_facade(cothread_backend_cothreadu, nb_pings);
+#endif
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/**
+ * @brief		This file contains the public declarations.
+ * @file
+ *
+ * @defgroup	doxy_cothread_facade		cothread - facade
+ * @{
+ *		@defgroup	doxy_cothread_facade_unittest	C unittest
+ * @}
+ */
+
+#ifndef __COTHREAD_COTHREAD_H__
+#define __COTHREAD_COTHREAD_H__
+
+#include <cothread/config.h>
+#include <cothread/features.h>
+#include <cothread/types.h>
+#if COTHREAD_WITH_BACKEND_J
+	#include <cothread/cothreadj.h>
+#endif
+#if COTHREAD_WITH_BACKEND_T
+	#include <cothread/cothreadt.h>
+#endif
+#if COTHREAD_WITH_BACKEND_U
+	#include <cothread/cothreadu.h>
+#endif
+
+//---Forward declarations---//
+/// @ingroup doxy_cothread_facade
+/// @{
+typedef enum _cothread_backend_t	cothread_backend_t;	///< @brief	The backend type.
+typedef struct _cothread_attr_t		cothread_attr_t;	///< @brief	The cothread attribute type.
+typedef struct _cothread_t			cothread_t;			///< @brief	The cothread type.
+#if COTHREAD_WITH_BACKEND_J
+typedef cothreadj_stack_t			cothread_stack_t;	///< @brief	The stack type, aligned as the setjmp / longjmp backend requires.
+#else
+typedef char						cothread_stack_t;	///< @brief	The stack type.
+#endif
+/// @}
+
+/**
+ * @brief		The number of backends compiled in the facade.
+ * @ingroup		doxy_cothread_facade
+ */
+#define COTHREAD_NB_BACKENDS	(COTHREAD_WITH_BACKEND_J + COTHREAD_WITH_BACKEND_T + COTHREAD_WITH_BACKEND_U)
+
+/**
+ * @brief		The name of the environment variable selecting the default backend
+ *				("cothreadj", "cothreadt" or "cothreadu".)
+ * @ingroup		doxy_cothread_facade
+ */
+#define COTHREAD_BACKEND_ENV	"COTHREAD_BACKEND"
+
+/**
+ * @brief		The backend type.
+ * @ingroup		doxy_cothread_facade
+ */
+enum _cothread_backend_t
+{
+	cothread_backend_default,	///< @brief	The backend named by @ref COTHREAD_BACKEND_ENV, the first compiled in one if not set.
+	cothread_backend_cothreadj,	///< @brief	The setjmp / longjmp backend.
+	cothread_backend_cothreadt,	///< @brief	The thread backend.
+	cothread_backend_cothreadu,	///< @brief	The ucontext backend.
+};
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns any user value (except zero) to send to the caller.
+ * @ingroup		doxy_cothread_facade
+ */
+typedef int (COTHREAD_CALL * cothread_cb_t) (cothread_t* cothread, int user_val);
+
+/**
+ * @brief		The cothread attribute type.
+ * @ingroup		doxy_cothread_facade
+ */
+struct _cothread_attr_t
+{
+	cothread_backend_t	backend;	///< @brief	The backend.
+	cothread_stack_t*	stack;		///< @brief	The lowest address of the callee stack, unused by the thread backend.
+	size_t				stack_sz;	///< @brief	The size of the callee stack, in bytes.
+	cothread_cb_t		user_cb;	///< @brief	The callee entry point.
+};
+
+/**
+ * @brief		The cothread type.
+ * @ingroup		doxy_cothread_facade
+ */
+struct _cothread_t
+{
+	/// @brief	The backend cothread.
+	union
+	{
+#if COTHREAD_WITH_BACKEND_J
+		cothreadj_t		j;	///< @brief	The setjmp / longjmp cothread.
+#endif
+#if COTHREAD_WITH_BACKEND_T
+		cothreadt_t		t;	///< @brief	The thread cothread.
+#endif
+#if COTHREAD_WITH_BACKEND_U
+		cothreadu_t		u;	///< @brief	The ucontext cothread.
+#endif
+	} impl;
+	cothread_backend_t	backend;	///< @brief	The backend (never @ref cothread_backend_default.)
+	int					user_val;	///< @brief	The user value sent to the other endpoint, by the thread backend only.
+	cothread_cb_t		user_cb;	///< @brief	The callee entry point.
+	void*				user_data;	///< @brief	Any user data.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified attributes, with the default backend.
+ * @param		[in]	attr		The attributes to initialize.
+ * @param		[in]	stack		The lowest address of the callee stack, may be NULL for the thread backend only.
+ * @param		[in]	stack_sz	The size of the callee stack, in bytes
+ *									(must be a multiple of the alignment of @ref cothread_stack_t.)
+ * @param		[in]	user_cb		The callee entry point.
+ * @relates		_cothread_attr_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothread_attr_init	(cothread_attr_t* attr, cothread_stack_t* stack, size_t stack_sz, cothread_cb_t user_cb);
+
+/**
+ * @brief		Sets the backend.
+ * @param		[in]	attr		The attributes to store the backend in.
+ * @param		[in]	backend		The backend, @ref cothread_backend_default to defer the choice to the environment.
+ * @relates		_cothread_attr_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothread_attr_set_backend	(cothread_attr_t* attr, cothread_backend_t backend);
+
+/**
+ * @brief		Initializes the specified cothread.
+ * @param		[in]	cothread	The cothread to initialize.
+ * @param		[in]	attr		The attributes to initialize the cothread with.
+ * @note		Modifying @e attr after calling this function has no effect on the initialized @e cothread.
+ *				The @ref COTHREAD_BACKEND_ENV environment variable is read by each call with the default backend.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the backend is unknown or not compiled in,
+ *				or if the backend fails to initialize the cothread.
+ *				.
+ * @relates		_cothread_t
+ */
+extern COTHREAD_LINK cothread_err_t		COTHREAD_CALL cothread_init	(cothread_t* cothread, const cothread_attr_t* attr);
+
+/**
+ * @brief		Uninitializes the specified cothread.
+ * @param		[in]	cothread	The cothread to uninitialize, which must not be called if @ref cothread_init has failed.
+ * @relates		_cothread_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothread_uninit	(cothread_t* cothread);
+
+/**
+ * @brief		Returns the backend of the specified cothread.
+ * @param		[in]	cothread	The cothread.
+ * @return		Returns the backend, never @ref cothread_backend_default.
+ * @relates		_cothread_t
+ */
+extern COTHREAD_LINK cothread_backend_t	COTHREAD_CALL cothread_get_backend	(const cothread_t* cothread);
+
+/**
+ * @brief		Returns the name of the specified backend, as set in the @ref COTHREAD_BACKEND_ENV environment variable.
+ * @param		[in]	backend		The backend.
+ * @return		Returns the name, "default" for @ref cothread_backend_default.
+ * @ingroup		doxy_cothread_facade
+ */
+extern COTHREAD_LINK const char*		COTHREAD_CALL cothread_backend_name	(cothread_backend_t backend);
+
+/**
+ * @brief		Stores the specified user data in the specified cothread.
+ * @param		[in]	cothread	The cothread to store the user data in.
+ * @param		[in]	user_data	Any user data to store in the cothread.
+ * @relates		_cothread_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothread_set_user_data	(cothread_t* cothread, void* user_data);
+
+/**
+ * @brief		Returns the user data stored in the specified cothread.
+ * @param		[in]	cothread	The cothread to return the user data stored in.
+ * @return		Returns the user data.
+ * @relates		_cothread_t
+ */
+extern COTHREAD_LINK void*				COTHREAD_CALL cothread_get_user_data	(const cothread_t* cothread);
+
+/**
+ * @brief		Switches from the current endpoint to the other one.
+ * @param		[in]	cothread	The cothread to switch.
+ * @param		[in]	user_val	Any user value (except zero) to send to the other endpoint.
+ * @return		Returns the @e user_val received from the other endpoint
+ *				(the value returned by the callee once it has returned.)
+ * @note		With a single backend compiled in, the call is forwarded to it without any dispatch.
+ * @relates		_cothread_t
+ */
+extern COTHREAD_LINK int				COTHREAD_CALL cothread_yield	(cothread_t* cothread, int user_val);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREAD_H__ */
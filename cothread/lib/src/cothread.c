@@ -0,0 +1,296 @@
+/**
+ * @brief		This file contains the C functions definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothread		cothread - facade
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothread_def	Definitions
+ *				The [cothread](@ref _cothread_t) offers a single API over the cothreadj (setjmp / longjmp),
+ *				cothreadt (thread) and cothreadu (ucontext) backends: user values are exchanged on each switch
+ *				whatever the backend, and the callee stack is simply ignored by the thread backend.
+ *				The backend is chosen for each cothread, in its [attributes](@ref _cothread_attr_t) or through
+ *				the @ref COTHREAD_BACKEND_ENV environment variable, so that the backends may be compared
+ *				without touching the code.
+ *				Each call is dispatched on the backend of the cothread, unless a single backend is compiled in
+ *				(see @ref COTHREAD_NB_BACKENDS): the calls are then forwarded to it directly.
+ *
+ * @section		doxy_p_cothread_use	Usage
+ *				-# First of all, a @e stack should be allocated (unless the thread backend is used) ;
+ *				-# Once the stack is allocated, some [attributes](@ref _cothread_attr_t) have to be initialized
+ *				with the @ref cothread_attr_init function, and the backend may be chosen with
+ *				the @ref cothread_attr_set_backend one ;
+ *				-# Once the attributes are initialized, the @ref cothread_init function should be called
+ *				to initialize the [cothread](@ref _cothread_t) itself (note that this function may fail
+ *				so its return value @b MUST be checked) ;
+ *				-# From this point, calling the @ref cothread_yield function pauses the current execution context
+ *				and resumes the other one ;
+ *				-# Finally, the @ref cothread_uninit function has to be called to release the cothread.
+ *				.
+ */
+
+#include <cothread/cothread.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief		Returns the backend of the specified cothread.
+ * @param		[in]	_cothread	The cothread.
+ * @return		Returns the backend, a constant if a single backend is compiled in.
+ * @ingroup		doxy_cothread_facade
+ */
+#if		(1 < COTHREAD_NB_BACKENDS)
+	#define COTHREAD_BACKEND(_cothread)	((_cothread)->backend)
+#elif	COTHREAD_WITH_BACKEND_J
+	#define COTHREAD_BACKEND(_cothread)	cothread_backend_cothreadj
+#elif	COTHREAD_WITH_BACKEND_T
+	#define COTHREAD_BACKEND(_cothread)	cothread_backend_cothreadt
+#else
+	#define COTHREAD_BACKEND(_cothread)	cothread_backend_cothreadu
+#endif
+
+/// @cond
+static const char* const	cothread_backend_names[]	= {	// the backend names, indexed by backend.
+	"default",
+	"cothreadj",
+	"cothreadt",
+	"cothreadu",
+};
+/// @endcond
+
+#if COTHREAD_WITH_BACKEND_J
+/**
+ * @brief		The callee entry point of the setjmp / longjmp backend.
+ * @param		[in]	impl		The backend cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns any user value (except zero) to send to the caller.
+ * @relates		_cothread_t
+ */
+static int COTHREAD_CALL
+cothread_cothreadj_cb(cothreadj_t* impl, int user_val)
+{
+	cothread_t*	cothread	= (cothread_t*)cothreadj_get_user_data(impl);
+	return cothread->user_cb(cothread, user_val);
+}
+#endif
+
+#if COTHREAD_WITH_BACKEND_T
+/**
+ * @brief		The callee entry point of the thread backend.
+ * @param		[in]	impl		The backend cothread.
+ * @relates		_cothread_t
+ */
+static void COTHREAD_CALL
+cothread_cothreadt_cb(cothreadt_t* impl)
+{
+	cothread_t*	cothread	= (cothread_t*)cothreadt_get_user_data(impl);
+	cothread->user_val	= cothread->user_cb(cothread, cothread->user_val);
+}
+#endif
+
+#if COTHREAD_WITH_BACKEND_U
+/**
+ * @brief		The callee entry point of the ucontext backend.
+ * @param		[in]	impl		The backend cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns any user value (except zero) to send to the caller.
+ * @relates		_cothread_t
+ */
+static int COTHREAD_CALL
+cothread_cothreadu_cb(cothreadu_t* impl, int user_val)
+{
+	cothread_t*	cothread	= (cothread_t*)cothreadu_get_user_data(impl);
+	return cothread->user_cb(cothread, user_val);
+}
+#endif
+
+/**
+ * @brief		Returns the backend named by the @ref COTHREAD_BACKEND_ENV environment variable.
+ * @return		Returns the named backend, the first compiled in one if the variable is not set,
+ *				@ref cothread_backend_default if the name is unknown.
+ * @ingroup		doxy_cothread_facade
+ */
+static cothread_backend_t COTHREAD_CALL
+cothread_backend_from_env(void)
+{
+	//---Is the variable set ?---//
+	const char*	name	= getenv(COTHREAD_BACKEND_ENV);
+	if ((NULL == name) || ('\0' == name[0])) {
+#if		COTHREAD_WITH_BACKEND_J
+		return cothread_backend_cothreadj;
+#elif	COTHREAD_WITH_BACKEND_T
+		return cothread_backend_cothreadt;
+#else
+		return cothread_backend_cothreadu;
+#endif
+	}
+
+	//---Look the name up---//
+	for (size_t i = cothread_backend_cothreadj; i < sizeof(cothread_backend_names) / sizeof(cothread_backend_names[0]); i++) {
+		if (0 == strcmp(name, cothread_backend_names[i])) {
+			return (cothread_backend_t)i;
+		}
+	}
+	return cothread_backend_default;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothread_attr_init(cothread_attr_t* attr, cothread_stack_t* stack, size_t stack_sz, cothread_cb_t user_cb)
+{
+	//---Check arguments---//
+	assert(NULL	!= attr);
+	assert(NULL	!= user_cb);
+
+	//---Init---//
+	attr->backend	= cothread_backend_default;
+	attr->stack		= stack;
+	attr->stack_sz	= stack_sz;
+	attr->user_cb	= user_cb;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothread_attr_set_backend(cothread_attr_t* attr, cothread_backend_t backend)
+{
+	assert(NULL	!= attr);
+	attr->backend	= backend;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothread_init(cothread_t* cothread, const cothread_attr_t* attr)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= attr);
+
+	//---Zero---//
+	cothread->backend	= (cothread_backend_default == attr->backend) ? cothread_backend_from_env() : attr->backend;
+	cothread->user_val	= 0;
+	cothread->user_cb	= attr->user_cb;
+	cothread->user_data	= NULL;
+
+	//---Initialize the backend cothread, which refers to the facade one---//
+	switch (cothread->backend) {
+#if COTHREAD_WITH_BACKEND_J
+	case cothread_backend_cothreadj: {
+		cothreadj_attr_t	impl_attr;
+		cothreadj_attr_init(&impl_attr, attr->stack, attr->stack_sz, cothread_cothreadj_cb);
+		cothreadj_init(&(cothread->impl.j), &impl_attr);
+		cothreadj_set_user_data(&(cothread->impl.j), cothread);
+		return cothread_err_ok;
+	}
+#endif
+#if COTHREAD_WITH_BACKEND_T
+	case cothread_backend_cothreadt: {
+		cothreadt_attr_t	impl_attr;
+		cothreadt_attr_init(&impl_attr, cothread_cothreadt_cb);
+		if (cothread_err_ok != cothreadt_init(&(cothread->impl.t), &impl_attr)) {
+			return cothread_err_notsup;
+		}
+		cothreadt_set_user_data(&(cothread->impl.t), cothread);
+		return cothread_err_ok;
+	}
+#endif
+#if COTHREAD_WITH_BACKEND_U
+	case cothread_backend_cothreadu: {
+		cothreadu_attr_t	impl_attr;
+		cothreadu_attr_init(&impl_attr, attr->stack, attr->stack_sz, cothread_cothreadu_cb);
+		if (cothread_err_ok != cothreadu_init(&(cothread->impl.u), &impl_attr)) {
+			return cothread_err_notsup;
+		}
+		cothreadu_set_user_data(&(cothread->impl.u), cothread);
+		return cothread_err_ok;
+	}
+#endif
+	default:
+		return cothread_err_notsup;
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothread_uninit(cothread_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+
+	//---Uninitialize the backend cothread---//
+	switch (COTHREAD_BACKEND(cothread)) {
+#if COTHREAD_WITH_BACKEND_J
+	case cothread_backend_cothreadj:
+		cothreadj_uninit(&(cothread->impl.j));
+		break;
+#endif
+#if COTHREAD_WITH_BACKEND_T
+	case cothread_backend_cothreadt:
+		cothreadt_uninit(&(cothread->impl.t));
+		break;
+#endif
+#if COTHREAD_WITH_BACKEND_U
+	case cothread_backend_cothreadu:
+		cothreadu_uninit(&(cothread->impl.u));
+		break;
+#endif
+	default:
+		assert(0);
+		break;
+	}
+}
+
+extern COTHREAD_LINK cothread_backend_t COTHREAD_CALL
+cothread_get_backend(const cothread_t* cothread)
+{
+	assert(NULL	!= cothread);
+	return COTHREAD_BACKEND(cothread);
+}
+
+extern COTHREAD_LINK const char* COTHREAD_CALL
+cothread_backend_name(cothread_backend_t backend)
+{
+	assert((size_t)backend < sizeof(cothread_backend_names) / sizeof(cothread_backend_names[0]));
+	return cothread_backend_names[backend];
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothread_set_user_data(cothread_t* cothread, void* user_data)
+{
+	assert(NULL	!= cothread);
+	cothread->user_data	= user_data;
+}
+
+extern COTHREAD_LINK void* COTHREAD_CALL
+cothread_get_user_data(const cothread_t* cothread)
+{
+	assert(NULL	!= cothread);
+	return cothread->user_data;
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothread_yield(cothread_t* cothread, int user_val)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(0	!= user_val);
+
+	//---Switch through the backend---//
+	switch (COTHREAD_BACKEND(cothread)) {
+#if COTHREAD_WITH_BACKEND_J
+	case cothread_backend_cothreadj:
+		return cothreadj_yield(&(cothread->impl.j), user_val);
+#endif
+#if COTHREAD_WITH_BACKEND_T
+	case cothread_backend_cothreadt:
+		cothread->user_val	= user_val;
+		cothreadt_yield(&(cothread->impl.t));
+		return cothread->user_val;
+#endif
+#if COTHREAD_WITH_BACKEND_U
+	case cothread_backend_cothreadu:
+		return cothreadu_yield(&(cothread->impl.u), user_val);
+#endif
+	default:
+		assert(0);
+		return 0;
+	}
+}
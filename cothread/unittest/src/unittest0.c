@@ -0,0 +1,97 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 8 * 1024)
+#define NB_ROUNDS	4
+/// @endcond
+
+/**
+ * @brief		The callee entry point, which sends back the received values plus one.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns any user value (except zero) to send to the caller.
+ * @ingroup		doxy_cothread_facade_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothread_t* cothread, int user_val)
+{
+	size_t*	ctr	= (size_t*)cothread_get_user_data(cothread);
+	for (int round = 0; round < NB_ROUNDS; round++) {
+		ctr[0]++;
+		user_val	= cothread_yield(cothread, user_val + 1);
+	}
+	return -user_val;
+}
+
+/**
+ * @brief		Runs the callee on the specified backend.
+ * @param		[in]	backend		The backend.
+ * @ingroup		doxy_cothread_facade_unittest
+ */
+static void
+run(cothread_backend_t backend)
+{
+	//---Definitions---//
+	static cothread_stack_t	stack[STACK_SZ];
+	cothread_attr_t				attr;
+	cothread_t					cothread;
+	size_t						ctr	= 0;
+
+	//---Initialize the cothread on the specified backend---//
+	cothread_attr_init(&attr, stack, sizeof(stack), user_cb);
+	cothread_attr_set_backend(&attr, backend);
+	assert(cothread_err_ok	== cothread_init(&cothread, &attr));
+	assert(backend			== cothread_get_backend(&cothread));
+	cothread_set_user_data(&cothread, &ctr);
+
+	//---The values are exchanged whatever the backend---//
+	for (int round = 0; round < NB_ROUNDS; round++) {
+		assert(round * 10 + 2	== cothread_yield(&cothread, round * 10 + 1));
+		assert((size_t)round + 1	== ctr);
+	}
+	assert(-99	== cothread_yield(&cothread, 99));
+
+	//---Uninitialize the cothread---//
+	cothread_uninit(&cothread);
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothread_facade_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest0(void)
+{
+	//---Run the callee on each compiled in backend---//
+#if COTHREAD_WITH_BACKEND_J
+	run(cothread_backend_cothreadj);
+#endif
+#if COTHREAD_WITH_BACKEND_T
+	run(cothread_backend_cothreadt);
+#endif
+#if COTHREAD_WITH_BACKEND_U
+	run(cothread_backend_cothreadu);
+#endif
+
+	//---The backends which are not compiled in are not supported---//
+	cothread_attr_t	attr;
+	cothread_t		cothread;
+	cothread_attr_init(&attr, NULL, 0, user_cb);
+#if !COTHREAD_WITH_BACKEND_U
+	cothread_attr_set_backend(&attr, cothread_backend_cothreadu);
+	assert(cothread_err_notsup	== cothread_init(&cothread, &attr));
+#endif
+	cothread_attr_set_backend(&attr, (cothread_backend_t)42);
+	assert(cothread_err_notsup	== cothread_init(&cothread, &attr));
+
+	//---The names match the environment variable values---//
+	assert(0	== strcmp("cothreadj", cothread_backend_name(cothread_backend_cothreadj)));
+	assert(0	== strcmp("cothreadt", cothread_backend_name(cothread_backend_cothreadt)));
+	assert(0	== strcmp("cothreadu", cothread_backend_name(cothread_backend_cothreadu)));
+}
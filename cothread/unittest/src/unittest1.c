@@ -0,0 +1,102 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <stdlib.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 8 * 1024)
+/// @endcond
+
+/**
+ * @brief		Sets the specified environment variable, or unsets it.
+ * @param		[in]	name	The variable name.
+ * @param		[in]	value	The variable value, NULL to unset it.
+ * @ingroup		doxy_cothread_facade_unittest
+ */
+static void
+set_env(const char* name, const char* value)
+{
+#if (COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	assert(0	== _putenv_s(name, (NULL != value) ? value : ""));
+#else
+	assert(0	== ((NULL != value) ? setenv(name, value, 1) : unsetenv(name)));
+#endif
+}
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns any user value (except zero) to send to the caller.
+ * @ingroup		doxy_cothread_facade_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothread_t* cothread, int user_val)
+{
+	(void)cothread;
+	return user_val * 2;
+}
+
+/**
+ * @brief		Returns the backend the environment selects, runs the callee on it once.
+ * @param		[in]	value	The environment variable value, NULL to unset it.
+ * @return		Returns the backend, @ref cothread_backend_default if the initialization failed.
+ * @ingroup		doxy_cothread_facade_unittest
+ */
+static cothread_backend_t
+run(const char* value)
+{
+	//---Definitions---//
+	static cothread_stack_t	stack[STACK_SZ];
+	cothread_attr_t			attr;
+	cothread_t				cothread;
+
+	//---Initialize the cothread with the default backend---//
+	set_env(COTHREAD_BACKEND_ENV, value);
+	cothread_attr_init(&attr, stack, sizeof(stack), user_cb);
+	if (cothread_err_ok != cothread_init(&cothread, &attr)) {
+		return cothread_backend_default;
+	}
+
+	//---Run the callee---//
+	const cothread_backend_t	backend	= cothread_get_backend(&cothread);
+	assert(42	== cothread_yield(&cothread, 21));
+	cothread_uninit(&cothread);
+	return backend;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothread_facade_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest1(void)
+{
+	//---Without the variable, the first compiled in backend is chosen---//
+#if COTHREAD_WITH_BACKEND_J
+	assert(cothread_backend_cothreadj	== run(NULL));
+#elif COTHREAD_WITH_BACKEND_T
+	assert(cothread_backend_cothreadt	== run(NULL));
+#else
+	assert(cothread_backend_cothreadu	== run(NULL));
+#endif
+
+	//---The variable names the backend---//
+#if COTHREAD_WITH_BACKEND_J
+	assert(cothread_backend_cothreadj	== run("cothreadj"));
+#endif
+#if COTHREAD_WITH_BACKEND_T
+	assert(cothread_backend_cothreadt	== run("cothreadt"));
+#endif
+#if COTHREAD_WITH_BACKEND_U
+	assert(cothread_backend_cothreadu	== run("cothreadu"));
+#endif
+
+	//---An unknown name makes the initialization fail---//
+	assert(cothread_backend_default	== run("cothreadx"));
+	assert(cothread_backend_default	== run("default"));
+	set_env(COTHREAD_BACKEND_ENV, NULL);
+}
@@ -0,0 +1,184 @@
+/**
+ * @brief		This file contains a benchmark comparing the stacks allocated separately with the arena ones.
+ * @file
+ *
+ * usage: cothreadj_benchmark_arena [nb_cothreads [stack_sz [nb_rounds]]]
+ *
+ * Each round resumes every cothread once, in the same order, the way a scheduler does.
+ * The switch latency is the time of a round divided by the number of switches (two per cothread),
+ * the TLB misses are read from the dTLB load misses hardware counter (GNU/Linux only.)
+ */
+
+#include <cothread/cothreadj_arena.h>
+#include <cothread/ticks.h>
+#include <stdint.h>
+#include <string.h>
+
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief		Opens the dTLB load misses counter of the calling thread.
+ * @return		Returns the counter file descriptor, -1 if not available (e.g. in most virtual machines.)
+ */
+static int
+tlb_open(void)
+{
+	struct perf_event_attr	attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size			= sizeof(attr);
+	attr.type			= PERF_TYPE_HW_CACHE;
+	attr.config			= PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.exclude_kernel	= 1;
+	attr.exclude_hv		= 1;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/**
+ * @brief		Reads the specified counter.
+ * @param		[in]	fd	The counter file descriptor.
+ * @return		Returns the counter value, zero if not available.
+ */
+static uint64_t
+tlb_read(int fd)
+{
+	uint64_t	val	= 0;
+	if ((0 > fd) || (sizeof(val) != read(fd, &val, sizeof(val)))) {
+		val	= 0;
+	}
+	return val;
+}
+#else
+	#define tlb_open()		(-1)
+	#define tlb_read(_fd)	((uint64_t)0)
+#endif
+
+/// @cond
+#define MODE_MALLOC		0	// each stack & each cothread is allocated separately.
+#define MODE_ARENA		1	// the stacks are carved out of the arena, the cothreads are allocated separately.
+#define MODE_COLOCATE	2	// the stacks & the cothreads are carved out of the arena.
+/// @endcond
+
+/**
+ * @brief		The callee entry point, which touches a few stack bytes between the switches.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Never returns.
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	volatile char	frame[256];
+	for (;;) {
+		frame[user_val & (sizeof(frame) - 1)]	= (char)user_val;
+		user_val	= cothreadj_yield(cothread, user_val + frame[0] + 1);
+	}
+	return user_val;
+}
+
+/**
+ * @brief		Runs the benchmark in the specified mode.
+ * @param		[in]	mode			The allocation mode (see MODE_MALLOC.)
+ * @param		[in]	nb_cothreads	The number of cothreads.
+ * @param		[in]	stack_sz		The stack size, in bytes.
+ * @param		[in]	nb_rounds		The number of rounds.
+ * @param		[in]	tlb_fd			The dTLB load misses counter, -1 if not available.
+ */
+static void
+run(int mode, size_t nb_cothreads, size_t stack_sz, size_t nb_rounds, int tlb_fd)
+{
+	//---Definitions---//
+	static const char*	names[]	= { "malloc", "arena", "arena+colocate" };
+	cothreadj_arena_t	arena;
+	cothreadj_t**		cothreads	= (cothreadj_t**)malloc(nb_cothreads * sizeof(cothreadj_t*));
+	void**				blocks		= (void**)malloc(nb_cothreads * 2 * sizeof(void*));
+	if ((NULL == cothreads) || (NULL == blocks)) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	//---Allocate & initialize the cothreads---//
+	cothreadj_arena_init(&arena, stack_sz, (MODE_COLOCATE == mode) ? COTHREADJ_ARENA_FLAG_COLOCATE : 0);
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		cothreadj_stack_t*	stack;
+		size_t				sz	= stack_sz;
+		blocks[2 * i + 0]	= NULL;
+		blocks[2 * i + 1]	= NULL;
+		if (MODE_MALLOC == mode) {
+			blocks[2 * i + 0]	= malloc(stack_sz + COTHREADJ_STACK_ALIGN);
+			stack				= (NULL == blocks[2 * i + 0]) ? NULL
+								: (cothreadj_stack_t*)(((uintptr_t)blocks[2 * i + 0] + COTHREADJ_STACK_ALIGN - 1) & ~(uintptr_t)(COTHREADJ_STACK_ALIGN - 1));
+		} else {
+			stack	= cothreadj_arena_alloc(&arena, cothreads + i);
+			sz		= arena.stack_sz;
+		}
+		if (MODE_COLOCATE != mode) {
+			blocks[2 * i + 1]	= malloc(sizeof(cothreadj_t));
+			cothreads[i]		= (cothreadj_t*)blocks[2 * i + 1];
+		}
+		if ((NULL == stack) || (NULL == cothreads[i])) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+
+		cothreadj_attr_t	attr;
+		cothreadj_attr_init(&attr, stack, sz, user_cb);
+		cothreadj_init(cothreads[i], &attr);
+	}
+
+	//---Warm up, then measure---//
+	uint64_t	tlb_misses	= 0;
+	uint64_t	ns			= 0;
+	for (size_t round = 0; round < nb_rounds + 1; round++) {
+		const uint64_t	tlb0	= tlb_read(tlb_fd);
+		const uint64_t	ns0		= cothread_ticks_ns();
+		for (size_t i = 0; i < nb_cothreads; i++) {
+			cothreadj_yield(cothreads[i], 1);
+		}
+		if (0 != round) {
+			ns			+= cothread_ticks_ns() - ns0;
+			tlb_misses	+= tlb_read(tlb_fd) - tlb0;
+		}
+	}
+
+	//---Report---//
+	const double	nb_switches	= 2.0 * (double)nb_cothreads * (double)nb_rounds;
+	if (0 > tlb_fd) {
+		printf("%-16s %10.2f ns/switch %16s\n", names[mode], (double)ns / nb_switches, "n/a");
+	} else {
+		printf("%-16s %10.2f ns/switch %10.3f dTLB misses/switch\n", names[mode], (double)ns / nb_switches, (double)tlb_misses / nb_switches);
+	}
+
+	//---Release---//
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		cothreadj_uninit(cothreads[i]);
+		free(blocks[2 * i + 0]);
+		free(blocks[2 * i + 1]);
+	}
+	cothreadj_arena_uninit(&arena);
+	free(blocks);
+	free(cothreads);
+}
+
+extern int
+main(int argc, char* argv[])
+{
+	//---Parse the arguments---//
+	const size_t	nb_cothreads	= (1 < argc) ? (size_t)strtoul(argv[1], NULL, 0) : 20000;
+	const size_t	stack_sz		= COTHREADJ_ROUND_STACK_SZ((2 < argc) ? (size_t)strtoul(argv[2], NULL, 0) : 16 * 1024);
+	const size_t	nb_rounds		= (3 < argc) ? (size_t)strtoul(argv[3], NULL, 0) : 50;
+	if ((0 == nb_cothreads) || (0 == stack_sz) || (0 == nb_rounds)) {
+		fprintf(stderr, "usage: %s [nb_cothreads [stack_sz [nb_rounds]]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	//---Run---//
+	const int	tlb_fd	= tlb_open();
+	printf("%zu cothreads, %zu-byte stacks, %zu rounds\n", nb_cothreads, stack_sz, nb_rounds);
+	run(MODE_MALLOC,	nb_cothreads, stack_sz, nb_rounds, tlb_fd);
+	run(MODE_ARENA,		nb_cothreads, stack_sz, nb_rounds, tlb_fd);
+	run(MODE_COLOCATE,	nb_cothreads, stack_sz, nb_rounds, tlb_fd);
+	return EXIT_SUCCESS;
+}
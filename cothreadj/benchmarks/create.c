@@ -0,0 +1,150 @@
+/**
+ * @brief		This file contains a benchmark comparing the eager cothread initialization with the lazy & bulk ones.
+ * @file
+ *
+ * usage: cothreadj_benchmark_create [nb_cothreads [stack_sz]]
+ *
+ * The stacks are carved out of an arena, the cothreads lie in a separate array.
+ * The creation latency is the time of the initialization (the per-element loop allocating each stack, initializing
+ * its attributes then its cothread, or the single bulk call) divided by the number of cothreads,
+ * the resident bytes are the growth of the process resident set during this loop (GNU/Linux only): since
+ * the arena asks for huge pages, the first write in a region commits all its stacks at once.
+ * Each cothread is then resumed once, so that the cost the lazy initialization defers is measured too.
+ */
+
+#include <cothread/cothreadj_arena.h>
+#include <cothread/ticks.h>
+#include <stdint.h>
+#include <string.h>
+
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+#include <unistd.h>
+
+/**
+ * @brief		Returns the resident bytes of the process.
+ * @return		Returns the resident bytes, zero if not available.
+ */
+static size_t
+get_rss(void)
+{
+	size_t	nb_pages	= 0;
+	size_t	nb_res		= 0;
+	FILE*	file		= fopen("/proc/self/statm", "r");
+	if (NULL != file) {
+		if (2 != fscanf(file, "%zu %zu", &nb_pages, &nb_res)) {
+			nb_res	= 0;
+		}
+		fclose(file);
+	}
+	return nb_res * (size_t)sysconf(_SC_PAGESIZE);
+}
+#else
+	#define get_rss()	((size_t)0)
+#endif
+
+/// @cond
+#define MODE_EAGER	0	// each cothread is initialized by cothreadj_init.
+#define MODE_LAZY	1	// each cothread is initialized by cothreadj_init_lazy.
+#define MODE_BULK	2	// the cothreads are initialized by cothreadj_init_many.
+/// @endcond
+
+/**
+ * @brief		The callee entry point, which returns at once.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	(void)cothread;
+	return user_val;
+}
+
+/**
+ * @brief		Runs the benchmark in the specified mode.
+ * @param		[in]	mode			The initialization mode (see MODE_EAGER.)
+ * @param		[in]	nb_cothreads	The number of cothreads.
+ * @param		[in]	stack_sz		The stack size, in bytes.
+ */
+static void
+run(int mode, size_t nb_cothreads, size_t stack_sz)
+{
+	//---Allocate the cothreads (the first read of the resident set faults the stdio buffers in)---//
+	static const char*	names[]	= { "eager", "lazy", "bulk" };
+	cothreadj_arena_t	arena;
+	cothreadj_t*		cothreads	= (cothreadj_t*)malloc(nb_cothreads * sizeof(cothreadj_t));
+	if (NULL == cothreads) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	cothreadj_arena_init(&arena, stack_sz, 0);
+	memset(cothreads, 0, nb_cothreads * sizeof(cothreadj_t));
+	get_rss();
+
+	//---Initialize---//
+	const size_t	rss0	= get_rss();
+	const uint64_t	ns0		= cothread_ticks_ns();
+	if (MODE_BULK == mode) {
+		static cothreadj_stack_t	unused[1];	// the stack attributes are ignored with an arena.
+		cothreadj_attr_t			attr;
+		cothreadj_attr_init(&attr, unused, sizeof(unused), user_cb);
+		if (cothread_err_ok != cothreadj_init_many(cothreads, nb_cothreads, &attr, &arena)) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	} else {
+		for (size_t i = 0; i < nb_cothreads; i++) {
+			cothreadj_attr_t	attr;
+			cothreadj_stack_t*	stack	= cothreadj_arena_alloc(&arena, NULL);
+			if (NULL == stack) {
+				fprintf(stderr, "out of memory\n");
+				exit(EXIT_FAILURE);
+			}
+			cothreadj_attr_init(&attr, stack, arena.stack_sz, user_cb);
+			if (MODE_LAZY == mode) {
+				cothreadj_init_lazy(cothreads + i, &attr);
+			} else {
+				cothreadj_init(cothreads + i, &attr);
+			}
+		}
+	}
+	const uint64_t	ns1		= cothread_ticks_ns();
+	const size_t	rss1	= get_rss();
+
+	//---Run each callee to completion---//
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		cothreadj_yield(cothreads + i, 1);
+	}
+	const uint64_t	ns2		= cothread_ticks_ns();
+
+	//---Report---//
+	printf("%-6s %10.2f ns/create %10.2f ns/first run %12zu resident bytes/create\n", names[mode],
+		(double)(ns1 - ns0) / (double)nb_cothreads, (double)(ns2 - ns1) / (double)nb_cothreads, (rss1 - rss0) / nb_cothreads);
+
+	//---Release---//
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		cothreadj_uninit(cothreads + i);
+	}
+	cothreadj_arena_uninit(&arena);
+	free(cothreads);
+}
+
+extern int
+main(int argc, char* argv[])
+{
+	//---Parse the arguments---//
+	const size_t	nb_cothreads	= (1 < argc) ? (size_t)strtoul(argv[1], NULL, 0) : 1000000;
+	const size_t	stack_sz		= COTHREADJ_ROUND_STACK_SZ((2 < argc) ? (size_t)strtoul(argv[2], NULL, 0) : 4 * 1024);
+	if ((0 == nb_cothreads) || (0 == stack_sz)) {
+		fprintf(stderr, "usage: %s [nb_cothreads [stack_sz]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	//---Run---//
+	printf("%zu cothreads, %zu-byte stacks\n", nb_cothreads, stack_sz);
+	run(MODE_EAGER,	nb_cothreads, stack_sz);
+	run(MODE_LAZY,	nb_cothreads, stack_sz);
+	run(MODE_BULK,	nb_cothreads, stack_sz);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+/**
+ * @brief		This file contains a benchmark measuring the footprint & the switch latency of the cothread layout.
+ * @file
+ *
+ * usage: cothreadj_benchmark_layout [nb_cothreads [nb_rounds]]
+ *
+ * The layout is chosen when the library is configured: run the benchmark from a build configured with
+ * -D COTHREAD_WITH_COMPACT_CTX=TRUE and from another one configured without it to compare both.
+ * The ping-pong measures the latency of a single cothread which stays in the cache,
+ * the round-robin resumes every cothread once per round, the way a scheduler does.
+ */
+
+#include <cothread/cothreadj_arena.h>
+#include <cothread/ticks.h>
+#include <stddef.h>
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Never returns.
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	for (;;) {
+		user_val	= cothreadj_yield(cothread, user_val);
+	}
+	return user_val;
+}
+
+extern int
+main(int argc, char* argv[])
+{
+	//---Parse the arguments---//
+	const size_t	nb_cothreads	= (1 < argc) ? (size_t)strtoul(argv[1], NULL, 0) : 100000;
+	const size_t	nb_rounds		= (2 < argc) ? (size_t)strtoul(argv[2], NULL, 0) : 20;
+	if ((0 == nb_cothreads) || (0 == nb_rounds)) {
+		fprintf(stderr, "usage: %s [nb_cothreads [nb_rounds]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	//---Footprint---//
+	printf("layout:           %s\n", COTHREAD_WITH_COMPACT_CTX ? "compact (stack pointer)" : "jmp_buf");
+	printf("sizeof:           %zu bytes\n", sizeof(cothreadj_t));
+	printf("hot members:      %zu bytes (up to shstk)\n", offsetof(cothreadj_t, shstk) + sizeof(cothreadj_shstk_t*));
+	printf("%zu cothreads: %.2f MiB\n", nb_cothreads, (double)(nb_cothreads * sizeof(cothreadj_t)) / (1024.0 * 1024.0));
+
+	//---Allocate the cothreads in an array, the stacks in an arena---//
+	cothreadj_arena_t	arena;
+	cothreadj_t*		cothreads	= (cothreadj_t*)malloc((nb_cothreads + 1) * sizeof(cothreadj_t) + 64);
+	if (NULL == cothreads) {
+		fprintf(stderr, "out of memory\n");
+		return EXIT_FAILURE;
+	}
+	cothreadj_t*		aligned		= (cothreadj_t*)(((size_t)cothreads + 63) & ~(size_t)63);
+	cothreadj_arena_init(&arena, 4096, 0);
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		cothreadj_stack_t*	stack	= cothreadj_arena_alloc(&arena, NULL);
+		if (NULL == stack) {
+			fprintf(stderr, "out of memory\n");
+			return EXIT_FAILURE;
+		}
+		cothreadj_attr_t	attr;
+		cothreadj_attr_init(&attr, stack, arena.stack_sz, user_cb);
+		cothreadj_init(aligned + i, &attr);
+	}
+
+	//---Ping-pong---//
+	const size_t	nb_pings	= nb_cothreads * nb_rounds;
+	uint64_t		ns0			= cothread_ticks_ns();
+	for (size_t i = 0; i < nb_pings; i++) {
+		cothreadj_yield(aligned, 1);
+	}
+	printf("ping-pong:        %.2f ns/switch\n", (double)(cothread_ticks_ns() - ns0) / (2.0 * (double)nb_pings));
+
+	//---Round-robin---//
+	ns0	= cothread_ticks_ns();
+	for (size_t round = 0; round < nb_rounds; round++) {
+		for (size_t i = 0; i < nb_cothreads; i++) {
+			cothreadj_yield(aligned + i, 1);
+		}
+	}
+	printf("round-robin:      %.2f ns/switch\n", (double)(cothread_ticks_ns() - ns0) / (2.0 * (double)nb_pings));
+
+	//---Release---//
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		cothreadj_uninit(aligned + i);
+	}
+	cothreadj_arena_uninit(&arena);
+	free(cothreads);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+/**
+ * @brief		This file contains a benchmark measuring the cross-core request throughput of the shared-nothing mesh.
+ * @file
+ *
+ * usage: cothreadj_benchmark_mesh [nb_requests [nb_clients [nb_rounds]]]
+ *
+ * Each core of the mesh spawns as many client cothreads, each one submitting its requests to the other cores
+ * in turn & waiting for each one: a request crosses two rings (there & back) and costs two wakes. The request
+ * adds to a counter owned by the destination core. The throughput counts the requests of all the cores, for 2, 4...
+ * cores up to the number of online CPUs, with 1, then the specified number of clients per core.
+ */
+
+#include <cothread/cothreadj_mesh.h>
+#include <cothread/ticks.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 4 * 1024)
+#define NB_CORES_MAX	256
+/// @endcond
+
+/// @cond
+typedef struct
+{
+	uint64_t	sum;			// the sum of the requests run by the core.
+	char		pad[64 - sizeof(uint64_t)];
+} shard_t;
+
+typedef struct
+{
+	cothreadj_t*		clients;		// the client cothreads, nb_clients per core.
+	cothreadj_stack_t*	stacks;			// the stacks of the client cothreads.
+	size_t				nb_clients;		// the number of clients per core.
+	size_t				nb_requests;	// the number of requests per client.
+	shard_t				shards[NB_CORES_MAX];	// the data of each core, touched by that core only.
+} run_t;
+/// @endcond
+
+/**
+ * @brief		The request callback, which adds to the counter of the destination core.
+ * @param		[in]	sched	The scheduler of the destination core.
+ * @param		[in]	msg		The request, whose user data is the run.
+ */
+static void COTHREAD_CALL
+request_cb(cothreadj_sched_t* sched, cothreadj_mesh_msg_t* msg)
+{
+	run_t*	run	= (run_t*)msg->user_data;
+	(void)sched;
+	run->shards[msg->dst].sum	+= msg->src + 1;
+}
+
+/**
+ * @brief		The client callee entry point, which submits its requests to the other cores in turn.
+ * @param		[in]	cothread	The cothread, whose user data is the run.
+ * @param		[in]	user_val	Any user value (except zero) received from the scheduler.
+ * @return		Returns any user value (except zero) to send to the scheduler.
+ */
+static int COTHREAD_CALL
+client_cb(cothreadj_t* cothread, int user_val)
+{
+	run_t*					run			= (run_t*)cothreadj_get_user_data(cothread);
+	const size_t			id			= cothreadj_mesh_core_id(cothread);
+	const size_t			nb_cores	= cothreadj_mesh_get(cothread)->nb_cores;
+	cothreadj_mesh_msg_t	msg;
+	for (size_t i = 0; i < run->nb_requests; i++) {
+		cothreadj_mesh_msg_init(&msg, request_cb, run);
+		cothreadj_mesh_submit(cothread, (id + 1 + (i % (nb_cores - 1))) % nb_cores, &msg);
+		cothreadj_mesh_wait(&msg, cothread);
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The main callback, which spawns the clients of the core.
+ * @param		[in]	cothread	The main cothread of the core.
+ * @param		[in]	user_data	The run.
+ */
+static void COTHREAD_CALL
+main_cb(cothreadj_t* cothread, void* user_data)
+{
+	run_t*				run		= (run_t*)user_data;
+	const size_t		first	= cothreadj_mesh_core_id(cothread) * run->nb_clients;
+	const size_t		nb		= STACK_SZ / sizeof(cothreadj_stack_t);
+	cothreadj_attr_t	attr;
+	for (size_t i = first; i < first + run->nb_clients; i++) {
+		cothreadj_attr_init(&attr, run->stacks + (i * nb), STACK_SZ, client_cb);
+		cothreadj_init(&(run->clients[i]), &attr);
+		cothreadj_set_user_data(&(run->clients[i]), run);
+		cothreadj_sched_spawn(cothread->sched, &(run->clients[i]));
+	}
+}
+
+/**
+ * @brief		Runs the requests on the specified number of cores.
+ * @param		[in]	run			The run.
+ * @param		[in]	nb_cores	The number of cores, at least two.
+ * @return		Returns the elapsed time, in nanoseconds.
+ */
+static uint64_t
+run_mesh(run_t* run, size_t nb_cores)
+{
+	//---Allocate the mesh & the clients---//
+	cothreadj_mesh_t	mesh;
+	const size_t		nb_clients	= nb_cores * run->nb_clients;
+	run->clients	= (cothreadj_t*)calloc(nb_clients, sizeof(cothreadj_t));
+	run->stacks		= (cothreadj_stack_t*)malloc(nb_clients * STACK_SZ);
+	if ((NULL == run->clients) || (NULL == run->stacks) || (cothread_err_ok != cothreadj_mesh_init(&mesh, nb_cores, 0, STACK_SZ))) {
+		fprintf(stderr, "cannot allocate %zu cores\n", nb_cores);
+		exit(EXIT_FAILURE);
+	}
+
+	//---Run---//
+	for (size_t i = 0; i < nb_cores; i++) {
+		run->shards[i].sum	= 0;
+	}
+	const uint64_t	ns0	= cothread_ticks_ns();
+	if (cothread_err_ok != cothreadj_mesh_run(&mesh, main_cb, run)) {
+		fprintf(stderr, "cannot start %zu cores\n", nb_cores);
+		exit(EXIT_FAILURE);
+	}
+	const uint64_t	ns	= cothread_ticks_ns() - ns0;
+
+	//---Check every request ran once (each one adds the index of its source core, plus one)---//
+	uint64_t	sum	= 0;
+	for (size_t i = 0; i < nb_cores; i++) {
+		sum	+= run->shards[i].sum;
+	}
+	if (sum != (uint64_t)(run->nb_clients * run->nb_requests) * (nb_cores * (nb_cores + 1) / 2)) {
+		fprintf(stderr, "wrong sum\n");
+		exit(EXIT_FAILURE);
+	}
+
+	//---Release---//
+	for (size_t i = 0; i < nb_clients; i++) {
+		cothreadj_uninit(&(run->clients[i]));
+	}
+	cothreadj_mesh_uninit(&mesh);
+	free(run->stacks);
+	free(run->clients);
+	return ns;
+}
+
+/**
+ * @brief		Returns the number of online CPUs.
+ * @return		Returns the number of online CPUs, at least one.
+ */
+static size_t
+nb_cpus(void)
+{
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	SYSTEM_INFO	info;
+	GetSystemInfo(&info);
+	return (size_t)info.dwNumberOfProcessors;
+#else
+	const long	nb	= sysconf(_SC_NPROCESSORS_ONLN);
+	return (0 < nb) ? (size_t)nb : 1;
+#endif
+}
+
+extern int
+main(int argc, char* argv[])
+{
+	//---Parse the arguments---//
+	const size_t	nb_requests	= (1 < argc) ? (size_t)strtoul(argv[1], NULL, 0) : 100000;
+	const size_t	nb_clients	= (2 < argc) ? (size_t)strtoul(argv[2], NULL, 0) : 64;
+	const size_t	nb_rounds	= (3 < argc) ? (size_t)strtoul(argv[3], NULL, 0) : 3;
+	if ((0 == nb_requests) || (0 == nb_clients) || (0 == nb_rounds)) {
+		fprintf(stderr, "usage: %s [nb_requests [nb_clients [nb_rounds]]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	size_t	nb_cores_max	= (NB_CORES_MAX < nb_cpus()) ? NB_CORES_MAX : nb_cpus();
+	nb_cores_max	= (2 > nb_cores_max) ? 2 : nb_cores_max;
+	printf("%zu requests per client, best of %zu rounds, %zu CPU(s)\n", nb_requests, nb_rounds, nb_cpus());
+	printf("%5s %7s %12s %10s\n", "cores", "clients", "requests/s", "ns/req");
+
+	//---Run, doubling the number of cores, with a single client per core then with many---//
+	static run_t	run;
+	run.nb_requests	= nb_requests;
+	for (size_t nb_cores = 2; ; nb_cores = (2 * nb_cores < nb_cores_max) ? 2 * nb_cores : nb_cores_max) {
+		for (size_t nb = 1; ; nb = nb_clients) {
+			uint64_t	best_ns	= UINT64_MAX;
+			run.nb_clients	= nb;
+			for (size_t round = 0; round < nb_rounds; round++) {
+				const uint64_t	ns	= run_mesh(&run, nb_cores);
+				best_ns	= (ns < best_ns) ? ns : best_ns;
+			}
+			const double	nb_total	= (double)(nb_cores * nb * nb_requests);
+			printf("%5zu %7zu %12.0f %10.1f\n", nb_cores, nb, nb_total * 1e9 / (double)best_ns, (double)best_ns / nb_total);
+			if (nb_clients == nb) {
+				break;
+			}
+		}
+		if (nb_cores_max == nb_cores) {
+			break;
+		}
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+/**
+ * @brief		This file contains a benchmark measuring how the parallel loops scale, against OpenMP.
+ * @file
+ *
+ * usage: cothreadj_benchmark_parallel [nb_items [grain [nb_rounds]]]
+ *
+ * The same CPU-bound loop (hashing each index, then summing the hashes) is run sequentially,
+ * then with @ref cothreadj_parallel_reduce and, if the compiler supports it, with an OpenMP
+ * "parallel for reduction" of the same grain, for 1, 2, 4... workers up to the number of online CPUs.
+ * The speedup is relative to the sequential loop.
+ */
+
+#include <cothread/cothreadj_parallel.h>
+#include <cothread/ticks.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if		defined(COTHREAD_BENCHMARK_WITH_OPENMP)
+#include <omp.h>
+#endif
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 16 * 1024)
+#define NB_WORKERS_MAX	256
+/// @endcond
+
+/// @cond
+typedef struct
+{
+	cothreadj_pool_t*	pool;		// the pool.
+	size_t				nb_items;	// the number of indexes.
+	size_t				grain;		// the grain.
+	uint64_t			sum;		// the sum of the hashes.
+	uint64_t			ns;			// the elapsed time, in nanoseconds.
+} run_t;
+/// @endcond
+
+/**
+ * @brief		Hashes the specified index, which costs a few dozen nanoseconds.
+ * @param		[in]	i	The index.
+ * @return		Returns the hash.
+ */
+static uint64_t
+hash(uint64_t i)
+{
+	for (int round = 0; round < 32; round++) {
+		i	^= i >> 33;
+		i	*= 0xff51afd7ed558ccdULL;
+		i	^= i >> 29;
+	}
+	return i;
+}
+
+/**
+ * @brief		The parallel-reduce body, which sums the hashes of the chunk.
+ * @param		[in]	cothread	The worker cothread.
+ * @param		[in]	begin		The first index of the chunk.
+ * @param		[in]	end			The index following the last one of the chunk.
+ * @param		[in]	acc			The partial sum of the worker.
+ * @param		[in]	user_data	Any user data.
+ */
+static void COTHREAD_CALL
+map_cb(cothreadj_t* cothread, size_t begin, size_t end, void* acc, void* user_data)
+{
+	uint64_t	sum	= 0;
+	(void)cothread;
+	(void)user_data;
+	for (size_t i = begin; i < end; i++) {
+		sum	+= hash(i);
+	}
+	*(uint64_t*)acc	+= sum;
+}
+
+/**
+ * @brief		The parallel-reduce combiner, which adds the partial sums.
+ * @param		[in]	acc			The partial sum to add to.
+ * @param		[in]	other		The partial sum to add.
+ * @param		[in]	user_data	Any user data.
+ */
+static void COTHREAD_CALL
+reduce_cb(void* acc, const void* other, void* user_data)
+{
+	(void)user_data;
+	*(uint64_t*)acc	+= *(const uint64_t*)other;
+}
+
+/**
+ * @brief		The callee entry point, which runs the loop once.
+ * @param		[in]	cothread	The cothread, whose user data is the run.
+ * @param		[in]	user_val	Any user value (except zero) received from the scheduler.
+ * @return		Returns any user value (except zero) to send to the scheduler.
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	run_t*		run	= (run_t*)cothreadj_get_user_data(cothread);
+	uint64_t	accs[NB_WORKERS_MAX]	= { 0 };
+	const uint64_t	ns0	= cothread_ticks_ns();
+	cothreadj_parallel_reduce(run->pool, cothread, 0, run->nb_items, run->grain, map_cb, reduce_cb, accs, sizeof(accs[0]), NULL);
+	run->ns		= cothread_ticks_ns() - ns0;
+	run->sum	= accs[0];
+	return user_val;
+}
+
+/**
+ * @brief		Runs the loop with the specified number of workers.
+ * @param		[in]	run			The run.
+ * @param		[in]	nb_workers	The number of workers.
+ */
+static void
+run_cothreadj(run_t* run, size_t nb_workers)
+{
+	//---Start the workers---//
+	static cothreadj_stack_t	stack[STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_pool_t			pool;
+	cothreadj_sched_t			sched;
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothread;
+	if (cothread_err_ok != cothreadj_pool_init(&pool, nb_workers, STACK_SZ)) {
+		fprintf(stderr, "cannot start %zu workers\n", nb_workers);
+		exit(EXIT_FAILURE);
+	}
+
+	//---Run the loop from a cothread---//
+	run->pool	= &pool;
+	cothreadj_sched_init(&sched);
+	cothreadj_attr_init(&attr, stack, sizeof(stack), user_cb);
+	cothreadj_init(&cothread, &attr);
+	cothreadj_set_user_data(&cothread, run);
+	cothreadj_sched_spawn(&sched, &cothread);
+	while (0 != cothreadj_sched_run(&sched)) {
+		cothreadj_sched_wait(&sched);
+	}
+
+	//---Release---//
+	cothreadj_uninit(&cothread);
+	cothreadj_sched_uninit(&sched);
+	cothreadj_pool_uninit(&pool);
+}
+
+#if		defined(COTHREAD_BENCHMARK_WITH_OPENMP)
+/**
+ * @brief		Runs the loop with OpenMP, with the specified number of threads.
+ * @param		[in]	run			The run.
+ * @param		[in]	nb_workers	The number of threads.
+ */
+static void
+run_openmp(run_t* run, size_t nb_workers)
+{
+	const long		nb_items	= (long)run->nb_items;
+	const int		grain		= (int)run->grain;
+	uint64_t		sum			= 0;
+	omp_set_num_threads((int)nb_workers);
+	const uint64_t	ns0	= cothread_ticks_ns();
+	#pragma omp parallel for reduction(+:sum) schedule(guided, grain)
+	for (long i = 0; i < nb_items; i++) {
+		sum	+= hash((uint64_t)i);
+	}
+	run->ns		= cothread_ticks_ns() - ns0;
+	run->sum	= sum;
+}
+#endif
+
+/**
+ * @brief		Returns the number of online CPUs.
+ * @return		Returns the number of online CPUs, at least one.
+ */
+static size_t
+nb_cpus(void)
+{
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	SYSTEM_INFO	info;
+	GetSystemInfo(&info);
+	return (size_t)info.dwNumberOfProcessors;
+#else
+	const long	nb	= sysconf(_SC_NPROCESSORS_ONLN);
+	return (0 < nb) ? (size_t)nb : 1;
+#endif
+}
+
+extern int
+main(int argc, char* argv[])
+{
+	//---Parse the arguments---//
+	const size_t	nb_items	= (1 < argc) ? (size_t)strtoul(argv[1], NULL, 0) : 20000000;
+	const size_t	grain		= (2 < argc) ? (size_t)strtoul(argv[2], NULL, 0) : 1024;
+	const size_t	nb_rounds	= (3 < argc) ? (size_t)strtoul(argv[3], NULL, 0) : 3;
+	if ((0 == nb_items) || (0 == grain) || (0 == nb_rounds)) {
+		fprintf(stderr, "usage: %s [nb_items [grain [nb_rounds]]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	const size_t	nb_workers_max	= (NB_WORKERS_MAX < nb_cpus()) ? NB_WORKERS_MAX : nb_cpus();
+	printf("%zu items, grain %zu, best of %zu rounds, %zu CPU(s)\n", nb_items, grain, nb_rounds, nb_workers_max);
+
+	//---Run sequentially---//
+	run_t		run;
+	uint64_t	seq_ns	= UINT64_MAX;
+	uint64_t	sum		= 0;
+	run.nb_items	= nb_items;
+	run.grain		= grain;
+	for (size_t round = 0; round < nb_rounds; round++) {
+		const uint64_t	ns0	= cothread_ticks_ns();
+		sum	= 0;
+		map_cb(NULL, 0, nb_items, &sum, NULL);
+		const uint64_t	ns	= cothread_ticks_ns() - ns0;
+		seq_ns	= (ns < seq_ns) ? ns : seq_ns;
+	}
+	printf("%-10s %4s %10.2f ms\n", "sequential", "1", (double)seq_ns / 1e6);
+
+	//---Run in parallel, doubling the number of workers---//
+	for (size_t nb_workers = 1; ; nb_workers = (2 * nb_workers < nb_workers_max) ? 2 * nb_workers : nb_workers_max) {
+		uint64_t	best_ns	= UINT64_MAX;
+		for (size_t round = 0; round < nb_rounds; round++) {
+			run_cothreadj(&run, nb_workers);
+			if (sum != run.sum) {
+				fprintf(stderr, "cothreadj: wrong sum\n");
+				return EXIT_FAILURE;
+			}
+			best_ns	= (run.ns < best_ns) ? run.ns : best_ns;
+		}
+		printf("%-10s %4zu %10.2f ms %6.2fx\n", "cothreadj", nb_workers, (double)best_ns / 1e6, (double)seq_ns / (double)best_ns);
+#if		defined(COTHREAD_BENCHMARK_WITH_OPENMP)
+		best_ns	= UINT64_MAX;
+		for (size_t round = 0; round < nb_rounds; round++) {
+			run_openmp(&run, nb_workers);
+			if (sum != run.sum) {
+				fprintf(stderr, "openmp: wrong sum\n");
+				return EXIT_FAILURE;
+			}
+			best_ns	= (run.ns < best_ns) ? run.ns : best_ns;
+		}
+		printf("%-10s %4zu %10.2f ms %6.2fx\n", "openmp", nb_workers, (double)best_ns / 1e6, (double)seq_ns / (double)best_ns);
+#endif
+		if (nb_workers_max == nb_workers) {
+			break;
+		}
+	}
+	return EXIT_SUCCESS;
+}
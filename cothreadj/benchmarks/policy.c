@@ -0,0 +1,297 @@
+/**
+ * @brief		This file contains a benchmark measuring the latency of interactive requests under batch saturation.
+ * @file
+ *
+ * usage: cothreadj_benchmark_policy [nb_batch [nb_requests]]
+ *
+ * A scheduler runs batch cothreads, which burn the CPU by chunks of 100 us and yield between chunks, next to
+ * interactive cothreads, parked until a request arrives (one every 500 us), then serving it in 20 us.
+ * A posted task polls the arrivals between two resumes, so every policy detects them equally late.
+ * The latency of a request runs from its arrival to the end of its service, against a 5 ms objective:
+ * - with the default FIFO order, a request waits behind every batch cothread ;
+ * - with the strict priority policy, the interactive cothreads have the highest level, the batch ones a lower one ;
+ * - with the earliest deadline first policy, a request is due 5 ms after its arrival, a batch chunk 100 ms after it starts.
+ * .
+ */
+
+#include <cothread/cothreadj_policy.h>
+#include <cothread/ticks.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 16 * 1024)
+#define NB_INTERACTIVE	64							// the interactive cothreads, each one serving a request at a time.
+#define PERIOD_NS		(500 * 1000)				// the time between two requests.
+#define REQUEST_NS		(20 * 1000)					// the time a request takes to serve.
+#define CHUNK_NS		(100 * 1000)				// the time a batch chunk takes.
+#define SLO_NS			(5 * 1000 * 1000)			// the latency objective of the requests.
+#define BATCH_SLO_NS	(100 * 1000 * 1000)			// the latency objective of the batch chunks.
+
+typedef enum
+{
+	kind_fifo,
+	kind_prio,
+	kind_edf,
+} kind_t;
+
+typedef struct
+{
+	kind_t					kind;						// the policy.
+	cothreadj_sched_task_t	poller;						// the task polling the arrivals.
+	cothreadj_t*			idle[NB_INTERACTIVE];		// the interactive cothreads waiting for a request.
+	size_t					nb_idle;					// the number of idle interactive cothreads.
+	uint64_t				arrivals[NB_INTERACTIVE];	// the arrival of the request each interactive cothread serves.
+	uint64_t				next_ns;					// the arrival of the next request.
+	size_t					nb_arrived;					// the number of requests which have arrived.
+	size_t					nb_requests;				// the number of requests to serve.
+	size_t					nb_served;					// the number of requests served.
+	uint64_t*				latencies;					// the latency of each served request.
+	size_t					nb_chunks;					// the number of batch chunks run.
+	int						stopping;					// says whether the cothreads shall return or not.
+} bench_t;
+
+static bench_t		bench_g;
+static cothreadj_t	interactive_g[NB_INTERACTIVE];
+/// @endcond
+
+/**
+ * @brief		Burns the CPU for the specified time.
+ * @param		[in]	ns	The time to burn, in nanoseconds.
+ */
+static void
+burn(uint64_t ns)
+{
+	const uint64_t	deadline	= cothread_ticks_ns() + ns;
+	while (cothread_ticks_ns() < deadline);
+}
+
+/**
+ * @brief		Sets the scheduling key of the specified cothread, according to the policy.
+ * @param		[in]	cothread	The cothread, which is not ready.
+ * @param		[in]	level		The priority level.
+ * @param		[in]	deadline_ns	The deadline.
+ */
+static void
+set_key(cothreadj_t* cothread, unsigned int level, uint64_t deadline_ns)
+{
+	if (kind_prio == bench_g.kind) {
+		cothreadj_set_prio(cothread, level);
+	} else if (kind_edf == bench_g.kind) {
+		cothreadj_set_deadline(cothread, deadline_ns);
+	}
+}
+
+/**
+ * @brief		The poller task callback, which wakes an idle interactive cothread up per arrived request.
+ * @param		[in]	task	The task.
+ */
+static void COTHREAD_CALL
+poller_cb(cothreadj_sched_task_t* task)
+{
+	//---Have all the requests been served ?---//
+	cothreadj_t*	cothread;
+	if (bench_g.nb_served == bench_g.nb_requests) {
+		bench_g.stopping	= 1;
+		while (0 != bench_g.nb_idle) {
+			cothreadj_sched_wake(bench_g.idle[--bench_g.nb_idle]);
+		}
+		return;
+	}
+
+	//---Dispatch the arrived requests---//
+	const uint64_t	now	= cothread_ticks_ns();
+	while ((bench_g.nb_arrived < bench_g.nb_requests) && (bench_g.next_ns <= now) && (0 != bench_g.nb_idle)) {
+		cothread	= bench_g.idle[--bench_g.nb_idle];
+		bench_g.arrivals[cothread - interactive_g]	= bench_g.next_ns;
+		set_key(cothread, 0, bench_g.next_ns + SLO_NS);
+		cothreadj_sched_wake(cothread);
+		bench_g.next_ns	+= PERIOD_NS;
+		bench_g.nb_arrived++;
+	}
+	cothreadj_sched_post(interactive_g[0].sched, task);
+}
+
+/**
+ * @brief		The interactive callee entry point, which serves a request each time it is woken up.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the scheduler.
+ * @return		Returns any user value (except zero) to send to the scheduler.
+ */
+static int COTHREAD_CALL
+interactive_cb(cothreadj_t* cothread, int user_val)
+{
+	for (;;) {
+		//---Wait for a request---//
+		bench_g.idle[bench_g.nb_idle++]	= cothread;
+		cothreadj_sched_park(cothread);
+		if (0 != bench_g.stopping) {
+			break;
+		}
+
+		//---Serve it---//
+		burn(REQUEST_NS);
+		bench_g.latencies[bench_g.nb_served++]	= cothread_ticks_ns() - bench_g.arrivals[cothread - interactive_g];
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The batch callee entry point, which runs chunks until the requests are served.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the scheduler.
+ * @return		Returns any user value (except zero) to send to the scheduler.
+ */
+static int COTHREAD_CALL
+batch_cb(cothreadj_t* cothread, int user_val)
+{
+	while (0 == bench_g.stopping) {
+		const uint64_t	ns	= cothread_ticks_ns();
+		burn(CHUNK_NS);
+		bench_g.nb_chunks++;
+		set_key(cothread, 1, ns + BATCH_SLO_NS);
+		cothreadj_sched_yield(cothread);
+	}
+	return user_val;
+}
+
+/**
+ * @brief		Compares the specified latencies.
+ * @param		[in]	a	The first latency.
+ * @param		[in]	b	The second latency.
+ * @return		Returns a negative, zero or positive value if @e a is lower than, equal to or greater than @e b.
+ */
+static int
+cmp(const void* a, const void* b)
+{
+	const uint64_t	x	= *(const uint64_t*)a;
+	const uint64_t	y	= *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief		Runs the benchmark with the specified policy.
+ * @param		[in]	kind		The policy.
+ * @param		[in]	stacks		The stacks, one per cothread.
+ * @param		[in]	batch		The batch cothreads.
+ * @param		[in]	nb_batch	The number of batch cothreads.
+ * @param		[in]	latencies	The latencies, one per request.
+ * @param		[in]	nb_requests	The number of requests.
+ */
+static void
+run(kind_t kind, cothreadj_stack_t* stacks, cothreadj_t* batch, size_t nb_batch, uint64_t* latencies, size_t nb_requests)
+{
+	//---Initialize the policy & the scheduler---//
+	static const char*	names[]	= { "fifo", "prio", "edf" };
+	cothreadj_fifo_t	fifo;
+	cothreadj_prio_t	prio;
+	cothreadj_edf_t		edf;
+	cothreadj_sched_t	sched;
+	cothreadj_attr_t	attr;
+	cothreadj_sched_init(&sched);
+	if (kind_prio == kind) {
+		cothreadj_prio_init(&prio);
+		cothreadj_sched_set_policy(&sched, &(prio.policy));
+	} else if (kind_edf == kind) {
+		cothreadj_edf_init(&edf);
+		cothreadj_sched_set_policy(&sched, &(edf.policy));
+	} else {
+		cothreadj_fifo_init(&fifo);
+		cothreadj_sched_set_policy(&sched, &(fifo.policy));
+	}
+	memset(&bench_g, 0, sizeof(bench_g));
+	bench_g.kind		= kind;
+	bench_g.nb_requests	= nb_requests;
+	bench_g.latencies	= latencies;
+
+	//---Spawn the interactive cothreads first, so they park before the first request---//
+	const uint64_t	now	= cothread_ticks_ns();
+	for (size_t i = 0; i < NB_INTERACTIVE; i++) {
+		cothreadj_attr_init(&attr, stacks + i * (STACK_SZ / sizeof(cothreadj_stack_t)), STACK_SZ, interactive_cb);
+		cothreadj_init(&(interactive_g[i]), &attr);
+		set_key(&(interactive_g[i]), 0, now);
+		cothreadj_sched_spawn(&sched, &(interactive_g[i]));
+	}
+	for (size_t i = 0; i < nb_batch; i++) {
+		cothreadj_attr_init(&attr, stacks + (NB_INTERACTIVE + i) * (STACK_SZ / sizeof(cothreadj_stack_t)), STACK_SZ, batch_cb);
+		cothreadj_init(&(batch[i]), &attr);
+		set_key(&(batch[i]), 1, now + BATCH_SLO_NS);
+		cothreadj_sched_spawn(&sched, &(batch[i]));
+	}
+
+	//---Run until the requests are served---//
+	bench_g.next_ns	= now + PERIOD_NS;
+	cothreadj_sched_task_init(&(bench_g.poller), poller_cb);
+	cothreadj_sched_post(&sched, &(bench_g.poller));
+	const uint64_t	ns0	= cothread_ticks_ns();
+	if (0 != cothreadj_sched_run(&sched)) {
+		fprintf(stderr, "the cothreads have not returned\n");
+		exit(EXIT_FAILURE);
+	}
+	const uint64_t	ns	= cothread_ticks_ns() - ns0;
+
+	//---Report the latency percentiles & the batch throughput---//
+	size_t	nb_missed	= 0;
+	qsort(latencies, nb_requests, sizeof(latencies[0]), cmp);
+	for (size_t i = 0; i < nb_requests; i++) {
+		nb_missed	+= (SLO_NS < latencies[i]);
+	}
+	printf("%-4s p50 %9.1f us p99 %9.1f us max %9.1f us missed %6.2f %% batch %8.0f chunks/s\n", names[kind],
+		(double)latencies[nb_requests / 2] / 1000.0,
+		(double)latencies[(nb_requests * 99) / 100] / 1000.0,
+		(double)latencies[nb_requests - 1] / 1000.0,
+		(100.0 * (double)nb_missed) / (double)nb_requests,
+		(double)bench_g.nb_chunks * 1e9 / (double)ns);
+
+	//---Release---//
+	for (size_t i = 0; i < NB_INTERACTIVE; i++) {
+		cothreadj_uninit(&(interactive_g[i]));
+	}
+	for (size_t i = 0; i < nb_batch; i++) {
+		cothreadj_uninit(&(batch[i]));
+	}
+	cothreadj_sched_uninit(&sched);
+}
+
+/**
+ * @brief		The benchmark entry point.
+ * @param		[in]	argc	The number of arguments.
+ * @param		[in]	argv	The arguments.
+ * @return		Returns EXIT_SUCCESS.
+ */
+int
+main(int argc, char* argv[])
+{
+	//---Parse the arguments---//
+	const size_t	nb_batch	= (1 < argc) ? (size_t)strtoul(argv[1], NULL, 0) : 32;
+	const size_t	nb_requests	= (2 < argc) ? (size_t)strtoul(argv[2], NULL, 0) : 2000;
+	if (0 == nb_requests) {
+		fprintf(stderr, "usage: %s [nb_batch [nb_requests (1 at least)]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	printf("%zu batch cothreads, %zu requests of %u us every %u us, %u us chunks\n", nb_batch, nb_requests,
+		REQUEST_NS / 1000, PERIOD_NS / 1000, CHUNK_NS / 1000);
+
+	//---Allocate---//
+	void*		block		= malloc((NB_INTERACTIVE + nb_batch) * STACK_SZ + COTHREADJ_STACK_ALIGN);
+	cothreadj_t*	batch		= (cothreadj_t*)malloc((nb_batch + 1) * sizeof(cothreadj_t));
+	uint64_t*	latencies	= (uint64_t*)malloc(nb_requests * sizeof(uint64_t));
+	if ((NULL == block) || (NULL == batch) || (NULL == latencies)) {
+		fprintf(stderr, "out of memory\n");
+		return EXIT_FAILURE;
+	}
+	cothreadj_stack_t*	stacks	= (cothreadj_stack_t*)(((uintptr_t)block + COTHREADJ_STACK_ALIGN - 1) & ~(uintptr_t)(COTHREADJ_STACK_ALIGN - 1));
+
+	//---Run---//
+	run(kind_fifo, stacks, batch, nb_batch, latencies, nb_requests);
+	run(kind_prio, stacks, batch, nb_batch, latencies, nb_requests);
+	run(kind_edf, stacks, batch, nb_batch, latencies, nb_requests);
+
+	//---Release---//
+	free(latencies);
+	free(batch);
+	free(block);
+	return EXIT_SUCCESS;
+}
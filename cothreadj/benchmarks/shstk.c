@@ -0,0 +1,153 @@
+/**
+ * @brief		This file contains a benchmark comparing the dedicated stacks with a shared one.
+ * @file
+ *
+ * usage: cothreadj_benchmark_shstk [nb_cothreads [stack_sz [nb_rounds]]]
+ *
+ * Each callee nests frames up to a given live size (1, 2 then 4 KiB) and yields from there.
+ * Each round resumes every cothread once, the way a scheduler does, so that on the shared stack
+ * each switch copies the frames of one callee off the stack and the ones of the next callee back.
+ * The memory is what each cothread holds once paused: its stack, or its save area plus its share of the
+ * shared stack, the cothread itself excluded.
+ */
+
+#include <cothread/cothreadj_arena.h>
+#include <cothread/cothreadj_shstk.h>
+#include <cothread/ticks.h>
+#include <stdint.h>
+#include <string.h>
+
+/// @cond
+#define CHUNK_SZ	256		// the size of each nested frame.
+/// @endcond
+
+/**
+ * @brief		Nests frames down to the specified depth, then yields from the deepest one forever.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	depth		The number of frames to nest.
+ * @param		[in]	user_val	Any user value (except zero) to send to the other endpoint.
+ * @return		Never returns.
+ */
+static COTHREAD_NOINLINE int COTHREAD_CALL
+nested_yield(cothreadj_t* cothread, size_t depth, int user_val)
+{
+	volatile char	frame[CHUNK_SZ - 64];
+	frame[0]	= (char)user_val;
+	if (0 != depth) {
+		return nested_yield(cothread, depth - 1, user_val) + frame[0];
+	}
+	do {
+		user_val	= cothreadj_yield(cothread, 1 + frame[0] - frame[0]);
+	} while (0 != user_val);
+	return user_val;
+}
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread, whose user data is the live frame size.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Never returns.
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	return nested_yield(cothread, (size_t)cothreadj_get_user_data(cothread) / CHUNK_SZ, user_val);
+}
+
+/**
+ * @brief		Runs the benchmark with the specified live frame size.
+ * @param		[in]	shared			Says whether the cothreads share a stack or not.
+ * @param		[in]	frame_sz		The live frame size, in bytes.
+ * @param		[in]	nb_cothreads	The number of cothreads.
+ * @param		[in]	stack_sz		The stack size, in bytes.
+ * @param		[in]	nb_rounds		The number of rounds.
+ */
+static void
+run(int shared, size_t frame_sz, size_t nb_cothreads, size_t stack_sz, size_t nb_rounds)
+{
+	//---Definitions---//
+	cothreadj_arena_t	arena;
+	cothreadj_shstk_t	shstk;
+	cothreadj_t*		cothreads	= (cothreadj_t*)malloc(nb_cothreads * sizeof(cothreadj_t));
+	if (NULL == cothreads) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	//---Allocate & initialize the cothreads---//
+	cothreadj_arena_init(&arena, stack_sz, 0);
+	cothreadj_stack_t*	shared_stack	= cothreadj_arena_alloc(&arena, NULL);
+	if (NULL == shared_stack) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	cothreadj_shstk_init(&shstk, shared_stack, arena.stack_sz);
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		cothreadj_attr_t	attr;
+		cothreadj_stack_t*	stack	= shared ? shared_stack : cothreadj_arena_alloc(&arena, NULL);
+		if (NULL == stack) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+		cothreadj_attr_init(&attr, stack, arena.stack_sz, user_cb);
+		if (shared) {
+			if (cothread_err_ok != cothreadj_init_shared(cothreads + i, &attr, &shstk)) {
+				fprintf(stderr, "out of memory\n");
+				exit(EXIT_FAILURE);
+			}
+		} else {
+			cothreadj_init(cothreads + i, &attr);
+		}
+		cothreadj_set_user_data(cothreads + i, (void*)frame_sz);
+	}
+
+	//---Warm up, then measure---//
+	uint64_t	ns	= 0;
+	for (size_t round = 0; round < nb_rounds + 1; round++) {
+		const uint64_t	ns0	= cothread_ticks_ns();
+		for (size_t i = 0; i < nb_cothreads; i++) {
+			if (0 == cothreadj_yield(cothreads + i, 1)) {
+				fprintf(stderr, "out of memory\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+		if (0 != round) {
+			ns	+= cothread_ticks_ns() - ns0;
+		}
+	}
+
+	//---Report---//
+	const double	nb_switches	= 2.0 * (double)nb_cothreads * (double)nb_rounds;
+	const double	mem			= shared ? (double)(shstk.nb_bytes + arena.stack_sz) : (double)(nb_cothreads * arena.stack_sz);
+	printf("%-8s %4zu B frames %10.2f ns/switch %10.0f B/cothread %10.2f MiB\n", shared ? "shared" : "separate", frame_sz,
+		(double)ns / nb_switches, mem / (double)nb_cothreads, mem / (1024.0 * 1024.0));
+
+	//---Release---//
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		cothreadj_uninit(cothreads + i);
+	}
+	cothreadj_shstk_uninit(&shstk);
+	cothreadj_arena_uninit(&arena);
+	free(cothreads);
+}
+
+extern int
+main(int argc, char* argv[])
+{
+	//---Parse the arguments---//
+	const size_t	nb_cothreads	= (1 < argc) ? (size_t)strtoul(argv[1], NULL, 0) : 10000;
+	const size_t	stack_sz		= COTHREADJ_ROUND_STACK_SZ((2 < argc) ? (size_t)strtoul(argv[2], NULL, 0) : 16 * 1024);
+	const size_t	nb_rounds		= (3 < argc) ? (size_t)strtoul(argv[3], NULL, 0) : 20;
+	if ((0 == nb_cothreads) || (8 * 1024 > stack_sz) || (0 == nb_rounds)) {
+		fprintf(stderr, "usage: %s [nb_cothreads [stack_sz (8 KiB at least) [nb_rounds]]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	//---Run---//
+	printf("%zu cothreads, %zu-byte stacks, %zu rounds\n", nb_cothreads, stack_sz, nb_rounds);
+	for (size_t frame_sz = 1024; frame_sz <= 4096; frame_sz *= 2) {
+		run(0, frame_sz, nb_cothreads, stack_sz, nb_rounds);
+		run(1, frame_sz, nb_cothreads, stack_sz, nb_rounds);
+	}
+	return EXIT_SUCCESS;
+}
@@ -13,7 +13,11 @@
 #define __COTHREAD_COTHREADJ_H__
 
 #include <cothread/config.h>
+#include <cothread/hooks.h>
+#include <cothread/stats.h>
+#include <cothread/types.h>
 #include <setjmp.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -24,6 +28,10 @@ typedef	struct _cothreadj_stack_t	cothreadj_stack_t;	///< @brief	The stack type.
 typedef struct _cothreadj_attr_t	cothreadj_attr_t;	///< @brief	The cothread attribute type.
 typedef struct _cothreadj_ep_t		cothreadj_ep_t;		///< @brief	The cothread endpoint type.
 typedef struct _cothreadj_t			cothreadj_t;		///< @brief	The cothread type.
+typedef struct _cothreadj_sched_t	cothreadj_sched_t;	///< @brief	The scheduler type.
+typedef struct _cothreadj_group_t	cothreadj_group_t;	///< @brief	The task group type.
+typedef struct _cothreadj_shstk_t	cothreadj_shstk_t;	///< @brief	The shared stack type.
+typedef struct _cothreadj_shstk_save_t	cothreadj_shstk_save_t;	///< @brief	The shared stack save area type.
 /// @}
 
 //---Stack type detection---//
@@ -105,6 +113,36 @@ typedef struct _cothreadj_t			cothreadj_t;		///< @brief	The cothread type.
  */
 #define COTHREADJ_ROUND_STACK_SZ(_sz)	((((_sz) + (COTHREADJ_STACK_ALIGN - 1)) / COTHREADJ_STACK_ALIGN) * COTHREADJ_STACK_ALIGN)
 
+/// @ingroup doxy_cothreadj
+/// @{
+#define COTHREADJ_FLAG_COMPLETED	(1 << 0)	///< @brief	Says whether the callee has returned or not.
+#define COTHREADJ_FLAG_SHARED_STACK	(1 << 1)	///< @brief	Says whether the callee runs on a shared stack or not.
+#define COTHREADJ_FLAG_LAZY			(1 << 2)	///< @brief	Says whether the initial callee frame is still to be built or not.
+#define COTHREADJ_FLAG_CANCELLED	(1 << 3)	///< @brief	Says whether the group of the callee has cancelled it or not.
+#define COTHREADJ_FLAG_YIELDED		(1 << 4)	///< @brief	Says whether the callee has yielded back to its scheduler to be resumed again or not.
+#define COTHREADJ_FLAG_LOG			(1 << 5)	///< @brief	Says whether the cothread logs to its debug stream or not.
+#define COTHREADJ_FLAG_GROUP_PARKED	(1 << 6)	///< @brief	Says whether the callee is parked in cothreadj_group_park or not.
+/// @}
+
+/**
+ * @brief		The number of fiber-local storage slots each cothread embeds.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_FLS_NB_SLOTS		8
+
+/**
+ * @brief		The fiber-local storage key type, the index of a slot.
+ * @ingroup		doxy_cothreadj
+ */
+typedef size_t	cothreadj_fls_key_t;
+
+/**
+ * @brief		The fiber-local storage destructor.
+ * @param		[in]	value	The non-NULL value stored in the slot when the callee returns.
+ * @ingroup		doxy_cothreadj
+ */
+typedef void (COTHREAD_CALL * cothreadj_fls_dtor_t) (void* value);
+
 /**
  * @brief		The callee entry point.
  * @param		[in]	cothread	The cothread.
@@ -135,12 +173,18 @@ struct _cothreadj_attr_t
  */
 struct _cothreadj_ep_t
 {
+	void*		sp;			///< @brief	The stack pointer while paused: with @ref COTHREAD_WITH_COMPACT_CTX, the registers are
+							///< spilled onto the stack, otherwise only the callee one is recorded, as an upper bound.
+#if !COTHREAD_WITH_COMPACT_CTX
 	jmp_buf		buf;		///< @brief	The execution context.
-	const char*	dbg_name;	///< @brief	The debug name, never NULL.
+#endif
 };
 
 /**
  * @brief		The cothread type.
+ * @note		The members a switch or a scheduler pass touches come first: with @ref COTHREAD_WITH_COMPACT_CTX,
+ *				they fill the first 64 bytes, and the cothread is aligned on a cache line boundary. The cold ones
+ *				(debug names & stream, groups, fiber-local storage, scheduling keys, trimming) follow.
  * @ingroup		doxy_cothreadj
  */
 struct _cothreadj_t
@@ -148,9 +192,43 @@ struct _cothreadj_t
 	cothreadj_ep_t*		current;	///< @brief	Points the current endpoint.
 	cothreadj_ep_t		caller;		///< @brief	The caller endpoint.
 	cothreadj_ep_t		callee;		///< @brief	The callee endpoint.
+	unsigned int		flags;		///< @brief	Several flags (see @ref COTHREADJ_FLAG_COMPLETED.)
+	cothreadj_sched_t*	sched;		///< @brief	The scheduler the cothread is spawned on, NULL if none.
+	cothreadj_t*		next;		///< @brief	The next cothread in the queue (run queue or wait list) the cothread is linked in.
+	cothreadj_stack_t*	stack;		///< @brief	The lowest address of the callee stack.
+	cothreadj_shstk_t*	shstk;		///< @brief	The shared stack the callee runs on, NULL if it owns its stack.
+	//
+	size_t				stack_sz;	///< @brief	The size of the callee stack, in bytes.
+	cothreadj_cb_t		user_cb;	///< @brief	The callee entry point.
 	void*				user_data;	///< @brief	Any user data.
-	FILE*				dbg_strm;	///< @brief	The stream to log debug informations to, may be NULL.
-};
+	cothreadj_group_t*	group;		///< @brief	The group the cothread is a child of, NULL if none.
+	cothreadj_t*		group_next;	///< @brief	The next child of the group, NULL if none.
+	int					group_ret;	///< @brief	The value the callee has returned, once spawned in a group.
+	void*				fls[COTHREADJ_FLS_NB_SLOTS];	///< @brief	The fiber-local storage slots, indexed by @ref cothreadj_fls_key_t.
+	cothreadj_shstk_save_t*	save;		///< @brief	The copy of the callee frames while evicted from the shared stack, NULL if none.
+	uint64_t			sched_key;	///< @brief	The key the scheduling policy orders the cothread by: its priority level or its deadline (see cothreadj_policy.h.)
+	uint64_t			sched_seq;	///< @brief	The order the cothread was made ready in, which breaks the ties between equal keys.
+	cothreadj_t*		sched_child;	///< @brief	The first child of the cothread in the heap of the EDF policy, NULL if none.
+	cothreadj_t*		trim_next;	///< @brief	The next cothread parked in the list of the ones its scheduler is to trim.
+	cothreadj_t**		trim_pprev;	///< @brief	Points the link to the cothread in the list of the ones to trim, NULL if not linked.
+	size_t				trim_pass;	///< @brief	The number of cothreads the scheduler had resumed when the cothread parked.
+	const char*			dbg_caller_name;	///< @brief	The caller debug name, never NULL.
+	const char*			dbg_callee_name;	///< @brief	The callee debug name, never NULL.
+	FILE*				dbg_strm;	///< @brief	The stream to log debug informations to, may be NULL (see @ref COTHREADJ_FLAG_LOG.)
+#if COTHREAD_WITH_STATS
+	cothread_stats_t	stats;		///< @brief	The statistics, once registered linked in the list of live ones until the callee returns.
+#endif
+#if COTHREAD_WITH_HOOKS
+	const cothread_hooks_t*	hooks;		///< @brief	The hooks called when the callee is resumed or suspended, NULL if none.
+#endif
+#if (COTHREAD_WITH_PROFILER || COTHREAD_WITH_WATCHDOG)
+	cothreadj_t*		running_prev;	///< @brief	The cothread whose callee was running in the OS thread when this callee was resumed, NULL if none.
+#endif
+}
+#if COTHREAD_WITH_COMPACT_CTX
+__attribute__ ((aligned (64)))	// only available with gcc on GNU/Linux.
+#endif
+;
 
 #ifdef __cplusplus
 extern "C" {
@@ -200,6 +278,28 @@ extern COTHREAD_LINK void		COTHREAD_CALL cothreadj_attr_set_dbg_strm	(cothreadj_
  */
 extern COTHREAD_LINK void		COTHREAD_CALL cothreadj_init	(cothreadj_t* cothread, const cothreadj_attr_t* attr);
 
+/**
+ * @brief		Initializes the specified cothread without touching its stack.
+ * @param		[in]	cothread	The cothread to initialize.
+ * @param		[in]	attr		The attributes to initialize the cothread with.
+ * @note		Only the entry point & the stack bounds are recorded: the initial callee frame is built
+ *				by the first @ref cothreadj_yield resuming the callee, so that a cothread which never runs
+ *				never faults its stack pages in (see @ref COTHREADJ_FLAG_LAZY.)
+ *				Modifying @e attr after calling this function has no effect on the initialized @e cothread.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK void		COTHREAD_CALL cothreadj_init_lazy	(cothreadj_t* cothread, const cothreadj_attr_t* attr);
+
+/**
+ * @brief		Uninitializes the specified cothread.
+ * @param		[in]	cothread	The cothread to uninitialize.
+ * @note		Calling this function is optional once the callee has returned, but it has to be called
+ *				before discarding a cothread whose callee has not returned yet if its statistics have been
+ *				registered (see @ref cothreadj_stats_register), which would remain linked in the list of live ones otherwise.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK void		COTHREAD_CALL cothreadj_uninit	(cothreadj_t* cothread);
+
 /**
  * @brief		Stores the specified user data in the specified cothread.
  * @param		[in]	cothread	The cothread to store the user data in.
@@ -220,11 +320,152 @@ extern COTHREAD_LINK void*		COTHREAD_CALL cothreadj_get_user_data	(const cothrea
  * @brief		Switches from the current endpoint to the other one.
  * @param		[in]	cothread	The cothread to switch.
  * @param		[in]	user_val	Any user value (except zero) to send to the other endpoint.
- * @return		Returns the @e user_val received from the other endpoint.
+ * @return		Returns the @e user_val received from the other endpoint,
+ *				zero if the callee runs on a shared stack which its frames could not be copied back to
+ *				(see @ref cothreadj_init_shared), in which case it is not resumed.
  * @relates		_cothreadj_t
  */
 extern COTHREAD_LINK int		COTHREAD_CALL cothreadj_yield	(cothreadj_t* cothread, int user_val);
 
+/**
+ * @brief		Returns the idle pages of the callee stack of the specified cothread to the kernel.
+ * @param		[in]	cothread	The cothread whose callee is paused (or has returned.)
+ * @param		[out]	nb_bytes	Receives the number of resident bytes returned to the kernel, may be NULL.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup on other operating systems than GNU/Linux, FreeBSD & macOS,
+ *				if the stack memory does not support it, or if the callee runs on a shared stack.
+ *				.
+ * @note		The pages lying below the stack pointer of the paused callee (the whole stack once it has returned)
+ *				are handed back with @c madvise(MADV_FREE): the kernel reclaims them when it runs short of memory,
+ *				and the callee gets them back zero-filled (or untouched) when its stack grows again.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_trim	(cothreadj_t* cothread, size_t* nb_bytes);
+
+/**
+ * @brief		Allocates a fiber-local storage key, valid in all the cothreads.
+ * @param		[out]	key		The allocated key.
+ * @param		[in]	dtor	The function to call on the non-NULL value of the slot when a callee returns, may be NULL.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if all the @ref COTHREADJ_FLS_NB_SLOTS keys are allocated.
+ *				.
+ * @note		Keys should be allocated once, before any cothread uses them: this function is not thread-safe.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_fls_key_create	(cothreadj_fls_key_t* key, cothreadj_fls_dtor_t dtor);
+
+/**
+ * @brief		Stores the specified value in the specified fiber-local storage slot of the specified cothread.
+ * @param		[in]	cothread	The cothread to store the value in.
+ * @param		[in]	key			The key of the slot to store the value in.
+ * @param		[in]	value		The value to store.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK void		COTHREAD_CALL cothreadj_fls_set	(cothreadj_t* cothread, cothreadj_fls_key_t key, void* value);
+
+/**
+ * @brief		Returns the value stored in the specified fiber-local storage slot of the specified cothread.
+ * @param		[in]	cothread	The cothread to return the value stored in.
+ * @param		[in]	key			The key of the slot to return the value of.
+ * @return		Returns the value, NULL if never set.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK void*		COTHREAD_CALL cothreadj_fls_get	(const cothreadj_t* cothread, cothreadj_fls_key_t key);
+
+/**
+ * @brief		Sets the hooks called each time the callee of the specified cothread is resumed or suspended.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	hooks		The hooks, kept alive until replaced (no internal copy is done), NULL to remove them.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_HOOKS.
+ *				.
+ * @note		The hooks get the cothread as first argument. The resume ones run right before the stack switch
+ *				to the callee, the suspend ones right before the stack switch back to the caller.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_set_hooks	(cothreadj_t* cothread, const cothread_hooks_t* hooks);
+
+/**
+ * @brief		Sets the hooks called each time the callee of any cothread is resumed or suspended.
+ * @param		[in]	hooks		The hooks, kept alive until replaced (no internal copy is done), NULL to remove them.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_HOOKS.
+ *				.
+ * @note		The global resume hook runs before the per-cothread one, the global suspend hook after it.
+ *				The hooks should be set while no callee runs, since the switches read them without synchronization.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_set_global_hooks	(const cothread_hooks_t* hooks);
+
+/**
+ * @brief		Links the statistics of the specified cothread in the list of the live ones.
+ * @param		[in]	cothread	The initialized cothread.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_STATS.
+ *				.
+ * @note		The statistics of every cothread are accounted, but only the registered ones are copied by
+ *				@ref cothreadj_stats_snapshot. They are unlinked once the callee returns, or by @ref cothreadj_uninit,
+ *				which has to be called before discarding a registered cothread whose callee has not returned yet.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_stats_register	(cothreadj_t* cothread);
+
+/**
+ * @brief		Copies the statistics of the live cothreads (registered, not returned nor uninitialized yet.)
+ * @param		[out]	stats		The array to copy the statistics to, may be NULL if @e nb_stats is zero.
+ * @param		[in]	nb_stats	The number of entries of the array.
+ * @return		Returns the number of live cothreads, which may be greater than @e nb_stats,
+ *				always zero if the library is built without @ref COTHREAD_WITH_STATS.
+ * @note		This function may be called from any thread, the statistics of the running callees may be slightly stale.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK size_t		COTHREAD_CALL cothreadj_stats_snapshot	(cothread_stats_t* stats, size_t nb_stats);
+
+/**
+ * @brief		Starts recording the switch events, the previously recorded ones are discarded.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_TRACE.
+ *				.
+ * @note		Each OS thread records its events in its own ring, which keeps the 4096
+ *				most recent ones.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_trace_start	(void);
+
+/**
+ * @brief		Stops recording the switch events, the recorded ones are kept until the next start.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK void		COTHREAD_CALL cothreadj_trace_stop	(void);
+
+/**
+ * @brief		Writes the recorded switch events to the specified stream, in the Chrome trace event JSON format.
+ * @param		[in]	strm	The stream to write the events to.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if the events cannot be gathered ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_TRACE.
+ *				.
+ * @note		Each cothread gets its own track, named after its callee debug name. The output may be loaded
+ *				in @c chrome://tracing or in the Perfetto UI.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_trace_dump	(FILE* strm);
+
+/**
+ * @brief		Frees the rings of the switch events, including the ones of the OS threads which have exited.
+ * @note		This function shall not be called while recording: each OS thread allocates a new ring on its
+ *				next recorded event.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK void		COTHREAD_CALL cothreadj_trace_release	(void);
+
 #ifdef __cplusplus
 } /* extern "C" { */
 #endif
@@ -0,0 +1,183 @@
+/**
+ * @brief		This file contains the stack arena public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_ARENA_H__
+#define __COTHREAD_COTHREADJ_ARENA_H__
+
+#include <cothread/cothreadj.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothreadj
+/// @{
+typedef struct _cothreadj_arena_region_t		cothreadj_arena_region_t;		///< @brief	The stack arena region type.
+typedef struct _cothreadj_arena_node_stats_t	cothreadj_arena_node_stats_t;	///< @brief	The per-node arena statistics type.
+typedef struct _cothreadj_arena_t				cothreadj_arena_t;				///< @brief	The stack arena type.
+/// @}
+
+/**
+ * @brief		The alignment of the regions, the size of a transparent huge page on x86 & x86_64.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_ARENA_REGION_ALIGN	(2 * 1024 * 1024)
+
+/**
+ * @brief		The minimum size of the regions, in bytes.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_ARENA_REGION_SZ_MIN	(16 * COTHREADJ_ARENA_REGION_ALIGN)
+
+/**
+ * @brief		The alignment of the slots (and of the colocated cothreads), the size of a cache line.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_ARENA_SLOT_ALIGN		64
+
+/// @ingroup doxy_cothreadj
+/// @{
+#define COTHREADJ_ARENA_FLAG_COLOCATE	(1 << 0)	///< @brief	Says whether each stack embeds its cothread at its top or not.
+#define COTHREADJ_ARENA_FLAG_NUMA_LOCAL	(1 << 1)	///< @brief	Says whether each region is placed on the NUMA node of the OS thread mapping it or not.
+/// @}
+
+/**
+ * @brief		The stack arena region type.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_arena_region_t
+{
+	cothreadj_arena_region_t*	next;	///< @brief	The previously mapped region, NULL if none.
+	void*						base;	///< @brief	The lowest address of the region.
+	size_t						sz;		///< @brief	The region size, in bytes.
+	int							node;	///< @brief	The NUMA node the region is placed on, -1 if not placed.
+};
+
+/**
+ * @brief		The per-node arena statistics type.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_arena_node_stats_t
+{
+	int			node;		///< @brief	The NUMA node, -1 for the regions which are not placed.
+	size_t		nb_regions;	///< @brief	The number of regions placed on the node.
+	size_t		nb_bytes;	///< @brief	The cumulative size of these regions, in bytes.
+	size_t		nb_slots;	///< @brief	The number of slots ever carved out of these regions.
+};
+
+/**
+ * @brief		The stack arena type.
+ * @details		The arena maps large @ref COTHREADJ_ARENA_REGION_ALIGN -aligned regions, backed by transparent huge
+ *				pages when available, and carves fixed-size slots out of them, so that switching between many
+ *				cothreads touches a few TLB entries instead of one per stack.
+ *				Each slot holds a stack and, with @ref COTHREADJ_ARENA_FLAG_COLOCATE, the cothread itself,
+ *				right above the stack top (so the control block shares its page with the hottest stack frames.)
+ * @note		An arena belongs to a single OS thread and never uses atomic operations.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_arena_t
+{
+	size_t						stack_sz;	///< @brief	The size of the stacks (at least the requested one), in bytes.
+	size_t						slot_sz;	///< @brief	The size of the slots, an odd number of cache lines, in bytes.
+	size_t						region_sz;	///< @brief	The size of the regions, in bytes.
+	unsigned int				flags;		///< @brief	Some flags (see @ref COTHREADJ_ARENA_FLAG_COLOCATE.)
+	cothreadj_arena_region_t*	regions;	///< @brief	The last mapped region, NULL if none.
+	char*						cur;		///< @brief	The first slot never carved out of the last region.
+	char*						end;		///< @brief	The past-the-end address of the last region.
+	void*						free_slots;	///< @brief	The released slots, linked through their lowest bytes.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified arena.
+ * @param		[in]	arena		The arena to initialize.
+ * @param		[in]	stack_sz	The minimum size of the stacks, a multiple of @ref COTHREADJ_STACK_ALIGN
+ *									(rounded up to fill the @ref COTHREADJ_ARENA_SLOT_ALIGN -aligned slots,
+ *									an odd number of cache lines in size.)
+ * @param		[in]	flags		Some flags (see @ref COTHREADJ_ARENA_FLAG_COLOCATE.)
+ * @note		No memory is mapped until the first allocation.
+ * @relates		_cothreadj_arena_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothreadj_arena_init	(cothreadj_arena_t* arena, size_t stack_sz, unsigned int flags);
+
+/**
+ * @brief		Unmaps the regions of the specified arena.
+ * @param		[in]	arena	The arena to uninitialize.
+ * @note		The stacks (and the colocated cothreads) allocated from the arena must not be used anymore.
+ * @relates		_cothreadj_arena_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothreadj_arena_uninit	(cothreadj_arena_t* arena);
+
+/**
+ * @brief		Allocates a stack from the specified arena.
+ * @param		[in]	arena		The arena to allocate the stack from.
+ * @param		[out]	cothread	Receives the cothread colocated at the stack top
+ *									(with @ref COTHREADJ_ARENA_FLAG_COLOCATE only, may be NULL otherwise.)
+ * @return		Returns the lowest address of a @ref _cothreadj_arena_t::stack_sz -byte stack, NULL if out of memory.
+ * @relates		_cothreadj_arena_t
+ */
+extern COTHREAD_LINK cothreadj_stack_t*	COTHREAD_CALL cothreadj_arena_alloc	(cothreadj_arena_t* arena, cothreadj_t** cothread);
+
+/**
+ * @brief		Releases the specified stack to the specified arena.
+ * @param		[in]	arena	The arena the stack was allocated from.
+ * @param		[in]	stack	The stack to release, whose callee is not running.
+ * @note		The slot is reused by the next allocation, the region is unmapped by @ref cothreadj_arena_uninit only.
+ * @relates		_cothreadj_arena_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothreadj_arena_free	(cothreadj_arena_t* arena, cothreadj_stack_t* stack);
+
+/**
+ * @brief		Initializes the specified cothreads in one pass.
+ * @param		[in]	cothreads		The contiguous array of cothreads to initialize.
+ * @param		[in]	nb_cothreads	The number of cothreads.
+ * @param		[in]	attr			The attributes shared by the cothreads (whose stack ones are ignored with an arena.)
+ * @param		[in]	arena			The arena providing the stacks (which must not colocate the cothreads), NULL
+ *										to carve them out of @e attr: the stack of the cothread @e i is then the
+ *										@e attr.stack_sz -byte one lying at @e attr.stack + @e i * @e attr.stack_sz.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if the arena is out of memory (no cothread is initialized then.)
+ *				.
+ * @note		The cothreads are initialized as @ref cothreadj_init_lazy does, without touching their stacks.
+ *				Each cothread has to be uninitialized with @ref cothreadj_uninit, and its stack released to
+ *				the arena (see @ref _cothreadj_t::stack.)
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK cothread_err_t		COTHREAD_CALL cothreadj_init_many	(cothreadj_t* cothreads, size_t nb_cothreads, const cothreadj_attr_t* attr, cothreadj_arena_t* arena);
+
+/**
+ * @brief		Copies the per-node statistics of the specified arena.
+ * @param		[in]	arena		The arena to get the statistics of.
+ * @param		[out]	stats		The array to copy the statistics to, from the node of the last mapped region.
+ * @param		[in]	nb_stats	The number of elements of @e stats.
+ * @return		Returns the number of nodes the arena mapped regions on (which may exceed @e nb_stats.)
+ * @relates		_cothreadj_arena_t
+ */
+extern COTHREAD_LINK size_t				COTHREAD_CALL cothreadj_arena_node_stats	(const cothreadj_arena_t* arena, cothreadj_arena_node_stats_t* stats, size_t nb_stats);
+
+/**
+ * @brief		Gets the NUMA node the specified stack is placed on.
+ * @param		[in]	arena	The arena the stack was allocated from.
+ * @param		[in]	stack	The stack.
+ * @return		Returns the node, -1 if the region holding the stack is not placed.
+ * @note		Anything handing cothreads over to other OS threads should prefer the ones running on this node
+ *				(see @ref cothreadj_numa_node.)
+ * @relates		_cothreadj_arena_t
+ */
+extern COTHREAD_LINK int				COTHREAD_CALL cothreadj_arena_get_node	(const cothreadj_arena_t* arena, const cothreadj_stack_t* stack);
+
+/**
+ * @brief		Gets the NUMA node of the CPU running the calling OS thread.
+ * @return		Returns the node, -1 if unknown (on other operating systems than GNU/Linux.)
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK int				COTHREAD_CALL cothreadj_numa_node	(void);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_ARENA_H__ */
@@ -0,0 +1,251 @@
+/**
+ * @brief		This file contains the adapters between the C++20 coroutines and the cothreads.
+ * @file
+ *
+ * The stackless coroutines and the cothreads (the fibers) share the same [scheduler](@ref _cothreadj_sched_t):
+ * - a coroutine suspended by @ref cothreadj::schedule is resumed by a [task](@ref _cothreadj_sched_task_t)
+ *   embedded in the awaiter, run by @ref cothreadj_sched_run on the scheduler stack ;
+ * - a coroutine gets the next value a fiber yields with @ref cothreadj::next, which resumes the fiber directly ;
+ * - a fiber waits for a @ref cothreadj::task with @ref cothreadj::sync_wait, which parks the fiber
+ *   until the task completes, then wakes it up through the scheduler.
+ * .
+ * No OS thread is involved and no awaiter allocates memory, only the coroutine frames are allocated
+ * (once per coroutine call, by the compiler.)
+ * This header is empty unless the compiler supports the C++20 coroutines.
+ */
+
+#ifndef __COTHREAD_COTHREADJ_CORO_HXX__
+#define __COTHREAD_COTHREADJ_CORO_HXX__
+
+#include <cothread/cothreadj_sched.h>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief		The C++20 coroutine adapters.
+ * @ingroup		doxy_cothreadj
+ */
+namespace cothreadj {
+
+/// @cond
+namespace detail {
+	/**
+	 * @brief		The part of the promise which does not depend on the result type.
+	 */
+	struct promise_base
+	{
+		std::coroutine_handle<>	continuation;		///< @brief	The coroutine awaiting the task, none if not awaited.
+		cothreadj_t*			fiber	= nullptr;	///< @brief	The fiber parked until the task completes, NULL if none.
+		std::exception_ptr		exception;			///< @brief	The exception thrown by the coroutine, if any.
+
+		/**
+		 * @brief		The awaiter resuming whoever waits for the completed task.
+		 */
+		struct final_awaiter
+		{
+			bool	await_ready		(void) noexcept	{ return false; }
+			void	await_resume	(void) noexcept	{}
+
+			template <typename P> std::coroutine_handle<>
+			await_suspend(std::coroutine_handle<P> handle) noexcept
+			{
+				promise_base&	promise	= handle.promise();
+				if (nullptr != promise.fiber) {
+					cothreadj_sched_wake(promise.fiber);
+					return std::noop_coroutine();
+				}
+				return promise.continuation ? promise.continuation : std::noop_coroutine();
+			}
+		};
+
+		std::suspend_always	initial_suspend		(void) noexcept	{ return {}; }
+		final_awaiter		final_suspend		(void) noexcept	{ return {}; }
+		void				unhandled_exception	(void) noexcept	{ this->exception	= std::current_exception(); }
+	};
+
+	/**
+	 * @brief		The part of the promise which stores the result.
+	 */
+	template <typename T>
+	struct promise_result
+	{
+		std::optional<T>	value;	///< @brief	The returned value.
+
+		void	return_value	(T val)		{ this->value.emplace(std::move(val)); }
+		T		get				(void)		{ return std::move(*(this->value)); }
+	};
+
+	template <>
+	struct promise_result<void>
+	{
+		void	return_void		(void) noexcept	{}
+		void	get				(void) noexcept	{}
+	};
+} /* namespace detail */
+/// @endcond
+
+/**
+ * @brief		A lazily started coroutine, which may be awaited by another coroutine or waited for by a fiber.
+ * @tparam		T	The result type.
+ * @ingroup		doxy_cothreadj
+ */
+template <typename T = void>
+class task
+{
+	public:
+		/// @brief	The promise type.
+		struct promise_type : detail::promise_base, detail::promise_result<T>
+		{
+			task	get_return_object	(void) noexcept	{ return task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+		};
+
+	private:
+		std::coroutine_handle<promise_type>	handle;	///< @brief	The coroutine, none once moved.
+
+	private:
+		explicit	task	(std::coroutine_handle<promise_type> handle) noexcept : handle(handle)	{}
+	public:
+					task	(task&& other) noexcept : handle(std::exchange(other.handle, {}))	{}
+					task	(const task&)	= delete;
+		task&		operator=	(const task&)	= delete;
+					~task	(void)	{ if (this->handle) { this->handle.destroy(); } }
+
+	public:
+		/**
+		 * @brief		Says whether the coroutine has completed or not.
+		 * @return		Returns true once the coroutine has returned (or thrown.)
+		 */
+		bool	done	(void) const noexcept	{ return this->handle.done(); }
+
+		/**
+		 * @brief		Returns the result of the completed coroutine.
+		 * @return		Returns the returned value, rethrows the thrown exception.
+		 */
+		T
+		result(void)
+		{
+			if (this->handle.promise().exception) {
+				std::rethrow_exception(this->handle.promise().exception);
+			}
+			return this->handle.promise().get();
+		}
+
+	public:
+		/// @brief	Starts the coroutine, the awaiting one is resumed once it completes (symmetric transfer.)
+		bool	await_ready		(void) const noexcept	{ return false; }
+		T		await_resume	(void)					{ return this->result(); }
+		std::coroutine_handle<>
+		await_suspend(std::coroutine_handle<> awaiting) noexcept
+		{
+			this->handle.promise().continuation	= awaiting;
+			return this->handle;
+		}
+
+	template <typename U> friend U	sync_wait	(cothreadj_t* cothread, task<U> coro);
+};
+
+/**
+ * @brief		The awaiter suspending the awaiting coroutine until the specified scheduler resumes it.
+ * @note		Like @ref cothreadj_sched_yield for the cothreads: the coroutine is resumed on the scheduler stack,
+ *				after the cothreads & the tasks which were ready before it.
+ * @ingroup		doxy_cothreadj
+ */
+class schedule
+{
+	private:
+		cothreadj_sched_task_t	node;	///< @brief	The task posted to the scheduler (first member.)
+		cothreadj_sched_t*		sched;	///< @brief	The scheduler.
+		std::coroutine_handle<>	handle;	///< @brief	The suspended coroutine.
+
+	private:
+		/**
+		 * @brief		Resumes the coroutine which posted the specified task.
+		 * @param		[in]	task	The task embedded in the awaiter.
+		 */
+		static void COTHREAD_CALL
+		run(cothreadj_sched_task_t* task)
+		{
+			reinterpret_cast<schedule*>(task)->handle.resume();
+		}
+
+	public:
+		/**
+		 * @brief		The main constructor.
+		 * @param		[in]	sched	The scheduler which resumes the coroutine.
+		 */
+		explicit
+		schedule(cothreadj_sched_t* sched) noexcept : sched(sched)
+		{
+			cothreadj_sched_task_init(&(this->node), &schedule::run);
+		}
+
+	public:
+		bool	await_ready		(void) const noexcept	{ return false; }
+		void	await_resume	(void) const noexcept	{}
+		void
+		await_suspend(std::coroutine_handle<> handle) noexcept
+		{
+			this->handle	= handle;
+			cothreadj_sched_post(this->sched, &(this->node));
+		}
+};
+
+/**
+ * @brief		The awaiter resuming the specified fiber, whose next yielded value is the result.
+ * @note		The awaiting coroutine is the caller of the fiber, which must not be spawned on a scheduler:
+ *				the fiber runs until it yields, and the coroutine goes on with the yielded value right away.
+ * @ingroup		doxy_cothreadj
+ */
+class next
+{
+	private:
+		cothreadj_t*	cothread;	///< @brief	The fiber.
+		int				user_val;	///< @brief	The value sent to the fiber, then the one received from it.
+
+	public:
+		/**
+		 * @brief		The main constructor.
+		 * @param		[in]	cothread	The fiber whose callee is paused.
+		 * @param		[in]	user_val	Any user value (except zero) to send to the fiber.
+		 */
+		next(cothreadj_t* cothread, int user_val) noexcept : cothread(cothread), user_val(user_val)	{}
+
+	public:
+		bool	await_ready		(void) const noexcept	{ return false; }
+		int		await_resume	(void) const noexcept	{ return this->user_val; }
+		bool
+		await_suspend(std::coroutine_handle<>) noexcept
+		{
+			this->user_val	= cothreadj_yield(this->cothread, this->user_val);
+			return false;
+		}
+};
+
+/**
+ * @brief		Runs the specified task from the specified fiber, which is parked until the task completes.
+ * @param		[in]	cothread	The fiber, spawned on a scheduler, whose callee is running.
+ * @param		[in]	coro		The task to run, never started yet.
+ * @return		Returns the task result, rethrows its exception.
+ * @note		The task starts on the fiber stack: if it completes without suspending, the fiber is not parked.
+ * @ingroup		doxy_cothreadj
+ */
+template <typename T> T
+sync_wait(cothreadj_t* cothread, task<T> coro)
+{
+	coro.handle.resume();
+	if (!coro.handle.done()) {
+		coro.handle.promise().fiber	= cothread;
+		cothreadj_sched_park(cothread);
+	}
+	return coro.result();
+}
+
+} /* namespace cothreadj */
+
+#endif /* defined(__cpp_impl_coroutine) */
+
+#endif /* __COTHREAD_COTHREADJ_CORO_HXX__ */
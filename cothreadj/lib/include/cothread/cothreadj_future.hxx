@@ -0,0 +1,220 @@
+/**
+ * @brief		This file contains the futures & the promises between cothreads.
+ * @file
+ *
+ * A [future](@ref cothreadj::future) holds its result inline and has a single waiter slot, which holds either
+ * the fiber parked in @ref cothreadj::future::get, or a continuation registered with @ref cothreadj::future::then:
+ * - the waiter publishes itself with a compare-and-swap on the empty slot ;
+ * - the [promise](@ref cothreadj::promise) constructs the result, then exchanges the slot with the ready mark:
+ *   a single atomic operation, which hands it the waiter to wake up (or the continuation to run inline), if any.
+ * .
+ * The promise may be fulfilled from another OS thread: the parked fiber is woken up through the inbox of its
+ * scheduler (see @ref cothreadj_sched_wake_remote.) Neither side allocates memory: the future lives on the stack of
+ * its owner, which must keep it alive (and in place) until fulfilled, and the promise merely points to it.
+ * This header requires C++17 (@c std::launder, @c decltype(auto)), it is empty otherwise (see @ref COTHREADJ_CXX17.)
+ */
+
+#ifndef __COTHREAD_COTHREADJ_FUTURE_HXX__
+#define __COTHREAD_COTHREADJ_FUTURE_HXX__
+
+/**
+ * @brief		Says whether the compiler supports C++17 or not (MSVC reports its standard through @c _MSVC_LANG only.)
+ * @ingroup		doxy_cothreadj
+ */
+#if ((201703L <= __cplusplus) || (defined(_MSVC_LANG) && (201703L <= _MSVC_LANG)))
+	#define COTHREADJ_CXX17		1
+#else
+	#define COTHREADJ_CXX17		0
+#endif
+
+#include <cothread/cothreadj_sched.h>
+
+#if COTHREADJ_CXX17
+#include <cothread/atomic.h>
+#include <assert.h>
+#include <new>
+#include <utility>
+
+namespace cothreadj {
+
+/// @cond
+namespace detail {
+	/**
+	 * @brief		The inline storage of a result.
+	 */
+	template <typename T>
+	struct future_storage
+	{
+		alignas(T) unsigned char	bytes[sizeof(T)];	///< @brief	The result, once constructed.
+
+		template <typename... A> void	construct	(A&&... args)	{ new (this->bytes) T(std::forward<A>(args)...); }
+		T&								get			(void) noexcept	{ return *std::launder(reinterpret_cast<T*>(this->bytes)); }
+		void							destroy		(void) noexcept	{ this->get().~T(); }
+	};
+
+	template <>
+	struct future_storage<void>
+	{
+		void	construct	(void) noexcept	{}
+		void	get			(void) noexcept	{}
+		void	destroy		(void) noexcept	{}
+	};
+
+	/**
+	 * @brief		The waiter parking a fiber, run as the continuation of the future.
+	 */
+	struct future_fiber
+	{
+		cothreadj_sched_task_t	node;		///< @brief	The continuation (first member.)
+		cothreadj_t*			cothread;	///< @brief	The parked fiber.
+
+		/**
+		 * @brief		Wakes up the fiber of the specified waiter, which must not be touched afterward.
+		 * @param		[in]	task	The continuation embedded in the waiter.
+		 */
+		static void COTHREAD_CALL
+		wake(cothreadj_sched_task_t* task)
+		{
+			cothreadj_sched_wake_remote(reinterpret_cast<future_fiber*>(task)->cothread);
+		}
+	};
+} /* namespace detail */
+/// @endcond
+
+template <typename T> class promise;
+
+/**
+ * @brief		A result which will be available later, waited for by a single fiber or continuation.
+ * @tparam		T	The result type.
+ * @note		The future is neither copyable nor movable, since its promise points to it.
+ * @ingroup		doxy_cothreadj
+ */
+template <typename T = void>
+class future
+{
+	private:
+		cothreadj_sched_task_t* volatile	slot;		///< @brief	The waiter, NULL if none, the ready mark once fulfilled.
+		detail::future_storage<T>			storage;	///< @brief	The result, once fulfilled.
+
+	private:
+		/**
+		 * @brief		Returns the ready mark, the address of the future itself (which is never a continuation.)
+		 * @return		Returns the ready mark.
+		 */
+		cothreadj_sched_task_t*	ready_mark	(void) const noexcept	{ return reinterpret_cast<cothreadj_sched_task_t*>(const_cast<future*>(this)); }
+
+		/**
+		 * @brief		Publishes the specified waiter unless the future has been fulfilled already.
+		 * @param		[in]	task	The waiter.
+		 * @return		Returns true if published, false if fulfilled already.
+		 */
+		bool
+		publish(cothreadj_sched_task_t* task) noexcept
+		{
+			assert(nullptr	== task->next);
+			return COTHREAD_ATOMIC_CAS_PTR(&(this->slot), static_cast<cothreadj_sched_task_t*>(nullptr), task);
+		}
+
+	public:
+					future	(void) noexcept : slot(nullptr)	{}
+					future	(const future&)	= delete;
+		future&		operator=	(const future&)	= delete;
+					~future	(void)	{ if (this->ready()) { this->storage.destroy(); } }
+
+	public:
+		/**
+		 * @brief		Returns the promise which fulfills the future.
+		 * @return		Returns the promise.
+		 */
+		promise<T>	get_promise	(void) noexcept	{ return promise<T>(this); }
+
+		/**
+		 * @brief		Says whether the future has been fulfilled or not.
+		 * @return		Returns true once the result is available.
+		 */
+		bool	ready	(void) const noexcept	{ return this->ready_mark() == COTHREAD_ATOMIC_LOAD_PTR(&(this->slot)); }
+
+		/**
+		 * @brief		Parks the specified fiber until the future is fulfilled, then returns the result.
+		 * @param		[in]	cothread	The fiber, spawned on a scheduler, whose callee is running.
+		 * @return		Returns a reference to the result, owned by the future.
+		 * @note		The fiber is not parked if the future has been fulfilled already.
+		 */
+		decltype(auto)
+		get(cothreadj_t* cothread)
+		{
+			if (!this->ready()) {
+				detail::future_fiber	waiter;
+				cothreadj_sched_task_init(&(waiter.node), &detail::future_fiber::wake);
+				waiter.cothread	= cothread;
+				if (this->publish(&(waiter.node))) {
+					cothreadj_sched_park(cothread);
+				}
+				assert(this->ready());
+			}
+			return this->storage.get();
+		}
+
+		/**
+		 * @brief		Runs the specified continuation once the future is fulfilled, inline, by the fulfilling party.
+		 * @param		[in]	task	The continuation, kept alive until run, & never posted to a scheduler.
+		 * @note		The continuation runs right away if the future has been fulfilled already,
+		 *				it may call @ref get (which does not park then.)
+		 */
+		void
+		then(cothreadj_sched_task_t* task) noexcept
+		{
+			if (!this->publish(task)) {
+				task->cb(task);
+			}
+		}
+
+	friend class promise<T>;
+};
+
+/**
+ * @brief		The fulfilling end of a @ref cothreadj::future, which may be handed over to another OS thread.
+ * @tparam		T	The result type.
+ * @ingroup		doxy_cothreadj
+ */
+template <typename T = void>
+class promise
+{
+	private:
+		future<T>*	state;	///< @brief	The future, NULL once fulfilled or moved.
+
+	private:
+		explicit	promise	(future<T>* state) noexcept : state(state)	{}
+	public:
+					promise	(promise&& other) noexcept : state(std::exchange(other.state, nullptr))	{}
+					promise	(const promise&)	= delete;
+		promise&	operator=	(const promise&)	= delete;
+					~promise	(void)	{ assert(nullptr == this->state); }
+
+	public:
+		/**
+		 * @brief		Constructs the result in place, then wakes the waiter up (or runs the continuation), if any.
+		 * @param		[in]	args	The arguments of the result constructor.
+		 * @note		The future must not be touched once fulfilled: its owner may destroy it right away.
+		 */
+		template <typename... A> void
+		set_value(A&&... args)
+		{
+			future<T>*	state	= std::exchange(this->state, nullptr);
+			assert(nullptr	!= state);
+			state->storage.construct(std::forward<A>(args)...);
+			cothreadj_sched_task_t*	waiter	= static_cast<cothreadj_sched_task_t*>(COTHREAD_ATOMIC_XCHG_PTR(&(state->slot), state->ready_mark()));
+			assert(state->ready_mark()	!= waiter);
+			if (nullptr != waiter) {
+				waiter->cb(waiter);
+			}
+		}
+
+	friend class future<T>;
+};
+
+} /* namespace cothreadj */
+
+#endif /* COTHREADJ_CXX17 */
+
+#endif /* __COTHREAD_COTHREADJ_FUTURE_HXX__ */
@@ -0,0 +1,118 @@
+/**
+ * @brief		This file contains the task group public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_GROUP_H__
+#define __COTHREAD_COTHREADJ_GROUP_H__
+
+#include <cothread/cothreadj_sched.h>
+
+/**
+ * @brief		The task group type, which owns the children a parent cothread fans out to.
+ * @note		The children are linked through their @ref _cothreadj_t::group_next member: a group never allocates memory.
+ *				A child fails by returning a negative value, which cancels its siblings (see @ref cothreadj_group_cancel.)
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_group_t
+{
+	cothreadj_sched_t*	sched;			///< @brief	The scheduler the children are spawned on.
+	cothreadj_t*		children;		///< @brief	The children, the last spawned one first, NULL if none.
+	cothreadj_t*		parent;			///< @brief	The cothread parked in a join, NULL if none.
+	cothreadj_t*		first_done;		///< @brief	The first child whose callee has returned, NULL if none.
+	cothreadj_t*		first_failed;	///< @brief	The first child whose callee has returned a negative value before being cancelled, NULL if none.
+	size_t				nb_alive;		///< @brief	The number of children whose callee has not returned yet.
+	int					join_any;		///< @brief	Says whether the parked parent waits for any child or for all of them.
+	int					cancelled;		///< @brief	Says whether the children have been cancelled or not.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified group.
+ * @param		[in]	group	The group to initialize.
+ * @param		[in]	sched	The scheduler to spawn the children on.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_group_init	(cothreadj_group_t* group, cothreadj_sched_t* sched);
+
+/**
+ * @brief		Spawns the specified child in the specified group.
+ * @param		[in]	group		The group.
+ * @param		[in]	cothread	The child, initialized but never yielded yet (see @ref cothreadj_sched_spawn.)
+ * @note		A child spawned in a cancelled group is cancelled at once.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_group_spawn	(cothreadj_group_t* group, cothreadj_t* cothread);
+
+/**
+ * @brief		Parks the specified parent until every child of the specified group has returned.
+ * @param		[in]	group		The group.
+ * @param		[in]	cothread	The parent, a spawned cothread of the group scheduler whose callee is running.
+ * @return		Returns the first child which has failed, NULL if none (a cancelled child never fails.)
+ * @note		The first failure cancels the siblings, which are still waited for: no child outlives the join.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK cothreadj_t*	COTHREAD_CALL cothreadj_group_join_all	(cothreadj_group_t* group, cothreadj_t* cothread);
+
+/**
+ * @brief		Parks the specified parent until a child of the specified group has returned, then cancels the others.
+ * @param		[in]	group		The group, with at least one child.
+ * @param		[in]	cothread	The parent, a spawned cothread of the group scheduler whose callee is running.
+ * @return		Returns the first child which has returned (whatever its value.)
+ * @note		The cancelled children may still be running: @ref cothreadj_group_join_all waits for them.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK cothreadj_t*	COTHREAD_CALL cothreadj_group_join_any	(cothreadj_group_t* group, cothreadj_t* cothread);
+
+/**
+ * @brief		Cancels the children of the specified group which have not returned yet.
+ * @param		[in]	group	The group.
+ * @note		The cancellation is cooperative: each child sees it through @ref cothreadj_group_is_cancelled
+ *				(at its scheduling points, typically) and is expected to return a negative value early.
+ *				The children parked in @ref cothreadj_group_park are woken up. The ones parked otherwise
+ *				(@ref cothreadj_sched_park, the synchronization primitives, which hand a resource over to their
+ *				waiters) are not: they only see the cancellation once their waker has made them ready.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_group_cancel	(cothreadj_group_t* group);
+
+/**
+ * @brief		Parks the specified child until it is woken up by @ref cothreadj_group_wake or cancelled.
+ * @param		[in]	cothread	The child, a spawned cothread of the group scheduler whose callee is running.
+ * @return		Returns non-zero if the child has been cancelled (it is not parked if it already was), zero otherwise.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK int			COTHREAD_CALL cothreadj_group_park	(cothreadj_t* cothread);
+
+/**
+ * @brief		Wakes the specified child up if it is parked in @ref cothreadj_group_park.
+ * @param		[in]	cothread	The child.
+ * @note		Does nothing if the child is not parked there, e.g. once the cancellation has woken it up.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_group_wake	(cothreadj_t* cothread);
+
+/**
+ * @brief		Says whether the specified child has been cancelled or not.
+ * @param		[in]	cothread	The child.
+ * @return		Returns non-zero if the child has been cancelled, zero otherwise (also if not spawned in a group.)
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK int			COTHREAD_CALL cothreadj_group_is_cancelled	(const cothreadj_t* cothread);
+
+/**
+ * @brief		Returns the value the specified child has returned.
+ * @param		[in]	cothread	The child, whose callee has returned.
+ * @return		Returns the value returned by the callee.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK int			COTHREAD_CALL cothreadj_group_get_ret	(const cothreadj_t* cothread);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_GROUP_H__ */
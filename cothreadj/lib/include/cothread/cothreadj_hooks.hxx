@@ -0,0 +1,73 @@
+/**
+ * @brief		This file contains the compile-time switch hooks.
+ * @file
+ *
+ * A hooks policy is any type providing two static functions, called with the cothread:
+ * - @c on_resume, right before its callee is resumed (or started) ;
+ * - @c on_suspend, right after its callee has yielded back (or returned.)
+ * .
+ * The policy is bound at compile time by @ref cothreadj::resume, which the caller calls instead of @ref cothreadj_yield.
+ * Several policies are combined with @ref cothreadj::hooks_chain, e.g. a global one with a per-cothread one.
+ * With @ref cothreadj::no_hooks (the default), @ref cothreadj::resume is a plain call to @ref cothreadj_yield.
+ * Unlike the hooks registered with @ref cothreadj_set_hooks, these ones do not need @ref COTHREAD_WITH_HOOKS,
+ * but only apply to the switches made through @ref cothreadj::resume (not to the ones of a scheduler.)
+ */
+
+#ifndef __COTHREAD_COTHREADJ_HOOKS_HXX__
+#define __COTHREAD_COTHREADJ_HOOKS_HXX__
+
+#include <cothread/cothreadj.h>
+
+namespace cothreadj {
+
+/**
+ * @brief		The hooks policy doing nothing.
+ * @ingroup		doxy_cothreadj
+ */
+struct no_hooks
+{
+	static void	on_resume	(cothreadj_t*) noexcept	{}
+	static void	on_suspend	(cothreadj_t*) noexcept	{}
+};
+
+/**
+ * @brief		The hooks policy calling the resume hooks of the specified policies in order, and their suspend hooks in
+ *				the reverse order.
+ * @tparam		H	The policies.
+ * @ingroup		doxy_cothreadj
+ */
+template <typename... H>
+struct hooks_chain : no_hooks
+{
+};
+
+/// @cond
+template <typename H, typename... T>
+struct hooks_chain<H, T...>
+{
+	static void	on_resume	(cothreadj_t* cothread)	{ H::on_resume(cothread); hooks_chain<T...>::on_resume(cothread); }
+	static void	on_suspend	(cothreadj_t* cothread)	{ hooks_chain<T...>::on_suspend(cothread); H::on_suspend(cothread); }
+};
+/// @endcond
+
+/**
+ * @brief		Resumes the callee of the specified cothread, calling the hooks of the specified policy around the switch.
+ * @tparam		Hooks		The hooks policy.
+ * @param		[in]	cothread	The cothread, whose caller is running.
+ * @param		[in]	user_val	Any user value (except zero) to send to the callee.
+ * @return		Returns the user value the callee yields back (or returns.)
+ * @ingroup		doxy_cothreadj
+ */
+template <typename Hooks = no_hooks>
+inline int
+resume(cothreadj_t* cothread, int user_val)
+{
+	Hooks::on_resume(cothread);
+	const int	ret	= cothreadj_yield(cothread, user_val);
+	Hooks::on_suspend(cothread);
+	return ret;
+}
+
+} /* namespace cothreadj */
+
+#endif /* __COTHREAD_COTHREADJ_HOOKS_HXX__ */
@@ -0,0 +1,172 @@
+/**
+ * @brief		This file contains the shared-nothing mesh public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_MESH_H__
+#define __COTHREAD_COTHREADJ_MESH_H__
+
+#include <cothread/cothreadj_sched.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothreadj
+/// @{
+typedef struct _cothreadj_mesh_t		cothreadj_mesh_t;		///< @brief	The shared-nothing mesh type.
+typedef struct _cothreadj_mesh_core_t	cothreadj_mesh_core_t;	///< @brief	The core type (opaque.)
+typedef struct _cothreadj_mesh_ring_t	cothreadj_mesh_ring_t;	///< @brief	The single-producer single-consumer ring type (opaque.)
+typedef struct _cothreadj_mesh_msg_t	cothreadj_mesh_msg_t;	///< @brief	The cross-core message type.
+/// @}
+
+/**
+ * @brief		The main callback, run by a cothread spawned on each core.
+ * @param		[in]	cothread	The main cothread of the core (see @ref cothreadj_mesh_core_id.)
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj
+ */
+typedef void (COTHREAD_CALL * cothreadj_mesh_main_cb_t) (cothreadj_t* cothread, void* user_data);
+
+/**
+ * @brief		The message callback, run by the destination core.
+ * @param		[in]	sched	The scheduler of the destination core.
+ * @param		[in]	msg		The message.
+ * @note		The callback runs on the scheduler stack of the destination core, in between its cothreads:
+ *				it must not park, but may spawn cothreads on @e sched.
+ * @ingroup		doxy_cothreadj
+ */
+typedef void (COTHREAD_CALL * cothreadj_mesh_msg_cb_t) (cothreadj_sched_t* sched, cothreadj_mesh_msg_t* msg);
+
+/**
+ * @brief		The cross-core message type, which serves as the future of its request.
+ * @note		The message is owned by the submitter: it is sent to the destination core, which runs its callback,
+ *				then sent back to the source core, which marks it done & wakes the waiting cothread up, if any.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_mesh_msg_t
+{
+	cothreadj_mesh_msg_t*	next;		///< @brief	The next message of the backlog it belongs to, NULL if none.
+	cothreadj_mesh_msg_cb_t	cb;			///< @brief	The callback, run by the destination core.
+	void*					user_data;	///< @brief	Any user data.
+	cothreadj_t*			waiter;		///< @brief	The cothread parked until the message is done, NULL if none.
+	size_t					src;		///< @brief	The index of the source core.
+	size_t					dst;		///< @brief	The index of the destination core.
+	int						state;		///< @brief	The state (sent or done), touched by the source core only, private.
+};
+
+/**
+ * @brief		The shared-nothing mesh type, one pinned OS thread per core, each one running a scheduler.
+ * @note		The cores share no state: they only talk through fixed-size single-producer single-consumer rings,
+ *				one per ordered pair of cores.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_mesh_t
+{
+	cothreadj_mesh_core_t*	cores;		///< @brief	The cores.
+	size_t					nb_cores;	///< @brief	The number of cores.
+	cothreadj_mesh_ring_t*	rings;		///< @brief	The rings, the one from core @e i to core @e j at @e i * @ref nb_cores + @e j.
+	void**					slots;		///< @brief	The slots of all the rings.
+	size_t					ring_sz;	///< @brief	The number of slots of each ring, a power of two.
+	cothreadj_mesh_main_cb_t	main_cb;	///< @brief	The main callback of the run in progress, NULL if none.
+	void*					user_data;	///< @brief	The user data of the run in progress.
+	volatile long			nb_busy;	///< @brief	The number of cores with alive cothreads or messages to send.
+	volatile long			stopping;	///< @brief	Says whether the run is over or not.
+	volatile long			gate;		///< @brief	Zero until every OS thread of the run is started, then one, or minus one to abort the run.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified mesh.
+ * @param		[in]	mesh		The mesh to initialize.
+ * @param		[in]	nb_cores	The number of cores, zero for as many as there are online CPUs.
+ * @param		[in]	ring_sz		The number of slots of each ring, rounded up to a power of two, zero for 256.
+ * @param		[in]	stack_sz	The size of the stack of the main cothread of each core, in bytes.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if the cores or the rings cannot be allocated.
+ *				.
+ * @relates		_cothreadj_mesh_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_mesh_init		(cothreadj_mesh_t* mesh, size_t nb_cores, size_t ring_sz, size_t stack_sz);
+
+/**
+ * @brief		Uninitializes the specified mesh.
+ * @param		[in]	mesh	The mesh to uninitialize, which is not running.
+ * @relates		_cothreadj_mesh_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_mesh_uninit		(cothreadj_mesh_t* mesh);
+
+/**
+ * @brief		Starts one OS thread per core, pinned to a CPU where supported, runs the specified main callback
+ *				on each core, then waits for the run to be over.
+ * @param		[in]	mesh		The mesh.
+ * @param		[in]	main_cb		The main callback.
+ * @param		[in]	user_data	Any user data to give to the main callback.
+ * @return		Returns
+ *				- @ref cothread_err_ok once every cothread of every core has returned ;
+ *				- @ref cothread_err_notsup if the OS threads cannot be started.
+ *				.
+ * @note		Every message has to be waited for (see @ref cothreadj_mesh_wait) before its submitter returns:
+ *				the run is over once no core has any alive cothread, which then implies no message is in flight.
+ * @relates		_cothreadj_mesh_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_mesh_run		(cothreadj_mesh_t* mesh, cothreadj_mesh_main_cb_t main_cb, void* user_data);
+
+/**
+ * @brief		Returns the index of the core the specified cothread runs on.
+ * @param		[in]	cothread	A cothread spawned on the scheduler of a core.
+ * @return		Returns the index of the core.
+ * @relates		_cothreadj_mesh_t
+ */
+extern COTHREAD_LINK size_t			COTHREAD_CALL cothreadj_mesh_core_id	(const cothreadj_t* cothread);
+
+/**
+ * @brief		Returns the mesh the specified cothread runs on.
+ * @param		[in]	cothread	A cothread spawned on the scheduler of a core.
+ * @return		Returns the mesh.
+ * @relates		_cothreadj_mesh_t
+ */
+extern COTHREAD_LINK cothreadj_mesh_t*	COTHREAD_CALL cothreadj_mesh_get	(const cothreadj_t* cothread);
+
+/**
+ * @brief		Initializes the specified message.
+ * @param		[in]	msg			The message to initialize.
+ * @param		[in]	cb			The callback, run by the destination core.
+ * @param		[in]	user_data	Any user data.
+ * @relates		_cothreadj_mesh_msg_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_mesh_msg_init	(cothreadj_mesh_msg_t* msg, cothreadj_mesh_msg_cb_t cb, void* user_data);
+
+/**
+ * @brief		Sends the specified message to the specified core, which runs its callback.
+ * @param		[in]	cothread	The calling cothread, spawned on the scheduler of a core.
+ * @param		[in]	core		The index of the destination core. The callback of a message to the calling core is run inline.
+ * @param		[in]	msg			The message, initialized & not in flight, which must outlive its completion.
+ * @note		This function never blocks nor allocates: a message which does not fit in its ring is kept in
+ *				a backlog of the source core, until the destination core makes room.
+ * @relates		_cothreadj_mesh_msg_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_mesh_submit		(cothreadj_t* cothread, size_t core, cothreadj_mesh_msg_t* msg);
+
+/**
+ * @brief		Says whether the callback of the specified message has run & its completion is back or not.
+ * @param		[in]	msg		The submitted message.
+ * @return		Returns non-zero if the message is done, zero otherwise.
+ * @relates		_cothreadj_mesh_msg_t
+ */
+extern COTHREAD_LINK int			COTHREAD_CALL cothreadj_mesh_is_done	(const cothreadj_mesh_msg_t* msg);
+
+/**
+ * @brief		Parks the specified cothread until the specified message is done.
+ * @param		[in]	msg			The submitted message, waited for by a single cothread.
+ * @param		[in]	cothread	The calling cothread, the one which submitted the message.
+ * @relates		_cothreadj_mesh_msg_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_mesh_wait		(cothreadj_mesh_msg_t* msg, cothreadj_t* cothread);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_MESH_H__ */
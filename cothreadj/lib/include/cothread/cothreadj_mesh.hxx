@@ -0,0 +1,116 @@
+/**
+ * @brief		This file contains the cross-core requests of the shared-nothing mesh.
+ * @file
+ *
+ * @ref cothreadj::submit_to runs a callable on another core of the [mesh](@ref _cothreadj_mesh_t) and returns
+ * a [future](@ref cothreadj::mesh_future) of its result. The future embeds the message, the callable and the result:
+ * it is returned in place (neither copyable nor movable), lives on the stack of the submitting cothread, and nothing
+ * is allocated. The callable runs on the scheduler stack of the destination core (see @ref cothreadj_mesh_msg_cb_t),
+ * and must not throw. This header requires C++17 (the future is returned through the guaranteed copy elision),
+ * it is empty otherwise (see @ref COTHREADJ_CXX17.)
+ */
+
+#ifndef __COTHREAD_COTHREADJ_MESH_HXX__
+#define __COTHREAD_COTHREADJ_MESH_HXX__
+
+#include <cothread/cothreadj_mesh.h>
+#include <cothread/cothreadj_future.hxx>
+
+#if COTHREADJ_CXX17
+#include <type_traits>
+
+namespace cothreadj {
+
+/**
+ * @brief		The result of a callable run on another core, waited for by the submitting cothread only.
+ * @tparam		F	The callable type.
+ * @note		The future is neither copyable nor movable, since the destination core points to it.
+ *				Destroying it parks the submitting cothread until the result is back, if not waited for yet (see @ref get.)
+ * @ingroup		doxy_cothreadj
+ */
+template <typename F>
+class mesh_future
+{
+	public:
+		using value_type	= std::invoke_result_t<F&>;	///< @brief	The result type.
+
+	private:
+		cothreadj_mesh_msg_t					msg;		///< @brief	The message, whose user data is the future.
+		cothreadj_t*							cothread;	///< @brief	The submitting cothread.
+		F										fn;			///< @brief	The callable.
+		detail::future_storage<value_type>		storage;	///< @brief	The result, once done.
+
+	private:
+		/**
+		 * @brief		Runs the callable of the future embedding the specified message, on the destination core.
+		 * @param		[in]	sched	The scheduler of the destination core.
+		 * @param		[in]	msg		The message.
+		 */
+		static void COTHREAD_CALL
+		run(cothreadj_sched_t* sched, cothreadj_mesh_msg_t* msg)
+		{
+			mesh_future*	self	= static_cast<mesh_future*>(msg->user_data);
+			if constexpr (std::is_void_v<value_type>) {
+				self->fn();
+			} else {
+				self->storage.construct(self->fn());
+			}
+		}
+
+	public:
+		/**
+		 * @brief		Submits the specified callable to the specified core.
+		 * @param		[in]	cothread	The calling cothread, spawned on the scheduler of a core.
+		 * @param		[in]	core		The index of the destination core.
+		 * @param		[in]	fn			The callable.
+		 */
+		template <typename G>
+		mesh_future(cothreadj_t* cothread, size_t core, G&& fn) : cothread(cothread), fn(std::forward<G>(fn))
+		{
+			cothreadj_mesh_msg_init(&(this->msg), &mesh_future::run, this);
+			cothreadj_mesh_submit(cothread, core, &(this->msg));
+		}
+						mesh_future	(const mesh_future&)	= delete;
+		mesh_future&	operator=	(const mesh_future&)	= delete;
+						~mesh_future	(void)	{ cothreadj_mesh_wait(&(this->msg), this->cothread); this->storage.destroy(); }
+
+	public:
+		/**
+		 * @brief		Says whether the callable has run & its result is back or not.
+		 * @return		Returns true once the result is available.
+		 */
+		bool	ready	(void) const noexcept	{ return cothreadj_mesh_is_done(&(this->msg)); }
+
+		/**
+		 * @brief		Parks the specified cothread until the result is back, then returns it.
+		 * @param		[in]	cothread	The submitting cothread.
+		 * @return		Returns a reference to the result, owned by the future.
+		 */
+		decltype(auto)
+		get(cothreadj_t* cothread)
+		{
+			cothreadj_mesh_wait(&(this->msg), cothread);
+			return this->storage.get();
+		}
+};
+
+/**
+ * @brief		Runs the specified callable on the specified core.
+ * @param		[in]	cothread	The calling cothread, spawned on the scheduler of a core.
+ * @param		[in]	core		The index of the destination core, the callable being run inline if the calling one.
+ * @param		[in]	fn			The callable, copied or moved into the future.
+ * @return		Returns the future of the result.
+ * @ingroup		doxy_cothreadj
+ */
+template <typename F>
+mesh_future<std::decay_t<F>>
+submit_to(cothreadj_t* cothread, size_t core, F&& fn)
+{
+	return mesh_future<std::decay_t<F>>(cothread, core, std::forward<F>(fn));
+}
+
+} /* namespace cothreadj */
+
+#endif /* COTHREADJ_CXX17 */
+
+#endif /* __COTHREAD_COTHREADJ_MESH_HXX__ */
@@ -0,0 +1,123 @@
+/**
+ * @brief		This file contains the parallel loops public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_PARALLEL_H__
+#define __COTHREAD_COTHREADJ_PARALLEL_H__
+
+#include <cothread/cothreadj_sched.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothreadj
+/// @{
+typedef struct _cothreadj_pool_t			cothreadj_pool_t;			///< @brief	The worker pool type.
+typedef struct _cothreadj_pool_worker_t		cothreadj_pool_worker_t;	///< @brief	The worker type (opaque.)
+/// @}
+
+/**
+ * @brief		The parallel-for body.
+ * @param		[in]	cothread	The worker cothread, which may call @ref cothreadj_sched_yield in between.
+ * @param		[in]	begin		The first index of the chunk.
+ * @param		[in]	end			The index following the last one of the chunk.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj
+ */
+typedef void (COTHREAD_CALL * cothreadj_parallel_for_cb_t) (cothreadj_t* cothread, size_t begin, size_t end, void* user_data);
+
+/**
+ * @brief		The parallel-reduce body, which accumulates a chunk into the partial result of the worker.
+ * @param		[in]	cothread	The worker cothread, which may call @ref cothreadj_sched_yield in between.
+ * @param		[in]	begin		The first index of the chunk.
+ * @param		[in]	end			The index following the last one of the chunk.
+ * @param		[in]	acc			The partial result of the worker.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj
+ */
+typedef void (COTHREAD_CALL * cothreadj_parallel_map_cb_t) (cothreadj_t* cothread, size_t begin, size_t end, void* acc, void* user_data);
+
+/**
+ * @brief		The parallel-reduce combiner, which must be associative & commutative.
+ * @param		[in]	acc			The partial result to combine into.
+ * @param		[in]	other		The partial result to combine.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj
+ */
+typedef void (COTHREAD_CALL * cothreadj_parallel_reduce_cb_t) (void* acc, const void* other, void* user_data);
+
+/**
+ * @brief		The worker pool type, one OS thread per worker, each one running a scheduler.
+ * @note		A pool runs a single parallel loop at a time, whose bodies must not start another loop on the same pool.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_pool_t
+{
+	cothreadj_pool_worker_t*	workers;	///< @brief	The workers.
+	size_t						nb_workers;	///< @brief	The number of workers.
+	void* volatile				job;		///< @brief	The parallel loop in progress, NULL if none.
+	volatile long				nb_ready;	///< @brief	The number of workers waiting for their first loop.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified pool & starts its workers.
+ * @param		[in]	pool		The pool to initialize.
+ * @param		[in]	nb_workers	The number of workers, zero for as many as there are online CPUs.
+ * @param		[in]	stack_sz	The size of the stack of each worker cothread, in bytes.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if the workers cannot be allocated ;
+ *				- @ref cothread_err_notsup if the OS threads cannot be started.
+ *				.
+ * @relates		_cothreadj_pool_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_pool_init	(cothreadj_pool_t* pool, size_t nb_workers, size_t stack_sz);
+
+/**
+ * @brief		Stops the workers of the specified pool & uninitializes it.
+ * @param		[in]	pool	The pool to uninitialize, with no parallel loop in progress.
+ * @relates		_cothreadj_pool_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_pool_uninit	(cothreadj_pool_t* pool);
+
+/**
+ * @brief		Calls the specified body over the chunks of the specified range, in parallel.
+ * @param		[in]	pool		The pool.
+ * @param		[in]	cothread	The calling cothread, spawned on a scheduler, which is parked until the loop is over.
+ * @param		[in]	begin		The first index of the range.
+ * @param		[in]	end			The index following the last one of the range.
+ * @param		[in]	grain		The minimum number of indexes of a chunk, zero for one.
+ * @param		[in]	cb			The body.
+ * @param		[in]	user_data	Any user data to give to the body.
+ * @note		The chunks shrink as the range is consumed (see parallel.c.)
+ *				A range no larger than the grain is run inline, by the calling cothread.
+ * @relates		_cothreadj_pool_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_parallel_for	(cothreadj_pool_t* pool, cothreadj_t* cothread, size_t begin, size_t end, size_t grain, cothreadj_parallel_for_cb_t cb, void* user_data);
+
+/**
+ * @brief		Accumulates the specified range in parallel, then combines the partial results.
+ * @param		[in]	pool		The pool.
+ * @param		[in]	cothread	The calling cothread, spawned on a scheduler, which is parked until the loop is over.
+ * @param		[in]	begin		The first index of the range.
+ * @param		[in]	end			The index following the last one of the range.
+ * @param		[in]	grain		The minimum number of indexes of a chunk, zero for one.
+ * @param		[in]	map_cb		The body.
+ * @param		[in]	reduce_cb	The combiner.
+ * @param		[in]	accs		The partial results, one per worker (see @ref _cothreadj_pool_t::nb_workers),
+ *									each one of @e acc_sz bytes & initialized to the identity of the combiner.
+ *									The first one receives the result.
+ * @param		[in]	acc_sz		The size of a partial result, in bytes.
+ * @param		[in]	user_data	Any user data to give to the body & the combiner.
+ * @relates		_cothreadj_pool_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_parallel_reduce	(cothreadj_pool_t* pool, cothreadj_t* cothread, size_t begin, size_t end, size_t grain, cothreadj_parallel_map_cb_t map_cb, cothreadj_parallel_reduce_cb_t reduce_cb, void* accs, size_t acc_sz, void* user_data);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_PARALLEL_H__ */
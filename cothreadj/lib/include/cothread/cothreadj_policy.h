@@ -0,0 +1,108 @@
+/**
+ * @brief		This file contains the scheduling policies public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_POLICY_H__
+#define __COTHREAD_COTHREADJ_POLICY_H__
+
+#include <cothread/cothreadj_sched.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothreadj
+/// @{
+typedef struct _cothreadj_fifo_t	cothreadj_fifo_t;	///< @brief	The FIFO policy type.
+typedef struct _cothreadj_prio_t	cothreadj_prio_t;	///< @brief	The strict priority policy type.
+typedef struct _cothreadj_edf_t		cothreadj_edf_t;	///< @brief	The earliest deadline first policy type.
+/// @}
+
+/**
+ * @brief		The number of priority levels of the strict priority policy.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_PRIO_NB_LEVELS	32
+
+/**
+ * @brief		The FIFO policy type, which resumes the cothreads in the order they are made ready.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_fifo_t
+{
+	cothreadj_policy_t	policy;	///< @brief	The policy (first member.)
+	cothreadj_queue_t	queue;	///< @brief	The ready cothreads.
+};
+
+/**
+ * @brief		The strict priority policy type, which resumes the cothreads of the highest priority level first,
+ *				in the FIFO order within a level.
+ * @note		The priority level is set with @ref cothreadj_set_prio. Pushing & popping are O(1).
+ *				The cothreads of a level are not resumed as long as a higher one has ready cothreads.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_prio_t
+{
+	cothreadj_policy_t	policy;	///< @brief	The policy (first member.)
+	unsigned long		mask;	///< @brief	The levels with ready cothreads, one bit per level.
+	cothreadj_queue_t	queues[COTHREADJ_PRIO_NB_LEVELS];	///< @brief	The ready cothreads of each level, the highest one first.
+};
+
+/**
+ * @brief		The earliest deadline first policy type, which resumes the cothread with the earliest deadline first,
+ *				in the FIFO order between equal deadlines.
+ * @note		The deadline is set with @ref cothreadj_set_deadline. The ready cothreads are linked in an intrusive
+ *				pairing heap: pushing is O(1), popping is O(log n) amortized, and neither allocates memory.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_edf_t
+{
+	cothreadj_policy_t	policy;		///< @brief	The policy (first member.)
+	cothreadj_t*		root;		///< @brief	The root of the heap, i.e. the cothread with the earliest deadline, NULL if none.
+	uint64_t			nb_pushes;	///< @brief	The number of cothreads made ready so far.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified FIFO policy.
+ * @param		[in]	fifo	The policy to initialize.
+ * @relates		_cothreadj_fifo_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_fifo_init	(cothreadj_fifo_t* fifo);
+
+/**
+ * @brief		Initializes the specified strict priority policy.
+ * @param		[in]	prio	The policy to initialize.
+ * @relates		_cothreadj_prio_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_prio_init	(cothreadj_prio_t* prio);
+
+/**
+ * @brief		Initializes the specified earliest deadline first policy.
+ * @param		[in]	edf		The policy to initialize.
+ * @relates		_cothreadj_edf_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_edf_init	(cothreadj_edf_t* edf);
+
+/**
+ * @brief		Sets the priority level of the specified cothread.
+ * @param		[in]	cothread	The cothread, which is not ready (e.g. its callee is running, or it is not spawned yet.)
+ * @param		[in]	level		The priority level, from zero (the highest, default) to @ref COTHREADJ_PRIO_NB_LEVELS excluded.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_set_prio	(cothreadj_t* cothread, unsigned int level);
+
+/**
+ * @brief		Sets the deadline of the specified cothread.
+ * @param		[in]	cothread	The cothread, which is not ready (e.g. its callee is running, or it is not spawned yet.)
+ * @param		[in]	deadline_ns	The deadline, in nanoseconds on the clock of @ref cothread_ticks_ns (zero by default.)
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_set_deadline	(cothreadj_t* cothread, uint64_t deadline_ns);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_POLICY_H__ */
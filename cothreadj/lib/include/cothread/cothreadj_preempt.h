@@ -0,0 +1,51 @@
+/**
+ * @brief		This file contains the preemption public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_PREEMPT_H__
+#define __COTHREAD_COTHREADJ_PREEMPT_H__
+
+#include <cothread/cothreadj_sched.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Starts slicing the time of the calling OS thread.
+ * @param		[in]	slice_us	The CPU time a callee may run before it is expired, in microseconds.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_PREEMPT
+ *				or if the timer cannot be created.
+ *				.
+ * @note		A per-thread timer signal marks the running callee expired once it has run for a whole slice,
+ *				the callee then yields at its next call to @ref cothreadj_checkpoint. The slices are measured
+ *				in CPU time of the OS thread, so a blocked or descheduled OS thread is not ticked. The preemption owns the
+ *				@c SIGVTALRM signal while any OS thread is sliced. Starting an already sliced OS thread changes its slice.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_preempt_start	(unsigned long slice_us);
+
+/**
+ * @brief		Stops slicing the time of the calling OS thread.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_preempt_stop	(void);
+
+/**
+ * @brief		Yields back to the scheduler if the calling callee has expired its slice.
+ * @param		[in]	cothread	The cothread, whose callee is running, spawned on a scheduler.
+ * @return		Returns non-zero if the callee has yielded, zero otherwise.
+ * @note		This function costs a thread-local load and a compare when the slice has not expired,
+ *				and always returns zero if the library is built without @ref COTHREAD_WITH_PREEMPT.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK int			COTHREAD_CALL cothreadj_checkpoint		(cothreadj_t* cothread);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_PREEMPT_H__ */
@@ -0,0 +1,70 @@
+/**
+ * @brief		This file contains the sampling profiler public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_PROF_H__
+#define __COTHREAD_COTHREADJ_PROF_H__
+
+#include <cothread/cothreadj.h>
+
+/**
+ * @brief		The maximum number of frames recorded per sample.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_PROF_NB_FRAMES_MAX	32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Starts sampling the process.
+ * @param		[in]	nb_samples_max	The maximum number of samples to record, the next ones are dropped.
+ * @param		[in]	period_us		The sampling period, in microseconds of CPU time consumed by the process.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if the samples cannot be allocated ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_PROFILER,
+ *				if the platform is not supported or if the timer cannot be created.
+ *				.
+ * @note		The previously recorded samples are discarded. The profiler owns the @c SIGPROF signal until
+ *				@ref cothreadj_prof_stop is called.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_prof_start	(size_t nb_samples_max, unsigned long period_us);
+
+/**
+ * @brief		Stops sampling the process, the recorded samples are kept until dumped or released.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_prof_stop	(void);
+
+/**
+ * @brief		Writes the recorded samples to the specified stream, in the "folded stacks" format of the flamegraph tools.
+ * @param		[in]	strm	The stream to write the samples to.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_PROFILER
+ *				or if the platform is not supported.
+ *				.
+ * @note		Each line starts with the debug name of the callee running when the sample was taken
+ *				(@c [thread] if none), followed by the frames from the outermost to the innermost one.
+ *				A frame is named after its dynamic symbol if any, @c module+offset otherwise.
+ *				This function shall not be called while sampling.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_prof_dump	(FILE* strm);
+
+/**
+ * @brief		Releases the recorded samples.
+ * @note		This function shall not be called while sampling.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_prof_release	(void);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_PROF_H__ */
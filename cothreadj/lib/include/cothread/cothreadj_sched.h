@@ -0,0 +1,271 @@
+/**
+ * @brief		This file contains the scheduler public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_SCHED_H__
+#define __COTHREAD_COTHREADJ_SCHED_H__
+
+#include <cothread/cothreadj.h>
+#include <stdint.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothreadj
+/// @{
+typedef struct _cothreadj_queue_t	cothreadj_queue_t;	///< @brief	The cothread queue type.
+typedef struct _cothreadj_sched_task_t	cothreadj_sched_task_t;	///< @brief	The scheduler task type.
+typedef struct _cothreadj_policy_t	cothreadj_policy_t;	///< @brief	The scheduling policy type.
+/// @}
+
+/**
+ * @brief		The value the scheduler and the scheduled callees exchange through @ref cothreadj_yield.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_SCHED_VAL		1
+
+/**
+ * @brief		The number of cothreads a scheduler resumes while a callee stays parked before trimming its stack
+ *				(see @ref cothreadj_sched_set_trim.)
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_SCHED_TRIM_NB_PASSES	64
+
+/**
+ * @brief		The intrusive FIFO cothread queue type.
+ * @note		The cothreads are linked through their @ref _cothreadj_t::next member,
+ *				so a cothread may only be linked in a single queue at a time.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_queue_t
+{
+	cothreadj_t*	head;	///< @brief	The first cothread of the queue, NULL if empty.
+	cothreadj_t*	tail;	///< @brief	The last cothread of the queue, NULL if empty.
+};
+
+/**
+ * @brief		The task callback.
+ * @param		[in]	task	The task, which may be posted again from the callback.
+ * @ingroup		doxy_cothreadj
+ */
+typedef void (COTHREAD_CALL * cothreadj_sched_task_cb_t) (cothreadj_sched_task_t* task);
+
+/**
+ * @brief		The intrusive scheduler task type, a callback run on the scheduler stack.
+ * @note		A task is usually embedded in a larger object (such as the awaiter of a C++20 coroutine,
+ *				see cothreadj_coro.hxx), so that posting it never allocates memory.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_sched_task_t
+{
+	cothreadj_sched_task_t*		next;	///< @brief	The next posted task, NULL if none.
+	cothreadj_sched_task_cb_t	cb;		///< @brief	The callback.
+};
+
+/**
+ * @brief		The callback making the specified cothread ready, according to the specified policy.
+ * @param		[in]	policy		The policy.
+ * @param		[in]	cothread	The cothread to make ready, which is not linked in any queue.
+ * @ingroup		doxy_cothreadj
+ */
+typedef void (COTHREAD_CALL * cothreadj_policy_push_cb_t) (cothreadj_policy_t* policy, cothreadj_t* cothread);
+
+/**
+ * @brief		The callback removing the next cothread to resume, according to the specified policy.
+ * @param		[in]	policy		The policy.
+ * @return		Returns the removed cothread (whose @ref _cothreadj_t::next member is NULL), NULL if none is ready.
+ * @ingroup		doxy_cothreadj
+ */
+typedef cothreadj_t* (COTHREAD_CALL * cothreadj_policy_pop_cb_t) (cothreadj_policy_t* policy);
+
+/**
+ * @brief		The scheduling policy type, which orders the ready cothreads of a scheduler.
+ * @note		A policy is embedded as the first member of a larger object holding its run queue,
+ *				such as the ones of cothreadj_policy.h. It may link the cothreads through their
+ *				@ref _cothreadj_t::next and @ref _cothreadj_t::sched_child members, and order them by their
+ *				@ref _cothreadj_t::sched_key one.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_policy_t
+{
+	cothreadj_policy_push_cb_t	push;	///< @brief	Makes a cothread ready.
+	cothreadj_policy_pop_cb_t	pop;	///< @brief	Removes the next cothread to resume.
+};
+
+/**
+ * @brief		The scheduler type.
+ * @note		A scheduler belongs to a single OS thread and never uses atomic operations,
+ *				except for its inbox, the only member other OS threads touch (see @ref cothreadj_sched_wake_remote.)
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_sched_t
+{
+	cothreadj_queue_t	ready;		///< @brief	The cothreads ready to be resumed, unless a policy is set.
+	cothreadj_policy_t*	policy;		///< @brief	The policy ordering the ready cothreads, NULL to resume them in the FIFO order.
+	cothreadj_sched_task_t*	tasks_head;	///< @brief	The first posted task, NULL if none.
+	cothreadj_sched_task_t*	tasks_tail;	///< @brief	The last posted task, NULL if none.
+	cothreadj_sched_task_t*	poller;		///< @brief	The task run each time a cothread is back in the scheduler, NULL if none (see mesh.c.)
+	cothreadj_t*		current;	///< @brief	The cothread currently resumed, NULL if none.
+	size_t				nb_alive;	///< @brief	The number of spawned cothreads whose callee has not returned yet.
+	size_t				trim_min;	///< @brief	The idle stack bytes from which a parked cothread is trimmed, zero if never.
+	size_t				nb_trimmed;	///< @brief	The number of resident bytes returned to the kernel so far.
+	cothreadj_t*		trim_head;	///< @brief	The parked cothreads to trim, the first parked first, NULL if none.
+	cothreadj_t**		trim_tail;	///< @brief	Points the link to append the next parked cothread to trim at.
+	size_t				nb_passes;	///< @brief	The number of cothreads resumed so far.
+	//
+	cothreadj_t* volatile	inbox;		///< @brief	The cothreads woken up from other OS threads, the last one first, NULL if none.
+	volatile long		sleeping;	///< @brief	Says whether the owner OS thread may be blocked on the doorbell or not.
+	volatile long		nb_rings;	///< @brief	The number of times the doorbell has been rung.
+	intptr_t			bell[2];	///< @brief	The doorbell read & write ends (an eventfd, a pipe or an event), -1 until opened.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified queue.
+ * @param		[in]	queue	The queue to initialize.
+ * @relates		_cothreadj_queue_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_queue_init	(cothreadj_queue_t* queue);
+
+/**
+ * @brief		Appends the specified cothread to the specified queue.
+ * @param		[in]	queue		The queue to append the cothread to.
+ * @param		[in]	cothread	The cothread to append, must not be linked in any queue.
+ * @relates		_cothreadj_queue_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_queue_push	(cothreadj_queue_t* queue, cothreadj_t* cothread);
+
+/**
+ * @brief		Removes the first cothread from the specified queue.
+ * @param		[in]	queue	The queue to remove the first cothread from.
+ * @return		Returns the removed cothread, NULL if the queue is empty.
+ * @relates		_cothreadj_queue_t
+ */
+extern COTHREAD_LINK cothreadj_t*	COTHREAD_CALL cothreadj_queue_pop	(cothreadj_queue_t* queue);
+
+/**
+ * @brief		Initializes the specified scheduler.
+ * @param		[in]	sched	The scheduler to initialize.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_init	(cothreadj_sched_t* sched);
+
+/**
+ * @brief		Uninitializes the specified scheduler.
+ * @param		[in]	sched	The scheduler to uninitialize, whose inbox is empty.
+ * @note		Only the doorbell opened by @ref cothreadj_sched_wait has to be released, if any.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_uninit	(cothreadj_sched_t* sched);
+
+/**
+ * @brief		Makes the specified scheduler trim the stacks of the cothreads which park themselves.
+ * @param		[in]	sched		The scheduler.
+ * @param		[in]	trim_min	The idle stack bytes from which a parked cothread is trimmed, zero to never trim (default.)
+ * @note		The idle stack pages are returned to the kernel with @ref cothreadj_trim once the callee has stayed
+ *				parked while the scheduler resumed @ref COTHREADJ_SCHED_TRIM_NB_PASSES cothreads, or once the scheduler
+ *				runs out of ready cothreads: a callee parking briefly is not trimmed, and a parked one at most once.
+ *				The number of returned bytes is accumulated in @ref _cothreadj_sched_t::nb_trimmed.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_set_trim	(cothreadj_sched_t* sched, size_t trim_min);
+
+/**
+ * @brief		Makes the specified scheduler order its ready cothreads according to the specified policy.
+ * @param		[in]	sched	The scheduler, with no ready cothread.
+ * @param		[in]	policy	The initialized policy (see cothreadj_policy.h), NULL to resume the cothreads in the FIFO order
+ *								of the @ref _cothreadj_sched_t::ready queue (default.)
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_set_policy	(cothreadj_sched_t* sched, cothreadj_policy_t* policy);
+
+/**
+ * @brief		Makes the specified scheduler responsible for resuming the specified cothread.
+ * @param		[in]	sched		The scheduler to spawn the cothread on.
+ * @param		[in]	cothread	The cothread to spawn, initialized but never yielded yet.
+ * @note		The cothread is appended to the ready queue, its callee is resumed by @ref cothreadj_sched_run.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_spawn	(cothreadj_sched_t* sched, cothreadj_t* cothread);
+
+/**
+ * @brief		Initializes the specified task.
+ * @param		[in]	task	The task to initialize.
+ * @param		[in]	cb		The callback.
+ * @relates		_cothreadj_sched_task_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_task_init	(cothreadj_sched_task_t* task, cothreadj_sched_task_cb_t cb);
+
+/**
+ * @brief		Makes the specified scheduler run the specified task.
+ * @param		[in]	sched	The scheduler to post the task to.
+ * @param		[in]	task	The task to run, not posted yet.
+ * @note		The tasks are run by @ref cothreadj_sched_run, in the posting order, alternately with the ready cothreads.
+ *				This function must be called from the OS thread running the scheduler.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_post	(cothreadj_sched_t* sched, cothreadj_sched_task_t* task);
+
+/**
+ * @brief		Resumes the ready cothreads & runs the posted tasks until none is left.
+ * @param		[in]	sched	The scheduler to run.
+ * @return		Returns the number of spawned cothreads whose callee has not returned yet (i.e. which are parked.)
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK size_t			COTHREAD_CALL cothreadj_sched_run	(cothreadj_sched_t* sched);
+
+/**
+ * @brief		Blocks the calling OS thread until a cothread of the specified scheduler is woken up from another one.
+ * @param		[in]	sched	The scheduler, which is not running.
+ * @return		Returns
+ *				- @ref cothread_err_ok once the inbox is not empty, or spuriously (the caller has to run the scheduler
+ *				then wait again if no cothread is ready) ;
+ *				- @ref cothread_err_notsup if the doorbell could not be opened.
+ *				.
+ * @note		The doorbell is opened by the first call (see @ref cothreadj_sched_uninit), and rung only when the inbox
+ *				was empty and this function may be blocked: a burst of remote wakes costs a single system call.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_sched_wait	(cothreadj_sched_t* sched);
+
+/**
+ * @brief		Appends the current callee to the ready queue and switches to the scheduler.
+ * @param		[in]	cothread	The spawned cothread whose callee is running.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_yield	(cothreadj_t* cothread);
+
+/**
+ * @brief		Switches to the scheduler without appending the current callee to the ready queue.
+ * @param		[in]	cothread	The spawned cothread whose callee is running.
+ * @note		The function returns once another party called @ref cothreadj_sched_wake on @e cothread.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_park	(cothreadj_t* cothread);
+
+/**
+ * @brief		Appends the specified parked cothread to the ready queue of its scheduler.
+ * @param		[in]	cothread	The parked cothread to wake up.
+ * @note		This function must be called from the OS thread running the scheduler.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_wake	(cothreadj_t* cothread);
+
+/**
+ * @brief		Appends the specified parked cothread to the inbox of its scheduler.
+ * @param		[in]	cothread	The parked cothread to wake up, which must not be linked in any queue (such as a wait list.)
+ * @note		This function may be called from any OS thread: it never touches the scheduler but its lock-free inbox,
+ *				which the scheduler drains at once into its ready queue each time it looks for a cothread to resume.
+ *				The cothread is linked in the inbox through its @ref _cothreadj_t::next member, and must be woken up
+ *				only once per park.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_sched_wake_remote	(cothreadj_t* cothread);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_SCHED_H__ */
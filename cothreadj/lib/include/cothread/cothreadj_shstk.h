@@ -0,0 +1,96 @@
+/**
+ * @brief		This file contains the shared stack public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_SHSTK_H__
+#define __COTHREAD_COTHREADJ_SHSTK_H__
+
+#include <cothread/cothreadj.h>
+
+/**
+ * @brief		The size of the smallest save areas, in bytes.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_SHSTK_SAVE_SZ_MIN		256
+
+/**
+ * @brief		The number of save area size classes, each one twice as large as the previous one.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_SHSTK_NB_CLASSES		24
+
+/**
+ * @brief		The shared stack save area type, followed by the copied frames.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_shstk_save_t
+{
+	union {
+		cothreadj_shstk_save_t*	next;	///< @brief	The next released save area of the same class, while released.
+		size_t					sz;		///< @brief	The number of copied bytes, while holding frames.
+	}							u;		///< @brief	The state-dependent member.
+	size_t						cls;	///< @brief	The size class: the area holds @ref COTHREADJ_SHSTK_SAVE_SZ_MIN << cls bytes.
+};
+
+/**
+ * @brief		The shared stack type.
+ * @details		Many cothreads run on the same stack, one at a time: the frames of the cothread which last ran
+ *				on it (the @e owner) stay in place until another one is resumed, then only their used part
+ *				(from the paused stack pointer up to the stack top) is copied into a right-sized save area,
+ *				and copied back once its cothread is resumed again.
+ * @note		A shared stack belongs to a single OS thread and never uses atomic operations.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_shstk_t
+{
+	cothreadj_stack_t*		stack;		///< @brief	The lowest address of the stack.
+	size_t					stack_sz;	///< @brief	The size of the stack, in bytes.
+	cothreadj_t*			owner;		///< @brief	The cothread whose frames lie on the stack, NULL if none.
+	cothreadj_shstk_save_t*	free[COTHREADJ_SHSTK_NB_CLASSES];	///< @brief	The released save areas, per size class.
+	size_t					nb_bytes;	///< @brief	The size of the save areas holding frames, in bytes.
+	size_t					nb_copies;	///< @brief	The number of times some frames were copied off or back onto the stack.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified shared stack.
+ * @param		[in]	shstk		The shared stack to initialize.
+ * @param		[in]	stack		The lowest address of the stack (must be @ref COTHREADJ_STACK_ALIGN aligned.)
+ * @param		[in]	stack_sz	The size of the stack, in bytes (must be a multiple of @ref COTHREADJ_STACK_ALIGN.)
+ * @relates		_cothreadj_shstk_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_shstk_init	(cothreadj_shstk_t* shstk, cothreadj_stack_t* stack, size_t stack_sz);
+
+/**
+ * @brief		Releases the save areas of the specified shared stack.
+ * @param		[in]	shstk	The shared stack to uninitialize.
+ * @note		The cothreads initialized on the shared stack must be uninitialized first.
+ * @relates		_cothreadj_shstk_t
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_shstk_uninit	(cothreadj_shstk_t* shstk);
+
+/**
+ * @brief		Initializes the specified cothread on the specified shared stack.
+ * @param		[in]	cothread	The cothread to initialize.
+ * @param		[in]	attr		The attributes to initialize the cothread with, except the stack ones which are ignored.
+ * @param		[in]	shstk		The shared stack the callee runs on.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if the frames of the current owner could not be copied off the stack.
+ *				.
+ * @note		The cothreads of a shared stack must be resumed from another stack (never from one of them),
+ *				and their callees must not share the addresses of their local variables with one another,
+ *				since these addresses are only valid while the callee owns the stack.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_init_shared	(cothreadj_t* cothread, const cothreadj_attr_t* attr, cothreadj_shstk_t* shstk);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_SHSTK_H__ */
@@ -0,0 +1,201 @@
+/**
+ * @brief		This file contains the synchronization primitives public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_SYNC_H__
+#define __COTHREAD_COTHREADJ_SYNC_H__
+
+#include <cothread/cothreadj_sched.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothreadj
+/// @{
+typedef struct _cothreadj_mutex_t	cothreadj_mutex_t;	///< @brief	The mutex type.
+typedef struct _cothreadj_cond_t	cothreadj_cond_t;	///< @brief	The condition variable type.
+typedef struct _cothreadj_sem_t		cothreadj_sem_t;	///< @brief	The semaphore type.
+typedef struct _cothreadj_rwlock_t	cothreadj_rwlock_t;	///< @brief	The readers-writer lock type.
+/// @}
+
+/**
+ * @brief		The mutex type.
+ * @note		Unlocking a mutex some cothreads are waiting for hands it over to the first one.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_mutex_t
+{
+	cothreadj_t*		owner;		///< @brief	The cothread owning the mutex, NULL if unlocked.
+	cothreadj_queue_t	waiters;	///< @brief	The cothreads waiting for the mutex.
+};
+
+/**
+ * @brief		The condition variable type.
+ * @note		Signaled cothreads are moved to the wait list of the mutex instead of being woken up.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_cond_t
+{
+	cothreadj_mutex_t*	mtx;		///< @brief	The mutex the waiting cothreads have released, NULL if none.
+	cothreadj_queue_t	waiters;	///< @brief	The cothreads waiting for the condition variable.
+};
+
+/**
+ * @brief		The counting semaphore type.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_sem_t
+{
+	size_t				count;		///< @brief	The number of available units.
+	cothreadj_queue_t	waiters;	///< @brief	The cothreads waiting for a unit.
+};
+
+/**
+ * @brief		The readers-writer lock type.
+ * @note		Unlocking the writer lock wakes all the waiting readers at once,
+ *				so readers and writers alternate in batches and none of them starves.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_rwlock_t
+{
+	cothreadj_t*		writer;		///< @brief	The cothread owning the writer lock, NULL if none.
+	size_t				nb_readers;	///< @brief	The number of cothreads owning the reader lock.
+	cothreadj_queue_t	readers;	///< @brief	The cothreads waiting for the reader lock.
+	cothreadj_queue_t	writers;	///< @brief	The cothreads waiting for the writer lock.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified mutex.
+ * @param		[in]	mtx		The mutex to initialize.
+ * @relates		_cothreadj_mutex_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_mutex_init		(cothreadj_mutex_t* mtx);
+
+/**
+ * @brief		Locks the specified mutex, parks the calling cothread while the mutex is owned by another one.
+ * @param		[in]	mtx			The mutex to lock.
+ * @param		[in]	cothread	The spawned cothread whose callee is running.
+ * @relates		_cothreadj_mutex_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_mutex_lock		(cothreadj_mutex_t* mtx, cothreadj_t* cothread);
+
+/**
+ * @brief		Locks the specified mutex if it is not owned.
+ * @param		[in]	mtx			The mutex to lock.
+ * @param		[in]	cothread	The cothread to lock the mutex for.
+ * @return		Returns non-zero if the mutex has been locked, zero otherwise.
+ * @relates		_cothreadj_mutex_t
+ */
+extern COTHREAD_LINK int	COTHREAD_CALL cothreadj_mutex_trylock	(cothreadj_mutex_t* mtx, cothreadj_t* cothread);
+
+/**
+ * @brief		Unlocks the specified mutex and hands it over to the first waiting cothread if any.
+ * @param		[in]	mtx			The mutex to unlock.
+ * @param		[in]	cothread	The cothread owning the mutex.
+ * @relates		_cothreadj_mutex_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_mutex_unlock	(cothreadj_mutex_t* mtx, cothreadj_t* cothread);
+
+/**
+ * @brief		Initializes the specified condition variable.
+ * @param		[in]	cond	The condition variable to initialize.
+ * @relates		_cothreadj_cond_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_cond_init		(cothreadj_cond_t* cond);
+
+/**
+ * @brief		Releases the specified mutex, parks the calling cothread until the condition variable
+ *				is signaled, then locks the mutex again.
+ * @param		[in]	cond		The condition variable to wait for.
+ * @param		[in]	mtx			The mutex owned by @e cothread.
+ * @param		[in]	cothread	The spawned cothread whose callee is running.
+ * @relates		_cothreadj_cond_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_cond_wait		(cothreadj_cond_t* cond, cothreadj_mutex_t* mtx, cothreadj_t* cothread);
+
+/**
+ * @brief		Unblocks the first cothread waiting for the specified condition variable if any.
+ * @param		[in]	cond	The condition variable to signal.
+ * @relates		_cothreadj_cond_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_cond_signal		(cothreadj_cond_t* cond);
+
+/**
+ * @brief		Unblocks all the cothreads waiting for the specified condition variable.
+ * @param		[in]	cond	The condition variable to broadcast.
+ * @relates		_cothreadj_cond_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_cond_broadcast	(cothreadj_cond_t* cond);
+
+/**
+ * @brief		Initializes the specified semaphore.
+ * @param		[in]	sem		The semaphore to initialize.
+ * @param		[in]	count	The initial number of available units.
+ * @relates		_cothreadj_sem_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_sem_init		(cothreadj_sem_t* sem, size_t count);
+
+/**
+ * @brief		Takes a unit from the specified semaphore, parks the calling cothread while none is available.
+ * @param		[in]	sem			The semaphore to take a unit from.
+ * @param		[in]	cothread	The spawned cothread whose callee is running.
+ * @relates		_cothreadj_sem_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_sem_wait		(cothreadj_sem_t* sem, cothreadj_t* cothread);
+
+/**
+ * @brief		Takes a unit from the specified semaphore if any is available.
+ * @param		[in]	sem		The semaphore to take a unit from.
+ * @return		Returns non-zero if a unit has been taken, zero otherwise.
+ * @relates		_cothreadj_sem_t
+ */
+extern COTHREAD_LINK int	COTHREAD_CALL cothreadj_sem_trywait		(cothreadj_sem_t* sem);
+
+/**
+ * @brief		Gives a unit back to the specified semaphore, hands it over to the first waiting cothread if any.
+ * @param		[in]	sem		The semaphore to give the unit back to.
+ * @relates		_cothreadj_sem_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_sem_post		(cothreadj_sem_t* sem);
+
+/**
+ * @brief		Initializes the specified readers-writer lock.
+ * @param		[in]	rwlock	The readers-writer lock to initialize.
+ * @relates		_cothreadj_rwlock_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_rwlock_init		(cothreadj_rwlock_t* rwlock);
+
+/**
+ * @brief		Locks the specified readers-writer lock for reading.
+ * @param		[in]	rwlock		The readers-writer lock to lock.
+ * @param		[in]	cothread	The spawned cothread whose callee is running.
+ * @note		The calling cothread is parked while a writer owns the lock or waits for it.
+ * @relates		_cothreadj_rwlock_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_rwlock_rdlock	(cothreadj_rwlock_t* rwlock, cothreadj_t* cothread);
+
+/**
+ * @brief		Locks the specified readers-writer lock for writing.
+ * @param		[in]	rwlock		The readers-writer lock to lock.
+ * @param		[in]	cothread	The spawned cothread whose callee is running.
+ * @note		The calling cothread is parked while any other cothread owns the lock.
+ * @relates		_cothreadj_rwlock_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_rwlock_wrlock	(cothreadj_rwlock_t* rwlock, cothreadj_t* cothread);
+
+/**
+ * @brief		Unlocks the specified readers-writer lock.
+ * @param		[in]	rwlock		The readers-writer lock to unlock.
+ * @param		[in]	cothread	The cothread owning the lock, either for reading or for writing.
+ * @relates		_cothreadj_rwlock_t
+ */
+extern COTHREAD_LINK void	COTHREAD_CALL cothreadj_rwlock_unlock	(cothreadj_rwlock_t* rwlock, cothreadj_t* cothread);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_SYNC_H__ */
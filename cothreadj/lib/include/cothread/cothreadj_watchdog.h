@@ -0,0 +1,54 @@
+/**
+ * @brief		This file contains the watchdog public declarations.
+ * @file
+ */
+
+#ifndef __COTHREAD_COTHREADJ_WATCHDOG_H__
+#define __COTHREAD_COTHREADJ_WATCHDOG_H__
+
+#include <cothread/cothreadj.h>
+
+/**
+ * @brief		The maximum number of frames reported per stalled callee.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_WATCHDOG_NB_FRAMES_MAX	32
+
+/// @cond
+#define COTHREADJ_WITH_EPOCH				(COTHREAD_WITH_WATCHDOG || COTHREAD_WITH_PREEMPT)	// the switches bump the epoch of their OS thread.
+#define COTHREADJ_WATCHDOG_DEPTH_BITS		8	// the low bits of a switch epoch count the nested running callees.
+#define COTHREADJ_WATCHDOG_DEPTH_MASK		((1UL << COTHREADJ_WATCHDOG_DEPTH_BITS) - 1)
+/// @endcond
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Starts the watchdog thread, which reports the callees running for longer than the specified threshold.
+ * @param		[in]	threshold_us	The time a callee may run without yielding, in microseconds.
+ * @param		[in]	strm			The stream to write the reports to.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_WATCHDOG
+ *				or if the thread cannot be created.
+ *				.
+ * @note		Each OS thread is watched from its first switch on. A report gives the debug name of the stalled
+ *				callee (@c [thread] if the stack it runs on belongs to no cothread) and its backtrace, sampled
+ *				from a @c SIGURG handler: the watchdog owns this signal until @ref cothreadj_watchdog_stop is called.
+ *				A stall is reported once, however long it lasts.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK cothread_err_t	COTHREAD_CALL cothreadj_watchdog_start	(unsigned long threshold_us, FILE* strm);
+
+/**
+ * @brief		Stops the watchdog thread.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK void			COTHREAD_CALL cothreadj_watchdog_stop	(void);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADJ_WATCHDOG_H__ */
@@ -0,0 +1,309 @@
+/**
+ * @brief		This file contains the stack arena definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_arena	cothread - stack arena
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_arena_def	Definitions
+ *				Allocating each stack separately scatters the stacks over as many pages as there are cothreads,
+ *				so switching between hundreds of thousands of cothreads misses the TLB on nearly every switch.
+ *				The [arena](@ref _cothreadj_arena_t) packs the stacks in large regions aligned on
+ *				@ref COTHREADJ_ARENA_REGION_ALIGN -byte boundaries which the kernel is advised to back with
+ *				transparent huge pages (@c MADV_HUGEPAGE on GNU/Linux), so one TLB entry covers many stacks.
+ *				With @ref COTHREADJ_ARENA_FLAG_NUMA_LOCAL, each region is placed on the NUMA node of the OS thread
+ *				mapping it (through the @c mbind system call, libnuma is not required), so the stacks are local to
+ *				the OS thread which is the most likely to resume them. On single-node machines, the regions are
+ *				merely placed on node 0, and on other operating systems than GNU/Linux, they are not placed.
+ *				The slots are colored: their size is an odd number of @ref COTHREADJ_ARENA_SLOT_ALIGN -byte cache
+ *				lines, one more than needed if need be. Slots a power of two apart (such as 16 KiB stacks) would put
+ *				the hot stack tops of every slot in the same few cache sets, where they evict each other on each
+ *				switch, while an odd stride walks the stack tops through every set.
+ *				The arena is not used by default: measure it against separately allocated stacks before adopting it.
+ *
+ * @section		doxy_p_cothreadj_arena_use	Usage
+ *				-# Initialize the arena with the @ref cothreadj_arena_init function ;
+ *				-# Call the @ref cothreadj_arena_alloc function to get a stack, to be given to
+ *				the @ref cothreadj_attr_init function along with the @ref _cothreadj_arena_t::stack_sz size ;
+ *				-# Release the stack with the @ref cothreadj_arena_free function once its cothread is over ;
+ *				-# Finally, call the @ref cothreadj_arena_uninit function to unmap the regions.
+ *				.
+ */
+
+#include <cothread/cothreadj_arena.h>
+#include <assert.h>
+#include <stdint.h>
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief		The number of NUMA nodes a region may be placed on.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_ARENA_NB_NODES_MAX	1024
+
+/**
+ * @brief		Rounds the specified size upward to make it a multiple of the specified power of two.
+ * @param		[in]	_sz		The size to round.
+ * @param		[in]	_align	The power of two.
+ * @return		Returns the rounded value.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_ARENA_ROUND(_sz, _align)	(((_sz) + ((_align) - 1)) & ~((size_t)(_align) - 1))
+
+/**
+ * @brief		Maps a region of the specified size.
+ * @param		[in]	sz		The region size, a multiple of @ref COTHREADJ_ARENA_REGION_ALIGN.
+ * @param		[in,out]	node	The NUMA node to place the region on (-1 if none),
+ *									receives -1 if the region could not be placed.
+ * @return		Returns the lowest address of the region, NULL if out of memory.
+ * @relates		_cothreadj_arena_t
+ */
+static void* COTHREAD_CALL
+cothreadj_arena_map(size_t sz, int* node)
+{
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	// large pages require the SeLockMemoryPrivilege, the 64 KiB allocation granularity is enough for the stacks.
+	node[0]	= -1;
+	return VirtualAlloc(NULL, sz, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	//---Over-map to align the region---//
+	const size_t	mapped_sz	= sz + COTHREADJ_ARENA_REGION_ALIGN;
+	char*			mapped		= (char*)mmap(NULL, mapped_sz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (MAP_FAILED == (void*)mapped) {
+		return NULL;
+	}
+
+	//---Unmap the misaligned head & the tail---//
+	char*	base	= (char*)COTHREADJ_ARENA_ROUND((uintptr_t)mapped, COTHREADJ_ARENA_REGION_ALIGN);
+	if (base != mapped) {
+		munmap(mapped, base - mapped);
+	}
+	if (base + sz != mapped + mapped_sz) {
+		munmap(base + sz, (mapped + mapped_sz) - (base + sz));
+	}
+
+	//---Prefer the node before any page is touched (a preference degrades to the other nodes when full)---//
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	if ((0 <= node[0]) && (COTHREADJ_ARENA_NB_NODES_MAX > node[0])) {
+		unsigned long	mask[COTHREADJ_ARENA_NB_NODES_MAX / (8 * sizeof(unsigned long))]	= { 0 };
+		mask[node[0] / (8 * sizeof(unsigned long))]	|= 1UL << (node[0] % (8 * sizeof(unsigned long)));
+		if (0 != syscall(SYS_mbind, base, sz, MPOL_PREFERRED, mask, (unsigned long)COTHREADJ_ARENA_NB_NODES_MAX + 1, 0)) {
+			node[0]	= -1;	// e.g. forbidden by a seccomp filter.
+		}
+	} else {
+		node[0]	= -1;
+	}
+#else
+	node[0]	= -1;
+#endif
+
+	//---Ask for transparent huge pages (a mere hint: the kernel may be configured not to use them)---//
+#ifdef	MADV_HUGEPAGE
+	madvise(base, sz, MADV_HUGEPAGE);
+#endif
+	return base;
+#endif
+}
+
+/**
+ * @brief		Unmaps the specified region.
+ * @param		[in]	base	The lowest address of the region.
+ * @param		[in]	sz		The region size.
+ * @relates		_cothreadj_arena_t
+ */
+static void COTHREAD_CALL
+cothreadj_arena_unmap(void* base, size_t sz)
+{
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	(void)sz;
+	VirtualFree(base, 0, MEM_RELEASE);
+#else
+	munmap(base, sz);
+#endif
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_arena_init(cothreadj_arena_t* arena, size_t stack_sz, unsigned int flags)
+{
+	//---Check arguments---//
+	assert(NULL	!= arena);
+	assert(0	!= stack_sz);
+	assert(0	== ((COTHREADJ_STACK_ALIGN - 1) & stack_sz));
+
+	//---Compute the slot layout: the stack, then the colocated cothread---//
+	const size_t	cothread_sz	= (0 != (COTHREADJ_ARENA_FLAG_COLOCATE & flags))
+								? COTHREADJ_ARENA_ROUND(sizeof(cothreadj_t), COTHREADJ_ARENA_SLOT_ALIGN) : 0;
+	arena->slot_sz		= COTHREADJ_ARENA_ROUND(stack_sz + cothread_sz, COTHREADJ_ARENA_SLOT_ALIGN);
+	//---Color the slots: an odd number of cache lines apart, so the stack tops of consecutive slots do not share their cache sets---//
+	if (0 == (1 & (arena->slot_sz / COTHREADJ_ARENA_SLOT_ALIGN))) {
+		arena->slot_sz	+= COTHREADJ_ARENA_SLOT_ALIGN;
+	}
+	arena->stack_sz		= arena->slot_sz - cothread_sz;
+	arena->region_sz	= COTHREADJ_ARENA_ROUND(arena->slot_sz, COTHREADJ_ARENA_REGION_ALIGN);
+	if (COTHREADJ_ARENA_REGION_SZ_MIN > arena->region_sz) {
+		arena->region_sz	= (COTHREADJ_ARENA_REGION_SZ_MIN / arena->slot_sz) * arena->slot_sz;
+		arena->region_sz	= COTHREADJ_ARENA_ROUND(arena->region_sz, COTHREADJ_ARENA_REGION_ALIGN);
+	}
+	arena->flags		= flags;
+
+	//---No region is mapped yet---//
+	arena->regions		= NULL;
+	arena->cur			= NULL;
+	arena->end			= NULL;
+	arena->free_slots	= NULL;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_arena_uninit(cothreadj_arena_t* arena)
+{
+	//---Check arguments---//
+	assert(NULL	!= arena);
+
+	//---Unmap the regions---//
+	while (NULL != arena->regions) {
+		cothreadj_arena_region_t*	region	= arena->regions;
+		arena->regions	= region->next;
+		cothreadj_arena_unmap(region->base, region->sz);
+		free(region);
+	}
+	arena->cur			= NULL;
+	arena->end			= NULL;
+	arena->free_slots	= NULL;
+}
+
+extern COTHREAD_LINK cothreadj_stack_t* COTHREAD_CALL
+cothreadj_arena_alloc(cothreadj_arena_t* arena, cothreadj_t** cothread)
+{
+	//---Definitions---//
+	char*	slot;
+
+	//---Check arguments---//
+	assert(NULL	!= arena);
+	assert((NULL != cothread) || (0 == (COTHREADJ_ARENA_FLAG_COLOCATE & arena->flags)));
+
+	//---Reuse the last released slot (the most likely to be cached) first---//
+	if (NULL != arena->free_slots) {
+		slot				= (char*)arena->free_slots;
+		arena->free_slots	= ((void**)slot)[0];
+	} else {
+		//---Map a new region if the last one is full---//
+		if ((size_t)(arena->end - arena->cur) < arena->slot_sz) {
+			cothreadj_arena_region_t*	region	= (cothreadj_arena_region_t*)malloc(sizeof(cothreadj_arena_region_t));
+			if (NULL == region) {
+				return NULL;
+			}
+			region->node	= (0 != (COTHREADJ_ARENA_FLAG_NUMA_LOCAL & arena->flags)) ? cothreadj_numa_node() : -1;
+			if (NULL == (region->base = cothreadj_arena_map(arena->region_sz, &(region->node)))) {
+				free(region);
+				return NULL;
+			}
+			region->sz		= arena->region_sz;
+			region->next	= arena->regions;
+			arena->regions	= region;
+			arena->cur		= (char*)region->base;
+			arena->end		= arena->cur + region->sz;
+		}
+
+		//---Carve the slot---//
+		slot		= arena->cur;
+		arena->cur	+= arena->slot_sz;
+	}
+
+	//---Return---//
+	if (NULL != cothread) {
+		cothread[0]	= (0 != (COTHREADJ_ARENA_FLAG_COLOCATE & arena->flags)) ? (cothreadj_t*)(slot + arena->stack_sz) : NULL;
+	}
+	return (cothreadj_stack_t*)slot;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_arena_free(cothreadj_arena_t* arena, cothreadj_stack_t* stack)
+{
+	//---Check arguments---//
+	assert(NULL	!= arena);
+	assert(NULL	!= stack);
+
+	//---Link the slot through its lowest bytes (the deepest, coldest part of the stack)---//
+	((void**)stack)[0]	= arena->free_slots;
+	arena->free_slots	= stack;
+}
+
+extern COTHREAD_LINK size_t COTHREAD_CALL
+cothreadj_arena_node_stats(const cothreadj_arena_t* arena, cothreadj_arena_node_stats_t* stats, size_t nb_stats)
+{
+	//---Check arguments---//
+	assert(NULL	!= arena);
+	assert((NULL != stats) || (0 == nb_stats));
+
+	//---Aggregate the regions by node---//
+	size_t	nb_nodes	= 0;
+	for (const cothreadj_arena_region_t* region = arena->regions; NULL != region; region = region->next) {
+		//---Is it the first region (from the last mapped one) placed on its node ?---//
+		const cothreadj_arena_region_t*	prev	= arena->regions;
+		while ((prev != region) && (prev->node != region->node)) {
+			prev	= prev->next;
+		}
+		if (prev == region) {
+			if (nb_nodes < nb_stats) {
+				stats[nb_nodes].node		= region->node;
+				stats[nb_nodes].nb_regions	= 0;
+				stats[nb_nodes].nb_bytes	= 0;
+				stats[nb_nodes].nb_slots	= 0;
+			}
+			nb_nodes++;
+		}
+
+		//---Accumulate (only the last region may be partially carved)---//
+		for (size_t i = 0; (i < nb_nodes) && (i < nb_stats); i++) {
+			if (stats[i].node == region->node) {
+				stats[i].nb_regions++;
+				stats[i].nb_bytes	+= region->sz;
+				stats[i].nb_slots	+= ((region == arena->regions) ? (size_t)(arena->cur - (char*)region->base) : region->sz) / arena->slot_sz;
+				break;
+			}
+		}
+	}
+	return nb_nodes;
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_arena_get_node(const cothreadj_arena_t* arena, const cothreadj_stack_t* stack)
+{
+	//---Check arguments---//
+	assert(NULL	!= arena);
+	assert(NULL	!= stack);
+
+	//---Look for the region holding the stack---//
+	for (const cothreadj_arena_region_t* region = arena->regions; NULL != region; region = region->next) {
+		if (((const char*)region->base <= (const char*)stack) && ((const char*)region->base + region->sz > (const char*)stack)) {
+			return region->node;
+		}
+	}
+	assert(0);
+	return -1;
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_numa_node(void)
+{
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	unsigned int	cpu;
+	unsigned int	node;
+	return (0 == syscall(SYS_getcpu, &cpu, &node, NULL)) ? (int)node : -1;
+#else
+	return -1;
+#endif
+}
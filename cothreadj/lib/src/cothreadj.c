@@ -35,9 +35,30 @@
  */
 
 #include <cothread/cothreadj.h>
+#include <cothread/cothreadj_arena.h>
+#include <cothread/cothreadj_shstk.h>
+#include <cothread/cothreadj_watchdog.h>
+#include <cothread/atomic.h>
+#include <cothread/probes.h>
+#include <cothread/trace.h>
 #include <assert.h>
 #include <stdint.h>
 
+/**
+ * @brief		Says whether the idle stack pages may be returned to the kernel or not (see @ref cothreadj_trim.)
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_WITH_TRIM	((COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID) || (COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+
+#if COTHREADJ_WITH_TRIM
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if		(COTHREAD_CC_ID_CL == COTHREAD_CC_ID)
+#include <intrin.h>
+#endif
+
 /**
  * @brief		Logs the specified message.
  * @param		[in]	_cothread	The cothread to log the message with.
@@ -47,8 +68,10 @@
  */
 #define COTHREADJ_LOGF(_cothread, _fmt, ...)	{												\
 	const cothreadj_t*	_cothd	= (_cothread);													\
-	if (NULL != _cothd->dbg_strm) {																\
-		fprintf(_cothd->dbg_strm, "%s: " _fmt "\n", _cothd->current->dbg_name, __VA_ARGS__);	\
+	if (0 != (COTHREADJ_FLAG_LOG & _cothd->flags)) {											\
+		fprintf(_cothd->dbg_strm, "%s: " _fmt "\n",												\
+			(&(_cothd->caller) == _cothd->current) ? _cothd->dbg_caller_name : _cothd->dbg_callee_name,	\
+			__VA_ARGS__);																		\
 	}																							\
 }
 
@@ -112,6 +135,198 @@
 	#define COTHREADJ_LONGJMP(_buf, _user_val)	longjmp((_buf), (_user_val))
 #endif
 
+/**
+ * @brief		Prefetches the specified cache line for writing.
+ * @param		[in]	_addr	An address of the cache line.
+ * @ingroup		doxy_cothreadj
+ */
+#if		(COTHREAD_CC_ID_CL != COTHREAD_CC_ID)
+	#define COTHREADJ_PREFETCH_LINE(_addr)	__builtin_prefetch((_addr), 1)
+#elif	((COTHREAD_ARCH_ID_X86 == COTHREAD_ARCH_ID) || (COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID))
+	#define COTHREADJ_PREFETCH_LINE(_addr)	_mm_prefetch((const char*)(_addr), _MM_HINT_T0)
+#else
+	#define COTHREADJ_PREFETCH_LINE(_addr)
+#endif
+
+/**
+ * @brief		Prefetches the specified cothread for writing.
+ * @param		[in]	_cothread	The cothread about to be initialized.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_PREFETCH(_cothread)	{								\
+	const char*	_bytes	= (const char*)(_cothread);						\
+	for (size_t _off = 0; _off < sizeof(cothreadj_t); _off += 64) {		\
+		COTHREADJ_PREFETCH_LINE(_bytes + _off);							\
+	}																	\
+}
+
+#if COTHREAD_WITH_COMPACT_CTX
+	/**
+	 * @brief		Saves the current context onto the stack.
+	 * @param		[out]	sp	Receives the stack pointer of the saved context.
+	 * @return		Returns zero on first return, the user value during the second one (see @ref cothreadj_ctx_swap.)
+	 * @note		Like setjmp, except that the registers are pushed onto the stack: the calling function
+	 *				must return without calling anything else, so that its frame is left untouched until resumed.
+	 * @ingroup		doxy_cothreadj
+	 */
+	extern COTHREAD_LINK_HIDDEN int	COTHREAD_CALL cothreadj_ctx_save	(void** sp) __attribute__ ((returns_twice));
+
+	/**
+	 * @brief		Saves the current context onto the stack and resumes the specified one.
+	 * @param		[out]	save_sp		Receives the stack pointer of the saved context.
+	 * @param		[in]	load_sp		The stack pointer of the context to resume.
+	 * @param		[in]	user_val	The user value the resumed context returns.
+	 * @return		Returns the user value sent by the endpoint which resumed the saved context.
+	 * @ingroup		doxy_cothreadj
+	 */
+	extern COTHREAD_LINK_HIDDEN int	COTHREAD_CALL cothreadj_ctx_swap	(void** save_sp, void* load_sp, int user_val);
+#endif
+
+#if (COTHREAD_WITH_PROFILER || COTHREAD_WITH_WATCHDOG)
+	/**
+	 * @brief		Makes the callee of the specified cothread the running one of the OS thread.
+	 * @param		[in]	_cothread	The cothread whose callee is resumed.
+	 * @ingroup		doxy_cothreadj
+	 */
+	#define COTHREADJ_RUNNING_ENTER(_cothread)	{		\
+		cothreadj_t*	_cothd	= (_cothread);			\
+		_cothd->running_prev	= cothreadj_running;	\
+		cothreadj_running		= _cothd;				\
+	}
+
+	/**
+	 * @brief		Makes the callee which resumed the specified cothread the running one of the OS thread again.
+	 * @param		[in]	_cothread	The cothread whose callee is paused.
+	 * @ingroup		doxy_cothreadj
+	 */
+	#define COTHREADJ_RUNNING_LEAVE(_cothread)	{			\
+		cothreadj_running	= (_cothread)->running_prev;	\
+	}
+
+	/// @cond
+	// the cothread whose callee is running in the OS thread, NULL if none (read by the profiler & watchdog signal handlers.)
+	extern COTHREAD_LINK_HIDDEN COTHREAD_THREAD_LOCAL cothreadj_t*	cothreadj_running;
+	COTHREAD_LINK_HIDDEN COTHREAD_THREAD_LOCAL cothreadj_t*			cothreadj_running	= NULL;
+	/// @endcond
+#else
+	#define COTHREADJ_RUNNING_ENTER(_cothread)
+	#define COTHREADJ_RUNNING_LEAVE(_cothread)
+#endif
+
+#if COTHREADJ_WITH_EPOCH
+	/// @cond
+	// the switch epoch of the OS thread, NULL until its first switch (defined in watchdog.c.)
+	extern COTHREAD_LINK_HIDDEN COTHREAD_THREAD_LOCAL volatile unsigned long*	cothreadj_watchdog_epoch;
+	extern COTHREAD_LINK_HIDDEN volatile unsigned long*	COTHREAD_CALL cothreadj_watchdog_attach		(void);
+	/// @endcond
+
+	/**
+	 * @brief		Bumps the switch epoch of the OS thread, with a single relaxed store.
+	 * @param		[in]	_depth	+1 if a callee is resumed, -1 if paused (the low bits count the nested running callees.)
+	 * @ingroup		doxy_cothreadj
+	 */
+	#define COTHREADJ_WATCHDOG_BUMP(_depth)	{																	\
+		volatile unsigned long*	_epoch	= cothreadj_watchdog_epoch;											\
+		if (NULL == _epoch) {																				\
+			_epoch	= cothreadj_watchdog_attach();															\
+		}																									\
+		COTHREAD_ATOMIC_STORE_RLX(_epoch, *_epoch + (1UL << COTHREADJ_WATCHDOG_DEPTH_BITS) + (unsigned long)(_depth));	\
+	}
+#else
+	#define COTHREADJ_WATCHDOG_BUMP(_depth)
+#endif
+
+#if COTHREAD_WITH_TRACE
+/// @cond
+static cothread_trace_t								cothreadj_trace			= COTHREAD_TRACE_INITIALIZER;	// the tracer.
+static COTHREAD_THREAD_LOCAL cothread_trace_slot_t	cothreadj_trace_slot	= { NULL, 0 };						// the ring of the OS thread.
+/// @endcond
+#endif
+
+/**
+ * @brief		Records the specified switch event.
+ * @param		[in]	_type		The event type (see @ref COTHREAD_TRACE_RESUME.)
+ * @param		[in]	_cothread	The cothread.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_TRACE(_type, _cothread)	\
+	COTHREAD_TRACE(&cothreadj_trace, &cothreadj_trace_slot, (_type), (_cothread), (_cothread)->dbg_callee_name)
+
+#if !COTHREAD_WITH_COMPACT_CTX
+#if		(COTHREAD_CC_ID_CL == COTHREAD_CC_ID)
+/**
+ * @brief		Returns an address lying below the stack frame of the calling function.
+ * @return		Returns an address of the frame of this function, every stack byte below it is unused once it returns.
+ * @ingroup		doxy_cothreadj
+ */
+static COTHREAD_NOINLINE void* COTHREAD_CALL
+cothreadj_get_sp(void)
+{
+	return _AddressOfReturnAddress();
+}
+#else
+/**
+ * @brief		Returns the stack pointer, without any call on the switch path.
+ * @return		Returns the stack pointer, every stack byte below it is unused by the calling function.
+ * @ingroup		doxy_cothreadj
+ */
+static inline void* COTHREAD_CALL
+cothreadj_get_sp(void)
+{
+	void*	sp;
+#if		(COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID)
+	__asm__ __volatile__ ("mov %%rsp, %0" : "=r" (sp));
+#elif	(COTHREAD_ARCH_ID_X86 == COTHREAD_ARCH_ID)
+	__asm__ __volatile__ ("mov %%esp, %0" : "=r" (sp));
+#elif	(COTHREAD_ARCH_ID_AARCH64 == COTHREAD_ARCH_ID)
+	__asm__ __volatile__ ("mov %0, sp" : "=r" (sp));
+#endif
+	return sp;
+}
+#endif
+
+/**
+ * @brief		Records the stack pointer of the specified paused callee.
+ * @param		[in]	_cothread	The cothread whose callee is paused.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_RECORD_SP(_cothread)	{	\
+	(_cothread)->callee.sp	= cothreadj_get_sp();	\
+}
+#else
+	#define COTHREADJ_RECORD_SP(_cothread)
+#endif
+
+/**
+ * @brief		Copies the frames of the owner off the shared stack of the specified cothread,
+ *				then copies the frames of its callee back onto it (see shstk.c.)
+ * @param		[in]	cothread	The cothread whose callee is about to be resumed, which does not own the stack.
+ * @return		Returns @ref cothread_err_ok in case of success, @ref cothread_err_nomem otherwise.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK_HIDDEN cothread_err_t	COTHREAD_CALL cothreadj_shstk_acquire	(cothreadj_t* cothread);
+
+/**
+ * @brief		Forgets the frames of the specified cothread, whether they lie on its shared stack or not (see shstk.c.)
+ * @param		[in]	cothread	The cothread which is uninitialized.
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL cothreadj_shstk_release	(cothreadj_t* cothread);
+
+/// @cond
+static cothreadj_fls_dtor_t	cothreadj_fls_dtors[COTHREADJ_FLS_NB_SLOTS];	// the destructor of each allocated key.
+static cothreadj_fls_key_t	cothreadj_fls_nb_keys;							// the number of allocated keys.
+#if COTHREAD_WITH_HOOKS
+/// @cond
+static const cothread_hooks_t*	cothreadj_hooks_global	= NULL;	// the hooks of all the cothreads.
+/// @endcond
+#endif
+
+#if COTHREAD_WITH_STATS
+static cothread_stats_list_t	cothreadj_stats_live	= COTHREAD_STATS_LIST_INITIALIZER;	// the statistics of the live cothreads.
+#endif
+/// @endcond
+
 extern COTHREAD_LINK void COTHREAD_CALL
 cothreadj_attr_init(cothreadj_attr_t* attr, cothreadj_stack_t* stack, size_t stack_sz, cothreadj_cb_t user_cb)
 {
@@ -157,51 +372,222 @@ cothreadj_attr_set_dbg_strm(cothreadj_attr_t* attr, FILE* strm)
 }
 
 /**
- * @brief		Initializes and runs the specified cothread.
+ * @brief		Initializes the members of the specified cothread, without touching its stack.
  * @param		[in]	cothread	The cothread to initialize.
  * @param		[in]	attr		The attributes to initialize the cothread with.
  * @relates		_cothreadj_t
  */
-extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
-cothreadj_core(cothreadj_t* cothread, const cothreadj_attr_t* attr)
+static void COTHREAD_CALL
+cothreadj_setup(cothreadj_t* cothread, const cothreadj_attr_t* attr)
 {
 	//---Definitions---//
 	static const char	dbg_caller_name_default[]	= "caller";
 	static const char	dbg_callee_name_default[]	= "callee";
 
+	//---Init---//
+	cothread->current			= &(cothread->callee);
+	cothread->caller.sp			= NULL;
+	cothread->callee.sp			= NULL;
+	cothread->stack				= attr->stack;
+	cothread->stack_sz			= attr->stack_sz;
+	cothread->user_cb			= attr->user_cb;
+	cothread->dbg_caller_name	= (NULL != attr->dbg_caller_name) ? attr->dbg_caller_name : dbg_caller_name_default;
+	cothread->dbg_callee_name	= (NULL != attr->dbg_callee_name) ? attr->dbg_callee_name : dbg_callee_name_default;
+	cothread->dbg_strm			= attr->dbg_strm;
+	cothread->flags				= (NULL != attr->dbg_strm) ? COTHREADJ_FLAG_LOG : 0;
+	cothread->sched				= NULL;
+	cothread->next				= NULL;
+	cothread->group				= NULL;
+	cothread->group_next		= NULL;
+	cothread->group_ret			= 0;
+	for (cothreadj_fls_key_t key = 0; key < COTHREADJ_FLS_NB_SLOTS; key++) {
+		cothread->fls[key]	= NULL;
+	}
+	cothread->shstk				= NULL;
+	cothread->save				= NULL;
+	cothread->sched_key			= 0;
+	cothread->sched_seq			= 0;
+	cothread->sched_child		= NULL;
+	cothread->trim_next			= NULL;
+	cothread->trim_pprev		= NULL;
+	cothread->trim_pass			= 0;
+#if COTHREAD_WITH_HOOKS
+	cothread->hooks				= NULL;
+#endif
+#if COTHREAD_WITH_STATS
+	cothread_stats_init(&(cothread->stats), cothread, cothread->dbg_callee_name);
+#endif
+}
+
+/**
+ * @brief		Initializes and runs the specified cothread.
+ * @param		[in]	cothread	The cothread to initialize.
+ * @param		[in]	attr		The attributes to initialize the cothread with, whose @e user_cb is NULL
+ *								if the members have already been initialized (see @ref cothreadj_init_lazy.)
+ * @relates		_cothreadj_t
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothreadj_core(cothreadj_t* cothread, const cothreadj_attr_t* attr)
+{
 	//---Check arguments---//
 	assert(NULL	!= cothread);
 	assert(NULL	!= attr);
 
-	//---Init---//
-	cothread->current			= &(cothread->callee);
-	cothread->caller.dbg_name	= (NULL != attr->dbg_caller_name) ? attr->dbg_caller_name : dbg_caller_name_default;
-	cothread->callee.dbg_name	= (NULL != attr->dbg_callee_name) ? attr->dbg_callee_name : dbg_callee_name_default;
-	cothread->dbg_strm			= attr->dbg_strm;
+	//---Init, unless done by cothreadj_init_lazy---//
+	if (NULL != attr->user_cb) {
+		cothreadj_setup(cothread, attr);
+	} else {
+		cothread->current	= &(cothread->callee);
+	}
 
 	//---Initialize the callee endpoint---//
-	cothreadj_cb_t	user_cb	= attr->user_cb;
+	cothreadj_cb_t	user_cb	= cothread->user_cb;
 	COTHREADJ_LOGF(cothread, "%s", "initializing endpoint");
+	COTHREAD_PROBE(cothreadj, init, cothread, user_cb);
+#if COTHREAD_WITH_COMPACT_CTX
+	COTHREADJ_LOGF(cothread, "%s", "initialized");	// nothing may be called once the context is saved.
+	int	user_val	= cothreadj_ctx_save(&(cothread->current->sp));
+#else
+	COTHREADJ_RECORD_SP(cothread);
 	int	user_val	= COTHREADJ_SETJMP(cothread->current->buf);
-	if (0 != user_val) {
+#endif
+	while (0 != user_val) {
 		//---Forget the attributes which are not valid during the 2nd return---//
 		attr	= NULL;
 
 		//---Run the user callback---//
 		COTHREADJ_LOGF(cothread, "%s", "starting user callback");
+		COTHREADJ_TRACE(COTHREAD_TRACE_START, cothread);
+		COTHREAD_PROBE(cothreadj, cb_start, cothread, user_val);
 		user_val	= user_cb(cothread, user_val);
+		COTHREAD_PROBE(cothreadj, cb_return, cothread, user_val);
 		COTHREADJ_LOGF(cothread, "%s", "user callback returned");
 
+		//---Destroy the fiber-local storage values---//
+		for (cothreadj_fls_key_t key = 0; key < cothreadj_fls_nb_keys; key++) {
+			void*	value	= cothread->fls[key];
+			if ((NULL != value) && (NULL != cothreadj_fls_dtors[key])) {
+				cothread->fls[key]	= NULL;
+				cothreadj_fls_dtors[key](value);
+			}
+		}
+
 		//---Jump to the caller---//
-		COTHREADJ_LOGF(cothread, "complete, returning to %s", cothread->caller.dbg_name);
+		COTHREADJ_LOGF(cothread, "complete, returning to %s", cothread->dbg_caller_name);
+		COTHREAD_HOOKS_SUSPEND(cothreadj_hooks_global, cothread->hooks, cothread);
+		COTHREAD_STATS_PAUSE(&(cothread->stats));
+		COTHREADJ_RUNNING_LEAVE(cothread);
+		COTHREADJ_TRACE(COTHREAD_TRACE_COMPLETE, cothread);
+		COTHREADJ_WATCHDOG_BUMP(-1);
+#if COTHREAD_WITH_STATS
+		cothread_stats_unregister(&cothreadj_stats_live, &(cothread->stats));
+#endif
+		cothread->flags		|= COTHREADJ_FLAG_COMPLETED;
 		cothread->current	= &(cothread->caller);
+#if COTHREAD_WITH_COMPACT_CTX
+		// resuming the completed callee runs the user callback again, as the jmp_buf saved above does.
+		user_val	= cothreadj_ctx_swap(&(cothread->callee.sp), cothread->current->sp, user_val);
+#else
 		COTHREADJ_LONGJMP(cothread->current->buf, user_val);
+#endif
 	}
 
 	//---Return to caller---//
+#if COTHREAD_WITH_COMPACT_CTX
+	cothread->current	= &(cothread->caller);
+#else
 	COTHREADJ_LOGF(cothread, "%s", "initialized");
 	cothread->current	= &(cothread->caller);
 	COTHREADJ_LOGF(cothread, "%s", "initialized");
+#endif
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_init_lazy(cothreadj_t* cothread, const cothreadj_attr_t* attr)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= attr);
+
+	//---Init, the callee frame being built by the first yield---//
+	cothreadj_setup(cothread, attr);
+	cothread->current	= &(cothread->caller);
+	cothread->flags		|= COTHREADJ_FLAG_LAZY;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_init_many(cothreadj_t* cothreads, size_t nb_cothreads, const cothreadj_attr_t* attr, cothreadj_arena_t* arena)
+{
+	//---Check arguments---//
+	assert((NULL != cothreads) || (0 == nb_cothreads));
+	assert(NULL	!= attr);
+	assert((NULL == arena) || (0 == (COTHREADJ_ARENA_FLAG_COLOCATE & arena->flags)));
+
+	//---Init, the callee frames being built by the first yields---//
+	cothreadj_attr_t	elt_attr	= attr[0];
+	if (NULL != arena) {
+		elt_attr.stack_sz	= arena->stack_sz;
+	}
+	for (size_t i = 0; i < nb_cothreads; i++) {
+		//---Get the stack---//
+		if (NULL == arena) {
+			elt_attr.stack	= (cothreadj_stack_t*)((char*)attr->stack + i * attr->stack_sz);
+		} else if (NULL == (elt_attr.stack = cothreadj_arena_alloc(arena, NULL))) {
+			while (0 != i--) {
+				cothreadj_uninit(cothreads + i);
+				cothreadj_arena_free(arena, cothreads[i].stack);
+			}
+			return cothread_err_nomem;
+		}
+
+		//---Init, while the next cothread is fetched---//
+		if (i + 1 < nb_cothreads) {
+			COTHREADJ_PREFETCH(cothreads + i + 1);
+		}
+		cothreadj_setup(cothreads + i, &elt_attr);
+		cothreads[i].current	= &(cothreads[i].caller);
+		cothreads[i].flags		|= COTHREADJ_FLAG_LAZY;
+	}
+	return cothread_err_ok;
+}
+
+/**
+ * @brief		Builds the initial callee frame of the specified lazily initialized cothread.
+ * @param		[in]	cothread	The cothread whose callee is about to be resumed for the first time.
+ * @relates		_cothreadj_t
+ */
+static COTHREAD_NOINLINE void COTHREAD_CALL
+cothreadj_start(cothreadj_t* cothread)
+{
+	//---Rebuild the attributes the stack switch reads, the NULL entry point saying the members are set---//
+	cothreadj_attr_t	attr;
+	attr.stack				= cothread->stack;
+	attr.stack_sz			= cothread->stack_sz;
+	attr.user_cb			= NULL;
+	attr.dbg_caller_name	= NULL;
+	attr.dbg_callee_name	= NULL;
+	attr.dbg_strm			= NULL;
+
+	//---Build the frame---//
+	cothread->flags	&= ~COTHREADJ_FLAG_LAZY;
+	cothreadj_init(cothread, &attr);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_uninit(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+
+	//---Unlink the statistics if registered & the callee has not returned---//
+#if COTHREAD_WITH_STATS
+	cothread_stats_unregister(&cothreadj_stats_live, &(cothread->stats));
+#endif
+
+	//---Forget the frames kept for the shared stack---//
+	if (0 != (COTHREADJ_FLAG_SHARED_STACK & cothread->flags)) {
+		cothreadj_shstk_release(cothread);
+	}
 }
 
 extern COTHREAD_LINK void COTHREAD_CALL
@@ -218,12 +604,56 @@ cothreadj_get_user_data(const cothreadj_t* cothread)
 	return cothread->user_data;
 }
 
+/**
+ * @brief		Makes the other endpoint of the specified cothread the current one.
+ * @param		[in]	cothread	The cothread to switch.
+ * @relates		_cothreadj_t
+ */
+static inline void COTHREAD_CALL
+cothreadj_switch(cothreadj_t* cothread)
+{
+	cothread->current	= (&(cothread->caller) == cothread->current) ? &(cothread->callee) : &(cothread->caller);
+	if (&(cothread->callee) == cothread->current) {
+		COTHREAD_STATS_RESUME(&(cothread->stats));
+		COTHREADJ_RUNNING_ENTER(cothread);
+		COTHREADJ_TRACE(COTHREAD_TRACE_RESUME, cothread);
+		COTHREADJ_WATCHDOG_BUMP(+1);
+		COTHREAD_HOOKS_RESUME(cothreadj_hooks_global, cothread->hooks, cothread);
+	} else {
+		COTHREAD_HOOKS_SUSPEND(cothreadj_hooks_global, cothread->hooks, cothread);
+		COTHREAD_STATS_PAUSE(&(cothread->stats));
+		COTHREADJ_RUNNING_LEAVE(cothread);
+		COTHREADJ_TRACE(COTHREAD_TRACE_PAUSE, cothread);
+		COTHREADJ_WATCHDOG_BUMP(-1);
+	}
+}
+
 extern COTHREAD_LINK int COTHREAD_CALL
 cothreadj_yield(cothreadj_t* cothread, int user_val)
 {
 	//---Check arguments---//
 	assert(NULL	!= cothread);
 
+	//---Build the initial callee frame if not done yet (only the caller may be current then)---//
+	if (0 != (COTHREADJ_FLAG_LAZY & cothread->flags)) {
+		cothreadj_start(cothread);
+	}
+
+	//---Copy the callee frames back onto its shared stack if another callee owns it---//
+	if ((0 != (COTHREADJ_FLAG_SHARED_STACK & cothread->flags)) && (&(cothread->caller) == cothread->current)
+		&& (cothread != cothread->shstk->owner) && (cothread_err_ok != cothreadj_shstk_acquire(cothread))) {
+		return 0;
+	}
+
+#if COTHREAD_WITH_COMPACT_CTX
+	//---Switch the endpoints & the stacks---//
+	COTHREADJ_LOGF(cothread, "%s", "yielding");
+	cothreadj_ep_t*	paused	= cothread->current;
+	cothreadj_switch(cothread);
+	COTHREADJ_LOGF(cothread, "%s", "resuming");
+	COTHREAD_PROBE(cothreadj, yield_out, cothread, user_val);
+	const int	ret	= cothreadj_ctx_swap(&(paused->sp), cothread->current->sp, user_val);
+#else
 	//---Save the current endpoint---//
 	COTHREADJ_LOGF(cothread, "%s", "saving endpoint");
 	const int	ret	= COTHREADJ_SETJMP(cothread->current->buf);
@@ -232,12 +662,211 @@ cothreadj_yield(cothreadj_t* cothread, int user_val)
 	if (0 == ret) {
 		//---Switch the endpoints---//
 		COTHREADJ_LOGF(cothread, "%s", "yielding");
-		cothread->current	= (&(cothread->caller) == cothread->current) ? &(cothread->callee) : &(cothread->caller);
+		if (&(cothread->callee) == cothread->current) {
+			COTHREADJ_RECORD_SP(cothread);
+		}
+		cothreadj_switch(cothread);
 		COTHREADJ_LOGF(cothread, "%s", "resuming");
+		COTHREAD_PROBE(cothreadj, yield_out, cothread, user_val);
 		COTHREADJ_LONGJMP(cothread->current->buf, user_val);
 	}
+#endif
 
 	//---Return---//
+	COTHREAD_PROBE(cothreadj, yield_in, cothread, ret);
 	COTHREADJ_LOGF(cothread, "%s", "endpoint restored");
 	return ret;
 }
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_trim(cothreadj_t* cothread, size_t* nb_bytes)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(&(cothread->caller)	== cothread->current);
+
+	//---Nothing trimmed yet---//
+	if (NULL != nb_bytes) {
+		nb_bytes[0]	= 0;
+	}
+
+	//---A shared stack may hold the frames of another callee---//
+	if (0 != (COTHREADJ_FLAG_SHARED_STACK & cothread->flags)) {
+		return cothread_err_notsup;
+	}
+
+#if COTHREADJ_WITH_TRIM
+	//---Compute the idle pages: below the stack pointer, or the whole stack unless the callee is started---//
+	const uintptr_t	page_sz	= (uintptr_t)sysconf(_SC_PAGESIZE);
+	const uintptr_t	top		= (0 != ((COTHREADJ_FLAG_COMPLETED | COTHREADJ_FLAG_LAZY) & cothread->flags))
+							? (uintptr_t)cothread->stack + cothread->stack_sz : (uintptr_t)cothread->callee.sp;
+	char*			lo		= (char*)(((uintptr_t)cothread->stack + page_sz - 1) & ~(page_sz - 1));
+	char*			hi		= (char*)(top & ~(page_sz - 1));
+	assert((NULL != cothread->callee.sp) || (0 != ((COTHREADJ_FLAG_COMPLETED | COTHREADJ_FLAG_LAZY) & cothread->flags)));
+	if (hi <= lo) {
+		return cothread_err_ok;
+	}
+
+	//---Count the resident pages---//
+	if (NULL != nb_bytes) {
+		unsigned char	vec[256];
+		for (char* addr = lo; addr < hi; addr += sizeof(vec) * page_sz) {
+			const size_t	sz	= ((size_t)(hi - addr) < sizeof(vec) * page_sz) ? (size_t)(hi - addr) : sizeof(vec) * page_sz;
+			if (0 == mincore(addr, sz, (void*)vec)) {
+				for (size_t i = 0; i < sz / page_sz; i++) {
+					nb_bytes[0]	+= (0 != (1 & vec[i])) ? page_sz : 0;
+				}
+			}
+		}
+	}
+
+	//---Hand the pages back (MADV_FREE is refused by some mappings, such as the shared ones)---//
+#ifdef	MADV_FREE
+	if (0 == madvise(lo, hi - lo, MADV_FREE)) {
+		return cothread_err_ok;
+	}
+#endif
+	if (0 == madvise(lo, hi - lo, MADV_DONTNEED)) {
+		return cothread_err_ok;
+	}
+	if (NULL != nb_bytes) {
+		nb_bytes[0]	= 0;
+	}
+#endif
+	return cothread_err_notsup;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_fls_key_create(cothreadj_fls_key_t* key, cothreadj_fls_dtor_t dtor)
+{
+	//---Check arguments---//
+	assert(NULL	!= key);
+
+	//---Is any key available ?---//
+	if (COTHREADJ_FLS_NB_SLOTS <= cothreadj_fls_nb_keys) {
+		return cothread_err_nomem;
+	}
+
+	//---Allocate the key---//
+	cothreadj_fls_dtors[cothreadj_fls_nb_keys]	= dtor;
+	key[0]	= cothreadj_fls_nb_keys++;
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_fls_set(cothreadj_t* cothread, cothreadj_fls_key_t key, void* value)
+{
+	assert(NULL	!= cothread);
+	assert(key	< cothreadj_fls_nb_keys);
+	cothread->fls[key]	= value;
+}
+
+extern COTHREAD_LINK void* COTHREAD_CALL
+cothreadj_fls_get(const cothreadj_t* cothread, cothreadj_fls_key_t key)
+{
+	assert(NULL	!= cothread);
+	assert(key	< cothreadj_fls_nb_keys);
+	return cothread->fls[key];
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_set_hooks(cothreadj_t* cothread, const cothread_hooks_t* hooks)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+
+	//---Set---//
+#if COTHREAD_WITH_HOOKS
+	cothread->hooks	= hooks;
+	return cothread_err_ok;
+#else
+	(void)hooks;
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_set_global_hooks(const cothread_hooks_t* hooks)
+{
+#if COTHREAD_WITH_HOOKS
+	cothreadj_hooks_global	= hooks;
+	return cothread_err_ok;
+#else
+	(void)hooks;
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_stats_register(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+
+	//---Link---//
+#if COTHREAD_WITH_STATS
+	assert(0	== (COTHREADJ_FLAG_COMPLETED & cothread->flags));
+	cothread_stats_register(&cothreadj_stats_live, &(cothread->stats));
+	return cothread_err_ok;
+#else
+	(void)cothread;
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK size_t COTHREAD_CALL
+cothreadj_stats_snapshot(cothread_stats_t* stats, size_t nb_stats)
+{
+	//---Check arguments---//
+	assert((NULL != stats) || (0 == nb_stats));
+
+	//---Copy---//
+#if COTHREAD_WITH_STATS
+	return cothread_stats_copy(&cothreadj_stats_live, stats, nb_stats);
+#else
+	(void)stats;
+	(void)nb_stats;
+	return 0;
+#endif
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_trace_start(void)
+{
+#if COTHREAD_WITH_TRACE
+	cothread_trace_start(&cothreadj_trace);
+	return cothread_err_ok;
+#else
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_trace_stop(void)
+{
+#if COTHREAD_WITH_TRACE
+	cothread_trace_stop(&cothreadj_trace);
+#endif
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_trace_dump(FILE* strm)
+{
+	//---Check arguments---//
+	assert(NULL	!= strm);
+
+	//---Dump---//
+#if COTHREAD_WITH_TRACE
+	return cothread_trace_dump(&cothreadj_trace, strm, 1, "cothreadj");
+#else
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_trace_release(void)
+{
+#if COTHREAD_WITH_TRACE
+	cothread_trace_release(&cothreadj_trace);
+#endif
+}
@@ -0,0 +1,189 @@
+/**
+ * @brief		This file contains the task group definitions.
+ * @file
+ *
+ * A group links its children through their @ref _cothreadj_t::group_next member and is told of each return
+ * by the scheduler, right after the callee has returned: a join parks the parent once, and the return which
+ * fulfils the join wakes it up, so neither side ever polls nor allocates. A child parked in cothreadj_group_park
+ * is flagged as such, so that the cancellation wakes it up, and a later cothreadj_group_wake does not wake it twice.
+ */
+
+#include <cothread/cothreadj_group.h>
+#include <assert.h>
+
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothreadj_group_complete(cothreadj_t* cothread, int ret)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->group);
+	assert(0	!= (COTHREADJ_FLAG_COMPLETED & cothread->flags));
+
+	//---Record the return---//
+	cothreadj_group_t*	group	= cothread->group;
+	assert(0	!= group->nb_alive);
+	group->nb_alive--;
+	cothread->group_ret	= ret;
+	if (NULL == group->first_done) {
+		group->first_done	= cothread;
+	}
+
+	//---Cancel the siblings on the first failure (a cancelled child returning early has not failed)---//
+	if ((0 > ret) && (0 == (COTHREADJ_FLAG_CANCELLED & cothread->flags)) && (NULL == group->first_failed)) {
+		group->first_failed	= cothread;
+		cothreadj_group_cancel(group);
+	}
+
+	//---Wake the parent up if its join is fulfilled---//
+	if ((NULL != group->parent) && ((0 == group->nb_alive) || (0 != group->join_any))) {
+		cothreadj_sched_wake(group->parent);
+		group->parent	= NULL;
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_group_init(cothreadj_group_t* group, cothreadj_sched_t* sched)
+{
+	//---Check arguments---//
+	assert(NULL	!= group);
+	assert(NULL	!= sched);
+
+	//---Init---//
+	group->sched		= sched;
+	group->children		= NULL;
+	group->parent		= NULL;
+	group->first_done	= NULL;
+	group->first_failed	= NULL;
+	group->nb_alive		= 0;
+	group->join_any		= 0;
+	group->cancelled	= 0;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_group_spawn(cothreadj_group_t* group, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= group);
+	assert(NULL	!= cothread);
+	assert(NULL	== cothread->group);
+
+	//---Link the child---//
+	cothread->group			= group;
+	cothread->group_next	= group->children;
+	cothread->group_ret		= 0;
+	group->children			= cothread;
+	group->nb_alive++;
+	if (0 != group->cancelled) {
+		cothread->flags	|= COTHREADJ_FLAG_CANCELLED;
+	}
+
+	//---Hand it over to the scheduler---//
+	cothreadj_sched_spawn(group->sched, cothread);
+}
+
+extern COTHREAD_LINK cothreadj_t* COTHREAD_CALL
+cothreadj_group_join_all(cothreadj_group_t* group, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= group);
+	assert(NULL	!= cothread);
+	assert(NULL	== group->parent);
+	assert(cothread->group	!= group);
+
+	//---Park until the last child returns---//
+	if (0 != group->nb_alive) {
+		group->parent	= cothread;
+		group->join_any	= 0;
+		cothreadj_sched_park(cothread);
+		assert(0	== group->nb_alive);
+	}
+
+	//---Return---//
+	return group->first_failed;
+}
+
+extern COTHREAD_LINK cothreadj_t* COTHREAD_CALL
+cothreadj_group_join_any(cothreadj_group_t* group, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= group);
+	assert(NULL	!= cothread);
+	assert(NULL	== group->parent);
+	assert(NULL	!= group->children);
+	assert(cothread->group	!= group);
+
+	//---Park until the first child returns---//
+	if (NULL == group->first_done) {
+		group->parent	= cothread;
+		group->join_any	= !0;
+		cothreadj_sched_park(cothread);
+		assert(NULL	!= group->first_done);
+	}
+
+	//---Cancel the others & return---//
+	cothreadj_group_cancel(group);
+	return group->first_done;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_group_cancel(cothreadj_group_t* group)
+{
+	//---Check arguments---//
+	assert(NULL	!= group);
+
+	//---Flag the children which have not returned yet, waking the ones parked in cothreadj_group_park up---//
+	group->cancelled	= !0;
+	for (cothreadj_t* cothread = group->children; NULL != cothread; cothread = cothread->group_next) {
+		if (0 == (COTHREADJ_FLAG_COMPLETED & cothread->flags)) {
+			cothread->flags	|= COTHREADJ_FLAG_CANCELLED;
+			cothreadj_group_wake(cothread);
+		}
+	}
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_group_park(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->group);
+
+	//---Park unless cancelled, until woken up or cancelled---//
+	if (0 == (COTHREADJ_FLAG_CANCELLED & cothread->flags)) {
+		cothread->flags	|= COTHREADJ_FLAG_GROUP_PARKED;
+		cothreadj_sched_park(cothread);
+		assert(0	== (COTHREADJ_FLAG_GROUP_PARKED & cothread->flags));
+	}
+
+	//---Return---//
+	return (0 != (COTHREADJ_FLAG_CANCELLED & cothread->flags));
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_group_wake(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+
+	//---Make the child ready, unless already done---//
+	if (0 != (COTHREADJ_FLAG_GROUP_PARKED & cothread->flags)) {
+		cothread->flags	&= ~(unsigned int)COTHREADJ_FLAG_GROUP_PARKED;
+		cothreadj_sched_wake(cothread);
+	}
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_group_is_cancelled(const cothreadj_t* cothread)
+{
+	assert(NULL	!= cothread);
+	return (0 != (COTHREADJ_FLAG_CANCELLED & cothread->flags));
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_group_get_ret(const cothreadj_t* cothread)
+{
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->group);
+	assert(0	!= (COTHREADJ_FLAG_COMPLETED & cothread->flags));
+	return cothread->group_ret;
+}
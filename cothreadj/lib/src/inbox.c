@@ -0,0 +1,231 @@
+/**
+ * @brief		This file contains the scheduler inbox definitions.
+ * @file
+ *
+ * The inbox is a lock-free LIFO list other OS threads push the woken up cothreads onto, with a compare-and-swap.
+ * The owner OS thread takes the whole list at once with an exchange, then reverses it to make the cothreads ready
+ * in the waking order: neither side ever waits for the other, and a pushed cothread is never popped concurrently,
+ * so the list is free from the ABA problem.
+ *
+ * The doorbell wakes the owner up once blocked in @ref cothreadj_sched_wait. The owner publishes that it may block
+ * before checking the inbox a last time, and each waker reads this flag after its push (both being sequentially
+ * consistent): either the owner sees the push, or the waker sees the flag. Only the waker which finds the inbox empty
+ * rings, the following ones knowing the owner has not drained the inbox yet.
+ *
+ * The same handshake serves the other queues an OS thread may block for, such as the rings of the shared-nothing
+ * mesh (see mesh.c): the owner checks them with a predicate once the flag is published, and the producers ring
+ * the doorbell after theirs.
+ */
+
+#include <cothread/cothreadj_sched.h>
+#include <cothread/atomic.h>
+#include <assert.h>
+
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif	((COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#elif	(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+#include <windows.h>
+#endif
+
+/**
+ * @brief		Opens the specified doorbell.
+ * @param		[out]	bell	Receives the read & write ends.
+ * @return		Returns @ref cothread_err_ok in case of success, @ref cothread_err_notsup otherwise.
+ * @ingroup		doxy_cothreadj
+ */
+static cothread_err_t COTHREAD_CALL
+cothreadj_bell_open(intptr_t bell[2])
+{
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	const int	fd	= eventfd(0, EFD_CLOEXEC);
+	if (0 > fd) {
+		return cothread_err_notsup;
+	}
+	bell[0]	= fd;
+	bell[1]	= fd;
+#elif	((COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+	// the write end never blocks: a full pipe already holds enough rings.
+	int	fds[2];
+	if (0 != pipe(fds)) {
+		return cothread_err_notsup;
+	}
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFL, O_NONBLOCK);
+	bell[0]	= fds[0];
+	bell[1]	= fds[1];
+#elif	(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	HANDLE	event	= CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (NULL == event) {
+		return cothread_err_notsup;
+	}
+	bell[0]	= (intptr_t)event;
+	bell[1]	= (intptr_t)event;
+#endif
+	return cothread_err_ok;
+}
+
+/**
+ * @brief		Closes the specified doorbell.
+ * @param		[in]	bell	The read & write ends.
+ * @ingroup		doxy_cothreadj
+ */
+static void COTHREAD_CALL
+cothreadj_bell_close(intptr_t bell[2])
+{
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	close((int)bell[0]);
+#elif	((COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+	close((int)bell[0]);
+	close((int)bell[1]);
+#elif	(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	CloseHandle((HANDLE)bell[0]);
+#endif
+}
+
+/**
+ * @brief		Rings the specified doorbell.
+ * @param		[in]	bell	The write end.
+ * @ingroup		doxy_cothreadj
+ */
+static void COTHREAD_CALL
+cothreadj_bell_ring(intptr_t bell)
+{
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	const uint64_t	val	= 1;
+	while ((0 > write((int)bell, &val, sizeof(val))) && (EINTR == errno)) {
+	}
+#elif	((COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+	const char	val	= 1;
+	while ((0 > write((int)bell, &val, sizeof(val))) && (EINTR == errno)) {
+	}
+#elif	(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	SetEvent((HANDLE)bell);
+#endif
+}
+
+/**
+ * @brief		Blocks until the specified doorbell rings, then silences it.
+ * @param		[in]	bell	The read end.
+ * @ingroup		doxy_cothreadj
+ */
+static void COTHREAD_CALL
+cothreadj_bell_wait(intptr_t bell)
+{
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	uint64_t	val;
+	while ((0 > read((int)bell, &val, sizeof(val))) && (EINTR == errno)) {
+	}
+#elif	((COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+	char	val[64];
+	while ((0 > read((int)bell, val, sizeof(val))) && (EINTR == errno)) {
+	}
+#elif	(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	WaitForSingleObject((HANDLE)bell, INFINITE);
+#endif
+}
+
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothreadj_sched_drain(cothreadj_sched_t* sched)
+{
+	//---Take the whole inbox at once---//
+	cothreadj_t*	cothread	= (cothreadj_t*)COTHREAD_ATOMIC_XCHG_PTR(&(sched->inbox), NULL);
+
+	//---Reverse it, the last woken up cothread being the first one---//
+	cothreadj_t*	first	= NULL;
+	while (NULL != cothread) {
+		cothreadj_t*	next	= cothread->next;
+		cothread->next	= first;
+		first			= cothread;
+		cothread		= next;
+	}
+
+	//---Make the cothreads ready, in the waking order---//
+	while (NULL != first) {
+		cothreadj_t*	next	= first->next;
+		first->next	= NULL;
+		cothreadj_sched_wake(first);
+		first		= next;
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_uninit(cothreadj_sched_t* sched)
+{
+	//---Check arguments---//
+	assert(NULL	!= sched);
+	assert(NULL	== sched->inbox);
+
+	//---Close the doorbell if opened---//
+	if (-1 != sched->bell[0]) {
+		cothreadj_bell_close(sched->bell);
+		sched->bell[0]	= -1;
+		sched->bell[1]	= -1;
+	}
+}
+
+extern COTHREAD_LINK_HIDDEN cothread_err_t COTHREAD_CALL
+cothreadj_sched_wait_idle(cothreadj_sched_t* sched, int (COTHREAD_CALL * idle_cb)(void* arg), void* arg)
+{
+	//---Check arguments---//
+	assert(NULL	!= sched);
+	assert(NULL	== sched->current);
+
+	//---Open the doorbell on first use---//
+	if ((-1 == sched->bell[0]) && (cothread_err_ok != cothreadj_bell_open(sched->bell))) {
+		return cothread_err_notsup;
+	}
+
+	//---Block unless a cothread (or anything the predicate checks) has been pushed before the wakers could see the flag---//
+	COTHREAD_ATOMIC_STORE(&(sched->sleeping), 1);
+	if ((NULL == COTHREAD_ATOMIC_LOAD_PTR(&(sched->inbox))) && ((NULL == idle_cb) || idle_cb(arg))) {
+		cothreadj_bell_wait(sched->bell[0]);
+	}
+	COTHREAD_ATOMIC_STORE(&(sched->sleeping), 0);
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothreadj_sched_ring(cothreadj_sched_t* sched)
+{
+	//---Ring the doorbell if the owner may be blocked (the caller has published its work, sequentially consistent)---//
+	if (0 != COTHREAD_ATOMIC_LOAD(&(sched->sleeping))) {
+		COTHREAD_ATOMIC_FETCH_ADD(&(sched->nb_rings), 1);
+		cothreadj_bell_ring(sched->bell[1]);
+	}
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_sched_wait(cothreadj_sched_t* sched)
+{
+	return cothreadj_sched_wait_idle(sched, NULL, NULL);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_wake_remote(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->sched);
+	assert(NULL	== cothread->next);
+
+	//---Push the cothread, which may be resumed as soon as pushed (only the scheduler is touched afterwards)---//
+	cothreadj_sched_t*	sched	= cothread->sched;
+	cothreadj_t*		head;
+	do {
+		head			= (cothreadj_t*)COTHREAD_ATOMIC_LOAD_PTR(&(sched->inbox));
+		cothread->next	= head;
+	} while (!COTHREAD_ATOMIC_CAS_PTR(&(sched->inbox), head, cothread));
+
+	//---Ring the doorbell for the first wake of a burst only, if the owner may be blocked---//
+	if ((NULL == head) && (0 != COTHREAD_ATOMIC_LOAD(&(sched->sleeping)))) {
+		COTHREAD_ATOMIC_FETCH_ADD(&(sched->nb_rings), 1);
+		cothreadj_bell_ring(sched->bell[1]);
+	}
+}
@@ -0,0 +1,659 @@
+/**
+ * @brief		This file contains the shared-nothing mesh definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_mesh	cothread - shared-nothing mesh
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_mesh_def	Definitions
+ *				The [mesh](@ref _cothreadj_mesh_t) runs one OS thread per core, pinned to its CPU, each one running its
+ *				own [scheduler](@ref _cothreadj_sched_t): the data of a core is only ever touched by its OS thread, so
+ *				none of it needs a lock or an atomic operation. The cores only talk through
+ *				[messages](@ref _cothreadj_mesh_msg_t) sent over fixed-size single-producer single-consumer rings,
+ *				one per ordered pair of cores, which are the only memory two cores share.
+ *
+ * @section		doxy_p_cothreadj_mesh_msg	Messages
+ *				A cothread submits a message to a core (see @ref cothreadj_mesh_submit), which runs its callback in
+ *				between its own cothreads, then sends the message back over the ring of the reverse direction. The source
+ *				core marks it done & wakes the waiting cothread up (see @ref cothreadj_mesh_wait) with a local wake:
+ *				the message is the future of its request, and its completion needs no atomic operation either. The
+ *				state of a message is only ever touched by its source core, which tells the replies it receives from
+ *				the requests by their source index: the destination core never writes it while the source may read it.
+ *				A message which does not fit in its ring is appended to a backlog of the source core instead, sent
+ *				once the destination core makes room: submitting never blocks nor allocates.
+ *
+ * @section		doxy_p_cothreadj_mesh_use	Usage
+ *				-# Initialize the mesh with the @ref cothreadj_mesh_init function ;
+ *				-# Call the @ref cothreadj_mesh_run function, whose main callback runs on every core. It typically
+ *				spawns the cothreads of the core, which submit messages to the other cores & wait for them ;
+ *				-# Finally, call the @ref cothreadj_mesh_uninit function.
+ *				.
+ *
+ * @section		doxy_p_cothreadj_mesh_impl	Implementation
+ *				The producer & the consumer of a ring each keep a copy of the index of the other side, next to their
+ *				own index, and only reload it once the ring looks full or empty: in a burst, the indexes are exchanged
+ *				once, not once per message. An idle core blocks on the doorbell of its scheduler, checking its rings
+ *				once it published it may block, and the producers ring it after publishing their message (see inbox.c.)
+ *				The scheduler of a core polls its rings each time one of its cothreads is back in it (see
+ *				@ref _cothreadj_sched_t::poller), so a core whose cothreads keep yielding still serves the requests
+ *				& receives the replies.
+ *				The run is over once no core has any alive cothread or backlog: as a message is waited for by an alive
+ *				cothread, none is in flight anymore. A core becomes busy again before replying to a message whose
+ *				callback spawned a cothread, while its submitter still keeps the count from dropping to zero.
+ */
+
+#if (defined(__gnu_linux__) && !defined(_GNU_SOURCE))
+	#define _GNU_SOURCE	// pthread_setaffinity_np.
+#endif
+
+#include <cothread/cothreadj_mesh.h>
+#include <cothread/atomic.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * @brief		The default number of slots of a ring.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_MESH_RING_SZ			256
+
+/**
+ * @brief		The size of a cache line, which the indexes of the two sides of a ring do not share.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_MESH_LINE_SZ			64
+
+/// @cond
+#define COTHREADJ_MESH_MSG_SENT			1	// sent to the destination core, until received back.
+#define COTHREADJ_MESH_MSG_DONE			2	// received back by the source core.
+/// @endcond
+
+/**
+ * @brief		Blocks the calling OS thread until a cothread of the specified scheduler is woken up from another one,
+ *				or the specified predicate is false once the owner published it may block (see inbox.c.)
+ * @param		[in]	sched	The scheduler, which is not running.
+ * @param		[in]	idle_cb	The predicate, which says whether the owner may block or not, NULL for always.
+ * @param		[in]	arg		The argument of the predicate.
+ * @return		Returns the same as @ref cothreadj_sched_wait.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK_HIDDEN cothread_err_t	COTHREAD_CALL cothreadj_sched_wait_idle	(cothreadj_sched_t* sched, int (COTHREAD_CALL * idle_cb)(void* arg), void* arg);
+
+/**
+ * @brief		Rings the doorbell of the specified scheduler if its owner may be blocked (see inbox.c.)
+ * @param		[in]	sched	The scheduler, whose owner has to see what the caller published beforehand.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL cothreadj_sched_ring		(cothreadj_sched_t* sched);
+
+/**
+ * @brief		Gives the rest of the time slice of the current OS thread to another one (see parallel.c.)
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL cothreadj_pool_os_yield	(void);
+
+/**
+ * @brief		Returns the number of online CPUs (see parallel.c.)
+ * @return		Returns the number of online CPUs, at least one.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK_HIDDEN size_t			COTHREAD_CALL cothreadj_pool_nb_cpus	(void);
+
+/**
+ * @brief		The single-producer single-consumer ring type, whose slots are stored apart.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_mesh_ring_t
+{
+	volatile long	tail;		///< @brief	The number of messages pushed, written by the producer only.
+	unsigned long	head_cache;	///< @brief	The copy of @ref head the producer last read.
+	char			pad0[COTHREADJ_MESH_LINE_SZ - sizeof(long) - sizeof(unsigned long)];
+	volatile long	head;		///< @brief	The number of messages popped, written by the consumer only.
+	unsigned long	tail_cache;	///< @brief	The copy of @ref tail the consumer last read.
+	char			pad1[COTHREADJ_MESH_LINE_SZ - sizeof(long) - sizeof(unsigned long)];
+};
+
+/**
+ * @brief		The task polling the rings of a core each time one of its cothreads is back in its scheduler.
+ * @ingroup		doxy_cothreadj
+ */
+typedef struct
+{
+	cothreadj_sched_task_t	node;	///< @brief	The task set as the poller of the scheduler of the core (first member.)
+	cothreadj_mesh_core_t*	core;	///< @brief	The core.
+} cothreadj_mesh_poller_t;
+
+/**
+ * @brief		The core type.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_mesh_core_t
+{
+	cothreadj_sched_t		sched;			///< @brief	The scheduler of the core OS thread (first member, see @ref cothreadj_mesh_core_id.)
+	cothreadj_t				cothread;		///< @brief	The main cothread.
+	cothreadj_mesh_t*		mesh;			///< @brief	The mesh the core belongs to.
+	size_t					id;				///< @brief	The index of the core in the mesh.
+	void*					stack;			///< @brief	The stack of the main cothread.
+	size_t					stack_sz;		///< @brief	The size of the stack of the main cothread, in bytes.
+	cothreadj_mesh_msg_t**	backlog_heads;	///< @brief	The first message waiting for room in the ring to each core, NULL if none.
+	cothreadj_mesh_msg_t**	backlog_tails;	///< @brief	The last message waiting for room in the ring to each core, NULL if none.
+	size_t					nb_backlog;		///< @brief	The number of messages waiting for room.
+	int						busy;			///< @brief	Says whether the core is counted in @ref _cothreadj_mesh_t::nb_busy or not.
+	cothreadj_mesh_poller_t	poller;			///< @brief	The task polling the rings in between the cothreads.
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	HANDLE					thread;			///< @brief	The core OS thread.
+#else
+	pthread_t				thread;			///< @brief	The core OS thread.
+#endif
+};
+
+/**
+ * @brief		Returns the ring from the specified core to the specified one.
+ * @param		[in]	mesh	The mesh.
+ * @param		[in]	src		The index of the producer core.
+ * @param		[in]	dst		The index of the consumer core.
+ * @return		Returns the ring.
+ * @relates		_cothreadj_mesh_t
+ */
+static inline cothreadj_mesh_ring_t* COTHREAD_CALL
+cothreadj_mesh_ring(cothreadj_mesh_t* mesh, size_t src, size_t dst)
+{
+	return &(mesh->rings[(src * mesh->nb_cores) + dst]);
+}
+
+/**
+ * @brief		Pushes the specified message onto the specified ring, from its producer.
+ * @param		[in]	mesh	The mesh.
+ * @param		[in]	ring	The ring.
+ * @param		[in]	msg		The message.
+ * @return		Returns non-zero if pushed, zero if the ring is full.
+ * @relates		_cothreadj_mesh_t
+ */
+static inline int COTHREAD_CALL
+cothreadj_mesh_push(cothreadj_mesh_t* mesh, cothreadj_mesh_ring_t* ring, cothreadj_mesh_msg_t* msg)
+{
+	//---Is the ring full, even once the head reloaded ?---//
+	const unsigned long	tail	= (unsigned long)COTHREAD_ATOMIC_LOAD_RLX(&(ring->tail));
+	if ((tail - ring->head_cache) >= mesh->ring_sz) {
+		ring->head_cache	= (unsigned long)COTHREAD_ATOMIC_LOAD_ACQ(&(ring->head));
+		if ((tail - ring->head_cache) >= mesh->ring_sz) {
+			return 0;
+		}
+	}
+
+	//---Publish the message (sequentially consistent, for the doorbell)---//
+	void**	slots	= mesh->slots + ((size_t)(ring - mesh->rings) * mesh->ring_sz);
+	slots[tail & (mesh->ring_sz - 1)]	= msg;
+	COTHREAD_ATOMIC_STORE(&(ring->tail), (long)(tail + 1));
+	return !0;
+}
+
+/**
+ * @brief		Pops the oldest message of the specified ring, from its consumer.
+ * @param		[in]	mesh	The mesh.
+ * @param		[in]	ring	The ring.
+ * @return		Returns the message, NULL if the ring is empty.
+ * @relates		_cothreadj_mesh_t
+ */
+static inline cothreadj_mesh_msg_t* COTHREAD_CALL
+cothreadj_mesh_pop(cothreadj_mesh_t* mesh, cothreadj_mesh_ring_t* ring)
+{
+	//---Is the ring empty, even once the tail reloaded ?---//
+	const unsigned long	head	= (unsigned long)COTHREAD_ATOMIC_LOAD_RLX(&(ring->head));
+	if (head == ring->tail_cache) {
+		ring->tail_cache	= (unsigned long)COTHREAD_ATOMIC_LOAD_ACQ(&(ring->tail));
+		if (head == ring->tail_cache) {
+			return NULL;
+		}
+	}
+
+	//---Take the message, then give its slot back---//
+	void**					slots	= mesh->slots + ((size_t)(ring - mesh->rings) * mesh->ring_sz);
+	cothreadj_mesh_msg_t*	msg		= (cothreadj_mesh_msg_t*)slots[head & (mesh->ring_sz - 1)];
+	COTHREAD_ATOMIC_STORE_REL(&(ring->head), (long)(head + 1));
+	return msg;
+}
+
+/**
+ * @brief		Sends the specified message to the specified core, or appends it to the backlog if the ring is full.
+ * @param		[in]	core	The source core.
+ * @param		[in]	dst		The index of the destination core.
+ * @param		[in]	msg		The message, which must not be touched once sent.
+ * @relates		_cothreadj_mesh_t
+ */
+static void COTHREAD_CALL
+cothreadj_mesh_send(cothreadj_mesh_core_t* core, size_t dst, cothreadj_mesh_msg_t* msg)
+{
+	//---Push the message unless older ones are waiting for room---//
+	cothreadj_mesh_t*	mesh	= core->mesh;
+	msg->next	= NULL;
+	if ((NULL == core->backlog_heads[dst]) && cothreadj_mesh_push(mesh, cothreadj_mesh_ring(mesh, core->id, dst), msg)) {
+		cothreadj_sched_ring(&(mesh->cores[dst].sched));
+		return;
+	}
+
+	//---Otherwise, append it to the backlog---//
+	if (NULL == core->backlog_heads[dst]) {
+		core->backlog_heads[dst]	= msg;
+	} else {
+		core->backlog_tails[dst]->next	= msg;
+	}
+	core->backlog_tails[dst]	= msg;
+	core->nb_backlog++;
+}
+
+/**
+ * @brief		Says whether the specified core is busy or not, and stops the run if it was the last busy one.
+ * @param		[in]	core	The core.
+ * @param		[in]	busy	Says whether the core is busy or not.
+ * @relates		_cothreadj_mesh_t
+ */
+static void COTHREAD_CALL
+cothreadj_mesh_set_busy(cothreadj_mesh_core_t* core, int busy)
+{
+	//---Has the state changed ?---//
+	cothreadj_mesh_t*	mesh	= core->mesh;
+	if (!busy == !core->busy) {
+		return;
+	}
+	core->busy	= busy;
+
+	//---Count the core, or stop the run & wake every core up if the last busy one---//
+	if (busy) {
+		COTHREAD_ATOMIC_FETCH_ADD(&(mesh->nb_busy), 1);
+	} else if (1 == COTHREAD_ATOMIC_FETCH_ADD(&(mesh->nb_busy), -1)) {
+		COTHREAD_ATOMIC_STORE(&(mesh->stopping), 1);
+		for (size_t i = 0; i < mesh->nb_cores; i++) {
+			cothreadj_sched_ring(&(mesh->cores[i].sched));
+		}
+	}
+}
+
+/**
+ * @brief		Handles the messages received by the specified core, then sends its backlog.
+ * @param		[in]	core	The core.
+ * @return		Returns non-zero if any message has been received or sent, zero otherwise.
+ * @relates		_cothreadj_mesh_t
+ */
+static int COTHREAD_CALL
+cothreadj_mesh_poll(cothreadj_mesh_core_t* core)
+{
+	cothreadj_mesh_t*	mesh		= core->mesh;
+	int					progress	= 0;
+
+	//---Handle the received messages---//
+	for (size_t src = 0; src < mesh->nb_cores; src++) {
+		if (src == core->id) {
+			continue;
+		}
+		cothreadj_mesh_ring_t*	ring	= cothreadj_mesh_ring(mesh, src, core->id);
+		cothreadj_mesh_msg_t*	msg;
+		while (NULL != (msg = cothreadj_mesh_pop(mesh, ring))) {
+			progress	= !0;
+			if (msg->src != core->id) {
+				//---Run the callback & reply, counting the core first if the callback spawned cothreads (the state is the source's)---//
+				msg->cb(&(core->sched), msg);
+				if (0 != core->sched.nb_alive) {
+					cothreadj_mesh_set_busy(core, !0);
+				}
+				cothreadj_mesh_send(core, src, msg);
+			} else {
+				//---Complete the message & wake its waiter up, if any---//
+				assert(COTHREADJ_MESH_MSG_SENT	== msg->state);
+				cothreadj_t*	waiter	= msg->waiter;
+				msg->state	= COTHREADJ_MESH_MSG_DONE;
+				msg->waiter	= NULL;
+				if (NULL != waiter) {
+					cothreadj_sched_wake(waiter);
+				}
+			}
+		}
+	}
+
+	//---Send the backlog, as far as the rings have room (the next member is reset before the message is published)---//
+	for (size_t dst = 0; (0 != core->nb_backlog) && (dst < mesh->nb_cores); dst++) {
+		cothreadj_mesh_ring_t*	ring	= cothreadj_mesh_ring(mesh, core->id, dst);
+		cothreadj_mesh_msg_t*	msg;
+		int						sent	= 0;
+		while (NULL != (msg = core->backlog_heads[dst])) {
+			cothreadj_mesh_msg_t*	next	= msg->next;
+			msg->next	= NULL;
+			if (!cothreadj_mesh_push(mesh, ring, msg)) {
+				msg->next	= next;
+				break;
+			}
+			core->backlog_heads[dst]	= next;
+			core->nb_backlog--;
+			sent	= !0;
+		}
+		if (NULL == core->backlog_heads[dst]) {
+			core->backlog_tails[dst]	= NULL;
+		}
+		if (sent) {
+			progress	= !0;
+			cothreadj_sched_ring(&(mesh->cores[dst].sched));
+		}
+	}
+	return progress;
+}
+
+/**
+ * @brief		Polls the rings of the core of the specified task, in between the cothreads of the core.
+ * @param		[in]	task	The task embedded in the poller of the core.
+ * @relates		_cothreadj_mesh_t
+ */
+static void COTHREAD_CALL
+cothreadj_mesh_poll_cb(cothreadj_sched_task_t* task)
+{
+	(void)cothreadj_mesh_poll(((cothreadj_mesh_poller_t*)task)->core);
+}
+
+/**
+ * @brief		Says whether the specified core may block or not, once it published it may.
+ * @param		[in]	arg		The core.
+ * @return		Returns non-zero if no ring to the core holds any message & the run is not over, zero otherwise.
+ * @relates		_cothreadj_mesh_t
+ */
+static int COTHREAD_CALL
+cothreadj_mesh_idle(void* arg)
+{
+	cothreadj_mesh_core_t*	core	= (cothreadj_mesh_core_t*)arg;
+	cothreadj_mesh_t*		mesh	= core->mesh;
+	for (size_t src = 0; src < mesh->nb_cores; src++) {
+		cothreadj_mesh_ring_t*	ring	= cothreadj_mesh_ring(mesh, src, core->id);
+		if ((src != core->id) && (COTHREAD_ATOMIC_LOAD(&(ring->tail)) != ring->head)) {
+			return 0;
+		}
+	}
+	return 0 == COTHREAD_ATOMIC_LOAD(&(mesh->stopping));
+}
+
+/**
+ * @brief		The main cothread entry point, which runs the main callback of the mesh.
+ * @param		[in]	cothread	The cothread, whose user data is the core.
+ * @param		[in]	user_val	Any user value (except zero) received from the scheduler.
+ * @return		Returns any user value (except zero) to send to the scheduler.
+ * @ingroup		doxy_cothreadj
+ */
+static int COTHREAD_CALL
+cothreadj_mesh_main_cb(cothreadj_t* cothread, int user_val)
+{
+	cothreadj_mesh_core_t*	core	= (cothreadj_mesh_core_t*)cothreadj_get_user_data(cothread);
+	core->mesh->main_cb(cothread, core->mesh->user_data);
+	return user_val;
+}
+
+/**
+ * @brief		Pins the calling OS thread to the CPU of the specified core, where supported.
+ * @param		[in]	core	The core.
+ * @ingroup		doxy_cothreadj
+ */
+static void COTHREAD_CALL
+cothreadj_mesh_pin(cothreadj_mesh_core_t* core)
+{
+	const size_t	cpu	= core->id % cothreadj_pool_nb_cpus();
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	cpu_set_t	set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	(void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif	(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	(void)SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (cpu % (8 * sizeof(DWORD_PTR))));
+#else
+	(void)cpu;	// the OS places the threads (no portable affinity API.)
+#endif
+}
+
+/**
+ * @brief		The core OS thread entry point.
+ * @param		[in]	core	The core.
+ * @ingroup		doxy_cothreadj
+ */
+static void COTHREAD_CALL
+cothreadj_mesh_core_main(cothreadj_mesh_core_t* core)
+{
+	//---Wait for every OS thread to start, unless the run is aborted---//
+	cothreadj_mesh_t*	mesh	= core->mesh;
+	long				gate;
+	while (0 == (gate = COTHREAD_ATOMIC_LOAD(&(mesh->gate)))) {
+		cothreadj_pool_os_yield();
+	}
+	if (0 > gate) {
+		return;
+	}
+
+	//---Spawn the main cothread---//
+	cothreadj_attr_t	attr;
+	cothreadj_mesh_pin(core);
+	cothreadj_sched_init(&(core->sched));
+	cothreadj_attr_init(&attr, core->stack, core->stack_sz, cothreadj_mesh_main_cb);
+	cothreadj_init(&(core->cothread), &attr);
+	cothreadj_set_user_data(&(core->cothread), core);
+	cothreadj_sched_spawn(&(core->sched), &(core->cothread));
+	cothreadj_sched_task_init(&(core->poller.node), cothreadj_mesh_poll_cb);
+	core->poller.core	= core;
+	core->sched.poller	= &(core->poller.node);
+
+	//---Run the cothreads & handle the messages until no core is busy, blocking while idle---//
+	for (;;) {
+		const size_t	nb_alive	= cothreadj_sched_run(&(core->sched));
+		if (cothreadj_mesh_poll(core)) {
+			continue;
+		}
+		cothreadj_mesh_set_busy(core, (0 != nb_alive) || (0 != core->nb_backlog));
+		if (0 != COTHREAD_ATOMIC_LOAD(&(mesh->stopping))) {
+			break;
+		}
+		if ((0 != core->nb_backlog) || (cothread_err_ok != cothreadj_sched_wait_idle(&(core->sched), cothreadj_mesh_idle, core))) {
+			cothreadj_pool_os_yield();
+		}
+	}
+
+	//---Release---//
+	cothreadj_uninit(&(core->cothread));
+	cothreadj_sched_uninit(&(core->sched));
+}
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+/// @cond
+static DWORD WINAPI	cothreadj_mesh_thread_main(LPVOID arg)	{ cothreadj_mesh_core_main((cothreadj_mesh_core_t*)arg); return 0; }
+#define cothreadj_mesh_thread_start(_core)	(NULL != ((_core)->thread = CreateThread(NULL, 0, cothreadj_mesh_thread_main, (_core), 0, NULL)))
+#define cothreadj_mesh_thread_join(_core)	{ WaitForSingleObject((_core)->thread, INFINITE); CloseHandle((_core)->thread); }
+/// @endcond
+#else
+/// @cond
+static void*		cothreadj_mesh_thread_main(void* arg)	{ cothreadj_mesh_core_main((cothreadj_mesh_core_t*)arg); return NULL; }
+#define cothreadj_mesh_thread_start(_core)	(0 == pthread_create(&((_core)->thread), NULL, cothreadj_mesh_thread_main, (_core)))
+#define cothreadj_mesh_thread_join(_core)	pthread_join((_core)->thread, NULL)
+/// @endcond
+#endif
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_mesh_uninit(cothreadj_mesh_t* mesh)
+{
+	//---Check arguments---//
+	assert(NULL	!= mesh);
+	assert(NULL	== mesh->main_cb);
+
+	//---Release the cores (which may be partially allocated) & the rings---//
+	if (NULL != mesh->cores) {
+		for (size_t i = 0; i < mesh->nb_cores; i++) {
+			free(mesh->cores[i].stack);
+			free(mesh->cores[i].backlog_heads);
+		}
+		free(mesh->cores);
+	}
+	free(mesh->rings);
+	free(mesh->slots);
+	mesh->cores		= NULL;
+	mesh->rings		= NULL;
+	mesh->slots		= NULL;
+	mesh->nb_cores	= 0;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_mesh_init(cothreadj_mesh_t* mesh, size_t nb_cores, size_t ring_sz, size_t stack_sz)
+{
+	//---Check arguments---//
+	assert(NULL	!= mesh);
+	assert(0	!= stack_sz);
+
+	//---Round the size of the rings up to a power of two---//
+	if (0 == nb_cores) {
+		nb_cores	= cothreadj_pool_nb_cpus();
+	}
+	if (0 == ring_sz) {
+		ring_sz	= COTHREADJ_MESH_RING_SZ;
+	}
+	for (mesh->ring_sz = 1; mesh->ring_sz < ring_sz; mesh->ring_sz <<= 1) {
+	}
+
+	//---Allocate the cores & the rings---//
+	mesh->nb_cores	= nb_cores;
+	mesh->main_cb	= NULL;
+	mesh->user_data	= NULL;
+	mesh->nb_busy	= 0;
+	mesh->stopping	= 0;
+	mesh->gate		= 0;
+	mesh->cores		= (cothreadj_mesh_core_t*)calloc(nb_cores, sizeof(cothreadj_mesh_core_t));
+	mesh->rings		= (cothreadj_mesh_ring_t*)calloc(nb_cores * nb_cores, sizeof(cothreadj_mesh_ring_t));
+	mesh->slots		= (void**)malloc(nb_cores * nb_cores * mesh->ring_sz * sizeof(void*));
+	if ((NULL == mesh->cores) || (NULL == mesh->rings) || (NULL == mesh->slots)) {
+		cothreadj_mesh_uninit(mesh);
+		return cothread_err_nomem;
+	}
+	for (size_t i = 0; i < nb_cores; i++) {
+		cothreadj_mesh_core_t*	core	= &(mesh->cores[i]);
+		core->mesh		= mesh;
+		core->id		= i;
+		core->stack_sz	= stack_sz;
+		core->stack		= malloc(stack_sz);
+		core->backlog_heads	= (cothreadj_mesh_msg_t**)calloc(2 * nb_cores, sizeof(cothreadj_mesh_msg_t*));
+		if ((NULL == core->stack) || (NULL == core->backlog_heads)) {
+			cothreadj_mesh_uninit(mesh);
+			return cothread_err_nomem;
+		}
+		core->backlog_tails	= core->backlog_heads + nb_cores;
+	}
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_mesh_run(cothreadj_mesh_t* mesh, cothreadj_mesh_main_cb_t main_cb, void* user_data)
+{
+	//---Check arguments---//
+	assert(NULL	!= mesh);
+	assert(NULL	!= main_cb);
+	assert(NULL	== mesh->main_cb);
+
+	//---Every core is busy with its main cothread until it tells otherwise---//
+	mesh->main_cb	= main_cb;
+	mesh->user_data	= user_data;
+	mesh->nb_busy	= (long)mesh->nb_cores;
+	mesh->stopping	= 0;
+	mesh->gate		= 0;
+	for (size_t i = 0; i < mesh->nb_cores; i++) {
+		mesh->cores[i].busy	= !0;
+	}
+
+	//---Start the OS threads, which wait for the gate to open, or abort---//
+	size_t	nb_started	= 0;
+	while ((nb_started < mesh->nb_cores) && cothreadj_mesh_thread_start(&(mesh->cores[nb_started]))) {
+		nb_started++;
+	}
+	COTHREAD_ATOMIC_STORE(&(mesh->gate), (nb_started == mesh->nb_cores) ? 1 : -1);
+
+	//---Wait for the run to be over---//
+	for (size_t i = 0; i < nb_started; i++) {
+		cothreadj_mesh_thread_join(&(mesh->cores[i]));
+	}
+	mesh->main_cb	= NULL;
+	mesh->user_data	= NULL;
+	return (nb_started == mesh->nb_cores) ? cothread_err_ok : cothread_err_notsup;
+}
+
+extern COTHREAD_LINK size_t COTHREAD_CALL
+cothreadj_mesh_core_id(const cothreadj_t* cothread)
+{
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->sched);
+	return ((const cothreadj_mesh_core_t*)cothread->sched)->id;
+}
+
+extern COTHREAD_LINK cothreadj_mesh_t* COTHREAD_CALL
+cothreadj_mesh_get(const cothreadj_t* cothread)
+{
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->sched);
+	return ((const cothreadj_mesh_core_t*)cothread->sched)->mesh;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_mesh_msg_init(cothreadj_mesh_msg_t* msg, cothreadj_mesh_msg_cb_t cb, void* user_data)
+{
+	assert(NULL	!= msg);
+	assert(NULL	!= cb);
+	msg->next		= NULL;
+	msg->cb			= cb;
+	msg->user_data	= user_data;
+	msg->waiter		= NULL;
+	msg->src		= 0;
+	msg->dst		= 0;
+	msg->state		= 0;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_mesh_submit(cothreadj_t* cothread, size_t core, cothreadj_mesh_msg_t* msg)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->sched);
+	assert(NULL	!= msg);
+	assert((0 == msg->state) || (COTHREADJ_MESH_MSG_DONE == msg->state));
+	cothreadj_mesh_core_t*	src	= (cothreadj_mesh_core_t*)cothread->sched;
+	assert(core	< src->mesh->nb_cores);
+
+	//---Run the callback inline if local, otherwise send the message---//
+	msg->src	= src->id;
+	msg->dst	= core;
+	msg->waiter	= NULL;
+	msg->state	= COTHREADJ_MESH_MSG_SENT;
+	if (core == src->id) {
+		msg->cb(cothread->sched, msg);
+		msg->state	= COTHREADJ_MESH_MSG_DONE;
+	} else {
+		cothreadj_mesh_send(src, core, msg);
+	}
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_mesh_is_done(const cothreadj_mesh_msg_t* msg)
+{
+	assert(NULL	!= msg);
+	return COTHREADJ_MESH_MSG_DONE == msg->state;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_mesh_wait(cothreadj_mesh_msg_t* msg, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= msg);
+	assert(NULL	!= cothread);
+	assert(NULL	== msg->waiter);
+	assert(msg->src	== cothreadj_mesh_core_id(cothread));
+
+	//---Park until the message is back---//
+	while (COTHREADJ_MESH_MSG_DONE != msg->state) {
+		msg->waiter	= cothread;
+		cothreadj_sched_park(cothread);
+	}
+}
@@ -0,0 +1,427 @@
+/**
+ * @brief		This file contains the parallel loops definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_parallel	cothread - parallel loops
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_parallel_def	Definitions
+ *				The [pool](@ref _cothreadj_pool_t) starts one OS thread per worker, each one running its own
+ *				[scheduler](@ref _cothreadj_sched_t) and a single worker cothread, parked in between the loops.
+ *				A loop wakes every worker cothread up remotely (see @ref cothreadj_sched_wake_remote), parks the
+ *				calling cothread, and the last worker to run out of chunks wakes the caller up the same way:
+ *				no OS thread ever blocks on a join, the one of the caller keeps on running its other cothreads.
+ *
+ * @section		doxy_p_cothreadj_parallel_grain	Chunks
+ *				The workers claim their chunks from a shared cursor, with a compare-and-swap. A chunk spans
+ *				the remaining indexes divided by twice the number of workers, but never less than the grain:
+ *				the chunks are large while there is much work left, which keeps the contention on the cursor low,
+ *				and shrink toward the grain as the range is consumed, which balances the load of the workers
+ *				without having to tune the grain for each loop.
+ *
+ * @section		doxy_p_cothreadj_parallel_use	Usage
+ *				-# Initialize the pool with the @ref cothreadj_pool_init function ;
+ *				-# From a spawned cothread, call the @ref cothreadj_parallel_for or the @ref cothreadj_parallel_reduce
+ *				function, while the OS thread of the scheduler keeps on calling the @ref cothreadj_sched_run and
+ *				the @ref cothreadj_sched_wait functions ;
+ *				-# Finally, call the @ref cothreadj_pool_uninit function to stop the workers.
+ *				.
+ */
+
+#include <cothread/cothreadj_parallel.h>
+#include <cothread/atomic.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief		The worker type.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_pool_worker_t
+{
+	cothreadj_sched_t	sched;		///< @brief	The scheduler of the worker OS thread.
+	cothreadj_t			cothread;	///< @brief	The worker cothread.
+	cothreadj_pool_t*	pool;		///< @brief	The pool the worker belongs to.
+	size_t				id;			///< @brief	The index of the worker in the pool.
+	void*				stack;		///< @brief	The stack of the worker cothread.
+	size_t				stack_sz;	///< @brief	The size of the stack of the worker cothread, in bytes.
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	HANDLE				thread;		///< @brief	The worker OS thread.
+#else
+	pthread_t			thread;		///< @brief	The worker OS thread.
+#endif
+};
+
+/**
+ * @brief		The parallel loop type, which lives on the stack of the calling cothread.
+ * @ingroup		doxy_cothreadj
+ */
+typedef struct
+{
+	cothreadj_t*					caller;		///< @brief	The calling cothread, parked until the loop is over.
+	void* volatile					next;		///< @brief	The first index which has not been claimed yet (as a pointer, for the compare-and-swap.)
+	size_t							end;		///< @brief	The index following the last one of the range.
+	size_t							grain;		///< @brief	The minimum number of indexes of a chunk.
+	size_t							nb_workers;	///< @brief	The number of workers.
+	volatile long					nb_pending;	///< @brief	The number of workers which have not run out of chunks yet.
+	cothreadj_parallel_for_cb_t		for_cb;		///< @brief	The parallel-for body, NULL for a parallel-reduce.
+	cothreadj_parallel_map_cb_t		map_cb;		///< @brief	The parallel-reduce body, NULL for a parallel-for.
+	void*							accs;		///< @brief	The partial results, one per worker, NULL for a parallel-for.
+	size_t							acc_sz;		///< @brief	The size of a partial result, in bytes.
+	void*							user_data;	///< @brief	Any user data.
+} cothreadj_parallel_job_t;
+
+/**
+ * @brief		Gives the rest of the time slice of the current OS thread to another one.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothreadj_pool_os_yield(void)
+{
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+/**
+ * @brief		Returns the number of online CPUs.
+ * @return		Returns the number of online CPUs, at least one.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK_HIDDEN size_t COTHREAD_CALL
+cothreadj_pool_nb_cpus(void)
+{
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+	SYSTEM_INFO	info;
+	GetSystemInfo(&info);
+	return (0 < info.dwNumberOfProcessors) ? (size_t)info.dwNumberOfProcessors : 1;
+#else
+	const long	nb_cpus	= sysconf(_SC_NPROCESSORS_ONLN);
+	return (0 < nb_cpus) ? (size_t)nb_cpus : 1;
+#endif
+}
+
+/**
+ * @brief		Claims the next chunk of the specified loop.
+ * @param		[in]	job		The loop.
+ * @param		[out]	begin	Receives the first index of the chunk.
+ * @param		[out]	end		Receives the index following the last one of the chunk.
+ * @return		Returns non-zero if a chunk has been claimed, zero once the range is consumed.
+ * @ingroup		doxy_cothreadj
+ */
+static int COTHREAD_CALL
+cothreadj_parallel_claim(cothreadj_parallel_job_t* job, size_t* begin, size_t* end)
+{
+	for (;;) {
+		//---Is the range consumed ?---//
+		void*			next	= COTHREAD_ATOMIC_LOAD_PTR(&(job->next));
+		const size_t	first	= (size_t)(uintptr_t)next;
+		if (job->end <= first) {
+			return 0;
+		}
+
+		//---Shrink the chunks as the range is consumed---//
+		const size_t	nb_left	= job->end - first;
+		size_t			nb		= nb_left / (2 * job->nb_workers);
+		if (nb < job->grain) {
+			nb	= (nb_left < job->grain) ? nb_left : job->grain;
+		}
+
+		//---Claim the chunk unless another worker has been faster---//
+		if (COTHREAD_ATOMIC_CAS_PTR(&(job->next), next, (void*)(uintptr_t)(first + nb))) {
+			*begin	= first;
+			*end	= first + nb;
+			return !0;
+		}
+	}
+}
+
+/**
+ * @brief		Runs the chunks of the specified loop until the range is consumed, then tells the caller.
+ * @param		[in]	job			The loop.
+ * @param		[in]	worker		The worker.
+ * @ingroup		doxy_cothreadj
+ */
+static void COTHREAD_CALL
+cothreadj_parallel_run(cothreadj_parallel_job_t* job, cothreadj_pool_worker_t* worker)
+{
+	//---Run the chunks---//
+	void*	acc	= (NULL == job->accs) ? NULL : (char*)job->accs + (worker->id * job->acc_sz);
+	size_t	begin;
+	size_t	end;
+	while (cothreadj_parallel_claim(job, &begin, &end)) {
+		if (NULL != job->map_cb) {
+			job->map_cb(&(worker->cothread), begin, end, acc, job->user_data);
+		} else {
+			job->for_cb(&(worker->cothread), begin, end, job->user_data);
+		}
+	}
+
+	//---Wake the caller up if the last one (the loop must not be touched once done)---//
+	cothreadj_t*	caller	= job->caller;
+	if (1 == COTHREAD_ATOMIC_FETCH_ADD(&(job->nb_pending), -1)) {
+		cothreadj_sched_wake_remote(caller);
+	}
+}
+
+/**
+ * @brief		The worker cothread entry point, which runs the loops until woken up without any.
+ * @param		[in]	cothread	The cothread, whose user data is the worker.
+ * @param		[in]	user_val	Any user value (except zero) received from the scheduler.
+ * @return		Returns any user value (except zero) to send to the scheduler.
+ * @ingroup		doxy_cothreadj
+ */
+static int COTHREAD_CALL
+cothreadj_pool_worker_cb(cothreadj_t* cothread, int user_val)
+{
+	cothreadj_pool_worker_t*	worker	= (cothreadj_pool_worker_t*)cothreadj_get_user_data(cothread);
+	cothreadj_pool_t*			pool	= worker->pool;
+
+	//---Tell the pool the worker may be woken up (which is safe as soon as its scheduler drains the inbox afterward)---//
+	COTHREAD_ATOMIC_FETCH_ADD(&(pool->nb_ready), 1);
+
+	//---Run the loops---//
+	for (;;) {
+		cothreadj_sched_park(cothread);
+		cothreadj_parallel_job_t*	job	= (cothreadj_parallel_job_t*)COTHREAD_ATOMIC_LOAD_PTR(&(pool->job));
+		if (NULL == job) {
+			break;
+		}
+		cothreadj_parallel_run(job, worker);
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The worker OS thread entry point.
+ * @param		[in]	worker	The worker.
+ * @ingroup		doxy_cothreadj
+ */
+static void COTHREAD_CALL
+cothreadj_pool_worker_main(cothreadj_pool_worker_t* worker)
+{
+	//---Spawn the worker cothread---//
+	cothreadj_attr_t	attr;
+	cothreadj_sched_init(&(worker->sched));
+	cothreadj_attr_init(&attr, worker->stack, worker->stack_sz, cothreadj_pool_worker_cb);
+	cothreadj_init(&(worker->cothread), &attr);
+	cothreadj_set_user_data(&(worker->cothread), worker);
+	cothreadj_sched_spawn(&(worker->sched), &(worker->cothread));
+
+	//---Run it until it returns, blocking in between the loops---//
+	while (0 != cothreadj_sched_run(&(worker->sched))) {
+		if (cothread_err_ok != cothreadj_sched_wait(&(worker->sched))) {
+			cothreadj_pool_os_yield();
+		}
+	}
+
+	//---Release---//
+	cothreadj_uninit(&(worker->cothread));
+	cothreadj_sched_uninit(&(worker->sched));
+}
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+/// @cond
+static DWORD WINAPI	cothreadj_pool_thread_main(LPVOID arg)	{ cothreadj_pool_worker_main((cothreadj_pool_worker_t*)arg); return 0; }
+#define cothreadj_pool_thread_start(_worker)	(NULL != ((_worker)->thread = CreateThread(NULL, 0, cothreadj_pool_thread_main, (_worker), 0, NULL)))
+#define cothreadj_pool_thread_join(_worker)		{ WaitForSingleObject((_worker)->thread, INFINITE); CloseHandle((_worker)->thread); }
+/// @endcond
+#else
+/// @cond
+static void*		cothreadj_pool_thread_main(void* arg)	{ cothreadj_pool_worker_main((cothreadj_pool_worker_t*)arg); return NULL; }
+#define cothreadj_pool_thread_start(_worker)	(0 == pthread_create(&((_worker)->thread), NULL, cothreadj_pool_thread_main, (_worker)))
+#define cothreadj_pool_thread_join(_worker)		pthread_join((_worker)->thread, NULL)
+/// @endcond
+#endif
+
+/**
+ * @brief		Stops the specified started workers & releases all of them.
+ * @param		[in]	pool		The pool.
+ * @param		[in]	nb_started	The number of started workers.
+ * @relates		_cothreadj_pool_t
+ */
+static void COTHREAD_CALL
+cothreadj_pool_stop(cothreadj_pool_t* pool, size_t nb_started)
+{
+	//---Wait for the started workers to park, then wake them up without any loop---//
+	while ((long)nb_started != COTHREAD_ATOMIC_LOAD(&(pool->nb_ready))) {
+		cothreadj_pool_os_yield();
+	}
+	(void)COTHREAD_ATOMIC_XCHG_PTR(&(pool->job), NULL);
+	for (size_t i = 0; i < nb_started; i++) {
+		cothreadj_sched_wake_remote(&(pool->workers[i].cothread));
+	}
+
+	//---Join them & release---//
+	for (size_t i = 0; i < nb_started; i++) {
+		cothreadj_pool_thread_join(&(pool->workers[i]));
+	}
+	for (size_t i = 0; i < pool->nb_workers; i++) {
+		free(pool->workers[i].stack);
+	}
+	free(pool->workers);
+	pool->workers		= NULL;
+	pool->nb_workers	= 0;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_pool_init(cothreadj_pool_t* pool, size_t nb_workers, size_t stack_sz)
+{
+	//---Check arguments---//
+	assert(NULL	!= pool);
+	assert(0	!= stack_sz);
+
+	//---Allocate the workers---//
+	if (0 == nb_workers) {
+		nb_workers	= cothreadj_pool_nb_cpus();
+	}
+	pool->job			= NULL;
+	pool->nb_ready		= 0;
+	pool->nb_workers	= nb_workers;
+	if (NULL == (pool->workers = (cothreadj_pool_worker_t*)calloc(nb_workers, sizeof(cothreadj_pool_worker_t)))) {
+		return cothread_err_nomem;
+	}
+	for (size_t i = 0; i < nb_workers; i++) {
+		cothreadj_pool_worker_t*	worker	= &(pool->workers[i]);
+		worker->pool		= pool;
+		worker->id			= i;
+		worker->stack_sz	= stack_sz;
+		if (NULL == (worker->stack = malloc(stack_sz))) {
+			cothreadj_pool_stop(pool, 0);
+			return cothread_err_nomem;
+		}
+	}
+
+	//---Start them---//
+	for (size_t i = 0; i < nb_workers; i++) {
+		if (!cothreadj_pool_thread_start(&(pool->workers[i]))) {
+			cothreadj_pool_stop(pool, i);
+			return cothread_err_notsup;
+		}
+	}
+
+	//---Wait for them to park---//
+	while ((long)nb_workers != COTHREAD_ATOMIC_LOAD(&(pool->nb_ready))) {
+		cothreadj_pool_os_yield();
+	}
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_pool_uninit(cothreadj_pool_t* pool)
+{
+	assert(NULL	!= pool);
+	assert(NULL	== pool->job);
+	cothreadj_pool_stop(pool, pool->nb_workers);
+}
+
+/**
+ * @brief		Runs the specified loop on the workers of the specified pool & parks the caller until it is over.
+ * @param		[in]	pool		The pool.
+ * @param		[in]	job			The loop, whose range is larger than the grain.
+ * @relates		_cothreadj_pool_t
+ */
+static void COTHREAD_CALL
+cothreadj_parallel_join(cothreadj_pool_t* pool, cothreadj_parallel_job_t* job)
+{
+	//---Check arguments---//
+	assert(NULL	!= pool);
+	assert(NULL	!= job);
+	assert(NULL	== COTHREAD_ATOMIC_LOAD_PTR(&(pool->job)));
+
+	//---Wake the workers up (the caller may be woken up before it parks, its scheduler drains the inbox afterward)---//
+	job->nb_workers	= pool->nb_workers;
+	job->nb_pending	= (long)pool->nb_workers;
+	(void)COTHREAD_ATOMIC_XCHG_PTR(&(pool->job), job);
+	for (size_t i = 0; i < pool->nb_workers; i++) {
+		cothreadj_sched_wake_remote(&(pool->workers[i].cothread));
+	}
+
+	//---Wait for the last one to run out of chunks---//
+	cothreadj_sched_park(job->caller);
+	(void)COTHREAD_ATOMIC_XCHG_PTR(&(pool->job), NULL);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_parallel_for(cothreadj_pool_t* pool, cothreadj_t* cothread, size_t begin, size_t end, size_t grain, cothreadj_parallel_for_cb_t cb, void* user_data)
+{
+	//---Check arguments---//
+	assert(NULL	!= pool);
+	assert(NULL	!= cothread);
+	assert(NULL	!= cb);
+	assert(begin	<= end);
+
+	//---Run small ranges inline---//
+	grain	= (0 == grain) ? 1 : grain;
+	if ((end - begin) <= grain) {
+		if (begin != end) {
+			cb(cothread, begin, end, user_data);
+		}
+		return;
+	}
+
+	//---Run on the workers---//
+	cothreadj_parallel_job_t	job;
+	job.caller		= cothread;
+	job.next		= (void*)(uintptr_t)begin;
+	job.end			= end;
+	job.grain		= grain;
+	job.for_cb		= cb;
+	job.map_cb		= NULL;
+	job.accs		= NULL;
+	job.acc_sz		= 0;
+	job.user_data	= user_data;
+	cothreadj_parallel_join(pool, &job);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_parallel_reduce(cothreadj_pool_t* pool, cothreadj_t* cothread, size_t begin, size_t end, size_t grain, cothreadj_parallel_map_cb_t map_cb, cothreadj_parallel_reduce_cb_t reduce_cb, void* accs, size_t acc_sz, void* user_data)
+{
+	//---Check arguments---//
+	assert(NULL	!= pool);
+	assert(NULL	!= cothread);
+	assert(NULL	!= map_cb);
+	assert(NULL	!= reduce_cb);
+	assert(NULL	!= accs);
+	assert(0	!= acc_sz);
+	assert(begin	<= end);
+
+	//---Run small ranges inline---//
+	grain	= (0 == grain) ? 1 : grain;
+	if ((end - begin) <= grain) {
+		if (begin != end) {
+			map_cb(cothread, begin, end, accs, user_data);
+		}
+		return;
+	}
+
+	//---Run on the workers---//
+	cothreadj_parallel_job_t	job;
+	job.caller		= cothread;
+	job.next		= (void*)(uintptr_t)begin;
+	job.end			= end;
+	job.grain		= grain;
+	job.for_cb		= NULL;
+	job.map_cb		= map_cb;
+	job.accs		= accs;
+	job.acc_sz		= acc_sz;
+	job.user_data	= user_data;
+	cothreadj_parallel_join(pool, &job);
+
+	//---Combine the partial results into the first one---//
+	for (size_t i = 1; i < pool->nb_workers; i++) {
+		reduce_cb(accs, (const char*)accs + (i * acc_sz), user_data);
+	}
+}
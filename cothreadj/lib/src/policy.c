@@ -0,0 +1,254 @@
+/**
+ * @brief		This file contains the scheduling policies definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_policy	cothread - scheduling policies
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_policy_def	Definitions
+ *				A [scheduler](@ref _cothreadj_sched_t) resumes its ready cothreads in the FIFO order, which treats
+ *				an interactive request like a batch job. A [policy](@ref _cothreadj_policy_t) orders them otherwise:
+ *				- the [FIFO](@ref _cothreadj_fifo_t) one, the same as the default order ;
+ *				- the [strict priority](@ref _cothreadj_prio_t) one, by priority level (see @ref cothreadj_set_prio) ;
+ *				- the [earliest deadline first](@ref _cothreadj_edf_t) one, by deadline (see @ref cothreadj_set_deadline.)
+ *				.
+ *
+ * @section		doxy_p_cothreadj_policy_use	Usage
+ *				-# Initialize the policy, e.g. with the @ref cothreadj_edf_init function ;
+ *				-# Set it to the scheduler, before any cothread is spawned, with the @ref cothreadj_sched_set_policy function ;
+ *				-# Set the deadline of each cothread before spawning or waking it, or from its callee before it yields.
+ *				.
+ *
+ * @section		doxy_p_cothreadj_policy_impl	Implementation
+ *				The strict priority policy keeps a FIFO queue per level and a bit mask of the non-empty ones,
+ *				the highest ready level being the lowest bit set. The earliest deadline first policy links the
+ *				cothreads in a pairing heap, through their @ref _cothreadj_t::sched_child member (the first child)
+ *				and their @ref _cothreadj_t::next one (the next sibling): pushing melds the cothread with the root,
+ *				popping melds the children of the root by pairs, then the pairs from the last one to the first one.
+ *				The deadlines are compared with the order they were made ready in, so equal deadlines are FIFO.
+ */
+
+#include <cothread/cothreadj_policy.h>
+#include <assert.h>
+
+#if		(COTHREAD_CC_ID_CL == COTHREAD_CC_ID)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief		Returns the index of the lowest bit set in the specified mask.
+ * @param		[in]	mask	The mask, not zero.
+ * @return		Returns the index of the lowest bit set.
+ * @ingroup		doxy_cothreadj
+ */
+static inline unsigned int COTHREAD_CALL
+cothreadj_prio_lowest(unsigned long mask)
+{
+#if		(COTHREAD_CC_ID_CL == COTHREAD_CC_ID)
+	unsigned long	idx;
+	_BitScanForward(&idx, mask);
+	return (unsigned int)idx;
+#else
+	return (unsigned int)__builtin_ctzl(mask);
+#endif
+}
+
+/**
+ * @brief		Makes the specified cothread ready, in the FIFO order.
+ * @param		[in]	policy		The FIFO policy.
+ * @param		[in]	cothread	The cothread.
+ * @relates		_cothreadj_fifo_t
+ */
+static void COTHREAD_CALL
+cothreadj_fifo_push(cothreadj_policy_t* policy, cothreadj_t* cothread)
+{
+	cothreadj_queue_push(&(((cothreadj_fifo_t*)policy)->queue), cothread);
+}
+
+/**
+ * @brief		Removes the first ready cothread.
+ * @param		[in]	policy		The FIFO policy.
+ * @return		Returns the removed cothread, NULL if none is ready.
+ * @relates		_cothreadj_fifo_t
+ */
+static cothreadj_t* COTHREAD_CALL
+cothreadj_fifo_pop(cothreadj_policy_t* policy)
+{
+	return cothreadj_queue_pop(&(((cothreadj_fifo_t*)policy)->queue));
+}
+
+/**
+ * @brief		Makes the specified cothread ready, behind the ones of its priority level.
+ * @param		[in]	policy		The strict priority policy.
+ * @param		[in]	cothread	The cothread.
+ * @relates		_cothreadj_prio_t
+ */
+static void COTHREAD_CALL
+cothreadj_prio_push(cothreadj_policy_t* policy, cothreadj_t* cothread)
+{
+	cothreadj_prio_t*	prio	= (cothreadj_prio_t*)policy;
+	assert(COTHREADJ_PRIO_NB_LEVELS	> cothread->sched_key);
+	cothreadj_queue_push(&(prio->queues[cothread->sched_key]), cothread);
+	prio->mask	|= 1UL << cothread->sched_key;
+}
+
+/**
+ * @brief		Removes the first ready cothread of the highest priority level.
+ * @param		[in]	policy		The strict priority policy.
+ * @return		Returns the removed cothread, NULL if none is ready.
+ * @relates		_cothreadj_prio_t
+ */
+static cothreadj_t* COTHREAD_CALL
+cothreadj_prio_pop(cothreadj_policy_t* policy)
+{
+	//---Is any cothread ready ?---//
+	cothreadj_prio_t*	prio	= (cothreadj_prio_t*)policy;
+	if (0 == prio->mask) {
+		return NULL;
+	}
+
+	//---Remove the first one of the highest level---//
+	const unsigned int	level		= cothreadj_prio_lowest(prio->mask);
+	cothreadj_t*		cothread	= cothreadj_queue_pop(&(prio->queues[level]));
+	if (NULL == prio->queues[level].head) {
+		prio->mask	&= ~(1UL << level);
+	}
+	return cothread;
+}
+
+/**
+ * @brief		Melds the specified heaps.
+ * @param		[in]	a	The root of the first heap, NULL if empty.
+ * @param		[in]	b	The root of the second heap, NULL if empty.
+ * @return		Returns the root of the melded heap, the one of @e a and @e b with the earliest deadline.
+ * @relates		_cothreadj_edf_t
+ */
+static inline cothreadj_t* COTHREAD_CALL
+cothreadj_edf_meld(cothreadj_t* a, cothreadj_t* b)
+{
+	//---Is any heap empty ?---//
+	if (NULL == a) {
+		return b;
+	} else if (NULL == b) {
+		return a;
+	}
+
+	//---Make the later root the first child of the earlier one---//
+	if ((b->sched_key < a->sched_key) || ((b->sched_key == a->sched_key) && (b->sched_seq < a->sched_seq))) {
+		cothreadj_t*	tmp	= a;
+		a	= b;
+		b	= tmp;
+	}
+	b->next			= a->sched_child;
+	a->sched_child	= b;
+	return a;
+}
+
+/**
+ * @brief		Makes the specified cothread ready, melding it with the heap.
+ * @param		[in]	policy		The earliest deadline first policy.
+ * @param		[in]	cothread	The cothread.
+ * @relates		_cothreadj_edf_t
+ */
+static void COTHREAD_CALL
+cothreadj_edf_push(cothreadj_policy_t* policy, cothreadj_t* cothread)
+{
+	cothreadj_edf_t*	edf	= (cothreadj_edf_t*)policy;
+	assert(NULL	== cothread->next);
+	cothread->sched_seq		= edf->nb_pushes++;
+	cothread->sched_child	= NULL;
+	edf->root	= cothreadj_edf_meld(edf->root, cothread);
+}
+
+/**
+ * @brief		Removes the ready cothread with the earliest deadline, melding its children back.
+ * @param		[in]	policy		The earliest deadline first policy.
+ * @return		Returns the removed cothread, NULL if none is ready.
+ * @relates		_cothreadj_edf_t
+ */
+static cothreadj_t* COTHREAD_CALL
+cothreadj_edf_pop(cothreadj_policy_t* policy)
+{
+	//---Is any cothread ready ?---//
+	cothreadj_edf_t*	edf		= (cothreadj_edf_t*)policy;
+	cothreadj_t*		root	= edf->root;
+	if (NULL == root) {
+		return NULL;
+	}
+
+	//---Meld the children by pairs, from the first one to the last one (the pairs are stacked)---//
+	cothreadj_t*	pairs		= NULL;
+	cothreadj_t*	children	= root->sched_child;
+	while (NULL != children) {
+		cothreadj_t*	a	= children;
+		cothreadj_t*	b	= a->next;
+		children	= (NULL != b) ? b->next : NULL;
+		a->next		= NULL;
+		if (NULL != b) {
+			b->next	= NULL;
+		}
+		cothreadj_t*	pair	= cothreadj_edf_meld(a, b);
+		pair->next	= pairs;
+		pairs		= pair;
+	}
+
+	//---Meld the pairs, from the last one to the first one---//
+	cothreadj_t*	heap	= NULL;
+	while (NULL != pairs) {
+		cothreadj_t*	pair	= pairs;
+		pairs		= pair->next;
+		pair->next	= NULL;
+		heap		= cothreadj_edf_meld(heap, pair);
+	}
+	edf->root			= heap;
+	root->sched_child	= NULL;
+	return root;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_fifo_init(cothreadj_fifo_t* fifo)
+{
+	assert(NULL	!= fifo);
+	fifo->policy.push	= cothreadj_fifo_push;
+	fifo->policy.pop	= cothreadj_fifo_pop;
+	cothreadj_queue_init(&(fifo->queue));
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_prio_init(cothreadj_prio_t* prio)
+{
+	assert(NULL	!= prio);
+	prio->policy.push	= cothreadj_prio_push;
+	prio->policy.pop	= cothreadj_prio_pop;
+	prio->mask			= 0;
+	for (unsigned int level = 0; level < COTHREADJ_PRIO_NB_LEVELS; level++) {
+		cothreadj_queue_init(&(prio->queues[level]));
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_edf_init(cothreadj_edf_t* edf)
+{
+	assert(NULL	!= edf);
+	edf->policy.push	= cothreadj_edf_push;
+	edf->policy.pop		= cothreadj_edf_pop;
+	edf->root			= NULL;
+	edf->nb_pushes		= 0;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_set_prio(cothreadj_t* cothread, unsigned int level)
+{
+	assert(NULL						!= cothread);
+	assert(COTHREADJ_PRIO_NB_LEVELS	> level);
+	cothread->sched_key	= level;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_set_deadline(cothreadj_t* cothread, uint64_t deadline_ns)
+{
+	assert(NULL	!= cothread);
+	cothread->sched_key	= deadline_ns;
+}
@@ -0,0 +1,211 @@
+/**
+ * @brief		This file contains the preemption definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_preempt	cothread - preemption
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_preempt_def	Definitions
+ *				A callee which seldom yields delays all the other ones of its OS thread. When the library is built
+ *				with @ref COTHREAD_WITH_PREEMPT, a per-thread timer signal marks the callee which has run for
+ *				a whole slice expired, and the callee yields back to its scheduler at its next checkpoint.
+ *
+ * @section		doxy_p_cothreadj_preempt_use	Usage
+ *				-# Call the @ref cothreadj_preempt_start function from the OS thread running the scheduler ;
+ *				-# Call the @ref cothreadj_checkpoint function from the long-running loops of the callees ;
+ *				-# Call the @ref cothreadj_preempt_stop function from the same OS thread once done.
+ *				.
+ *
+ * @section		doxy_p_cothreadj_preempt_impl	Implementation
+ *				The callee is never switched from the signal handler itself: it may have been interrupted anywhere,
+ *				e.g. within @c malloc, holding a lock the next callee would wait for. The handler rather reads the
+ *				switch epoch of its OS thread, which the switches bump just as for the watchdog: an epoch which has not
+ *				changed since the previous tick, while a callee runs, is recorded as expired. A checkpoint then merely
+ *				compares the current epoch with the expired one, and the yield it makes bumps the epoch, which
+ *				un-expires the next callee. A callee is thus expired after running for one to two slices.
+ *				The timer measures the CPU time of its OS thread (@c CLOCK_THREAD_CPUTIME_ID), so it does not tick
+ *				while the OS thread is idle, blocked (e.g. in @ref cothreadj_sched_wait) or descheduled.
+ */
+
+#if (defined(__gnu_linux__) && !defined(_GNU_SOURCE))
+	#define _GNU_SOURCE	// syscall & SIGEV_THREAD_ID.
+#endif
+
+#include <cothread/cothreadj_preempt.h>
+#include <cothread/cothreadj_watchdog.h>
+#include <assert.h>
+
+#if		(COTHREAD_WITH_PREEMPT && (COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID))
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef sigev_notify_thread_id
+	#define sigev_notify_thread_id	_sigev_un._tid	///< @brief	The thread the signal is sent to (older C libraries.)
+#endif
+
+/**
+ * @brief		The sliced OS thread type.
+ * @ingroup		doxy_cothreadj
+ */
+typedef struct _cothreadj_preempt_host_t
+{
+	timer_t					timer;		///< @brief	The timer raising SIGVTALRM.
+	int						started;	///< @brief	Says whether the timer is armed or not.
+	unsigned long			seen;		///< @brief	The epoch read by the previous tick.
+	volatile unsigned long	expired;	///< @brief	The epoch of the expired callee, an impossible one if none.
+} cothreadj_preempt_host_t;
+
+/// @cond
+// the switch epoch of the OS thread, NULL until its first switch (defined in watchdog.c.)
+extern COTHREAD_LINK_HIDDEN COTHREAD_THREAD_LOCAL volatile unsigned long*	cothreadj_watchdog_epoch;
+
+static COTHREAD_THREAD_LOCAL cothreadj_preempt_host_t	cothreadj_preempt_host	= { 0, 0, 0, ~0UL };
+static pthread_mutex_t				cothreadj_preempt_mtx		= PTHREAD_MUTEX_INITIALIZER;	// protects the sliced OS threads count.
+static unsigned long				cothreadj_preempt_nb_hosts	= 0;	// the number of sliced OS threads.
+static struct sigaction				cothreadj_preempt_old_action;		// the SIGVTALRM action to restore.
+/// @endcond
+
+/**
+ * @brief		Marks the running callee expired if it has not yielded since the previous tick.
+ * @param		[in]	signum	The signal number.
+ * @ingroup		doxy_cothreadj
+ */
+static void
+cothreadj_preempt_handler(int signum)
+{
+	(void)signum;
+	cothreadj_preempt_host_t*	host	= &cothreadj_preempt_host;
+	volatile unsigned long*		epoch	= cothreadj_watchdog_epoch;
+	if (NULL != epoch) {
+		const unsigned long	cur	= *epoch;
+		if ((cur == host->seen) && (0 != (COTHREADJ_WATCHDOG_DEPTH_MASK & cur))) {
+			host->expired	= cur;
+		}
+		host->seen	= cur;
+	}
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_preempt_start(unsigned long slice_us)
+{
+	//---Definitions---//
+	cothread_err_t				err		= cothread_err_notsup;
+	cothreadj_preempt_host_t*	host	= &cothreadj_preempt_host;
+
+	//---Check arguments---//
+	assert(0	!= slice_us);
+
+	//---Create the timer, on the first start of the OS thread---//
+	pthread_mutex_lock(&cothreadj_preempt_mtx);
+	if (0 == host->started) {
+		//---Install the handler, on the first sliced OS thread---//
+		int	installed	= (0 != cothreadj_preempt_nb_hosts);
+		if (0 == installed) {
+			struct sigaction	action;
+			memset(&action, 0, sizeof(action));
+			action.sa_handler	= cothreadj_preempt_handler;
+			action.sa_flags		= SA_RESTART;
+			sigemptyset(&(action.sa_mask));
+			installed	= (0 == sigaction(SIGVTALRM, &action, &cothreadj_preempt_old_action));
+		}
+		if (0 != installed) {
+			struct sigevent	sev;
+			memset(&sev, 0, sizeof(sev));
+			sev.sigev_notify			= SIGEV_THREAD_ID;
+			sev.sigev_signo				= SIGVTALRM;
+			sev.sigev_notify_thread_id	= (pid_t)syscall(SYS_gettid);
+			host->seen		= 0;
+			host->expired	= ~0UL;
+			if (0 == timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &(host->timer))) {
+				host->started	= 1;
+				++cothreadj_preempt_nb_hosts;
+			} else if (0 == cothreadj_preempt_nb_hosts) {
+				sigaction(SIGVTALRM, &cothreadj_preempt_old_action, NULL);
+			}
+		}
+	}
+
+	//---Arm the timer---//
+	if (0 != host->started) {
+		struct itimerspec	its;
+		its.it_interval.tv_sec	= (time_t)(slice_us / 1000000);
+		its.it_interval.tv_nsec	= (long)(slice_us % 1000000) * 1000;
+		its.it_value			= its.it_interval;
+		if (0 == timer_settime(host->timer, 0, &its, NULL)) {
+			err	= cothread_err_ok;
+		}
+	}
+	pthread_mutex_unlock(&cothreadj_preempt_mtx);
+
+	//---Return---//
+	return err;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_preempt_stop(void)
+{
+	//---Definitions---//
+	cothreadj_preempt_host_t*	host	= &cothreadj_preempt_host;
+
+	//---Check the state---//
+	assert(0	!= host->started);
+
+	//---Stop the timer---//
+	pthread_mutex_lock(&cothreadj_preempt_mtx);
+	timer_delete(host->timer);
+	host->started	= 0;
+	host->expired	= ~0UL;
+
+	//---Discard the pending signal if any & restore the previous action, on the last sliced OS thread---//
+	if (0 == --cothreadj_preempt_nb_hosts) {
+		struct sigaction	action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler	= SIG_IGN;
+		sigemptyset(&(action.sa_mask));
+		sigaction(SIGVTALRM, &action, NULL);
+		sigaction(SIGVTALRM, &cothreadj_preempt_old_action, NULL);
+	}
+	pthread_mutex_unlock(&cothreadj_preempt_mtx);
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_checkpoint(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+
+	//---Yield if expired---//
+	volatile unsigned long*	epoch	= cothreadj_watchdog_epoch;
+	if ((NULL != epoch) && (*epoch == cothreadj_preempt_host.expired)) {
+		cothreadj_sched_yield(cothread);
+		return 1;
+	}
+	return 0;
+}
+#else
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_preempt_start(unsigned long slice_us)
+{
+	(void)slice_us;
+	return cothread_err_notsup;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_preempt_stop(void)
+{
+	// never started.
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_checkpoint(cothreadj_t* cothread)
+{
+	assert(NULL	!= cothread);
+	return 0;
+}
+#endif
@@ -0,0 +1,361 @@
+/**
+ * @brief		This file contains the sampling profiler definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_prof	cothread - sampling profiler
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_prof_def	Definitions
+ *				The usual profilers attribute the samples to the OS threads, mixing up the callees living in the
+ *				same OS thread. When the library is built with @ref COTHREAD_WITH_PROFILER, each OS thread tracks
+ *				its running callee, so the sampling profiler attributes each sample to the debug name of the callee
+ *				it was taken from, along with the frame pointers chain of the callee stack.
+ *
+ * @section		doxy_p_cothreadj_prof_use	Usage
+ *				-# Call the @ref cothreadj_prof_start function to arm a timer which raises @c SIGPROF
+ *				each time the process consumes the specified CPU time ;
+ *				-# Call the @ref cothreadj_prof_stop function once the code to profile has run ;
+ *				-# Call the @ref cothreadj_prof_dump function to write the samples in the "folded stacks"
+ *				format, ready to be turned into a flamegraph ;
+ *				-# Finally, call the @ref cothreadj_prof_release function to release the samples.
+ *				.
+ *
+ * @section		doxy_p_cothreadj_prof_impl	Implementation
+ *				The signal handler only reads the registers of the interrupted context and the callee stack,
+ *				it reserves its sample slot with a single atomic addition and never locks anything.
+ *				The frame pointers are followed while they remain within the bounds of the running callee stack
+ *				(whose frame pointers chain is terminated by @ref cothreadj_init), which makes it safe to sample
+ *				code built without frame pointers: its frames are merely missing.
+ *				The samples are sorted and aggregated by the @ref cothreadj_prof_dump function.
+ */
+
+#if (defined(__gnu_linux__) && !defined(_GNU_SOURCE))
+	#define _GNU_SOURCE	// dladdr & the REG_xxx indexes of the machine context.
+#endif
+
+#include <cothread/cothreadj_prof.h>
+#include <assert.h>
+
+#if		(COTHREAD_WITH_PROFILER	\
+		&& (COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)	\
+		&& ((COTHREAD_ARCH_ID_X86 == COTHREAD_ARCH_ID) || (COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID))	\
+		)
+#include <cothread/atomic.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#if		(COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID)
+	#define COTHREADJ_PROF_REG_PC	REG_RIP		///< @brief	The index of the program counter in the machine context.
+	#define COTHREADJ_PROF_REG_FP	REG_RBP		///< @brief	The index of the frame pointer in the machine context.
+#else
+	#define COTHREADJ_PROF_REG_PC	REG_EIP		///< @brief	The index of the program counter in the machine context.
+	#define COTHREADJ_PROF_REG_FP	REG_EBP		///< @brief	The index of the frame pointer in the machine context.
+#endif
+
+/**
+ * @brief		The sample type.
+ * @ingroup		doxy_cothreadj
+ */
+typedef struct _cothreadj_prof_sample_t
+{
+	const char*	dbg_name;	///< @brief	The debug name of the running callee, NULL if none.
+	size_t		nb_frames;	///< @brief	The number of recorded frames.
+	void*		frames[COTHREADJ_PROF_NB_FRAMES_MAX];	///< @brief	The program counters, from the innermost frame to the outermost one.
+} cothreadj_prof_sample_t;
+
+/// @cond
+// the cothread whose callee is running in the OS thread, NULL if none (defined in cothreadj.c.)
+extern COTHREAD_LINK_HIDDEN COTHREAD_THREAD_LOCAL cothreadj_t*	cothreadj_running;
+
+static cothreadj_prof_sample_t*	cothreadj_prof_samples;			// the recorded samples.
+static long						cothreadj_prof_nb_samples_max;	// the number of allocated samples.
+static volatile long			cothreadj_prof_nb_samples;		// the number of reserved samples (may exceed the allocated ones.)
+static volatile long			cothreadj_prof_enabled;			// says whether the handler shall record samples or not.
+static volatile long			cothreadj_prof_nb_inflight;		// the number of handlers being run.
+static timer_t					cothreadj_prof_timer;			// the timer raising SIGPROF.
+static struct sigaction			cothreadj_prof_old_action;		// the SIGPROF action to restore.
+/// @endcond
+
+/**
+ * @brief		The SIGPROF handler.
+ * @param		[in]	signum	The signal number.
+ * @param		[in]	info	The signal informations.
+ * @param		[in]	uctx	The interrupted context.
+ * @note		This function is async-signal-safe.
+ * @ingroup		doxy_cothreadj
+ */
+static void
+cothreadj_prof_handler(int signum, siginfo_t* info, void* uctx)
+{
+	//---Definitions---//
+	const int	saved_errno	= errno;
+
+	//---Is sampling enabled ?---//
+	COTHREAD_ATOMIC_FETCH_ADD(&cothreadj_prof_nb_inflight, 1);
+	if (0 != COTHREAD_ATOMIC_LOAD(&cothreadj_prof_enabled)) {
+		//---Reserve a sample---//
+		const long	idx	= COTHREAD_ATOMIC_FETCH_ADD(&cothreadj_prof_nb_samples, 1);
+		if (idx < cothreadj_prof_nb_samples_max) {
+			cothreadj_prof_sample_t*	sample	= cothreadj_prof_samples + idx;
+			const greg_t*				gregs	= ((const ucontext_t*)uctx)->uc_mcontext.gregs;
+			const cothreadj_t*			running	= cothreadj_running;
+
+			//---Record the interrupted frame---//
+			sample->dbg_name	= (NULL != running) ? running->dbg_callee_name : NULL;
+			sample->frames[0]	= (void*)gregs[COTHREADJ_PROF_REG_PC];
+			sample->nb_frames	= 1;
+
+			//---Follow the frame pointers within the callee stack---//
+			if (NULL != running) {
+				const uintptr_t	lo	= (uintptr_t)running->stack;
+				const uintptr_t	hi	= lo + running->stack_sz - 2 * sizeof(void*);
+				uintptr_t		fp	= (uintptr_t)gregs[COTHREADJ_PROF_REG_FP];
+				while ((COTHREADJ_PROF_NB_FRAMES_MAX > sample->nb_frames)
+				&& (lo <= fp) && (hi >= fp) && (0 == (fp & (sizeof(void*) - 1)))) {
+					void* const*	frame	= (void* const*)fp;
+					if (NULL == frame[1]) {
+						break;
+					}
+					sample->frames[sample->nb_frames++]	= frame[1];
+					if ((uintptr_t)frame[0] <= fp) {
+						break;	// the chain shall go up the stack.
+					}
+					fp	= (uintptr_t)frame[0];
+				}
+			}
+		}
+	}
+	COTHREAD_ATOMIC_FETCH_ADD(&cothreadj_prof_nb_inflight, -1);
+
+	//---Restore errno---//
+	errno	= saved_errno;
+}
+
+/**
+ * @brief		Compares the specified samples.
+ * @param		[in]	a	The first sample.
+ * @param		[in]	b	The second sample.
+ * @return		Returns a negative, zero or positive value as for the strcmp function.
+ * @ingroup		doxy_cothreadj
+ */
+static int
+cothreadj_prof_cmp(const void* a, const void* b)
+{
+	//---Definitions---//
+	const cothreadj_prof_sample_t*	sa	= (const cothreadj_prof_sample_t*)a;
+	const cothreadj_prof_sample_t*	sb	= (const cothreadj_prof_sample_t*)b;
+
+	//---Compare the debug names---//
+	if (sa->dbg_name != sb->dbg_name) {
+		if (NULL == sa->dbg_name) {
+			return -1;
+		} else if (NULL == sb->dbg_name) {
+			return +1;
+		}
+		const int	ret	= strcmp(sa->dbg_name, sb->dbg_name);
+		if (0 != ret) {
+			return ret;
+		}
+	}
+
+	//---Compare the frames---//
+	if (sa->nb_frames != sb->nb_frames) {
+		return (sa->nb_frames < sb->nb_frames) ? -1 : +1;
+	}
+	return memcmp(sa->frames, sb->frames, sa->nb_frames * sizeof(sa->frames[0]));
+}
+
+/**
+ * @brief		Writes the name of the specified frame to the specified stream.
+ * @param		[in]	strm	The stream to write the name to.
+ * @param		[in]	pc		The program counter of the frame.
+ * @param		[in]	is_ret	Says whether @e pc is a return address or not.
+ * @ingroup		doxy_cothreadj
+ */
+static void
+cothreadj_prof_dump_frame(FILE* strm, void* pc, int is_ret)
+{
+	//---Look for the symbol (a return address may be past the end of the calling function)---//
+	Dl_info	info;
+	void*	addr	= (0 != is_ret) ? (void*)((uintptr_t)pc - 1) : pc;
+	if (0 == dladdr(addr, &info)) {
+		fprintf(strm, "%p", pc);
+	} else if (NULL != info.dli_sname) {
+		fprintf(strm, "%s", info.dli_sname);
+	} else {
+		const char*	slash	= strrchr(info.dli_fname, '/');
+		fprintf(strm, "%s+%#lx", (NULL != slash) ? slash + 1 : info.dli_fname,
+			(unsigned long)((uintptr_t)pc - (uintptr_t)info.dli_fbase));
+	}
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_prof_start(size_t nb_samples_max, unsigned long period_us)
+{
+	//---Definitions---//
+	cothread_err_t	err	= cothread_err_notsup;
+
+	//---Check arguments---//
+	assert(0	!= nb_samples_max);
+	assert(0	!= period_us);
+	assert(0	== cothreadj_prof_enabled);
+
+	//---Allocate the samples---//
+	cothreadj_prof_release();
+	if (NULL == (cothreadj_prof_samples = (cothreadj_prof_sample_t*)calloc(nb_samples_max, sizeof(cothreadj_prof_sample_t)))) {
+		err	= cothread_err_nomem;
+	} else {
+		//---Install the handler---//
+		struct sigaction	action;
+		memset(&action, 0, sizeof(action));
+		action.sa_sigaction	= cothreadj_prof_handler;
+		action.sa_flags		= SA_SIGINFO | SA_RESTART;
+		sigemptyset(&(action.sa_mask));
+		cothreadj_prof_nb_samples_max	= (long)nb_samples_max;
+		cothreadj_prof_nb_samples		= 0;
+		COTHREAD_ATOMIC_STORE(&cothreadj_prof_enabled, 1);
+		if (0 == sigaction(SIGPROF, &action, &cothreadj_prof_old_action)) {
+			//---Create the timer---//
+			struct sigevent	sev;
+			memset(&sev, 0, sizeof(sev));
+			sev.sigev_notify	= SIGEV_SIGNAL;
+			sev.sigev_signo		= SIGPROF;
+			if (0 == timer_create(CLOCK_PROCESS_CPUTIME_ID, &sev, &cothreadj_prof_timer)) {
+				//---Arm the timer---//
+				struct itimerspec	its;
+				its.it_interval.tv_sec	= (time_t)(period_us / 1000000);
+				its.it_interval.tv_nsec	= (long)(period_us % 1000000) * 1000;
+				its.it_value			= its.it_interval;
+				if (0 == timer_settime(cothreadj_prof_timer, 0, &its, NULL)) {
+					err	= cothread_err_ok;
+				}
+
+				//---Error Management---//
+				if (COTHREAD_ERR_ISNOK(err)) {
+					timer_delete(cothreadj_prof_timer);
+				}
+			}
+
+			//---Error Management---//
+			if (COTHREAD_ERR_ISNOK(err)) {
+				sigaction(SIGPROF, &cothreadj_prof_old_action, NULL);
+			}
+		}
+
+		//---Error Management---//
+		if (COTHREAD_ERR_ISNOK(err)) {
+			COTHREAD_ATOMIC_STORE(&cothreadj_prof_enabled, 0);
+			cothreadj_prof_release();
+		}
+	}
+
+	//---Return---//
+	return err;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_prof_stop(void)
+{
+	//---Check the state---//
+	assert(0	!= cothreadj_prof_enabled);
+
+	//---Stop the timer---//
+	timer_delete(cothreadj_prof_timer);
+
+	//---Wait for the running handlers---//
+	COTHREAD_ATOMIC_STORE(&cothreadj_prof_enabled, 0);
+	while (0 != COTHREAD_ATOMIC_LOAD(&cothreadj_prof_nb_inflight)) {
+		COTHREAD_CPU_RELAX();
+	}
+
+	//---Discard the pending signal if any & restore the previous action---//
+	struct sigaction	action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler	= SIG_IGN;
+	sigemptyset(&(action.sa_mask));
+	sigaction(SIGPROF, &action, NULL);
+	sigaction(SIGPROF, &cothreadj_prof_old_action, NULL);
+
+	//---Forget the reserved slots which were never allocated---//
+	if (cothreadj_prof_nb_samples > cothreadj_prof_nb_samples_max) {
+		cothreadj_prof_nb_samples	= cothreadj_prof_nb_samples_max;
+	}
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_prof_dump(FILE* strm)
+{
+	//---Check arguments---//
+	assert(NULL	!= strm);
+	assert(0	== cothreadj_prof_enabled);
+
+	//---Gather the identical samples---//
+	const size_t	nb_samples	= (NULL != cothreadj_prof_samples) ? (size_t)cothreadj_prof_nb_samples : 0;
+	qsort(cothreadj_prof_samples, nb_samples, sizeof(cothreadj_prof_sample_t), cothreadj_prof_cmp);
+
+	//---Write one line per distinct stack---//
+	for (size_t i = 0, j; i < nb_samples; i = j) {
+		//---Count the identical samples---//
+		const cothreadj_prof_sample_t*	sample	= cothreadj_prof_samples + i;
+		for (j = i + 1; (j < nb_samples) && (0 == cothreadj_prof_cmp(sample, cothreadj_prof_samples + j)); j++);
+
+		//---Write the frames, from the outermost to the innermost one---//
+		fputs((NULL != sample->dbg_name) ? sample->dbg_name : "[thread]", strm);
+		for (size_t k = sample->nb_frames; 0 != k--;) {
+			fputc(';', strm);
+			cothreadj_prof_dump_frame(strm, sample->frames[k], 0 != k);
+		}
+		fprintf(strm, " %lu\n", (unsigned long)(j - i));
+	}
+
+	//---Return---//
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_prof_release(void)
+{
+	//---Check the state---//
+	assert(0	== cothreadj_prof_enabled);
+
+	//---Release---//
+	free(cothreadj_prof_samples);
+	cothreadj_prof_samples			= NULL;
+	cothreadj_prof_nb_samples_max	= 0;
+	cothreadj_prof_nb_samples		= 0;
+}
+#else
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_prof_start(size_t nb_samples_max, unsigned long period_us)
+{
+	(void)nb_samples_max;
+	(void)period_us;
+	return cothread_err_notsup;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_prof_stop(void)
+{
+	// never started.
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_prof_dump(FILE* strm)
+{
+	assert(NULL	!= strm);
+	return cothread_err_notsup;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_prof_release(void)
+{
+	// never started.
+}
+#endif
@@ -0,0 +1,391 @@
+/**
+ * @brief		This file contains the scheduler definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_sched	cothread - scheduler
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_sched_def	Definitions
+ *				The [scheduler](@ref _cothreadj_sched_t) is the @e caller of many [cothreads](@ref _cothreadj_t)
+ *				living in the same OS thread. It resumes the @e ready ones, one at a time, until they either
+ *				yield back, @e park themselves or return.
+ *				A parked cothread is not resumed until another party wakes it up, which makes it possible to
+ *				wait for a [synchronization primitive](@ref cothreadj_sync.h) without blocking the
+ *				other cothreads of the OS thread.
+ *
+ * @section		doxy_p_cothreadj_sched_use	Usage
+ *				-# Initialize the scheduler with the @ref cothreadj_sched_init function ;
+ *				-# Initialize the cothreads as usual and hand them over to the scheduler with the
+ *				@ref cothreadj_sched_spawn function ;
+ *				-# Call the @ref cothreadj_sched_run function, which returns once no cothread is ready anymore ;
+ *				-# From a callee, the @ref cothreadj_sched_yield and the @ref cothreadj_sched_park functions
+ *				switch back to the scheduler, and the @ref cothreadj_sched_wake one makes a parked cothread ready.
+ *				.
+ *
+ * @section		doxy_p_cothreadj_sched_policy	Policies
+ *				By default, the ready cothreads are resumed in the FIFO order. A [policy](@ref _cothreadj_policy_t) set
+ *				with the @ref cothreadj_sched_set_policy function orders them otherwise, e.g. by priority level or by
+ *				deadline (see cothreadj_policy.h.) A yielding cothread is made ready again only once back in the scheduler,
+ *				so its callee may change its priority level or its deadline right before yielding.
+ *
+ * @section		doxy_p_cothreadj_sched_task	Tasks
+ *				Besides the cothreads, the scheduler runs [tasks](@ref _cothreadj_sched_task_t): callbacks posted with
+ *				the @ref cothreadj_sched_post function, run on the scheduler stack. They make it possible to resume
+ *				the stackless C++20 coroutines from the same loop as the cothreads (see cothreadj_coro.hxx.)
+ *				A task set as the [poller](@ref _cothreadj_sched_t::poller) is run each time a cothread is back
+ *				in the scheduler instead, which makes it possible to check the rings of a mesh core while
+ *				its cothreads keep yielding (see mesh.c.)
+ *
+ * @section		doxy_p_cothreadj_sched_remote	Remote wakes
+ *				A cothread parked on an I/O request is often woken up by another OS thread, which must not touch
+ *				the scheduler: the @ref cothreadj_sched_wake_remote function pushes the cothread onto the lock-free
+ *				inbox of the scheduler instead, and rings its doorbell if the owner OS thread is blocked in
+ *				the @ref cothreadj_sched_wait function (see inbox.c.)
+ *
+ * @section		doxy_p_cothreadj_sched_trim	Trimming
+ *				A parked cothread may wait for long, while the deepest pages its stack ever touched stay resident.
+ *				Once enabled with the @ref cothreadj_sched_set_trim function, the scheduler returns these pages
+ *				to the kernel (see @ref cothreadj_trim) once a callee parked with enough idle stack bytes has
+ *				stayed parked for a while. The parked callees are appended to a list, in the order they parked,
+ *				which they leave once ready again: a callee parking briefly is never trimmed, whose pages would
+ *				fault back in right away, nor one parking often more than once per park.
+ */
+
+#include <cothread/cothreadj_sched.h>
+#include <cothread/atomic.h>
+#include <assert.h>
+
+/**
+ * @brief		Moves the cothreads of the inbox of the specified scheduler to its ready queue (see inbox.c.)
+ * @param		[in]	sched	The scheduler, whose inbox is not empty.
+ * @relates		_cothreadj_sched_t
+ */
+extern COTHREAD_LINK_HIDDEN void	COTHREAD_CALL cothreadj_sched_drain	(cothreadj_sched_t* sched);
+
+/**
+ * @brief		Records the return of the specified child in its group (see group.c.)
+ * @param		[in]	cothread	The child whose callee has returned.
+ * @param		[in]	ret			The value the callee has returned.
+ * @relates		_cothreadj_group_t
+ */
+extern COTHREAD_LINK_HIDDEN void	COTHREAD_CALL cothreadj_group_complete	(cothreadj_t* cothread, int ret);
+
+/**
+ * @brief		Removes the specified cothread from the list of the parked ones to trim.
+ * @param		[in]	sched		The scheduler.
+ * @param		[in]	cothread	The cothread, linked in the list.
+ * @relates		_cothreadj_sched_t
+ */
+static inline void COTHREAD_CALL
+cothreadj_sched_trim_unlink(cothreadj_sched_t* sched, cothreadj_t* cothread)
+{
+	cothread->trim_pprev[0]	= cothread->trim_next;
+	if (NULL != cothread->trim_next) {
+		cothread->trim_next->trim_pprev	= cothread->trim_pprev;
+	} else {
+		sched->trim_tail	= cothread->trim_pprev;
+	}
+	cothread->trim_next		= NULL;
+	cothread->trim_pprev	= NULL;
+}
+
+/**
+ * @brief		Trims the stack of the first parked cothread to trim, and removes it from the list.
+ * @param		[in]	sched		The scheduler, whose list of the parked cothreads to trim is not empty.
+ * @relates		_cothreadj_sched_t
+ */
+static void COTHREAD_CALL
+cothreadj_sched_trim(cothreadj_sched_t* sched)
+{
+	cothreadj_t*	cothread	= sched->trim_head;
+	size_t			nb_bytes;
+	cothreadj_sched_trim_unlink(sched, cothread);
+	if (cothread_err_ok == cothreadj_trim(cothread, &nb_bytes)) {
+		sched->nb_trimmed	+= nb_bytes;
+	}
+}
+
+/**
+ * @brief		Makes the specified cothread ready, according to the policy of the specified scheduler.
+ * @param		[in]	sched		The scheduler.
+ * @param		[in]	cothread	The cothread, which is not linked in any queue.
+ * @relates		_cothreadj_sched_t
+ */
+static inline void COTHREAD_CALL
+cothreadj_sched_push(cothreadj_sched_t* sched, cothreadj_t* cothread)
+{
+	if (NULL != cothread->trim_pprev) {
+		cothreadj_sched_trim_unlink(sched, cothread);
+	}
+	if (NULL == sched->policy) {
+		cothreadj_queue_push(&(sched->ready), cothread);
+	} else {
+		sched->policy->push(sched->policy, cothread);
+	}
+}
+
+/**
+ * @brief		Removes the next cothread to resume, according to the policy of the specified scheduler.
+ * @param		[in]	sched		The scheduler.
+ * @return		Returns the removed cothread, NULL if none is ready.
+ * @relates		_cothreadj_sched_t
+ */
+static inline cothreadj_t* COTHREAD_CALL
+cothreadj_sched_pop(cothreadj_sched_t* sched)
+{
+	return (NULL == sched->policy) ? cothreadj_queue_pop(&(sched->ready)) : sched->policy->pop(sched->policy);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_queue_init(cothreadj_queue_t* queue)
+{
+	assert(NULL	!= queue);
+	queue->head	= NULL;
+	queue->tail	= NULL;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_queue_push(cothreadj_queue_t* queue, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= queue);
+	assert(NULL	!= cothread);
+	assert(NULL	== cothread->next);
+	assert(cothread	!= queue->tail);
+
+	//---Append---//
+	if (NULL == queue->tail) {
+		queue->head			= cothread;
+	} else {
+		queue->tail->next	= cothread;
+	}
+	queue->tail	= cothread;
+}
+
+extern COTHREAD_LINK cothreadj_t* COTHREAD_CALL
+cothreadj_queue_pop(cothreadj_queue_t* queue)
+{
+	//---Check arguments---//
+	assert(NULL	!= queue);
+
+	//---Remove the first cothread if any---//
+	cothreadj_t*	cothread	= queue->head;
+	if (NULL != cothread) {
+		queue->head	= cothread->next;
+		if (NULL == queue->head) {
+			queue->tail	= NULL;
+		}
+		cothread->next	= NULL;
+	}
+
+	//---Return---//
+	return cothread;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_init(cothreadj_sched_t* sched)
+{
+	//---Check arguments---//
+	assert(NULL	!= sched);
+
+	//---Init---//
+	cothreadj_queue_init(&(sched->ready));
+	sched->policy		= NULL;
+	sched->tasks_head	= NULL;
+	sched->tasks_tail	= NULL;
+	sched->poller		= NULL;
+	sched->current		= NULL;
+	sched->nb_alive		= 0;
+	sched->trim_min		= 0;
+	sched->nb_trimmed	= 0;
+	sched->trim_head	= NULL;
+	sched->trim_tail	= &(sched->trim_head);
+	sched->nb_passes	= 0;
+	sched->inbox		= NULL;
+	sched->sleeping		= 0;
+	sched->nb_rings		= 0;
+	sched->bell[0]		= -1;
+	sched->bell[1]		= -1;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_set_trim(cothreadj_sched_t* sched, size_t trim_min)
+{
+	assert(NULL	!= sched);
+	sched->trim_min	= trim_min;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_set_policy(cothreadj_sched_t* sched, cothreadj_policy_t* policy)
+{
+	//---Check arguments---//
+	assert(NULL	!= sched);
+	assert(NULL	== sched->ready.head);	// a policy cannot be checked for ready cothreads without popping them.
+
+	//---Set---//
+	sched->policy	= policy;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_spawn(cothreadj_sched_t* sched, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= sched);
+	assert(NULL	!= cothread);
+	assert(NULL	== cothread->sched);
+	assert(0	== (COTHREADJ_FLAG_COMPLETED & cothread->flags));
+
+	//---Make the cothread ready---//
+	cothread->sched	= sched;
+	sched->nb_alive++;
+	cothreadj_sched_push(sched, cothread);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_task_init(cothreadj_sched_task_t* task, cothreadj_sched_task_cb_t cb)
+{
+	assert(NULL	!= task);
+	assert(NULL	!= cb);
+	task->next	= NULL;
+	task->cb	= cb;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_post(cothreadj_sched_t* sched, cothreadj_sched_task_t* task)
+{
+	//---Check arguments---//
+	assert(NULL	!= sched);
+	assert(NULL	!= task);
+	assert(NULL	== task->next);
+	assert(task	!= sched->tasks_tail);
+
+	//---Append---//
+	if (NULL == sched->tasks_tail) {
+		sched->tasks_head		= task;
+	} else {
+		sched->tasks_tail->next	= task;
+	}
+	sched->tasks_tail	= task;
+}
+
+extern COTHREAD_LINK size_t COTHREAD_CALL
+cothreadj_sched_run(cothreadj_sched_t* sched)
+{
+	//---Check arguments---//
+	assert(NULL	!= sched);
+	assert(NULL	== sched->current);
+
+	//---Alternately run a posted task & resume a ready cothread---//
+	for (;;) {
+		//---Run the first posted task if any (it may post itself again)---//
+		cothreadj_sched_task_t*	task	= sched->tasks_head;
+		if (NULL != task) {
+			sched->tasks_head	= task->next;
+			if (NULL == sched->tasks_head) {
+				sched->tasks_tail	= NULL;
+			}
+			task->next	= NULL;
+			task->cb(task);
+		}
+
+		//---Make the cothreads woken up from other OS threads ready---//
+		if (NULL != COTHREAD_ATOMIC_LOAD_PTR(&(sched->inbox))) {
+			cothreadj_sched_drain(sched);
+		}
+
+		//---Is any cothread ready ?---//
+		cothreadj_t*	cothread	= cothreadj_sched_pop(sched);
+		if (NULL == cothread) {
+			if (NULL == sched->tasks_head) {
+				break;
+			}
+			continue;
+		}
+
+		//---Resume the callee---//
+		assert(sched	== cothread->sched);
+		sched->current	= cothread;
+		sched->nb_passes++;
+		const int	ret	= cothreadj_yield(cothread, COTHREADJ_SCHED_VAL);
+		sched->current	= NULL;
+
+		//---Has the callee returned ?---//
+		if (0 != (COTHREADJ_FLAG_COMPLETED & cothread->flags)) {
+			assert(0	!= sched->nb_alive);
+			sched->nb_alive--;
+			if (NULL != cothread->group) {
+				cothreadj_group_complete(cothread, ret);
+			}
+
+		//---Has the callee yielded ?---//
+		} else if (0 != (COTHREADJ_FLAG_YIELDED & cothread->flags)) {
+			cothread->flags	&= ~(unsigned int)COTHREADJ_FLAG_YIELDED;
+			cothreadj_sched_push(sched, cothread);
+
+		//---Has the callee parked with enough idle stack bytes ? Trim it once it has stayed parked for a while---//
+		} else if ((0 != sched->trim_min)
+			&& (sched->trim_min <= (size_t)((char*)cothread->callee.sp - (char*)cothread->stack))) {
+			cothread->trim_pass		= sched->nb_passes;
+			cothread->trim_pprev	= sched->trim_tail;
+			sched->trim_tail[0]		= cothread;
+			sched->trim_tail		= &(cothread->trim_next);
+		}
+
+		//---Trim the callees parked while the scheduler resumed enough cothreads---//
+		while ((NULL != sched->trim_head) && (COTHREADJ_SCHED_TRIM_NB_PASSES <= sched->nb_passes - sched->trim_head->trim_pass)) {
+			cothreadj_sched_trim(sched);
+		}
+
+		//---Run the poller if any, which may make cothreads ready---//
+		if (NULL != sched->poller) {
+			sched->poller->cb(sched->poller);
+		}
+	}
+
+	//---Trim the parked callees left, the scheduler being idle---//
+	while (NULL != sched->trim_head) {
+		cothreadj_sched_trim(sched);
+	}
+
+	//---Return---//
+	return sched->nb_alive;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_yield(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->sched);
+	assert(cothread	== cothread->sched->current);
+
+	//---Switch to the scheduler, which makes the cothread ready again---//
+	cothread->flags	|= COTHREADJ_FLAG_YIELDED;
+	cothreadj_yield(cothread, COTHREADJ_SCHED_VAL);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_park(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->sched);
+	assert(cothread	== cothread->sched->current);
+
+	//---Switch to the scheduler---//
+	cothreadj_yield(cothread, COTHREADJ_SCHED_VAL);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sched_wake(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= cothread->sched);
+	assert(0	== (COTHREADJ_FLAG_COMPLETED & cothread->flags));
+
+	//---Make the cothread ready---//
+	cothreadj_sched_push(cothread->sched, cothread);
+}
@@ -0,0 +1,249 @@
+/**
+ * @brief		This file contains the shared stack definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_shstk	cothread - shared stack
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_shstk_def	Definitions
+ *				A dedicated stack has to be sized for the deepest call chain its callee may ever run, while a
+ *				callee waiting for some event usually keeps a few KiB of live frames only.
+ *				The cothreads initialized on a [shared stack](@ref _cothreadj_shstk_t) all run on the same large
+ *				stack, one at a time. Resuming a cothread whose frames are not on the shared stack copies the
+ *				frames of the current owner off the stack, into a save area sized after them, then copies the
+ *				frames of the resumed cothread back. The save areas are pooled per power-of-two size class.
+ *				Resuming the owner again costs nothing more than a regular switch.
+ *
+ * @section		doxy_p_cothreadj_shstk_use	Usage
+ *				-# Allocate a large stack and initialize the shared stack with the @ref cothreadj_shstk_init function ;
+ *				-# Initialize the cothreads with the @ref cothreadj_init_shared function (instead of @ref cothreadj_init),
+ *				then yield to them as usual, from another stack ;
+ *				-# Uninitialize each cothread with the @ref cothreadj_uninit function, then
+ *				the shared stack with the @ref cothreadj_shstk_uninit function.
+ *				.
+ */
+
+#include <cothread/cothreadj_shstk.h>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief		Returns the frames of the specified save area.
+ * @param		[in]	_save	The save area.
+ * @return		Returns the lowest address of the copied frames.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_SHSTK_SAVE_BUF(_save)	((char*)((_save) + 1))
+
+/**
+ * @brief		Returns the past-the-end address of the specified shared stack.
+ * @param		[in]	_shstk	The shared stack.
+ * @return		Returns the stack top.
+ * @ingroup		doxy_cothreadj
+ */
+#define COTHREADJ_SHSTK_TOP(_shstk)		((char*)(_shstk)->stack + (_shstk)->stack_sz)
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_shstk_init(cothreadj_shstk_t* shstk, cothreadj_stack_t* stack, size_t stack_sz)
+{
+	//---Check arguments---//
+	assert(NULL	!= shstk);
+	assert(NULL	!= stack);
+	assert(0	!= stack_sz);
+	assert(0	== ((COTHREADJ_STACK_ALIGN - 1) & (uintptr_t)stack));
+	assert(0	== ((COTHREADJ_STACK_ALIGN - 1) & stack_sz));
+
+	//---Init---//
+	shstk->stack		= stack;
+	shstk->stack_sz		= stack_sz;
+	shstk->owner		= NULL;
+	for (size_t cls = 0; cls < COTHREADJ_SHSTK_NB_CLASSES; cls++) {
+		shstk->free[cls]	= NULL;
+	}
+	shstk->nb_bytes		= 0;
+	shstk->nb_copies	= 0;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_shstk_uninit(cothreadj_shstk_t* shstk)
+{
+	//---Check arguments---//
+	assert(NULL	!= shstk);
+	assert(NULL	== shstk->owner);
+	assert(0	== shstk->nb_bytes);
+
+	//---Release the pooled save areas---//
+	for (size_t cls = 0; cls < COTHREADJ_SHSTK_NB_CLASSES; cls++) {
+		cothreadj_shstk_save_t*	save;
+		while (NULL != (save = shstk->free[cls])) {
+			shstk->free[cls]	= save->u.next;
+			free(save);
+		}
+	}
+}
+
+/**
+ * @brief		Allocates a save area holding at least the specified number of bytes.
+ * @param		[in]	shstk	The shared stack to allocate the save area from.
+ * @param		[in]	sz		The number of bytes to copy.
+ * @return		Returns the save area, NULL if out of memory.
+ * @relates		_cothreadj_shstk_t
+ */
+static cothreadj_shstk_save_t* COTHREAD_CALL
+cothreadj_shstk_save_alloc(cothreadj_shstk_t* shstk, size_t sz)
+{
+	//---Find the smallest class the frames fit in---//
+	size_t	cls	= 0;
+	while ((COTHREADJ_SHSTK_NB_CLASSES > cls) && (((size_t)COTHREADJ_SHSTK_SAVE_SZ_MIN << cls) < sz)) {
+		cls++;
+	}
+	if (COTHREADJ_SHSTK_NB_CLASSES <= cls) {
+		return NULL;
+	}
+
+	//---Reuse a released save area, allocate one otherwise---//
+	cothreadj_shstk_save_t*	save	= shstk->free[cls];
+	if (NULL != save) {
+		shstk->free[cls]	= save->u.next;
+	} else if (NULL == (save = (cothreadj_shstk_save_t*)malloc(sizeof(cothreadj_shstk_save_t) + ((size_t)COTHREADJ_SHSTK_SAVE_SZ_MIN << cls)))) {
+		return NULL;
+	} else {
+		save->cls	= cls;
+	}
+
+	//---Return---//
+	save->u.sz		= sz;
+	shstk->nb_bytes	+= (size_t)COTHREADJ_SHSTK_SAVE_SZ_MIN << cls;
+	return save;
+}
+
+/**
+ * @brief		Releases the specified save area to the pool of the specified shared stack.
+ * @param		[in]	shstk	The shared stack the save area was allocated from.
+ * @param		[in]	save	The save area to release.
+ * @relates		_cothreadj_shstk_t
+ */
+static void COTHREAD_CALL
+cothreadj_shstk_save_free(cothreadj_shstk_t* shstk, cothreadj_shstk_save_t* save)
+{
+	assert(((size_t)COTHREADJ_SHSTK_SAVE_SZ_MIN << save->cls) <= shstk->nb_bytes);
+	shstk->nb_bytes		-= (size_t)COTHREADJ_SHSTK_SAVE_SZ_MIN << save->cls;
+	save->u.next		= shstk->free[save->cls];
+	shstk->free[save->cls]	= save;
+}
+
+/**
+ * @brief		Copies the frames of the owner of the specified shared stack off the stack.
+ * @param		[in]	shstk	The shared stack.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if no save area could be allocated.
+ *				.
+ * @relates		_cothreadj_shstk_t
+ */
+static cothread_err_t COTHREAD_CALL
+cothreadj_shstk_evict(cothreadj_shstk_t* shstk)
+{
+	//---Are there any frames to copy ?---//
+	cothreadj_t*	owner	= shstk->owner;
+	if ((NULL != owner) && (0 == (COTHREADJ_FLAG_COMPLETED & owner->flags))) {
+		//---Copy the used part of the stack, from the paused stack pointer up to the stack top---//
+		char*			sp	= (char*)owner->callee.sp;
+		const size_t	sz	= (size_t)(COTHREADJ_SHSTK_TOP(shstk) - sp);
+		assert(NULL	== owner->save);
+		assert(((char*)shstk->stack <= sp) && (sz <= shstk->stack_sz));
+		if (NULL == (owner->save = cothreadj_shstk_save_alloc(shstk, sz))) {
+			return cothread_err_nomem;
+		}
+		memcpy(COTHREADJ_SHSTK_SAVE_BUF(owner->save), sp, sz);
+		shstk->nb_copies++;
+	}
+
+	//---The stack is free---//
+	shstk->owner	= NULL;
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_init_shared(cothreadj_t* cothread, const cothreadj_attr_t* attr, cothreadj_shstk_t* shstk)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= attr);
+	assert(NULL	!= shstk);
+
+	//---Make room for the new frames---//
+	if (cothread_err_ok != cothreadj_shstk_evict(shstk)) {
+		return cothread_err_nomem;
+	}
+
+	//---Initialize the cothread on the shared stack, which it owns from now on---//
+	cothreadj_attr_t	shared_attr	= attr[0];
+	shared_attr.stack		= shstk->stack;
+	shared_attr.stack_sz	= shstk->stack_sz;
+	cothreadj_init(cothread, &shared_attr);
+	cothread->flags			|= COTHREADJ_FLAG_SHARED_STACK;
+	cothread->shstk			= shstk;
+	shstk->owner			= cothread;
+	return cothread_err_ok;
+}
+
+/**
+ * @brief		Copies the frames of the owner off the shared stack of the specified cothread,
+ *				then copies the frames of its callee back onto it.
+ * @param		[in]	cothread	The cothread whose callee is about to be resumed, which does not own the stack.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if no save area could be allocated for the owner frames.
+ *				.
+ * @relates		_cothreadj_shstk_t
+ */
+extern COTHREAD_LINK_HIDDEN cothread_err_t COTHREAD_CALL
+cothreadj_shstk_acquire(cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	cothreadj_shstk_t*	shstk	= cothread->shstk;
+	assert(cothread	!= shstk->owner);
+	assert(NULL		!= cothread->save);
+
+	//---The stack must not be the running one, its frames are about to be overwritten---//
+#ifndef NDEBUG
+	char	mark;
+	assert(((char*)&mark < (char*)shstk->stack) || (COTHREADJ_SHSTK_TOP(shstk) <= (char*)&mark));
+#endif
+
+	//---Copy the owner frames off the stack---//
+	if (cothread_err_ok != cothreadj_shstk_evict(shstk)) {
+		return cothread_err_nomem;
+	}
+
+	//---Copy the callee frames back---//
+	cothreadj_shstk_save_t*	save	= cothread->save;
+	memcpy(COTHREADJ_SHSTK_TOP(shstk) - save->u.sz, COTHREADJ_SHSTK_SAVE_BUF(save), save->u.sz);
+	cothread->save	= NULL;
+	cothreadj_shstk_save_free(shstk, save);
+	shstk->owner	= cothread;
+	shstk->nb_copies++;
+	return cothread_err_ok;
+}
+
+/**
+ * @brief		Forgets the frames of the specified cothread, whether they lie on its shared stack or not.
+ * @param		[in]	cothread	The cothread which is uninitialized.
+ * @relates		_cothreadj_shstk_t
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+cothreadj_shstk_release(cothreadj_t* cothread)
+{
+	cothreadj_shstk_t*	shstk	= cothread->shstk;
+	if (cothread == shstk->owner) {
+		shstk->owner	= NULL;
+	}
+	if (NULL != cothread->save) {
+		cothreadj_shstk_save_free(shstk, cothread->save);
+		cothread->save	= NULL;
+	}
+}
@@ -0,0 +1,281 @@
+/**
+ * @brief		This file contains the synchronization primitives definitions.
+ * @file
+ *
+ * All the primitives below park the waiting cothreads on intrusive wait lists and never busy-wait.
+ * Releasing a primitive hands it over to the waiting cothread directly (the released unit never
+ * becomes available in between), so a woken up cothread never has to compete again for it.
+ */
+
+#include <cothread/cothreadj_sync.h>
+#include <assert.h>
+
+/**
+ * @brief		Gives the ownership of the specified mutex to the specified cothread, or makes it wait for it.
+ * @param		[in]	mtx			The mutex.
+ * @param		[in]	cothread	The parked cothread to give the ownership to.
+ * @relates		_cothreadj_mutex_t
+ */
+static void COTHREAD_CALL
+cothreadj_mutex_handover(cothreadj_mutex_t* mtx, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= mtx);
+	assert(NULL	!= cothread);
+
+	//---Is the mutex unlocked ?---//
+	if (NULL == mtx->owner) {
+		mtx->owner	= cothread;
+		cothreadj_sched_wake(cothread);
+	} else {
+		cothreadj_queue_push(&(mtx->waiters), cothread);
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_mutex_init(cothreadj_mutex_t* mtx)
+{
+	assert(NULL	!= mtx);
+	mtx->owner	= NULL;
+	cothreadj_queue_init(&(mtx->waiters));
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_mutex_lock(cothreadj_mutex_t* mtx, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= mtx);
+	assert(NULL	!= cothread);
+	assert(cothread	!= mtx->owner);
+
+	//---Is the mutex unlocked ?---//
+	if (NULL == mtx->owner) {
+		mtx->owner	= cothread;
+	} else {
+		//---Wait for the mutex to be handed over---//
+		cothreadj_queue_push(&(mtx->waiters), cothread);
+		cothreadj_sched_park(cothread);
+		assert(cothread	== mtx->owner);
+	}
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_mutex_trylock(cothreadj_mutex_t* mtx, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= mtx);
+	assert(NULL	!= cothread);
+
+	//---Is the mutex unlocked ?---//
+	if (NULL != mtx->owner) {
+		return 0;
+	}
+	mtx->owner	= cothread;
+	return !0;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_mutex_unlock(cothreadj_mutex_t* mtx, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= mtx);
+	assert(NULL	!= cothread);
+	assert(cothread	== mtx->owner);
+
+	//---Hand the mutex over to the first waiter if any---//
+	mtx->owner	= cothreadj_queue_pop(&(mtx->waiters));
+	if (NULL != mtx->owner) {
+		cothreadj_sched_wake(mtx->owner);
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_cond_init(cothreadj_cond_t* cond)
+{
+	assert(NULL	!= cond);
+	cond->mtx	= NULL;
+	cothreadj_queue_init(&(cond->waiters));
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_cond_wait(cothreadj_cond_t* cond, cothreadj_mutex_t* mtx, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= cond);
+	assert(NULL	!= mtx);
+	assert(NULL	!= cothread);
+	assert(cothread	== mtx->owner);
+	assert((NULL == cond->mtx) || (mtx == cond->mtx));
+
+	//---Wait for the condition variable, then for the mutex---//
+	cond->mtx	= mtx;
+	cothreadj_queue_push(&(cond->waiters), cothread);
+	cothreadj_mutex_unlock(mtx, cothread);
+	cothreadj_sched_park(cothread);
+	assert(cothread	== mtx->owner);
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_cond_signal(cothreadj_cond_t* cond)
+{
+	//---Check arguments---//
+	assert(NULL	!= cond);
+
+	//---Move the first waiter to the mutex---//
+	cothreadj_t*	cothread	= cothreadj_queue_pop(&(cond->waiters));
+	if (NULL != cothread) {
+		cothreadj_mutex_t*	mtx	= cond->mtx;
+		if (NULL == cond->waiters.head) {
+			cond->mtx	= NULL;
+		}
+		cothreadj_mutex_handover(mtx, cothread);
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_cond_broadcast(cothreadj_cond_t* cond)
+{
+	//---Check arguments---//
+	assert(NULL	!= cond);
+
+	//---Move all the waiters to the mutex (at most one of them is woken up)---//
+	cothreadj_mutex_t*	mtx	= cond->mtx;
+	cothreadj_t*		cothread;
+	cond->mtx	= NULL;
+	while (NULL != (cothread = cothreadj_queue_pop(&(cond->waiters)))) {
+		cothreadj_mutex_handover(mtx, cothread);
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sem_init(cothreadj_sem_t* sem, size_t count)
+{
+	assert(NULL	!= sem);
+	sem->count	= count;
+	cothreadj_queue_init(&(sem->waiters));
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sem_wait(cothreadj_sem_t* sem, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= sem);
+	assert(NULL	!= cothread);
+
+	//---Is a unit available ?---//
+	if (0 != sem->count) {
+		sem->count--;
+	} else {
+		//---Wait for a unit to be handed over---//
+		cothreadj_queue_push(&(sem->waiters), cothread);
+		cothreadj_sched_park(cothread);
+	}
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadj_sem_trywait(cothreadj_sem_t* sem)
+{
+	//---Check arguments---//
+	assert(NULL	!= sem);
+
+	//---Is a unit available ?---//
+	if (0 == sem->count) {
+		return 0;
+	}
+	sem->count--;
+	return !0;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_sem_post(cothreadj_sem_t* sem)
+{
+	//---Check arguments---//
+	assert(NULL	!= sem);
+
+	//---Hand the unit over to the first waiter if any---//
+	cothreadj_t*	cothread	= cothreadj_queue_pop(&(sem->waiters));
+	if (NULL != cothread) {
+		cothreadj_sched_wake(cothread);
+	} else {
+		sem->count++;
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_rwlock_init(cothreadj_rwlock_t* rwlock)
+{
+	assert(NULL	!= rwlock);
+	rwlock->writer		= NULL;
+	rwlock->nb_readers	= 0;
+	cothreadj_queue_init(&(rwlock->readers));
+	cothreadj_queue_init(&(rwlock->writers));
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_rwlock_rdlock(cothreadj_rwlock_t* rwlock, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= rwlock);
+	assert(NULL	!= cothread);
+	assert(cothread	!= rwlock->writer);
+
+	//---Is no writer owning or waiting for the lock ?---//
+	if ((NULL == rwlock->writer) && (NULL == rwlock->writers.head)) {
+		rwlock->nb_readers++;
+	} else {
+		//---Wait for the next batch of readers---//
+		cothreadj_queue_push(&(rwlock->readers), cothread);
+		cothreadj_sched_park(cothread);
+		assert(0	!= rwlock->nb_readers);
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_rwlock_wrlock(cothreadj_rwlock_t* rwlock, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= rwlock);
+	assert(NULL	!= cothread);
+	assert(cothread	!= rwlock->writer);
+
+	//---Is the lock free ?---//
+	if ((NULL == rwlock->writer) && (0 == rwlock->nb_readers)) {
+		rwlock->writer	= cothread;
+	} else {
+		//---Wait for the lock to be handed over---//
+		cothreadj_queue_push(&(rwlock->writers), cothread);
+		cothreadj_sched_park(cothread);
+		assert(cothread	== rwlock->writer);
+	}
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_rwlock_unlock(cothreadj_rwlock_t* rwlock, cothreadj_t* cothread)
+{
+	//---Check arguments---//
+	assert(NULL	!= rwlock);
+	assert(NULL	!= cothread);
+
+	//---Release the lock---//
+	const int	was_writer	= (cothread == rwlock->writer);
+	if (0 != was_writer) {
+		rwlock->writer	= NULL;
+	} else {
+		assert(0	!= rwlock->nb_readers);
+		if (0 != --rwlock->nb_readers) {
+			return;
+		}
+	}
+
+	//---Alternate: a writer hands the lock over to the whole batch of waiting readers if any---//
+	if (((0 != was_writer) || (NULL == rwlock->writers.head)) && (NULL != rwlock->readers.head)) {
+		cothreadj_t*	reader;
+		while (NULL != (reader = cothreadj_queue_pop(&(rwlock->readers)))) {
+			rwlock->nb_readers++;
+			cothreadj_sched_wake(reader);
+		}
+	} else if (NULL != (rwlock->writer = cothreadj_queue_pop(&(rwlock->writers)))) {
+		//---Hand the lock over to the first waiting writer---//
+		cothreadj_sched_wake(rwlock->writer);
+	}
+}
@@ -0,0 +1,365 @@
+/**
+ * @brief		This file contains the watchdog definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadj_watchdog	cothread - watchdog
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadj_watchdog_def	Definitions
+ *				A callee which never yields stalls all the other ones of its OS thread. When the library is built
+ *				with @ref COTHREAD_WITH_WATCHDOG, each OS thread bumps a switch epoch on each resume and pause,
+ *				and the watchdog thread reports the callees which have kept their OS thread for too long.
+ *
+ * @section		doxy_p_cothreadj_watchdog_use	Usage
+ *				-# Call the @ref cothreadj_watchdog_start function to start watching the OS threads ;
+ *				-# Call the @ref cothreadj_watchdog_stop function to stop watching them.
+ *				.
+ *
+ * @section		doxy_p_cothreadj_watchdog_impl	Implementation
+ *				The switch only loads the epoch of its OS thread and stores it back bumped, with a relaxed store:
+ *				the high bits count the switches, the @ref COTHREADJ_WATCHDOG_DEPTH_BITS low ones the nested
+ *				running callees. The watchdog thread periodically reads the epochs of the watched OS threads:
+ *				an epoch which has not changed since the threshold, while a callee runs, reveals a stall.
+ *				The watchdog then samples the backtrace of the stalled OS thread from a @c SIGURG handler,
+ *				which also reads the name of the culprit from the running cothread of the OS thread: the watchdog
+ *				thread never touches a cothread, which its OS thread may free meanwhile.
+ */
+
+#if (defined(__gnu_linux__) && !defined(_GNU_SOURCE))
+	#define _GNU_SOURCE	// sigaction, pthread_kill & nanosleep.
+#endif
+
+#include <cothread/cothreadj_watchdog.h>
+#include <assert.h>
+
+#if		(COTHREADJ_WITH_EPOCH && (COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID))
+#include <cothread/atomic.h>
+#include <cothread/ticks.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief		The watched OS thread type.
+ * @ingroup		doxy_cothreadj
+ */
+typedef struct _cothreadj_watchdog_host_t	cothreadj_watchdog_host_t;
+
+/**
+ * @brief		The watched OS thread type.
+ * @ingroup		doxy_cothreadj
+ */
+struct _cothreadj_watchdog_host_t
+{
+	volatile unsigned long		epoch;		///< @brief	The switch epoch, bumped by the OS thread (first member.)
+	pthread_t					thread;		///< @brief	The OS thread.
+	cothreadj_watchdog_host_t*	next;		///< @brief	The next watched OS thread.
+	//
+	unsigned long				seen_epoch;	///< @brief	The epoch the watchdog has seen last.
+	uint64_t					seen_ns;	///< @brief	The time the watchdog has seen the epoch change last, in nanoseconds.
+	int							reported;	///< @brief	Says whether the current stall has been reported or not.
+	int							reporting;	///< @brief	Says whether the watchdog is reporting the OS thread or not, which pins it.
+	//
+	volatile long				nb_frames;	///< @brief	The number of sampled frames, negative while the sample is pending.
+	const char*					dbg_name;	///< @brief	The debug name of the sampled running callee, NULL if none.
+	void*						frames[COTHREADJ_WATCHDOG_NB_FRAMES_MAX];	///< @brief	The sampled frames.
+};
+
+/// @cond
+#define COTHREADJ_WATCHDOG_SAMPLE_NS	(100 * 1000 * 1000)	// the time the stalled OS thread has to sample its backtrace.
+
+COTHREAD_LINK_HIDDEN COTHREAD_THREAD_LOCAL volatile unsigned long*	cothreadj_watchdog_epoch	= NULL;
+
+static volatile unsigned long		cothreadj_watchdog_epoch_unwatched;	// the epoch of the OS threads which cannot be watched.
+static pthread_once_t				cothreadj_watchdog_once		= PTHREAD_ONCE_INIT;
+static pthread_key_t				cothreadj_watchdog_key;				// detaches the OS threads when they exit.
+static pthread_mutex_t				cothreadj_watchdog_hosts_mtx	= PTHREAD_MUTEX_INITIALIZER;	// protects the watched OS threads.
+static pthread_cond_t				cothreadj_watchdog_hosts_cond	= PTHREAD_COND_INITIALIZER;		// signals the end of a report.
+static cothreadj_watchdog_host_t*	cothreadj_watchdog_hosts		= NULL;	// the watched OS threads.
+/// @endcond
+
+/**
+ * @brief		Unlinks the specified OS thread from the watched ones, when it exits.
+ * @param		[in]	arg		The OS thread.
+ * @note		The OS thread waits for the report in progress on it, if any, before being unlinked.
+ * @ingroup		doxy_cothreadj
+ */
+static void
+cothreadj_watchdog_detach(void* arg)
+{
+	cothreadj_watchdog_host_t*	host	= (cothreadj_watchdog_host_t*)arg;
+	pthread_mutex_lock(&cothreadj_watchdog_hosts_mtx);
+	while (0 != host->reporting) {
+		pthread_cond_wait(&cothreadj_watchdog_hosts_cond, &cothreadj_watchdog_hosts_mtx);
+	}
+	for (cothreadj_watchdog_host_t** it = &cothreadj_watchdog_hosts; NULL != *it; it = &((*it)->next)) {
+		if (host == *it) {
+			*it	= host->next;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&cothreadj_watchdog_hosts_mtx);
+	cothreadj_watchdog_epoch	= &cothreadj_watchdog_epoch_unwatched;
+	free(host);
+}
+
+/**
+ * @brief		Creates the key detaching the OS threads.
+ * @ingroup		doxy_cothreadj
+ */
+static void
+cothreadj_watchdog_init_key(void)
+{
+	if (0 != pthread_key_create(&cothreadj_watchdog_key, cothreadj_watchdog_detach)) {
+		abort();
+	}
+}
+
+/**
+ * @brief		Links the calling OS thread to the watched ones, on its first switch.
+ * @return		Returns the epoch of the calling OS thread.
+ * @ingroup		doxy_cothreadj
+ */
+extern COTHREAD_LINK_HIDDEN COTHREAD_NOINLINE volatile unsigned long* COTHREAD_CALL
+cothreadj_watchdog_attach(void)
+{
+	//---Allocate the OS thread, left unwatched if impossible---//
+	cothreadj_watchdog_host_t*	host;
+	pthread_once(&cothreadj_watchdog_once, cothreadj_watchdog_init_key);
+	if (NULL == (host = (cothreadj_watchdog_host_t*)calloc(1, sizeof(cothreadj_watchdog_host_t)))) {
+		cothreadj_watchdog_epoch	= &cothreadj_watchdog_epoch_unwatched;
+	} else if (0 != pthread_setspecific(cothreadj_watchdog_key, host)) {
+		free(host);
+		cothreadj_watchdog_epoch	= &cothreadj_watchdog_epoch_unwatched;
+	} else {
+		//---Link---//
+		host->thread	= pthread_self();
+		pthread_mutex_lock(&cothreadj_watchdog_hosts_mtx);
+		host->next					= cothreadj_watchdog_hosts;
+		cothreadj_watchdog_hosts	= host;
+		pthread_mutex_unlock(&cothreadj_watchdog_hosts_mtx);
+		cothreadj_watchdog_epoch	= &(host->epoch);
+	}
+	return cothreadj_watchdog_epoch;
+}
+
+#endif
+
+#if		(COTHREAD_WITH_WATCHDOG && (COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID))
+/// @cond
+extern COTHREAD_LINK_HIDDEN COTHREAD_THREAD_LOCAL cothreadj_t*	cothreadj_running;	// the cothread whose callee is running in the OS thread (see cothreadj.c.)
+
+static pthread_mutex_t				cothreadj_watchdog_mtx			= PTHREAD_MUTEX_INITIALIZER;	// protects the stop request.
+static pthread_cond_t				cothreadj_watchdog_cond			= PTHREAD_COND_INITIALIZER;		// signals the stop request.
+static int							cothreadj_watchdog_running		= 0;	// says whether the watchdog thread runs or not.
+static int							cothreadj_watchdog_stopping		= 0;	// says whether the watchdog thread shall stop or not.
+static pthread_t					cothreadj_watchdog_thread;			// the watchdog thread.
+static uint64_t						cothreadj_watchdog_threshold_ns;	// the time a callee may run without yielding.
+static FILE*						cothreadj_watchdog_strm;			// the stream to write the reports to.
+static struct sigaction				cothreadj_watchdog_old_action;		// the SIGURG action to restore.
+/// @endcond
+
+/**
+ * @brief		The SIGURG handler, which samples the backtrace of the stalled OS thread.
+ * @param		[in]	signum	The signal number.
+ * @note		This function is async-signal-safe once @c backtrace has been called.
+ * @ingroup		doxy_cothreadj
+ */
+static void
+cothreadj_watchdog_handler(int signum)
+{
+	//---Definitions---//
+	const int					saved_errno	= errno;
+	volatile unsigned long*		epoch		= cothreadj_watchdog_epoch;
+	(void)signum;
+
+	//---Sample the running stack if requested---//
+	if ((NULL != epoch) && (&cothreadj_watchdog_epoch_unwatched != epoch)) {
+		cothreadj_watchdog_host_t*	host	= (cothreadj_watchdog_host_t*)epoch;
+		if (0 > COTHREAD_ATOMIC_LOAD(&(host->nb_frames))) {
+			const cothreadj_t*	running	= cothreadj_running;	// the interrupted callee, still alive.
+			host->dbg_name	= (NULL != running) ? running->dbg_callee_name : NULL;
+			COTHREAD_ATOMIC_STORE(&(host->nb_frames), (long)backtrace(host->frames, COTHREADJ_WATCHDOG_NB_FRAMES_MAX));
+		}
+	}
+
+	//---Restore errno---//
+	errno	= saved_errno;
+}
+
+/**
+ * @brief		Reports the callee running in the specified stalled OS thread.
+ * @param		[in]	host		The OS thread.
+ * @param		[in]	stall_ns	The time the callee has been running for, in nanoseconds.
+ * @note		The watched OS threads are not locked, the specified one being pinned (see @c reporting.)
+ * @ingroup		doxy_cothreadj
+ */
+static void
+cothreadj_watchdog_report(cothreadj_watchdog_host_t* host, uint64_t stall_ns)
+{
+	//---Sample the backtrace---//
+	COTHREAD_ATOMIC_STORE(&(host->nb_frames), -1);
+	long	nb_frames	= -1;
+	if (0 == pthread_kill(host->thread, SIGURG)) {
+		const uint64_t	deadline	= cothread_ticks_ns() + COTHREADJ_WATCHDOG_SAMPLE_NS;
+		while ((0 > (nb_frames = COTHREAD_ATOMIC_LOAD(&(host->nb_frames)))) && (cothread_ticks_ns() < deadline)) {
+			const struct timespec	ts	= { 0, 1000 * 1000 };
+			nanosleep(&ts, NULL);
+		}
+	}
+
+	//---Name the callee the handler found running---//
+	const char*	dbg_name	= ((0 <= nb_frames) && (NULL != host->dbg_name)) ? host->dbg_name : "[thread]";
+
+	//---Write the report---//
+	fprintf(cothreadj_watchdog_strm, "cothreadj watchdog: %s has been running for %lu ms without yielding\n",
+		dbg_name, (unsigned long)(stall_ns / 1000000));
+	if (0 > nb_frames) {
+		fprintf(cothreadj_watchdog_strm, "\t(no backtrace)\n");
+	} else {
+		char**	symbols	= backtrace_symbols(host->frames, (int)nb_frames);
+		for (long i = 1; i < nb_frames; i++) {	// the first frame is the handler one.
+			if (NULL != symbols) {
+				fprintf(cothreadj_watchdog_strm, "\t#%ld %s\n", i - 1, symbols[i]);
+			} else {
+				fprintf(cothreadj_watchdog_strm, "\t#%ld %p\n", i - 1, host->frames[i]);
+			}
+		}
+		free(symbols);
+	}
+	fflush(cothreadj_watchdog_strm);
+}
+
+/**
+ * @brief		The watchdog thread entry point.
+ * @param		[in]	arg		Unused.
+ * @return		Returns NULL.
+ * @ingroup		doxy_cothreadj
+ */
+static void*
+cothreadj_watchdog_thread_cb(void* arg)
+{
+	//---Check 4 times per threshold, 1 ms apart at least---//
+	uint64_t	period_ns	= cothreadj_watchdog_threshold_ns / 4;
+	period_ns	= (1000000 > period_ns) ? 1000000 : period_ns;
+	(void)arg;
+
+	//---Check until stopped---//
+	pthread_mutex_lock(&cothreadj_watchdog_mtx);
+	while (0 == cothreadj_watchdog_stopping) {
+		//---Wait for the period to elapse---//
+		struct timespec	ts;
+		clock_gettime(CLOCK_REALTIME, &ts);	// the clock of the condition variable.
+		const uint64_t	ns	= (uint64_t)ts.tv_nsec + period_ns;
+		ts.tv_sec	+= (time_t)(ns / 1000000000);
+		ts.tv_nsec	= (long)(ns % 1000000000);
+		if (ETIMEDOUT != pthread_cond_timedwait(&cothreadj_watchdog_cond, &cothreadj_watchdog_mtx, &ts)) {
+			continue;
+		}
+		pthread_mutex_unlock(&cothreadj_watchdog_mtx);
+
+		//---Look for the epochs which have not changed while a callee runs---//
+		const uint64_t	now	= cothread_ticks_ns();
+		pthread_mutex_lock(&cothreadj_watchdog_hosts_mtx);
+		for (cothreadj_watchdog_host_t* host = cothreadj_watchdog_hosts; NULL != host; host = host->next) {
+			const unsigned long	epoch	= COTHREAD_ATOMIC_LOAD_RLX(&(host->epoch));
+			if ((epoch != host->seen_epoch) || (0 == (COTHREADJ_WATCHDOG_DEPTH_MASK & epoch))) {
+				host->seen_epoch	= epoch;
+				host->seen_ns		= now;
+				host->reported		= 0;
+			} else if ((0 == host->reported) && (now - host->seen_ns >= cothreadj_watchdog_threshold_ns)) {
+				//---Report unlocked, the OS thread staying linked until done---//
+				const uint64_t	stall_ns	= now - host->seen_ns;
+				host->reported	= 1;
+				host->reporting	= 1;
+				pthread_mutex_unlock(&cothreadj_watchdog_hosts_mtx);
+				cothreadj_watchdog_report(host, stall_ns);
+				pthread_mutex_lock(&cothreadj_watchdog_hosts_mtx);
+				host->reporting	= 0;
+				pthread_cond_broadcast(&cothreadj_watchdog_hosts_cond);
+			}
+		}
+		pthread_mutex_unlock(&cothreadj_watchdog_hosts_mtx);
+		pthread_mutex_lock(&cothreadj_watchdog_mtx);
+	}
+	pthread_mutex_unlock(&cothreadj_watchdog_mtx);
+	return NULL;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_watchdog_start(unsigned long threshold_us, FILE* strm)
+{
+	//---Check arguments---//
+	assert(0	!= threshold_us);
+	assert(NULL	!= strm);
+	assert(0	== cothreadj_watchdog_running);
+
+	//---Load what backtrace needs, which the handler cannot do---//
+	void*	frame;
+	backtrace(&frame, 1);
+
+	//---Install the handler---//
+	struct sigaction	action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler	= cothreadj_watchdog_handler;
+	action.sa_flags		= SA_RESTART;
+	sigemptyset(&(action.sa_mask));
+	if (0 != sigaction(SIGURG, &action, &cothreadj_watchdog_old_action)) {
+		return cothread_err_notsup;
+	}
+
+	//---Start the thread, every watched OS thread being considered as switching right now---//
+	cothreadj_watchdog_threshold_ns	= (uint64_t)threshold_us * 1000;
+	cothreadj_watchdog_strm			= strm;
+	cothreadj_watchdog_stopping		= 0;
+	pthread_mutex_lock(&cothreadj_watchdog_hosts_mtx);
+	for (cothreadj_watchdog_host_t* host = cothreadj_watchdog_hosts; NULL != host; host = host->next) {
+		host->seen_epoch	= ~COTHREAD_ATOMIC_LOAD_RLX(&(host->epoch));
+	}
+	pthread_mutex_unlock(&cothreadj_watchdog_hosts_mtx);
+	if (0 != pthread_create(&cothreadj_watchdog_thread, NULL, cothreadj_watchdog_thread_cb, NULL)) {
+		sigaction(SIGURG, &cothreadj_watchdog_old_action, NULL);
+		return cothread_err_notsup;
+	}
+	cothreadj_watchdog_running	= 1;
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_watchdog_stop(void)
+{
+	//---Check the state---//
+	assert(0	!= cothreadj_watchdog_running);
+
+	//---Stop the thread---//
+	pthread_mutex_lock(&cothreadj_watchdog_mtx);
+	cothreadj_watchdog_stopping	= 1;
+	pthread_cond_signal(&cothreadj_watchdog_cond);
+	pthread_mutex_unlock(&cothreadj_watchdog_mtx);
+	pthread_join(cothreadj_watchdog_thread, NULL);
+	cothreadj_watchdog_running	= 0;
+
+	//---Restore the previous action---//
+	sigaction(SIGURG, &cothreadj_watchdog_old_action, NULL);
+}
+#else
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadj_watchdog_start(unsigned long threshold_us, FILE* strm)
+{
+	(void)threshold_us;
+	assert(NULL	!= strm);
+	return cothread_err_notsup;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadj_watchdog_stop(void)
+{
+	// never started.
+}
+#endif
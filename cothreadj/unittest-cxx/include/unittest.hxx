@@ -13,5 +13,9 @@
 extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest0			(void);
 extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest1			(void);
 extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest2			(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest3			(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest4			(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest5			(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest6			(void);
 
 #endif /* __UNITTEST_HXX__ */
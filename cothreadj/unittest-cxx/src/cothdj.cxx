@@ -10,6 +10,7 @@
  */
 _cothdj_t::~_cothdj_t(void)
 {
+	cothreadj_uninit(&(this->cothreadj));
 }
 
 /**
@@ -20,6 +20,10 @@ main(int argc, char* argv[])
 	unittest0();
 	unittest1();
 	unittest2();
+	unittest3();
+	unittest4();
+	unittest5();
+	unittest6();
 
 	printf("%s terminated\n", __func__);
 	return 0;
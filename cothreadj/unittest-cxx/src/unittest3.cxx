@@ -0,0 +1,158 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.hxx>
+#include <cothread/cothreadj_coro.hxx>
+#include <stdexcept>
+
+#if defined(__cpp_impl_coroutine)
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 16 * 1024)
+static cothreadj_sched_t	sched_g;	// the scheduler shared by the fibers & the coroutines.
+static int					ctr_g;		// incremented by a fiber while another one waits for the coroutines.
+/// @endcond
+
+/**
+ * @brief		The generator entry point, which yields its received value times 1, 2, 3...
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Never returns.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static int COTHREAD_CALL
+gen_cb(cothreadj_t* cothread, int user_val)
+{
+	for (int i = 1; ; i++) {
+		user_val	= cothreadj_yield(cothread, i * user_val);
+	}
+}
+
+/**
+ * @brief		Adds the specified values once resumed by the scheduler.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static cothreadj::task<int>
+add(int a, int b)
+{
+	co_await cothreadj::schedule(&sched_g);
+	co_return a + b;
+}
+
+/**
+ * @brief		Sums the first values of the specified generator, then adds a few ones.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static cothreadj::task<int>
+sum(cothreadj_t* gen)
+{
+	int	val	= 0;
+	for (int i = 0; i < 4; i++) {
+		val	+= co_await cothreadj::next(gen, 1);
+		co_await cothreadj::schedule(&sched_g);
+	}
+	co_return val + co_await add(10, 20);
+}
+
+/**
+ * @brief		Returns without suspending.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static cothreadj::task<int>
+immediate(void)
+{
+	co_return 7;
+}
+
+/**
+ * @brief		Throws once resumed by the scheduler.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static cothreadj::task<void>
+fail(void)
+{
+	co_await cothreadj::schedule(&sched_g);
+	throw std::runtime_error("fail");
+}
+
+/**
+ * @brief		The entry point of the fiber waiting for the coroutines.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static int COTHREAD_CALL
+waiter_cb(cothreadj_t* cothread, int user_val)
+{
+	//---Drive a generator from a coroutine, the other fiber runs meanwhile---//
+	static cothreadj_stack_t	stack[STACK_SZ];
+	cothreadj_attr_t			attr;
+	cothreadj_t					gen;
+	cothreadj_attr_init(&attr, stack, sizeof(stack), &gen_cb);
+	cothreadj_init(&gen, &attr);
+	assert(1 + 2 + 3 + 4 + 30	== cothreadj::sync_wait(cothread, sum(&gen)));
+	assert(0					< ctr_g);
+	cothreadj_uninit(&gen);
+
+	//---The fiber is not parked if the coroutine does not suspend---//
+	const int	ctr	= ctr_g;
+	assert(7	== cothreadj::sync_wait(cothread, immediate()));
+	assert(ctr	== ctr_g);
+
+	//---The exception is rethrown in the fiber---//
+	bool	thrown	= false;
+	try { cothreadj::sync_wait(cothread, fail()); }
+	catch (std::runtime_error&) { thrown	= true; }
+	assert(thrown);
+	return user_val;
+}
+
+/**
+ * @brief		The entry point of the fiber running alongside the coroutines.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static int COTHREAD_CALL
+counter_cb(cothreadj_t* cothread, int user_val)
+{
+	for (int i = 0; i < 4; i++) {
+		ctr_g++;
+		cothreadj_sched_yield(cothread);
+	}
+	return user_val;
+}
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest3(void)
+{
+#if defined(__cpp_impl_coroutine)
+	//---Definitions---//
+	static cothreadj_stack_t	stacks[2][STACK_SZ];
+	cothreadj_attr_t			attr;
+	cothreadj_t					waiter;
+	cothreadj_t					counter;
+
+	//---Spawn both fibers on the scheduler the coroutines use---//
+	cothreadj_sched_init(&sched_g);
+	cothreadj_attr_init(&attr, stacks[0], sizeof(stacks[0]), &waiter_cb);
+	cothreadj_init(&waiter, &attr);
+	cothreadj_sched_spawn(&sched_g, &waiter);
+	cothreadj_attr_init(&attr, stacks[1], sizeof(stacks[1]), &counter_cb);
+	cothreadj_init(&counter, &attr);
+	cothreadj_sched_spawn(&sched_g, &counter);
+
+	//---Run until both fibers return---//
+	assert(0	== cothreadj_sched_run(&sched_g));
+	assert(0	!= (COTHREADJ_FLAG_COMPLETED & waiter.flags));
+	assert(4	== ctr_g);
+#endif
+}
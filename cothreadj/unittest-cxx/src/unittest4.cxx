@@ -0,0 +1,154 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.hxx>
+#include <cothread/cothreadj_future.hxx>
+
+#if COTHREADJ_CXX17
+#include <optional>
+#include <string>
+#include <thread>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 16 * 1024)
+static cothreadj_sched_t							sched_g;	// the scheduler.
+static std::optional<cothreadj::promise<int>>		promise_g;	// the promise the setter fulfills.
+static int											ctr_g;		// incremented by the setter each time it runs.
+/// @endcond
+
+/// @cond
+struct continuation
+{
+	cothreadj_sched_task_t		node;	// the continuation (first member.)
+	cothreadj::future<int>*		future;	// the future.
+	int							val;	// the result seen by the continuation, zero until run.
+
+	static void COTHREAD_CALL
+	run(cothreadj_sched_task_t* task)
+	{
+		continuation*	self	= reinterpret_cast<continuation*>(task);
+		self->val	= self->future->get(nullptr);
+	}
+};
+/// @endcond
+
+/**
+ * @brief		The entry point of the fiber waiting for the futures.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static int COTHREAD_CALL
+waiter_cb(cothreadj_t* cothread, int user_val)
+{
+	//---A fulfilled future does not park the fiber---//
+	{
+		cothreadj::future<int>	future;
+		future.get_promise().set_value(7);
+		assert(future.ready());
+		const int	ctr	= ctr_g;
+		assert(7	== future.get(cothread));
+		assert(ctr	== ctr_g);
+	}
+
+	//---The fiber is parked until the other one fulfills the future---//
+	{
+		cothreadj::future<int>	future;
+		promise_g.emplace(future.get_promise());
+		assert(!future.ready());
+		assert(42	== future.get(cothread));
+		assert(2	== ctr_g);
+	}
+
+	//---The continuation runs inline, on fulfilment or right away once fulfilled---//
+	{
+		cothreadj::future<int>	future;
+		continuation			cont;
+		cothreadj_sched_task_init(&(cont.node), &continuation::run);
+		cont.future	= &future;
+		cont.val	= 0;
+		future.then(&(cont.node));
+		assert(0	== cont.val);
+		future.get_promise().set_value(9);
+		assert(9	== cont.val);
+		cothreadj_sched_task_init(&(cont.node), &continuation::run);
+		cont.val	= 0;
+		future.then(&(cont.node));
+		assert(9	== cont.val);
+	}
+
+	//---The future may be fulfilled from another OS thread---//
+	{
+		cothreadj::future<std::string>	text;
+		cothreadj::future<>				done;
+		std::thread	thread([p = text.get_promise(), q = done.get_promise()] (void) mutable {
+			p.set_value("remote");
+			q.set_value();
+		});
+		assert("remote"	== text.get(cothread));
+		done.get(cothread);
+		thread.join();
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The entry point of the fiber fulfilling the future after a few runs.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static int COTHREAD_CALL
+setter_cb(cothreadj_t* cothread, int user_val)
+{
+	while (!promise_g.has_value()) {
+		cothreadj_sched_yield(cothread);
+	}
+	for (int i = 0; i < 2; i++) {
+		ctr_g++;
+		cothreadj_sched_yield(cothread);
+	}
+	promise_g->set_value(42);
+	promise_g.reset();
+	return user_val;
+}
+
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest4(void)
+{
+#if COTHREADJ_CXX17
+	//---Definitions---//
+	static cothreadj_stack_t	stacks[2][STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					waiter;
+	cothreadj_t					setter;
+
+	//---Spawn both fibers---//
+	cothreadj_sched_init(&sched_g);
+	cothreadj_attr_init(&attr, stacks[0], sizeof(stacks[0]), &waiter_cb);
+	cothreadj_init(&waiter, &attr);
+	cothreadj_sched_spawn(&sched_g, &waiter);
+	cothreadj_attr_init(&attr, stacks[1], sizeof(stacks[1]), &setter_cb);
+	cothreadj_init(&setter, &attr);
+	cothreadj_sched_spawn(&sched_g, &setter);
+
+	//---Run until both fibers return, blocking while the waiter waits for the other OS thread---//
+	while (0 != cothreadj_sched_run(&sched_g)) {
+		assert(cothread_err_ok	== cothreadj_sched_wait(&sched_g));
+	}
+	assert(0	!= (COTHREADJ_FLAG_COMPLETED & waiter.flags));
+	cothreadj_uninit(&waiter);
+	cothreadj_uninit(&setter);
+	cothreadj_sched_uninit(&sched_g);
+#endif
+}
@@ -0,0 +1,81 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.hxx>
+#include <cothread/cothreadj_hooks.hxx>
+#include <errno.h>
+#include <string>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 16 * 1024)
+static std::string	events_g;	// the hooks called, in order.
+static int			errno_g[2];	// the errno of the caller while the callee runs, & of the callee while suspended.
+/// @endcond
+
+/// @cond
+template <char R, char S>
+struct logger
+{
+	static void	on_resume	(cothreadj_t*)	{ events_g	+= R; }
+	static void	on_suspend	(cothreadj_t*)	{ events_g	+= S; }
+};
+
+struct errno_keeper
+{
+	static void	on_resume	(cothreadj_t*) noexcept	{ errno_g[0]	= errno;	errno	= errno_g[1]; }
+	static void	on_suspend	(cothreadj_t*) noexcept	{ errno_g[1]	= errno;	errno	= errno_g[0]; }
+};
+/// @endcond
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	errno	= EAGAIN;
+	user_val	= cothreadj_yield(cothread, user_val + 1);
+	assert(EAGAIN	== errno);
+	return user_val + 1;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest5(void)
+{
+	//---Definitions---//
+	using global_hooks	= cothreadj::hooks_chain<logger<'R', 'S'>, errno_keeper>;
+	using hooks			= cothreadj::hooks_chain<global_hooks, logger<'r', 's'>>;
+	static cothreadj_stack_t	stack[STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothread;
+	cothreadj_attr_init(&attr, stack, sizeof(stack), &user_cb);
+
+	//---Without hooks---//
+	cothreadj_init(&cothread, &attr);
+	assert(2	== cothreadj::resume(&cothread, 1));
+	assert(4	== cothreadj::resume(&cothread, 3));
+	cothreadj_uninit(&cothread);
+
+	//---The global hooks wrap the per-cothread ones, the callee errno being kept across the switches---//
+	cothreadj_init(&cothread, &attr);
+	errno_g[1]	= 0;
+	errno		= 0;
+	assert(2	== cothreadj::resume<hooks>(&cothread, 1));
+	assert(0	== errno);
+	assert(EAGAIN	== errno_g[1]);
+	errno	= EINTR;
+	assert(4	== cothreadj::resume<hooks>(&cothread, 3));
+	assert(EINTR	== errno);
+	assert("RrsSRrsS"	== events_g);
+	cothreadj_uninit(&cothread);
+}
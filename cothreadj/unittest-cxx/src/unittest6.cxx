@@ -0,0 +1,76 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.hxx>
+#include <cothread/cothreadj_mesh.hxx>
+
+#if COTHREADJ_CXX17
+#include <string>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 16 * 1024)
+#define NB_CORES	2
+static thread_local size_t	core_id_g	= static_cast<size_t>(-1);	// the index of the core of the OS thread.
+static int					ctrs_g[NB_CORES];							// the callables run by each core, touched by that core only.
+/// @endcond
+
+/**
+ * @brief		The main callback, which runs callables on its own core & on the other one.
+ * @param		[in]	cothread	The main cothread of the core.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+static void COTHREAD_CALL
+main_cb(cothreadj_t* cothread, void* user_data)
+{
+	const size_t	id		= cothreadj_mesh_core_id(cothread);
+	const size_t	other	= (id + 1) % NB_CORES;
+	core_id_g	= id;
+
+	//---A callable submitted to the calling core runs inline---//
+	{
+		auto	local	= cothreadj::submit_to(cothread, id, [] { return core_id_g; });
+		assert(local.ready());
+		assert(id	== local.get(cothread));
+	}
+
+	//---The results of the other core come back, whatever their type & the captures of the callable---//
+	{
+		const std::string	from(1, static_cast<char>('a' + id));
+		auto	remote	= cothreadj::submit_to(cothread, other, [] { return core_id_g; });
+		auto	text	= cothreadj::submit_to(cothread, other, [from] { return from + "->" + static_cast<char>('a' + core_id_g); });
+		auto	none	= cothreadj::submit_to(cothread, other, [] { ctrs_g[core_id_g]++; });
+		assert(other	== remote.get(cothread));
+		assert(from + "->" + static_cast<char>('a' + other)	== text.get(cothread));
+		none.get(cothread);
+		assert(none.ready());
+	}
+
+	//---A future dropped before its result is back waits for it---//
+	{
+		auto	dropped	= cothreadj::submit_to(cothread, other, [] { ctrs_g[core_id_g]++; });
+		assert(!dropped.ready());
+	}
+}
+
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest_cxx
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest6(void)
+{
+#if COTHREADJ_CXX17
+	cothreadj_mesh_t	mesh;
+	assert(cothread_err_ok	== cothreadj_mesh_init(&mesh, NB_CORES, 0, STACK_SZ));
+	assert(cothread_err_ok	== cothreadj_mesh_run(&mesh, &main_cb, nullptr));
+	for (size_t i = 0; i < NB_CORES; i++) {
+		assert(2	== ctrs_g[i]);
+	}
+	cothreadj_mesh_uninit(&mesh);
+#endif
+}
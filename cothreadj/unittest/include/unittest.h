@@ -16,6 +16,28 @@ extern "C" {
 /// @cond
 extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest0	(void);
 extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest1	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest2	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest3	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest4	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest5	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest6	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest7	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest8	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest9	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest10	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest11	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest12	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest13	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest14	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest15	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest16	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest17	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest18	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest19	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest20	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest21	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest22	(void);
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest23	(void);
 /// @endcond
 
 #ifdef __cplusplus
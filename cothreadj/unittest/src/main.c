@@ -4,6 +4,7 @@
  */
 
 #include <unittest.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdint.h>
 
@@ -165,7 +166,7 @@ static void COTHREAD_CALL
 check_cothread_init(void)
 {
 	//---Initialize the attributes---//
-	cothreadj_stack_t	stack[(2 * 1024) / sizeof(cothreadj_stack_t)];
+	cothreadj_stack_t	stack[(16 * 1024) / sizeof(cothreadj_stack_t)];
 	cothreadj_attr_t	attr;
 	cothreadj_attr_init(&attr, stack, sizeof(stack), (cothreadj_cb_t)0x1234);
 
@@ -175,12 +176,17 @@ check_cothread_init(void)
 	cothread.user_data	= (void*)0x1234;
 	cothreadj_init(&cothread, &attr);
 	assert(&(cothread.caller)	== cothread.current);
-	assert(NULL					!= cothread.caller.dbg_name);
-	assert(0					== strcmp("caller", cothread.caller.dbg_name));
-	assert(NULL					!= cothread.callee.dbg_name);
-	assert(0					== strcmp("callee", cothread.callee.dbg_name));
+	assert(NULL					!= cothread.dbg_caller_name);
+	assert(0					== strcmp("caller", cothread.dbg_caller_name));
+	assert(NULL					!= cothread.dbg_callee_name);
+	assert(0					== strcmp("callee", cothread.dbg_callee_name));
 	assert((void*)0x1234		== cothread.user_data);
 	assert(NULL					== cothread.dbg_strm);
+	assert(0					== (COTHREADJ_FLAG_LOG & cothread.flags));
+#if COTHREAD_WITH_COMPACT_CTX
+	//---The members a switch or a scheduler pass touches fill the first cache line---//
+	assert(64					>= offsetof(cothreadj_t, shstk) + sizeof(cothread.shstk));
+#endif
 
 	//---Check user data functions---//
 	assert((void*)0x1234		== cothread.user_data);
@@ -188,6 +194,9 @@ check_cothread_init(void)
 	cothreadj_set_user_data(&cothread, (void*)0x5678);
 	assert((void*)0x5678		== cothread.user_data);
 	assert((void*)0x5678		== cothreadj_get_user_data(&cothread));
+
+	//---Uninitialize the cothread which is never resumed---//
+	cothreadj_uninit(&cothread);
 }
 
 /**
@@ -211,6 +220,28 @@ main(int argc, char* argv[])
 	check_cothread_init();
 	unittest0();
 	unittest1();
+	unittest2();
+	unittest3();
+	unittest4();
+	unittest5();
+	unittest6();
+	unittest7();
+	unittest8();
+	unittest9();
+	unittest10();
+	unittest11();
+	unittest12();
+	unittest13();
+	unittest14();
+	unittest15();
+	unittest16();
+	unittest17();
+	unittest18();
+	unittest19();
+	unittest20();
+	unittest21();
+	unittest22();
+	unittest23();
 	printf("%s terminated\n", __func__);
 	return 0;
 }
@@ -0,0 +1,87 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_arena.h>
+#include <string.h>
+
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 2 * 1024)
+/// @endcond
+
+/**
+ * @brief		Checks the per-node statistics of an arena.
+ * @param		[in]	flags	The arena flags.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+check_arena(unsigned int flags)
+{
+	//---No region, no node---//
+	cothreadj_arena_t				arena;
+	cothreadj_arena_node_stats_t	stats[2];
+	cothreadj_arena_init(&arena, STACK_SZ, flags);
+	assert(0	== cothreadj_arena_node_stats(&arena, NULL, 0));
+
+	//---Carve slots out of two regions---//
+	const size_t	nb_slots	= arena.region_sz / arena.slot_sz + 1;
+	cothreadj_stack_t*	last	= NULL;
+	for (size_t i = 0; i < nb_slots; i++) {
+		last	= cothreadj_arena_alloc(&arena, NULL);
+		assert(NULL	!= last);
+	}
+	memset(last, 0, arena.stack_sz);
+
+	//---The regions are placed with the flag only, unless the placement is refused (e.g. by a seccomp filter)---//
+	const int	node	= cothreadj_arena_get_node(&arena, last);
+	assert((0 != (COTHREADJ_ARENA_FLAG_NUMA_LOCAL & flags)) || (-1 == node));
+
+	//---Both regions are counted, on the same node unless the OS thread migrated in between---//
+	const size_t	nb_nodes	= cothreadj_arena_node_stats(&arena, NULL, 0);
+	assert((1 == nb_nodes) || ((2 == nb_nodes) && (0 != flags)));
+	assert(nb_nodes	== cothreadj_arena_node_stats(&arena, stats, 2));
+	assert(node		== stats[0].node);
+	assert(2						== stats[0].nb_regions + ((2 == nb_nodes) ? stats[1].nb_regions : 0));
+	assert(2 * arena.region_sz		== stats[0].nb_bytes + ((2 == nb_nodes) ? stats[1].nb_bytes : 0));
+	assert(nb_slots					== stats[0].nb_slots + ((2 == nb_nodes) ? stats[1].nb_slots : 0));
+
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	//---The touched page is on the node---//
+	if (0 <= node) {
+		int	page_node	= -1;
+		assert(0	== syscall(SYS_get_mempolicy, &page_node, NULL, 0, (void*)last, MPOL_F_NODE | MPOL_F_ADDR));
+		assert(node	== page_node);
+	}
+#endif
+
+	//---Release---//
+	cothreadj_arena_uninit(&arena);
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest10(void)
+{
+	//---The node is known on GNU/Linux only---//
+	const int	node	= cothreadj_numa_node();
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	assert(0	<= node);
+#else
+	assert(-1	== node);
+#endif
+
+	//---Without & with the placement---//
+	check_arena(0);
+	check_arena(COTHREADJ_ARENA_FLAG_NUMA_LOCAL);
+}
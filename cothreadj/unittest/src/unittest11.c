@@ -0,0 +1,205 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_sched.h>
+#include <stdint.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ	(256 * 1024)
+#define DEPTH_SZ	(128 * 1024)
+#define NB_PARKS	8
+/// @endcond
+
+/**
+ * @brief		Dirties the specified number of stack bytes below the calling frame.
+ * @param		[in]	nb_bytes	The number of stack bytes to dirty.
+ * @return		Returns a value depending on the dirtied bytes, so that they are not optimized out.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static COTHREAD_NOINLINE int COTHREAD_CALL
+dirty_stack(size_t nb_bytes)
+{
+	volatile char	frame[4096];
+	memset((char*)frame, (int)nb_bytes, sizeof(frame));
+	return frame[nb_bytes % sizeof(frame)] + ((sizeof(frame) < nb_bytes) ? dirty_stack(nb_bytes - sizeof(frame)) : 0);
+}
+
+/**
+ * @brief		The callee entry point, which yields once its stack is dirty.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	user_val	+= dirty_stack(DEPTH_SZ) & 0;
+	return cothreadj_yield(cothread, user_val + 1) + 1;
+}
+
+/**
+ * @brief		The scheduled callee entry point, which parks once its stack is dirty.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+sched_cb(cothreadj_t* cothread, int user_val)
+{
+	user_val	+= dirty_stack(DEPTH_SZ) & 0;
+	cothreadj_sched_park(cothread);
+	return user_val;
+}
+
+/**
+ * @brief		The scheduled callee entry point, which parks briefly a few times once its stack is dirty.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+brief_cb(cothreadj_t* cothread, int user_val)
+{
+	user_val	+= dirty_stack(DEPTH_SZ) & 0;
+	for (size_t i = 0; i < NB_PARKS; i++) {
+		cothreadj_sched_park(cothread);
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The scheduled callee entry point, which wakes the cothread parking briefly up each time it runs.
+ * @param		[in]	cothread	The cothread, whose user data is the cothread parking briefly.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+waker_cb(cothreadj_t* cothread, int user_val)
+{
+	for (size_t i = 0; i < NB_PARKS; i++) {
+		cothreadj_sched_wake((cothreadj_t*)cothreadj_get_user_data(cothread));
+		cothreadj_sched_yield(cothread);
+	}
+	return user_val;
+}
+
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+/**
+ * @brief		Returns the resident anonymous bytes of the process which the kernel may not reclaim freely.
+ * @return		Returns the resident anonymous bytes minus the lazily freed ones, zero if not available.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static size_t COTHREAD_CALL
+get_rss(void)
+{
+	char	line[256];
+	size_t	anon		= 0;
+	size_t	lazy_free	= 0;
+	FILE*	file		= fopen("/proc/self/smaps_rollup", "r");
+	if (NULL != file) {
+		while (NULL != fgets(line, sizeof(line), file)) {
+			size_t	val;
+			if (1 == sscanf(line, "Anonymous: %zu kB", &val)) {
+				anon		= val * 1024;
+			} else if (1 == sscanf(line, "LazyFree: %zu kB", &val)) {
+				lazy_free	= val * 1024;
+			}
+		}
+		fclose(file);
+	}
+	return anon - lazy_free;
+}
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest11(void)
+{
+	//---Definitions (the stack is allocated apart from the huge pages, to measure the resident bytes accurately)---//
+	cothreadj_attr_t	attr;
+	cothreadj_t			cothread;
+	size_t				nb_bytes;
+	void*				block	= malloc(STACK_SZ + COTHREADJ_STACK_ALIGN);
+	assert(NULL	!= block);
+	cothreadj_stack_t*	stack	= (cothreadj_stack_t*)(((uintptr_t)block + COTHREADJ_STACK_ALIGN - 1) & ~(uintptr_t)(COTHREADJ_STACK_ALIGN - 1));
+
+	//---Dirty the stack, then pause---//
+	cothreadj_attr_init(&attr, stack, STACK_SZ, user_cb);
+	cothreadj_init(&cothread, &attr);
+	assert(11	== cothreadj_yield(&cothread, 10));
+
+#if		((COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID) || (COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+	//---Trim the pages below the paused frame (the first read faults the stdio buffers in)---//
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	get_rss();
+	const size_t	rss0	= get_rss();
+#endif
+	assert(cothread_err_ok	== cothreadj_trim(&cothread, &nb_bytes));
+	assert(DEPTH_SZ / 2		<= nb_bytes);
+	assert(nb_bytes			<= DEPTH_SZ + 16 * 1024);
+#if		(COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)
+	const size_t	rss1	= get_rss();
+	assert((0 == rss0) || (rss1 + DEPTH_SZ / 2 <= rss0));
+#endif
+
+	//---Nothing left to trim, the paused frames survived---//
+	assert(cothread_err_ok	== cothreadj_trim(&cothread, NULL));
+	assert(21				== cothreadj_yield(&cothread, 20));
+
+	//---The whole stack of a returned callee is idle---//
+	assert(cothread_err_ok	== cothreadj_trim(&cothread, &nb_bytes));
+	assert(0				< nb_bytes);
+#else
+	assert(cothread_err_notsup	== cothreadj_trim(&cothread, &nb_bytes));
+	assert(0					== nb_bytes);
+	assert(21					== cothreadj_yield(&cothread, 20));
+#endif
+	cothreadj_uninit(&cothread);
+
+	//---The scheduler trims the parked cothreads only once enabled---//
+	cothreadj_sched_t	sched;
+	cothreadj_sched_init(&sched);
+	cothreadj_sched_set_trim(&sched, DEPTH_SZ / 2);
+	cothreadj_attr_init(&attr, stack, STACK_SZ, sched_cb);
+	cothreadj_init(&cothread, &attr);
+	cothreadj_sched_spawn(&sched, &cothread);
+	assert(1	== cothreadj_sched_run(&sched));
+#if		((COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID) || (COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+	assert(DEPTH_SZ / 2	<= sched.nb_trimmed);
+#else
+	assert(0			== sched.nb_trimmed);
+#endif
+	cothreadj_sched_wake(&cothread);
+	assert(0	== cothreadj_sched_run(&sched));
+	cothreadj_uninit(&cothread);
+
+	//---A cothread parking briefly is not trimmed---//
+	static cothreadj_stack_t	waker_stack[64 * 1024 / sizeof(cothreadj_stack_t)];
+	cothreadj_t					waker;
+	sched.nb_trimmed	= 0;
+	cothreadj_attr_init(&attr, stack, STACK_SZ, brief_cb);
+	cothreadj_init(&cothread, &attr);
+	cothreadj_attr_init(&attr, waker_stack, sizeof(waker_stack), waker_cb);
+	cothreadj_init(&waker, &attr);
+	cothreadj_set_user_data(&waker, &cothread);
+	cothreadj_sched_spawn(&sched, &cothread);
+	cothreadj_sched_spawn(&sched, &waker);
+	assert(0	== cothreadj_sched_run(&sched));
+	assert(0	== sched.nb_trimmed);
+	cothreadj_uninit(&waker);
+	cothreadj_uninit(&cothread);
+
+	//---Release---//
+	free(block);
+}
@@ -0,0 +1,152 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_sched.h>
+#include <cothread/cothreadj_shstk.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 8 * 1024)
+#define NB_COTHREADS	4
+#define NB_ROUNDS		8
+/// @endcond
+
+/**
+ * @brief		Fills a frame with a pattern, yields, then checks the pattern survived.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	depth		The number of frames to nest.
+ * @param		[in]	user_val	The user value to send to the other endpoint.
+ * @return		Returns the user value received from the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static COTHREAD_NOINLINE int COTHREAD_CALL
+nested_yield(cothreadj_t* cothread, int depth, int user_val)
+{
+	//---Fill the frame with a pattern unique to the cothread & the depth---//
+	const int		pattern	= (int)(size_t)cothreadj_get_user_data(cothread) * 16 + depth;
+	volatile char	frame[256];
+	memset((char*)frame, pattern, sizeof(frame));
+
+	//---Yield from the deepest frame---//
+	const int	ret	= (0 < depth) ? nested_yield(cothread, depth - 1, user_val) : cothreadj_yield(cothread, user_val);
+
+	//---Check the pattern---//
+	for (size_t i = 0; i < sizeof(frame); i++) {
+		assert((char)pattern	== frame[i]);
+	}
+	return ret;
+}
+
+/**
+ * @brief		The callee entry point, which yields from frames of a depth depending on its index.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	const int	depth	= (int)(size_t)cothreadj_get_user_data(cothread);
+	for (int round = 0; round < NB_ROUNDS; round++) {
+		user_val	= nested_yield(cothread, depth, user_val + 1);
+	}
+	return user_val + 1;
+}
+
+/**
+ * @brief		The scheduled callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+sched_cb(cothreadj_t* cothread, int user_val)
+{
+	volatile int	counter	= 0;
+	for (int round = 0; round < NB_ROUNDS; round++) {
+		counter++;
+		cothreadj_sched_yield(cothread);
+	}
+	assert(NB_ROUNDS	== counter);
+	return user_val;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest12(void)
+{
+	//---Definitions---//
+	static cothreadj_stack_t	stack[STACK_SZ];
+	cothreadj_shstk_t			shstk;
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothreads[NB_COTHREADS];
+	cothreadj_shstk_init(&shstk, stack, sizeof(stack));
+	assert(NULL	== shstk.owner);
+
+	//---Initialize the cothreads, each one evicts the previous one---//
+	cothreadj_attr_init(&attr, stack, sizeof(stack), user_cb);
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert(cothread_err_ok	== cothreadj_init_shared(cothreads + i, &attr, &shstk));
+		cothreadj_set_user_data(cothreads + i, (void*)(i + 1));
+		assert(cothreads + i	== shstk.owner);
+		assert(0				!= (COTHREADJ_FLAG_SHARED_STACK & cothreads[i].flags));
+	}
+	assert(NULL	== cothreads[NB_COTHREADS - 1].save);
+	assert(NULL	!= cothreads[0].save);
+
+	//---Interleave the cothreads, the frames survive the copies---//
+	for (int round = 0; round < NB_ROUNDS; round++) {
+		for (size_t i = 0; i < NB_COTHREADS; i++) {
+			assert(round * 10 + 2	== cothreadj_yield(cothreads + i, round * 10 + 1));
+			assert(cothreads + i	== shstk.owner);
+			assert(NULL				== cothreads[i].save);
+		}
+
+		//---The save areas are sized after the live frames, far below the stack size---//
+		assert(0				< shstk.nb_bytes);
+		assert(NB_COTHREADS * 4096	> shstk.nb_bytes);
+	}
+
+	//---Resuming the owner again copies nothing---//
+	const size_t	nb_copies	= shstk.nb_copies;
+	cothreadj_t*	last		= cothreads + NB_COTHREADS - 1;
+	assert(NB_ROUNDS * 10 + 2	== cothreadj_yield(last, NB_ROUNDS * 10 + 1));
+	assert(0					!= (COTHREADJ_FLAG_COMPLETED & last->flags));
+	assert(nb_copies			== shstk.nb_copies);
+
+	//---The frames of a returned callee are not copied---//
+	assert(NB_ROUNDS * 10 + 2	== cothreadj_yield(cothreads + 0, NB_ROUNDS * 10 + 1));
+	assert(nb_copies + 1		== shstk.nb_copies);
+
+	//---Uninitializing releases the save areas---//
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		cothreadj_uninit(cothreads + i);
+	}
+	assert(0	== shstk.nb_bytes);
+	assert(NULL	== shstk.owner);
+
+	//---The scheduler runs cothreads on a shared stack---//
+	cothreadj_sched_t	sched;
+	cothreadj_sched_init(&sched);
+	cothreadj_attr_init(&attr, stack, sizeof(stack), sched_cb);
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert(cothread_err_ok	== cothreadj_init_shared(cothreads + i, &attr, &shstk));
+		cothreadj_sched_spawn(&sched, cothreads + i);
+	}
+	assert(0	== cothreadj_sched_run(&sched));
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert(0	!= (COTHREADJ_FLAG_COMPLETED & cothreads[i].flags));
+		cothreadj_uninit(cothreads + i);
+	}
+
+	//---Release---//
+	cothreadj_shstk_uninit(&shstk);
+}
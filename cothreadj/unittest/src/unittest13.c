@@ -0,0 +1,117 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_sched.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 8 * 1024)
+#define NB_ROUNDS	4
+/// @endcond
+
+/// @cond
+static char				trace_g[64];	// the events, in the order they happened.
+static size_t			nb_events_g;	// the number of events.
+static cothreadj_t*		parked_g;		// the cothread parked until a task wakes it up.
+/// @endcond
+
+/**
+ * @brief		Records the specified event.
+ * @param		[in]	event	The event.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void
+record(char event)
+{
+	assert(sizeof(trace_g) - 1	> nb_events_g);
+	trace_g[nb_events_g++]	= event;
+}
+
+/**
+ * @brief		The task which records its run, then posts itself again a few times.
+ * @param		[in]	task	The task.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+repost_cb(cothreadj_sched_task_t* task)
+{
+	static int	nb_runs	= 0;
+	record('a');
+	if (NB_ROUNDS > ++nb_runs) {
+		cothreadj_sched_post((cothreadj_sched_t*)cothreadj_get_user_data(parked_g), task);
+	}
+}
+
+/**
+ * @brief		The task which wakes the parked cothread up.
+ * @param		[in]	task	The task.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+wake_cb(cothreadj_sched_task_t* task)
+{
+	(void)task;
+	record('w');
+	cothreadj_sched_wake(parked_g);
+}
+
+/**
+ * @brief		The callee entry point, which parks until a task wakes it up.
+ * @param		[in]	cothread	The cothread, whose user data is the scheduler.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	//---Post the waking task, then park---//
+	cothreadj_sched_task_t	task;
+	cothreadj_sched_task_init(&task, &wake_cb);
+	record('p');
+	cothreadj_sched_post((cothreadj_sched_t*)cothreadj_get_user_data(cothread), &task);
+	cothreadj_sched_park(cothread);
+	record('r');
+	return user_val;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest13(void)
+{
+	//---Definitions---//
+	static cothreadj_stack_t	stack[STACK_SZ];
+	cothreadj_sched_t			sched;
+	cothreadj_sched_task_t		task;
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothread;
+
+	//---Running a scheduler with neither cothreads nor tasks returns right away---//
+	cothreadj_sched_init(&sched);
+	assert(0	== cothreadj_sched_run(&sched));
+
+	//---Post a task reposting itself & spawn a cothread waiting for another task---//
+	cothreadj_attr_init(&attr, stack, sizeof(stack), &user_cb);
+	cothreadj_init(&cothread, &attr);
+	cothreadj_set_user_data(&cothread, &sched);
+	parked_g	= &cothread;
+	cothreadj_sched_task_init(&task, &repost_cb);
+	cothreadj_sched_post(&sched, &task);
+	cothreadj_sched_spawn(&sched, &cothread);
+
+	//---The tasks run in posting order, alternately with the ready cothreads---//
+	assert(0	== cothreadj_sched_run(&sched));
+	assert(0	!= (COTHREADJ_FLAG_COMPLETED & cothread.flags));
+	assert(0	== strcmp("apawraa", trace_g));
+	assert(NULL	== sched.tasks_head);
+	assert(NULL	== sched.tasks_tail);
+
+	//---Release---//
+	cothreadj_uninit(&cothread);
+}
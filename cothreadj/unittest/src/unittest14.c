@@ -0,0 +1,121 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_sched.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 8 * 1024)
+#define PATTERN		0x5a	// the byte the stacks are filled with, to detect any write.
+/// @endcond
+
+/**
+ * @brief		The callee entry point, which exchanges a value with the caller before returning.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	assert(0	== (COTHREADJ_FLAG_LAZY & cothread->flags));
+	return cothreadj_yield(cothread, user_val + 1) + 1;
+}
+
+/**
+ * @brief		The scheduled callee entry point, which counts its runs.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+sched_cb(cothreadj_t* cothread, int user_val)
+{
+	size_t*	ctr	= (size_t*)cothreadj_get_user_data(cothread);
+	ctr[0]++;
+	cothreadj_sched_yield(cothread);
+	ctr[0]++;
+	return user_val;
+}
+
+/**
+ * @brief		Says whether the specified stack still holds the pattern only.
+ * @param		[in]	stack		The stack.
+ * @param		[in]	stack_sz	The size of the stack, in bytes.
+ * @return		Returns non-zero if no byte has been written, zero otherwise.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+is_untouched(const cothreadj_stack_t* stack, size_t stack_sz)
+{
+	const unsigned char*	bytes	= (const unsigned char*)stack;
+	for (size_t i = 0; i < stack_sz; i++) {
+		if (PATTERN != bytes[i]) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest14(void)
+{
+	//---Definitions---//
+	static cothreadj_stack_t	stacks[2][STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothreads[2];
+	size_t						ctr	= 0;
+	memset(stacks, PATTERN, sizeof(stacks));
+
+	//---The lazy initialization leaves the stack untouched---//
+	cothreadj_attr_init(&attr, stacks[0], sizeof(stacks[0]), user_cb);
+	cothreadj_init_lazy(&cothreads[0], &attr);
+	assert(COTHREADJ_FLAG_LAZY	== cothreads[0].flags);
+	assert(is_untouched(stacks[0], sizeof(stacks[0])));
+
+#if		((COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID) || (COTHREAD_OS_ID_FREEBSD == COTHREAD_OS_ID) || (COTHREAD_OS_ID_MACOS == COTHREAD_OS_ID))
+	//---The whole stack of a callee never resumed is idle---//
+	assert(cothread_err_ok	== cothreadj_trim(&cothreads[0], NULL));
+	memset(stacks[0], PATTERN, sizeof(stacks[0]));
+#endif
+
+	//---The first yield builds the frame, then the cothread behaves as an eager one---//
+	assert(11					== cothreadj_yield(&cothreads[0], 10));
+	assert(!is_untouched(stacks[0], sizeof(stacks[0])));
+	assert(0					== cothreads[0].flags);
+	assert(21					== cothreadj_yield(&cothreads[0], 20));
+	assert(COTHREADJ_FLAG_COMPLETED	== cothreads[0].flags);
+	cothreadj_uninit(&cothreads[0]);
+
+	//---A cothread which never runs may be uninitialized as is---//
+	memset(stacks[0], PATTERN, sizeof(stacks[0]));
+	cothreadj_init_lazy(&cothreads[0], &attr);
+	cothreadj_uninit(&cothreads[0]);
+	assert(is_untouched(stacks[0], sizeof(stacks[0])));
+
+	//---The lazy cothreads may be spawned, they are started by the scheduler---//
+	cothreadj_sched_t	sched;
+	cothreadj_sched_init(&sched);
+	for (size_t i = 0; i < 2; i++) {
+		cothreadj_attr_init(&attr, stacks[i], sizeof(stacks[i]), sched_cb);
+		cothreadj_init_lazy(&cothreads[i], &attr);
+		cothreadj_set_user_data(&cothreads[i], &ctr);
+		cothreadj_sched_spawn(&sched, &cothreads[i]);
+	}
+	assert(is_untouched(stacks[1], sizeof(stacks[1])));
+	assert(0	== cothreadj_sched_run(&sched));
+	assert(4	== ctr);
+	for (size_t i = 0; i < 2; i++) {
+		assert(COTHREADJ_FLAG_COMPLETED	== cothreads[i].flags);
+		cothreadj_uninit(&cothreads[i]);
+	}
+}
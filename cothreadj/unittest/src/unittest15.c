@@ -0,0 +1,93 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_arena.h>
+#include <cothread/cothreadj_sched.h>
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 8 * 1024)
+#define NB_COTHREADS	4
+/// @endcond
+
+/// @cond
+static const cothreadj_t*	order_g[2 * NB_COTHREADS];	// the cothreads, in the order their callees run.
+static size_t				nb_order_g;					// the number of recorded runs.
+/// @endcond
+
+/**
+ * @brief		The callee entry point, which records its runs (two if scheduled, one otherwise.)
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	order_g[nb_order_g++]	= cothread;
+	if (NULL != cothread->sched) {
+		cothreadj_sched_yield(cothread);
+		order_g[nb_order_g++]	= cothread;
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest15(void)
+{
+	//---Definitions---//
+	static cothreadj_stack_t	region[NB_COTHREADS][STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothreads[NB_COTHREADS];
+	cothreadj_arena_t			arena;
+
+	//---Carve the stacks out of a single region---//
+	cothreadj_attr_init(&attr, region[0], sizeof(region[0]), user_cb);
+	assert(cothread_err_ok	== cothreadj_init_many(cothreads, NB_COTHREADS, &attr, NULL));
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert(region[i]			== cothreads[i].stack);
+		assert(sizeof(region[i])	== cothreads[i].stack_sz);
+		assert(COTHREADJ_FLAG_LAZY	== cothreads[i].flags);
+		assert(NULL					== cothreads[i].sched);
+	}
+
+	//---Each cothread runs on its own stack---//
+	nb_order_g	= 0;
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert((int)i + 1		== cothreadj_yield(&cothreads[i], (int)i + 1));
+		assert(i + 1			== nb_order_g);
+		assert(&cothreads[i]	== order_g[i]);
+		cothreadj_uninit(&cothreads[i]);
+	}
+
+	//---Carve the stacks out of an arena, then schedule the cothreads---//
+	cothreadj_sched_t	sched;
+	cothreadj_sched_init(&sched);
+	cothreadj_arena_init(&arena, STACK_SZ, 0);
+	assert(cothread_err_ok	== cothreadj_init_many(cothreads, NB_COTHREADS, &attr, &arena));
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert(arena.stack_sz	== cothreads[i].stack_sz);
+		assert((0 == i) || (cothreads[i - 1].stack != cothreads[i].stack));
+		cothreadj_sched_spawn(&sched, &cothreads[i]);
+	}
+	nb_order_g	= 0;
+	assert(0					== cothreadj_sched_run(&sched));
+	assert(2 * NB_COTHREADS		== nb_order_g);
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert(&cothreads[i]	== order_g[i]);
+		assert(&cothreads[i]	== order_g[NB_COTHREADS + i]);
+	}
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert(COTHREADJ_FLAG_COMPLETED	== cothreads[i].flags);
+		cothreadj_uninit(&cothreads[i]);
+		cothreadj_arena_free(&arena, cothreads[i].stack);
+	}
+	cothreadj_arena_uninit(&arena);
+}
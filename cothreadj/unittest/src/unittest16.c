@@ -0,0 +1,133 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/atomic.h>
+#include <cothread/cothreadj_sched.h>
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 8 * 1024)
+#define NB_COTHREADS	8
+/// @endcond
+
+/// @cond
+static cothreadj_sched_t	sched_g;						// the scheduler.
+static cothreadj_t			cothreads_g[NB_COTHREADS];		// the cothreads, parked twice each.
+static const cothreadj_t*	order_g[3 * NB_COTHREADS];		// the cothreads, in the order their callees run.
+static size_t				nb_order_g;						// the number of recorded runs.
+static volatile long		wait_sleeping_g;				// says whether the waker waits for the owner to block or not.
+/// @endcond
+
+/**
+ * @brief		The callee entry point, which parks twice.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	for (size_t i = 0; i < 2; i++) {
+		order_g[nb_order_g++]	= cothread;
+		cothreadj_sched_park(cothread);
+	}
+	order_g[nb_order_g++]	= cothread;
+	return user_val;
+}
+
+/**
+ * @brief		Wakes up every cothread from another OS thread, in the reverse order.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+waker(void)
+{
+	//---Wait for the owner to block if asked to---//
+	if (0 != COTHREAD_ATOMIC_LOAD(&wait_sleeping_g)) {
+		while (0 == COTHREAD_ATOMIC_LOAD(&(sched_g.sleeping))) {
+			COTHREAD_CPU_RELAX();
+		}
+	}
+
+	//---Wake up the cothreads in a burst---//
+	for (size_t i = NB_COTHREADS; 0 != i--; ) {
+		cothreadj_sched_wake_remote(&cothreads_g[i]);
+	}
+}
+
+#if		(COTHREAD_OS_ID_WINDOWS == COTHREAD_OS_ID)
+/// @cond
+static DWORD WINAPI	waker_main(LPVOID arg)	{ (void)arg; waker(); return 0; }
+typedef HANDLE		waker_t;
+#define waker_start(_thread)	assert(NULL != ((_thread)[0] = CreateThread(NULL, 0, waker_main, NULL, 0, NULL)))
+#define waker_join(_thread)		{ WaitForSingleObject((_thread)[0], INFINITE); CloseHandle((_thread)[0]); }
+/// @endcond
+#else
+/// @cond
+static void*		waker_main(void* arg)	{ (void)arg; waker(); return NULL; }
+typedef pthread_t	waker_t;
+#define waker_start(_thread)	assert(0 == pthread_create((_thread), NULL, waker_main, NULL))
+#define waker_join(_thread)		assert(0 == pthread_join((_thread)[0], NULL))
+/// @endcond
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest16(void)
+{
+	//---Definitions---//
+	static cothreadj_stack_t	stacks[NB_COTHREADS][STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	waker_t						thread;
+
+	//---Park every cothread---//
+	cothreadj_sched_init(&sched_g);
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		cothreadj_attr_init(&attr, stacks[i], sizeof(stacks[i]), user_cb);
+		cothreadj_init(&cothreads_g[i], &attr);
+		cothreadj_sched_spawn(&sched_g, &cothreads_g[i]);
+	}
+	assert(NB_COTHREADS	== cothreadj_sched_run(&sched_g));
+	assert(NB_COTHREADS	== nb_order_g);
+
+	//---A burst of wakes while the owner is busy rings nothing, the inbox is drained at once, in the waking order---//
+	wait_sleeping_g	= 0;
+	waker_start(&thread);
+	waker_join(&thread);
+	assert(0				== sched_g.nb_rings);
+	assert(cothread_err_ok	== cothreadj_sched_wait(&sched_g));
+	assert(NB_COTHREADS		== cothreadj_sched_run(&sched_g));
+	assert(2 * NB_COTHREADS	== nb_order_g);
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		assert(&cothreads_g[NB_COTHREADS - 1 - i]	== order_g[NB_COTHREADS + i]);
+	}
+
+	//---A burst of wakes while the owner is blocked rings it up (once, unless it drains the inbox in between)---//
+	wait_sleeping_g	= 1;
+	waker_start(&thread);
+	while (0 != cothreadj_sched_run(&sched_g)) {
+		assert(cothread_err_ok	== cothreadj_sched_wait(&sched_g));
+	}
+	waker_join(&thread);
+	assert(3 * NB_COTHREADS	== nb_order_g);
+	assert(1				<= sched_g.nb_rings);
+	assert(NB_COTHREADS		>= sched_g.nb_rings);
+
+	//---Release---//
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		cothreadj_uninit(&cothreads_g[i]);
+	}
+	cothreadj_sched_uninit(&sched_g);
+}
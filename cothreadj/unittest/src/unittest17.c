@@ -0,0 +1,204 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_group.h>
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 8 * 1024)
+#define NB_CHILDREN		4
+#define CANCELLED_RET	(-2)	// the value a cancelled child returns.
+/// @endcond
+
+/// @cond
+typedef struct
+{
+	int	nb_yields;	// the number of times the child yields before returning.
+	int	ret;		// the value the child returns unless cancelled.
+} job_t;
+/// @endcond
+
+/// @cond
+static cothreadj_stack_t	stacks_g[NB_CHILDREN][STACK_SZ / sizeof(cothreadj_stack_t)];	// the children stacks.
+static cothreadj_t			children_g[NB_CHILDREN];										// the children.
+static job_t				jobs_g[NB_CHILDREN];											// the children jobs.
+static cothreadj_sched_t	sched_g;														// the scheduler.
+/// @endcond
+
+/**
+ * @brief		The child entry point, which yields until its job is done or it is cancelled.
+ * @param		[in]	cothread	The cothread, whose user data is its job.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+child_cb(cothreadj_t* cothread, int user_val)
+{
+	const job_t*	job	= (const job_t*)cothreadj_get_user_data(cothread);
+	(void)user_val;
+	for (int i = 0; i < job->nb_yields; i++) {
+		if (cothreadj_group_is_cancelled(cothread)) {
+			return CANCELLED_RET;
+		}
+		cothreadj_sched_yield(cothread);
+	}
+	return job->ret;
+}
+
+/**
+ * @brief		The child entry point, which parks until woken up or cancelled, unless its job fails at once.
+ * @param		[in]	cothread	The cothread, whose user data is its job.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+park_cb(cothreadj_t* cothread, int user_val)
+{
+	const job_t*	job	= (const job_t*)cothreadj_get_user_data(cothread);
+	(void)user_val;
+	if (0 > job->ret) {
+		return job->ret;
+	}
+	return cothreadj_group_park(cothread) ? CANCELLED_RET : job->ret;
+}
+
+/**
+ * @brief		Spawns the children in the specified group, each one yielding @e i + 1 times.
+ * @param		[in]	group		The initialized group.
+ * @param		[in]	failed		The index of the child returning a negative value, NB_CHILDREN if none.
+ * @param		[in]	user_cb		The children entry point.
+ */
+static void
+spawn_children(cothreadj_group_t* group, size_t failed, cothreadj_cb_t user_cb)
+{
+	cothreadj_attr_t	attr;
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		jobs_g[i].nb_yields	= (failed == i) ? 0 : (int)(i + 1);
+		jobs_g[i].ret		= (failed == i) ? -1 : (int)(i + 1);
+		cothreadj_attr_init(&attr, stacks_g[i], sizeof(stacks_g[i]), user_cb);
+		cothreadj_init(&children_g[i], &attr);
+		cothreadj_set_user_data(&children_g[i], &jobs_g[i]);
+		cothreadj_group_spawn(group, &children_g[i]);
+	}
+}
+
+/**
+ * @brief		The parent entry point, which fans out to the children & joins them in turn.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+parent_cb(cothreadj_t* cothread, int user_val)
+{
+	cothreadj_group_t	group;
+
+	//---Join all: every child returns its value---//
+	cothreadj_group_init(&group, &sched_g);
+	spawn_children(&group, NB_CHILDREN, child_cb);
+	assert(NULL			== cothreadj_group_join_all(&group, cothread));
+	assert(0			== group.nb_alive);
+	assert(children_g	== group.first_done);
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		assert((int)(i + 1)	== cothreadj_group_get_ret(&children_g[i]));
+		assert(!cothreadj_group_is_cancelled(&children_g[i]));
+		cothreadj_uninit(&children_g[i]);
+	}
+
+	//---Join all: the first failure cancels the siblings, which are still waited for---//
+	cothreadj_group_init(&group, &sched_g);
+	spawn_children(&group, 1, child_cb);
+	assert(&children_g[1]	== cothreadj_group_join_all(&group, cothread));
+	assert(0				== group.nb_alive);
+	assert(1				== children_g[0].group_ret);
+	assert(-1				== children_g[1].group_ret);
+	for (size_t i = 2; i < NB_CHILDREN; i++) {
+		assert(CANCELLED_RET	== cothreadj_group_get_ret(&children_g[i]));
+		assert(cothreadj_group_is_cancelled(&children_g[i]));
+	}
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		cothreadj_uninit(&children_g[i]);
+	}
+
+	//---Join any: the quickest child wins, the others are cancelled then joined---//
+	cothreadj_group_init(&group, &sched_g);
+	spawn_children(&group, NB_CHILDREN, child_cb);
+	assert(children_g		== cothreadj_group_join_any(&group, cothread));
+	assert(1				== cothreadj_group_get_ret(&children_g[0]));
+	assert(NB_CHILDREN - 1	== group.nb_alive);
+	assert(NULL				== cothreadj_group_join_all(&group, cothread));
+	assert(2				== cothreadj_group_get_ret(&children_g[1]));	// done before seeing the cancellation.
+	for (size_t i = 2; i < NB_CHILDREN; i++) {
+		assert(CANCELLED_RET	== cothreadj_group_get_ret(&children_g[i]));
+	}
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		cothreadj_uninit(&children_g[i]);
+	}
+
+	//---A child spawned in a cancelled group is cancelled at once---//
+	cothreadj_group_init(&group, &sched_g);
+	cothreadj_group_cancel(&group);
+	spawn_children(&group, NB_CHILDREN, child_cb);
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		assert(cothreadj_group_is_cancelled(&children_g[i]));
+	}
+	assert(NULL	== cothreadj_group_join_all(&group, cothread));
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		assert(CANCELLED_RET	== cothreadj_group_get_ret(&children_g[i]));
+		cothreadj_uninit(&children_g[i]);
+	}
+
+	//---The cancellation wakes the children parked in cothreadj_group_park up---//
+	cothreadj_group_init(&group, &sched_g);
+	spawn_children(&group, 1, park_cb);
+	assert(&children_g[1]	== cothreadj_group_join_all(&group, cothread));
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		assert(((1 == i) ? -1 : CANCELLED_RET)	== cothreadj_group_get_ret(&children_g[i]));
+		cothreadj_uninit(&children_g[i]);
+	}
+
+	//---A parked child is woken up once, however many times it is told to---//
+	cothreadj_group_init(&group, &sched_g);
+	spawn_children(&group, NB_CHILDREN, park_cb);
+	cothreadj_sched_yield(cothread);	// the children park.
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		cothreadj_group_wake(&children_g[i]);
+		cothreadj_group_wake(&children_g[i]);
+	}
+	assert(NULL	== cothreadj_group_join_all(&group, cothread));
+	for (size_t i = 0; i < NB_CHILDREN; i++) {
+		assert((int)(i + 1)	== cothreadj_group_get_ret(&children_g[i]));
+		cothreadj_group_wake(&children_g[i]);
+		cothreadj_uninit(&children_g[i]);
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest17(void)
+{
+	//---Definitions---//
+	static cothreadj_stack_t	stack[STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					parent;
+
+	//---Run the parent---//
+	cothreadj_sched_init(&sched_g);
+	cothreadj_attr_init(&attr, stack, sizeof(stack), parent_cb);
+	cothreadj_init(&parent, &attr);
+	cothreadj_sched_spawn(&sched_g, &parent);
+	assert(0	== cothreadj_sched_run(&sched_g));
+
+	//---Release---//
+	cothreadj_uninit(&parent);
+	cothreadj_sched_uninit(&sched_g);
+}
@@ -0,0 +1,141 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/atomic.h>
+#include <cothread/cothreadj_parallel.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 8 * 1024)
+#define NB_WORKERS		3
+#define NB_ITEMS		100000
+/// @endcond
+
+/// @cond
+static cothreadj_pool_t		pool_g;				// the pool.
+static unsigned char		visits_g[NB_ITEMS];	// the number of times each index is visited.
+static volatile long		nb_chunks_g;		// the number of chunks run.
+/// @endcond
+
+/**
+ * @brief		The parallel-for body, which visits each index of the chunk and yields halfway.
+ * @param		[in]	cothread	The worker cothread.
+ * @param		[in]	begin		The first index of the chunk.
+ * @param		[in]	end			The index following the last one of the chunk.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+for_cb(cothreadj_t* cothread, size_t begin, size_t end, void* user_data)
+{
+	assert(NULL	== user_data);
+	assert(begin	< end);
+	for (size_t i = begin; i < end; i++) {
+		visits_g[i]++;
+		if (((end - begin) / 2) == (i - begin)) {
+			cothreadj_sched_yield(cothread);
+		}
+	}
+	COTHREAD_ATOMIC_FETCH_ADD(&nb_chunks_g, 1);
+}
+
+/**
+ * @brief		The parallel-reduce body, which sums the indexes of the chunk.
+ * @param		[in]	cothread	The worker cothread.
+ * @param		[in]	begin		The first index of the chunk.
+ * @param		[in]	end			The index following the last one of the chunk.
+ * @param		[in]	acc			The partial sum of the worker.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+map_cb(cothreadj_t* cothread, size_t begin, size_t end, void* acc, void* user_data)
+{
+	(void)cothread;
+	(void)user_data;
+	for (size_t i = begin; i < end; i++) {
+		*(uint64_t*)acc	+= i;
+	}
+}
+
+/**
+ * @brief		The parallel-reduce combiner, which adds the partial sums.
+ * @param		[in]	acc			The partial sum to add to.
+ * @param		[in]	other		The partial sum to add.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+reduce_cb(void* acc, const void* other, void* user_data)
+{
+	(void)user_data;
+	*(uint64_t*)acc	+= *(const uint64_t*)other;
+}
+
+/**
+ * @brief		The callee entry point, which runs the loops.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	uint64_t	accs[NB_WORKERS];
+
+	//---Each index is visited once, the chunks shrinking toward the grain---//
+	cothreadj_parallel_for(&pool_g, cothread, 0, NB_ITEMS, 16, for_cb, NULL);
+	for (size_t i = 0; i < NB_ITEMS; i++) {
+		assert(1	== visits_g[i]);
+	}
+	assert(NB_ITEMS / 16	> nb_chunks_g);
+	assert(NB_WORKERS		<= nb_chunks_g);
+
+	//---A range no larger than the grain is run inline---//
+	nb_chunks_g	= 0;
+	cothreadj_parallel_for(&pool_g, cothread, 10, 20, 10, for_cb, NULL);
+	assert(1	== nb_chunks_g);
+	assert(2	== visits_g[10]);
+	assert(1	== visits_g[20]);
+
+	//---The partial sums are combined into the first one---//
+	memset(accs, 0, sizeof(accs));
+	cothreadj_parallel_reduce(&pool_g, cothread, 0, NB_ITEMS, 0, map_cb, reduce_cb, accs, sizeof(accs[0]), NULL);
+	assert(((uint64_t)NB_ITEMS * (NB_ITEMS - 1) / 2)	== accs[0]);
+	return user_val;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest18(void)
+{
+	//---Definitions---//
+	static cothreadj_stack_t	stack[STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_sched_t			sched;
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothread;
+
+	//---Run the loops from a cothread, the OS thread blocking on the scheduler doorbell in between---//
+	assert(cothread_err_ok	== cothreadj_pool_init(&pool_g, NB_WORKERS, STACK_SZ));
+	assert(NB_WORKERS		== pool_g.nb_workers);
+	cothreadj_sched_init(&sched);
+	cothreadj_attr_init(&attr, stack, sizeof(stack), user_cb);
+	cothreadj_init(&cothread, &attr);
+	cothreadj_sched_spawn(&sched, &cothread);
+	while (0 != cothreadj_sched_run(&sched)) {
+		assert(cothread_err_ok	== cothreadj_sched_wait(&sched));
+	}
+
+	//---Release---//
+	cothreadj_uninit(&cothread);
+	cothreadj_sched_uninit(&sched);
+	cothreadj_pool_uninit(&pool_g);
+	assert(NULL	== pool_g.workers);
+}
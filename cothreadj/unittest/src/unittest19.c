@@ -0,0 +1,110 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 16 * 1024)
+#define NB_EVENTS	16
+/// @endcond
+
+/// @cond
+typedef struct
+{
+	char			events[NB_EVENTS];	// the hooks called, in order ('R'/'S' for the global ones, 'r'/'s' for the local ones.)
+	size_t			nb_events;			// the number of hooks called.
+	cothreadj_t*	cothread;			// the cothread the hooks are expected to be called with.
+} log_t;
+/// @endcond
+
+#if COTHREAD_WITH_HOOKS
+/**
+ * @brief		Logs the specified event.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	hook_log	The log.
+ * @param		[in]	event		The event.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+log_event(void* cothread, log_t* hook_log, char event)
+{
+	assert(hook_log->cothread	== cothread);
+	assert(hook_log->nb_events	< NB_EVENTS);
+	hook_log->events[hook_log->nb_events++]	= event;
+}
+
+/// @cond
+static void COTHREAD_CALL global_resume_cb	(void* cothread, void* user_data)	{ log_event(cothread, (log_t*)user_data, 'R'); }
+static void COTHREAD_CALL global_suspend_cb	(void* cothread, void* user_data)	{ log_event(cothread, (log_t*)user_data, 'S'); }
+static void COTHREAD_CALL local_resume_cb	(void* cothread, void* user_data)	{ log_event(cothread, (log_t*)user_data, 'r'); }
+static void COTHREAD_CALL local_suspend_cb	(void* cothread, void* user_data)	{ log_event(cothread, (log_t*)user_data, 's'); }
+/// @endcond
+#endif
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	return cothreadj_yield(cothread, user_val + 1) + 1;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest19(void)
+{
+	//---Initialize the cothread---//
+	static cothreadj_stack_t	stack[STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothread;
+	log_t						hook_log;
+	cothreadj_attr_init(&attr, stack, sizeof(stack), user_cb);
+	cothreadj_init(&cothread, &attr);
+	hook_log.nb_events	= 0;
+	hook_log.cothread	= &cothread;
+
+#if !COTHREAD_WITH_HOOKS
+	//---The hooks are not available---//
+	static const cothread_hooks_t	hooks	= { NULL, NULL, NULL };
+	assert(cothread_err_notsup	== cothreadj_set_global_hooks(&hooks));
+	assert(cothread_err_notsup	== cothreadj_set_hooks(&cothread, &hooks));
+	assert(2	== cothreadj_yield(&cothread, 1));
+	assert(4	== cothreadj_yield(&cothread, 3));
+	assert(0	== hook_log.nb_events);
+#else
+	//---The global hooks wrap the local ones, on each resume, pause & completion---//
+	const cothread_hooks_t	global_hooks	= { global_resume_cb, global_suspend_cb, &hook_log };
+	const cothread_hooks_t	local_hooks		= { local_resume_cb, local_suspend_cb, &hook_log };
+	assert(cothread_err_ok	== cothreadj_set_global_hooks(&global_hooks));
+	assert(cothread_err_ok	== cothreadj_set_hooks(&cothread, &local_hooks));
+	assert(2	== cothreadj_yield(&cothread, 1));
+	assert(4	== cothreadj_yield(&cothread, 3));
+	assert(8	== hook_log.nb_events);
+	assert(0	== memcmp("RrsSRrsS", hook_log.events, 8));
+
+	//---The hooks may be removed, & a missing callback is skipped---//
+	const cothread_hooks_t	resume_hooks	= { local_resume_cb, NULL, &hook_log };
+	cothreadj_uninit(&cothread);
+	cothreadj_init(&cothread, &attr);
+	assert(cothread_err_ok	== cothreadj_set_global_hooks(NULL));
+	assert(cothread_err_ok	== cothreadj_set_hooks(&cothread, &resume_hooks));
+	hook_log.nb_events	= 0;
+	assert(2	== cothreadj_yield(&cothread, 1));
+	assert(cothread_err_ok	== cothreadj_set_hooks(&cothread, NULL));
+	assert(4	== cothreadj_yield(&cothread, 3));
+	assert(1	== hook_log.nb_events);
+	assert('r'	== hook_log.events[0]);
+#endif
+	cothreadj_uninit(&cothread);
+}
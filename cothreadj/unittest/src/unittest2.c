@@ -0,0 +1,261 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_sync.h>
+#include <string.h>
+
+/// @cond
+#define NB_COTHREADS	4
+#define STACK_SZ		(64 * 1024)
+
+static cothreadj_stack_t	stacks_g[NB_COTHREADS][STACK_SZ / sizeof(cothreadj_stack_t)];
+static cothreadj_t			cothreads_g[NB_COTHREADS];
+static cothreadj_sched_t	sched_g;
+static cothreadj_mutex_t	mtx_g;
+static cothreadj_cond_t		cond_g;
+static cothreadj_sem_t		sem_g;
+static cothreadj_rwlock_t	rwlock_g;
+static char					log_g[64];
+static size_t				log_len_g;
+static int					flag_g;
+/// @endcond
+
+/**
+ * @brief		Appends the specified character to the log.
+ * @param		[in]	c	The character to append.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+log_append(char c)
+{
+	assert((log_len_g + 1)	< sizeof(log_g));
+	log_g[log_len_g++]	= c;
+	log_g[log_len_g]	= '\0';
+}
+
+/**
+ * @brief		Spawns the specified number of cothreads, runs the scheduler and checks the log.
+ * @param		[in]	nb			The number of cothreads to spawn.
+ * @param		[in]	user_cb		The callee entry point.
+ * @param		[in]	expected	The expected log.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+run(size_t nb, cothreadj_cb_t user_cb, const char* expected)
+{
+	//---Initialize the scheduler & the cothreads---//
+	cothreadj_sched_init(&sched_g);
+	log_len_g	= 0;
+	log_g[0]	= '\0';
+	for (size_t i = 0; i < nb; i++) {
+		cothreadj_attr_t	attr;
+		cothreadj_attr_init(&attr, stacks_g[i], sizeof(stacks_g[i]), user_cb);
+		cothreadj_init(&(cothreads_g[i]), &attr);
+		cothreadj_set_user_data(&(cothreads_g[i]), (void*)(cothreads_g + i));
+		cothreadj_sched_spawn(&sched_g, &(cothreads_g[i]));
+	}
+
+	//---Run & check---//
+	assert(0	== cothreadj_sched_run(&sched_g));
+	assert(NULL	== sched_g.current);
+	assert(0	== strcmp(expected, log_g));
+	for (size_t i = 0; i < nb; i++) {
+		assert(COTHREADJ_FLAG_COMPLETED	== (COTHREADJ_FLAG_COMPLETED & cothreads_g[i].flags));
+	}
+}
+
+/**
+ * @brief		The callee entry point checking the mutex.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+mutex_cb(cothreadj_t* cothread, int user_val)
+{
+	//---Check arguments---//
+	const char	id	= (char)('a' + (cothread - cothreads_g));
+	assert(COTHREADJ_SCHED_VAL	== user_val);
+
+	//---Lock, yield while owning the mutex, unlock---//
+	cothreadj_mutex_lock(&mtx_g, cothread);
+	assert(cothread	== mtx_g.owner);
+	log_append(id);
+	cothreadj_sched_yield(cothread);
+	assert(0	== cothreadj_mutex_trylock(&mtx_g, &(cothreads_g[NB_COTHREADS - 1])));
+	log_append((char)(id - 'a' + 'A'));
+	cothreadj_mutex_unlock(&mtx_g, cothread);
+
+	//---The mutex is handed over to the next waiter---//
+	if ('c' != id) {
+		assert(&(cothreads_g[cothread - cothreads_g + 1])	== mtx_g.owner);
+	} else {
+		assert(NULL	== mtx_g.owner);
+	}
+	return 1;
+}
+
+/**
+ * @brief		The callee entry point checking the condition variable.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+cond_cb(cothreadj_t* cothread, int user_val)
+{
+	//---Definitions---//
+	const char	id	= (char)('a' + (cothread - cothreads_g));
+
+	//---Is it the broadcaster ?---//
+	cothreadj_mutex_lock(&mtx_g, cothread);
+	if ('d' == id) {
+		//---Wake the waiters up---//
+		log_append(id);
+		flag_g	= !0;
+		cothreadj_cond_broadcast(&cond_g);
+
+		//---All the waiters wait for the mutex, none of them is ready---//
+		assert(NULL	== cond_g.waiters.head);
+		assert(NULL	== sched_g.ready.head);
+		assert(&(cothreads_g[0])	== mtx_g.waiters.head);
+	} else {
+		//---Wait for the flag---//
+		while (0 == flag_g) {
+			log_append(id);
+			cothreadj_cond_wait(&cond_g, &mtx_g, cothread);
+		}
+		log_append((char)(id - 'a' + 'A'));
+	}
+	cothreadj_mutex_unlock(&mtx_g, cothread);
+	return 1;
+}
+
+/**
+ * @brief		The callee entry point checking the semaphore.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+sem_cb(cothreadj_t* cothread, int user_val)
+{
+	//---Definitions---//
+	const char	id	= (char)('a' + (cothread - cothreads_g));
+
+	//---Take a unit, yield, give it back---//
+	cothreadj_sem_wait(&sem_g, cothread);
+	log_append(id);
+	cothreadj_sched_yield(cothread);
+	log_append((char)(id - 'a' + 'A'));
+	cothreadj_sem_post(&sem_g);
+	return 1;
+}
+
+/**
+ * @brief		The callee entry point checking the readers-writer lock.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+rwlock_cb(cothreadj_t* cothread, int user_val)
+{
+	//---Definitions---//
+	const char	id	= (char)('a' + (cothread - cothreads_g));
+
+	//---The 2nd cothread is a writer, the others are readers---//
+	if ('b' == id) {
+		cothreadj_rwlock_wrlock(&rwlock_g, cothread);
+		assert(0	== rwlock_g.nb_readers);
+	} else {
+		cothreadj_rwlock_rdlock(&rwlock_g, cothread);
+		assert(NULL	== rwlock_g.writer);
+	}
+	log_append(id);
+	cothreadj_sched_yield(cothread);
+	log_append((char)(id - 'a' + 'A'));
+	cothreadj_rwlock_unlock(&rwlock_g, cothread);
+
+	//---The writer hands the lock over to the whole batch of readers---//
+	if ('b' == id) {
+		assert(2	== rwlock_g.nb_readers);
+	}
+	return 1;
+}
+
+/**
+ * @brief		The callee entry point checking the parking.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+park_cb(cothreadj_t* cothread, int user_val)
+{
+	cothreadj_sched_park(cothread);
+	return 1;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest2(void)
+{
+	//---Check the queue---//
+	cothreadj_queue_t	queue;
+	cothreadj_queue_init(&queue);
+	assert(NULL	== cothreadj_queue_pop(&queue));
+	cothreads_g[0].next	= NULL;
+	cothreads_g[1].next	= NULL;
+	cothreadj_queue_push(&queue, &(cothreads_g[0]));
+	cothreadj_queue_push(&queue, &(cothreads_g[1]));
+	assert(&(cothreads_g[0])	== cothreadj_queue_pop(&queue));
+	assert(&(cothreads_g[1])	== cothreadj_queue_pop(&queue));
+	assert(NULL					== cothreadj_queue_pop(&queue));
+	assert(NULL					== queue.tail);
+
+	//---Check the mutex---//
+	cothreadj_mutex_init(&mtx_g);
+	run(3, mutex_cb, "aAbBcC");
+	assert(NULL	== mtx_g.owner);
+
+	//---Check the condition variable---//
+	cothreadj_mutex_init(&mtx_g);
+	cothreadj_cond_init(&cond_g);
+	flag_g	= 0;
+	run(4, cond_cb, "abcdABC");
+	assert(NULL	== cond_g.mtx);
+
+	//---Check the semaphore---//
+	cothreadj_sem_init(&sem_g, 2);
+	assert(0	!= cothreadj_sem_trywait(&sem_g));
+	cothreadj_sem_post(&sem_g);
+	run(4, sem_cb, "abABcdCD");
+	assert(2	== sem_g.count);
+
+	//---Check the readers-writer lock---//
+	cothreadj_rwlock_init(&rwlock_g);
+	run(4, rwlock_cb, "aAbBcdCD");
+	assert(0	== rwlock_g.nb_readers);
+
+	//---Check the parking: the scheduler returns the parked cothreads---//
+	cothreadj_sched_init(&sched_g);
+	cothreadj_attr_t	attr;
+	cothreadj_attr_init(&attr, stacks_g[0], sizeof(stacks_g[0]), park_cb);
+	cothreadj_init(&(cothreads_g[0]), &attr);
+	cothreadj_sched_spawn(&sched_g, &(cothreads_g[0]));
+	assert(1	== cothreadj_sched_run(&sched_g));
+	cothreadj_sched_wake(&(cothreads_g[0]));
+	assert(0	== cothreadj_sched_run(&sched_g));
+}
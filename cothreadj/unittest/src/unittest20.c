@@ -0,0 +1,115 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_watchdog.h>
+#include <cothread/ticks.h>
+#include <string.h>
+
+#if COTHREAD_WITH_WATCHDOG
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 16 * 1024)
+#define THRESHOLD_US	20000	// the time a callee may run without yielding.
+#define RUN_NS			(10 * THRESHOLD_US * 1000)	// the time each callee runs for.
+/// @endcond
+
+/**
+ * @brief		Spins for the specified time.
+ * @param		[in]	ns	The time to spin for, in nanoseconds.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+spin(uint64_t ns)
+{
+	const uint64_t	deadline	= cothread_ticks_ns() + ns;
+	while (cothread_ticks_ns() < deadline);
+}
+
+/**
+ * @brief		The entry point of the callee which never yields.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+hog_cb(cothreadj_t* cothread, int user_val)
+{
+	(void)cothread;
+	spin(RUN_NS);
+	return user_val;
+}
+
+/**
+ * @brief		The entry point of the callee which yields often.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+polite_cb(cothreadj_t* cothread, int user_val)
+{
+	const uint64_t	deadline	= cothread_ticks_ns() + RUN_NS;
+	while (cothread_ticks_ns() < deadline) {
+		spin(THRESHOLD_US * 100);
+		user_val	= cothreadj_yield(cothread, user_val);
+	}
+	return -user_val;
+}
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest20(void)
+{
+#if !COTHREAD_WITH_WATCHDOG
+	//---The watchdog is not available---//
+	assert(cothread_err_notsup	== cothreadj_watchdog_start(1000, stdout));
+#else
+	//---Initialize the cothreads---//
+	static cothreadj_stack_t	stacks[2][STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					hog;
+	cothreadj_t					polite;
+	cothreadj_attr_init(&attr, stacks[0], sizeof(stacks[0]), hog_cb);
+	cothreadj_attr_set_dbg_callee_name(&attr, "hog");
+	cothreadj_init(&hog, &attr);
+	cothreadj_attr_init(&attr, stacks[1], sizeof(stacks[1]), polite_cb);
+	cothreadj_attr_set_dbg_callee_name(&attr, "polite");
+	cothreadj_init(&polite, &attr);
+
+	//---Run the callees, then spin in the caller, while watched---//
+	FILE*	strm	= tmpfile();
+	assert(NULL				!= strm);
+	assert(cothread_err_ok	== cothreadj_watchdog_start(THRESHOLD_US, strm));
+	while (0 < cothreadj_yield(&polite, 1));
+	assert(1	== cothreadj_yield(&hog, 1));
+	spin(RUN_NS);
+	cothreadj_watchdog_stop();
+	cothreadj_uninit(&hog);
+	cothreadj_uninit(&polite);
+
+	//---Only the callee which never yields is reported, once, with its backtrace---//
+	char	line[512];
+	size_t	nb_reports	= 0;
+	size_t	nb_frames	= 0;
+	rewind(strm);
+	while (NULL != fgets(line, sizeof(line), strm)) {
+		if (NULL != strstr(line, "without yielding")) {
+			assert(NULL	!= strstr(line, " hog "));
+			nb_reports++;
+		} else if ('#' == line[1]) {
+			nb_frames++;
+		}
+	}
+	fclose(strm);
+	assert(1	== nb_reports);
+	assert(0	!= nb_frames);
+#endif
+}
@@ -0,0 +1,129 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_preempt.h>
+#include <cothread/ticks.h>
+
+#if COTHREAD_WITH_PREEMPT
+#include <time.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 16 * 1024)
+#define SLICE_US	2000	// the time a callee may run before it is expired.
+#define RUN_NS		(100 * SLICE_US * 1000)	// the time the spinning callee runs for.
+
+static volatile int	done_g;			// says whether the spinning callee has returned or not.
+static size_t		nb_preempts_g;	// the number of times the spinning callee has been preempted.
+static uint64_t		max_gap_ns_g;	// the longest time the probing callee has waited for.
+static size_t		nb_sleeps_g;	// the number of times the sleeping callee has been preempted.
+/// @endcond
+
+/**
+ * @brief		The entry point of the callee which spins, only calling the checkpoints.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+spin_cb(cothreadj_t* cothread, int user_val)
+{
+	const uint64_t	deadline	= cothread_ticks_ns() + RUN_NS;
+	while (cothread_ticks_ns() < deadline) {
+		nb_preempts_g	+= (size_t)cothreadj_checkpoint(cothread);
+	}
+	done_g	= 1;
+	return user_val;
+}
+
+/**
+ * @brief		The entry point of the callee which measures how long it waits to be resumed.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+probe_cb(cothreadj_t* cothread, int user_val)
+{
+	while (0 == done_g) {
+		const uint64_t	ns	= cothread_ticks_ns();
+		cothreadj_sched_yield(cothread);
+		const uint64_t	gap_ns	= cothread_ticks_ns() - ns;
+		if (max_gap_ns_g < gap_ns) {
+			max_gap_ns_g	= gap_ns;
+		}
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The entry point of the callee which blocks for many slices, then calls a checkpoint.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+sleep_cb(cothreadj_t* cothread, int user_val)
+{
+	struct timespec	ts;
+	ts.tv_sec	= 0;
+	ts.tv_nsec	= 10 * SLICE_US * 1000;
+	while (0 != nanosleep(&ts, &ts)) {
+	}
+	nb_sleeps_g	+= (size_t)cothreadj_checkpoint(cothread);
+	return user_val;
+}
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest21(void)
+{
+#if !COTHREAD_WITH_PREEMPT
+	//---The preemption is not available, the checkpoints never yield---//
+	assert(cothread_err_notsup	== cothreadj_preempt_start(1000));
+#else
+	//---Initialize the scheduler & the cothreads---//
+	static cothreadj_stack_t	stacks[2][STACK_SZ / sizeof(cothreadj_stack_t)];
+	cothreadj_sched_t			sched;
+	cothreadj_attr_t			attr;
+	cothreadj_t					spin;
+	cothreadj_t					probe;
+	cothreadj_t					sleeper;
+	cothreadj_sched_init(&sched);
+	cothreadj_attr_init(&attr, stacks[0], sizeof(stacks[0]), spin_cb);
+	cothreadj_init(&spin, &attr);
+	cothreadj_attr_init(&attr, stacks[1], sizeof(stacks[1]), probe_cb);
+	cothreadj_init(&probe, &attr);
+	cothreadj_attr_init(&attr, stacks[0], sizeof(stacks[0]), sleep_cb);
+
+	//---Run the spinning callee next to the probing one, while sliced---//
+	assert(cothread_err_ok	== cothreadj_preempt_start(SLICE_US));
+	cothreadj_sched_spawn(&sched, &spin);
+	cothreadj_sched_spawn(&sched, &probe);
+	assert(0	== cothreadj_sched_run(&sched));
+
+	//---A callee blocked for many slices has not run for them, it is not expired---//
+	cothreadj_uninit(&spin);
+	cothreadj_init(&sleeper, &attr);
+	cothreadj_sched_spawn(&sched, &sleeper);
+	assert(0	== cothreadj_sched_run(&sched));
+	cothreadj_preempt_stop();
+	assert(0	== nb_sleeps_g);
+
+	//---The probing callee never waited for the whole spin, but for a few slices---//
+	assert(0				< nb_preempts_g);
+	assert(max_gap_ns_g		< RUN_NS / 4);
+	cothreadj_uninit(&sleeper);
+	cothreadj_uninit(&probe);
+	cothreadj_sched_uninit(&sched);
+#endif
+}
@@ -0,0 +1,163 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_policy.h>
+#include <string.h>
+
+/// @cond
+#define STACK_SZ		(sizeof(void*) * 16 * 1024)
+#define NB_COTHREADS	4
+#define NB_NODES		1000
+
+static cothreadj_stack_t	stacks_g[NB_COTHREADS][STACK_SZ / sizeof(cothreadj_stack_t)];
+static cothreadj_t			cothreads_g[NB_COTHREADS];
+static char					log_g[64];
+static size_t				log_len_g;
+/// @endcond
+
+/**
+ * @brief		The callee entry point, which logs its identifier each time it runs, then yields as many times as told.
+ * @param		[in]	cothread	The cothread, whose user data is the number of times to yield.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	const char	id	= (char)('a' + (cothread - cothreads_g));
+	for (size_t nb_yields = (size_t)cothreadj_get_user_data(cothread); ; nb_yields--) {
+		assert(log_len_g	< sizeof(log_g) - 1);
+		log_g[log_len_g++]	= id;
+		if (0 == nb_yields) {
+			break;
+		}
+		cothreadj_sched_yield(cothread);
+	}
+	return user_val;
+}
+
+/**
+ * @brief		Sets the scheduling key of the specified cothread, as its priority level or its deadline.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	key			The key.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+typedef void (COTHREAD_CALL * set_key_t) (cothreadj_t* cothread, unsigned int key);
+
+/**
+ * @brief		Sets the priority level of the specified cothread.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	key			The priority level.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+set_prio(cothreadj_t* cothread, unsigned int key)
+{
+	cothreadj_set_prio(cothread, key);
+}
+
+/**
+ * @brief		Sets the deadline of the specified cothread.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	key			The deadline.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+set_deadline(cothreadj_t* cothread, unsigned int key)
+{
+	cothreadj_set_deadline(cothread, key);
+}
+
+/**
+ * @brief		Runs the cothreads with the specified scheduling keys and numbers of yields, under the specified policy.
+ * @param		[in]	policy		The policy, NULL for the default one.
+ * @param		[in]	set_key		The function setting the scheduling key the policy orders the cothreads by.
+ * @param		[in]	keys		The scheduling key (priority level or deadline) of each cothread.
+ * @param		[in]	nb_yields	The number of times each cothread yields.
+ * @param		[in]	expected	The expected log.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+run(cothreadj_policy_t* policy, set_key_t set_key, const unsigned int keys[NB_COTHREADS], const size_t nb_yields[NB_COTHREADS], const char* expected)
+{
+	//---Spawn the cothreads---//
+	cothreadj_sched_t	sched;
+	cothreadj_attr_t	attr;
+	cothreadj_sched_init(&sched);
+	cothreadj_sched_set_policy(&sched, policy);
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		cothreadj_attr_init(&attr, stacks_g[i], sizeof(stacks_g[i]), user_cb);
+		cothreadj_init(&(cothreads_g[i]), &attr);
+		cothreadj_set_user_data(&(cothreads_g[i]), (void*)nb_yields[i]);
+		set_key(&(cothreads_g[i]), keys[i]);
+		cothreadj_sched_spawn(&sched, &(cothreads_g[i]));
+	}
+
+	//---Run them---//
+	log_len_g	= 0;
+	assert(0	== cothreadj_sched_run(&sched));
+	log_g[log_len_g]	= '\0';
+	assert(0	== strcmp(expected, log_g));
+
+	//---Release---//
+	for (size_t i = 0; i < NB_COTHREADS; i++) {
+		cothreadj_uninit(&(cothreads_g[i]));
+	}
+	cothreadj_sched_uninit(&sched);
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest22(void)
+{
+	//---Definitions---//
+	static const unsigned int	keys[NB_COTHREADS]		= { 3, 1, 2, 1 };
+	static const size_t			nb_yields[NB_COTHREADS]	= { 1, 2, 0, 1 };
+	cothreadj_fifo_t			fifo;
+	cothreadj_prio_t			prio;
+	cothreadj_edf_t				edf;
+
+	//---The default & the FIFO orders round-robin the cothreads---//
+	run(NULL, set_prio, keys, nb_yields, "abcdabdb");
+	cothreadj_fifo_init(&fifo);
+	run(&(fifo.policy), set_prio, keys, nb_yields, "abcdabdb");
+
+	//---The strict priority order round-robins the cothreads of the highest level only---//
+	cothreadj_prio_init(&prio);
+	run(&(prio.policy), set_prio, keys, nb_yields, "bdbdbcaa");
+
+	//---The earliest deadline first order runs the earliest one until it returns, FIFO between equal ones---//
+	cothreadj_edf_init(&edf);
+	run(&(edf.policy), set_deadline, keys, nb_yields, "bdbdbcaa");
+	static const unsigned int	deadlines[NB_COTHREADS]	= { 30, 10, 20, 5 };
+	run(&(edf.policy), set_deadline, deadlines, nb_yields, "ddbbbcaa");
+
+	//---The heap pops many pseudo-random deadlines in order, equal ones in the pushing order---//
+	static cothreadj_t	nodes[NB_NODES];
+	uint64_t			seed	= 1;
+	memset(nodes, 0, sizeof(nodes));
+	cothreadj_edf_init(&edf);
+	for (size_t round = 0; round < 2; round++) {
+		for (size_t i = 0; i < NB_NODES; i++) {
+			seed	= seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			cothreadj_set_deadline(&(nodes[i]), (seed >> 33) % (NB_NODES / 4));
+			edf.policy.push(&(edf.policy), &(nodes[i]));
+		}
+		const cothreadj_t*	prev	= NULL;
+		for (size_t i = 0; i < NB_NODES; i++) {
+			const cothreadj_t*	node	= edf.policy.pop(&(edf.policy));
+			assert(NULL	!= node);
+			assert(NULL	== node->next);
+			assert((NULL == prev) || (prev->sched_key < node->sched_key) || ((prev->sched_key == node->sched_key) && (prev < node)));
+			prev	= node;
+		}
+		assert(NULL	== edf.policy.pop(&(edf.policy)));
+	}
+}
@@ -0,0 +1,162 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_mesh.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 16 * 1024)
+#define NB_CORES	3
+#define RING_SZ		4
+#define NB_MSGS		64
+#define NB_YIELDS	8
+#define NB_SPINS	1000000	// the yields after which a cothread waiting for a reply by yielding is deemed stalled.
+
+static COTHREAD_THREAD_LOCAL size_t	core_id_g	= (size_t)-1;	// the index of the core of the OS thread.
+static size_t						ctrs_g[NB_CORES];			// the messages run by each core, touched by that core only.
+static size_t						nb_yields_g[NB_CORES];		// the yields of the cothread spawned on each core.
+static cothreadj_stack_t			stacks_g[NB_CORES][STACK_SZ / sizeof(cothreadj_stack_t)];
+static cothreadj_t					cothreads_g[NB_CORES];
+static cothreadj_mesh_msg_t			msgs_g[NB_CORES][NB_CORES][NB_MSGS];	// the messages of each core, to each core.
+/// @endcond
+
+/**
+ * @brief		The spawned callee entry point, which yields a few times before returning.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+spawned_cb(cothreadj_t* cothread, int user_val)
+{
+	for (size_t i = 0; i < NB_YIELDS; i++) {
+		assert(core_id_g	== cothreadj_mesh_core_id(cothread));
+		nb_yields_g[core_id_g]++;
+		cothreadj_sched_yield(cothread);
+	}
+	return user_val;
+}
+
+/**
+ * @brief		The message callback, which counts the message on the destination core.
+ * @param		[in]	sched	The scheduler of the destination core.
+ * @param		[in]	msg		The message.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+count_cb(cothreadj_sched_t* sched, cothreadj_mesh_msg_t* msg)
+{
+	assert(core_id_g	== msg->dst);
+	ctrs_g[msg->dst]++;
+}
+
+/**
+ * @brief		The message callback, which spawns a cothread on the destination core, outliving its submitter.
+ * @param		[in]	sched	The scheduler of the destination core.
+ * @param		[in]	msg		The message.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+spawn_cb(cothreadj_sched_t* sched, cothreadj_mesh_msg_t* msg)
+{
+	cothreadj_attr_t	attr;
+	assert(core_id_g	== msg->dst);
+	cothreadj_attr_init(&attr, stacks_g[msg->dst], sizeof(stacks_g[msg->dst]), spawned_cb);
+	cothreadj_init(&(cothreads_g[msg->dst]), &attr);
+	cothreadj_sched_spawn(sched, &(cothreads_g[msg->dst]));
+}
+
+/**
+ * @brief		The main callback, which sends a burst of messages to every core (more than a ring holds), then waits for them.
+ * @param		[in]	cothread	The main cothread of the core.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+main_cb(cothreadj_t* cothread, void* user_data)
+{
+	const size_t	id	= cothreadj_mesh_core_id(cothread);
+	core_id_g	= id;
+	assert(NB_CORES		== cothreadj_mesh_get(cothread)->nb_cores);
+	assert((void*)msgs_g	== user_data);
+
+	//---Send the bursts (a message to the calling core is done right away)---//
+	for (size_t i = 0; i < NB_MSGS; i++) {
+		for (size_t dst = 0; dst < NB_CORES; dst++) {
+			cothreadj_mesh_msg_t*	msg	= &(msgs_g[id][dst][i]);
+			cothreadj_mesh_msg_init(msg, count_cb, NULL);
+			cothreadj_mesh_submit(cothread, dst, msg);
+			assert((dst != id) || cothreadj_mesh_is_done(msg));
+		}
+	}
+
+	//---Wait for them---//
+	for (size_t dst = 0; dst < NB_CORES; dst++) {
+		for (size_t i = 0; i < NB_MSGS; i++) {
+			cothreadj_mesh_wait(&(msgs_g[id][dst][i]), cothread);
+			assert(cothreadj_mesh_is_done(&(msgs_g[id][dst][i])));
+		}
+	}
+
+	//---Have the next core spawn a cothread, which keeps the run going once the main cothreads returned---//
+	cothreadj_mesh_msg_t	msg;
+	cothreadj_mesh_msg_init(&msg, spawn_cb, NULL);
+	cothreadj_mesh_submit(cothread, (id + 1) % NB_CORES, &msg);
+	cothreadj_mesh_wait(&msg, cothread);
+}
+
+/**
+ * @brief		The main callback, which waits for a message to the next core by yielding instead of parking.
+ * @param		[in]	cothread	The main cothread of the core.
+ * @param		[in]	user_data	Any user data.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+spin_cb(cothreadj_t* cothread, void* user_data)
+{
+	const size_t			id	= cothreadj_mesh_core_id(cothread);
+	cothreadj_mesh_msg_t	msg;
+	core_id_g	= id;
+	(void)user_data;
+
+	//---Every core keeps yielding, yet serves the message of the previous core & gets its own reply---//
+	cothreadj_mesh_msg_init(&msg, count_cb, NULL);
+	cothreadj_mesh_submit(cothread, (id + 1) % NB_CORES, &msg);
+	for (size_t i = 0; !cothreadj_mesh_is_done(&msg); i++) {
+		assert(NB_SPINS	> i);
+		cothreadj_sched_yield(cothread);
+	}
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest23(void)
+{
+	//---Definitions---//
+	cothreadj_mesh_t	mesh;
+	assert(cothread_err_ok	== cothreadj_mesh_init(&mesh, NB_CORES, RING_SZ - 1, STACK_SZ));
+	assert(RING_SZ			== mesh.ring_sz);
+
+	//---Every message runs on its destination core, and the run waits for the spawned cothreads (twice)---//
+	for (size_t run = 1; run <= 2; run++) {
+		assert(cothread_err_ok	== cothreadj_mesh_run(&mesh, main_cb, msgs_g));
+		for (size_t i = 0; i < NB_CORES; i++) {
+			assert((run * NB_CORES * NB_MSGS)	== ctrs_g[i]);
+			assert((run * NB_YIELDS)			== nb_yields_g[i]);
+			cothreadj_uninit(&(cothreads_g[i]));
+		}
+	}
+
+	//---A core whose cothreads keep yielding still checks its rings---//
+	assert(cothread_err_ok	== cothreadj_mesh_run(&mesh, spin_cb, NULL));
+	for (size_t i = 0; i < NB_CORES; i++) {
+		assert((2 * NB_CORES * NB_MSGS) + 1	== ctrs_g[i]);
+	}
+	cothreadj_mesh_uninit(&mesh);
+}
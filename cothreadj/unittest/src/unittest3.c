@@ -0,0 +1,91 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+
+/// @cond
+static cothreadj_fls_key_t	key0_g;
+static cothreadj_fls_key_t	key1_g;
+static size_t				dtor_ctr_g;
+/// @endcond
+
+/**
+ * @brief		The fiber-local storage destructor.
+ * @param		[in]	value	The non-NULL value stored in the slot when the callee returns.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+dtor(void* value)
+{
+	assert(NULL	!= value);
+	dtor_ctr_g	+= *(size_t*)value;
+}
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	//---The slots are empty on startup---//
+	assert(NULL	== cothreadj_fls_get(cothread, key0_g));
+	assert(NULL	== cothreadj_fls_get(cothread, key1_g));
+
+	//---Store some values---//
+	size_t*	value	= (size_t*)cothreadj_get_user_data(cothread);
+	cothreadj_fls_set(cothread, key0_g, value);
+	cothreadj_fls_set(cothread, key1_g, value + 1);
+
+	//---The values survive a switch---//
+	assert(user_val + 1	== cothreadj_yield(cothread, user_val));
+	assert(value		== cothreadj_fls_get(cothread, key0_g));
+	assert(value + 1	== cothreadj_fls_get(cothread, key1_g));
+	return user_val + 1;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest3(void)
+{
+	//---Allocate the keys---//
+	assert(cothread_err_ok	== cothreadj_fls_key_create(&key0_g, dtor));
+	assert(cothread_err_ok	== cothreadj_fls_key_create(&key1_g, NULL));
+	assert(key0_g	!= key1_g);
+	assert(key0_g	< COTHREADJ_FLS_NB_SLOTS);
+	assert(key1_g	< COTHREADJ_FLS_NB_SLOTS);
+
+	//---Initialize two cothreads---//
+	static cothreadj_stack_t	stacks[2][64 * 1024 / sizeof(cothreadj_stack_t)];
+	cothreadj_t					cothreads[2];
+	size_t						values[2][2]	= { { 1, 2 }, { 10, 20 } };
+	for (size_t i = 0; i < 2; i++) {
+		cothreadj_attr_t	attr;
+		cothreadj_attr_init(&attr, stacks[i], sizeof(stacks[i]), user_cb);
+		cothreadj_init(&(cothreads[i]), &attr);
+		cothreadj_set_user_data(&(cothreads[i]), values[i]);
+	}
+
+	//---Interleave the cothreads, each one sees its own slots---//
+	dtor_ctr_g	= 0;
+	assert(100	== cothreadj_yield(&(cothreads[0]), 100));
+	assert(200	== cothreadj_yield(&(cothreads[1]), 200));
+	assert(values[0]	== cothreadj_fls_get(&(cothreads[0]), key0_g));
+	assert(values[1]	== cothreadj_fls_get(&(cothreads[1]), key0_g));
+
+	//---The destructor runs on completion, for the keys which have one---//
+	assert(101	== cothreadj_yield(&(cothreads[0]), 101));
+	assert(1	== dtor_ctr_g);
+	assert(NULL	== cothreadj_fls_get(&(cothreads[0]), key0_g));
+	assert(201	== cothreadj_yield(&(cothreads[1]), 201));
+	assert(11	== dtor_ctr_g);
+	assert(values[1] + 1	== cothreadj_fls_get(&(cothreads[1]), key1_g));
+}
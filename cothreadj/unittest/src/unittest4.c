@@ -0,0 +1,98 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+
+#if		((COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID) && ((COTHREAD_ARCH_ID_X86 == COTHREAD_ARCH_ID) || (COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID)))
+#include <execinfo.h>
+
+/// @cond
+#define NB_FRAMES_MAX	64
+
+static cothreadj_stack_t	stack_g[sizeof(void*) * 1024 * 1024 / sizeof(cothreadj_stack_t)];
+/// @endcond
+
+/**
+ * @brief		Checks the backtraces taken from the specified callee.
+ * @param		[in]	depth	The number of nested calls to do before taking the backtraces.
+ * @return		Returns the number of frames found by walking the frame pointers.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static size_t COTHREAD_CALL
+check_backtrace(size_t depth)
+{
+	//---Go deeper---//
+	if (0 != depth) {
+		return check_backtrace(depth - 1) + 1;
+	}
+
+	//---Unwind with the CFI: the backtrace stops at the bottom of the callee stack---//
+	void*	frames[NB_FRAMES_MAX];
+	int		nb_frames	= backtrace(frames, NB_FRAMES_MAX);
+	assert(0			<  nb_frames);
+	assert(NB_FRAMES_MAX >  nb_frames);
+
+	//---Unwind with the frame pointers: the linked list ends within the callee stack---//
+	void**	fp			= (void**)__builtin_frame_address(0);
+	size_t	nb_fps		= 0;
+	while (NULL != fp) {
+		assert((void*)stack_g				<= (void*)fp);
+		assert((void*)(stack_g + sizeof(stack_g) / sizeof(stack_g[0]))	> (void*)fp);
+		assert(NB_FRAMES_MAX	> ++nb_fps);
+		fp	= (void**)fp[0];
+	}
+
+	//---The CFI unwinder also reports cothreadj_init---//
+	assert((size_t)nb_frames	== nb_fps + 1);
+	return nb_fps;
+}
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	//---Frames: check_backtrace, user_cb & cothreadj_core---//
+	assert(3	== check_backtrace(0));
+	assert(103	== cothreadj_yield(cothread, user_val));
+
+	//---Same thing after a switch, from deeper frames---//
+	assert(5	== check_backtrace(2) - 2);
+	return 104;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest4(void)
+{
+	//---Initialize the cothread---//
+	cothreadj_attr_t	attr;
+	cothreadj_t			cothread;
+	cothreadj_attr_init(&attr, stack_g, sizeof(stack_g), user_cb);
+	cothreadj_init(&cothread, &attr);
+
+	//---Take backtraces from the callee---//
+	assert(102	== cothreadj_yield(&cothread, 102));
+	assert(104	== cothreadj_yield(&cothread, 103));
+}
+#else
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest4(void)
+{
+	// the callee stack unwinding is checked on GNU/Linux only.
+}
+#endif
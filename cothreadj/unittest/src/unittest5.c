@@ -0,0 +1,144 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+
+#if COTHREAD_WITH_STATS
+/// @cond
+#define NB_STATS_MAX	16
+/// @endcond
+
+/**
+ * @brief		Returns the statistics of the specified cothread among the live ones.
+ * @param		[in]	cothread	The cothread to return the statistics of.
+ * @param		[out]	stats		The statistics of the cothread.
+ * @return		Returns non-zero if the cothread is live, zero otherwise.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+find_stats(const cothreadj_t* cothread, cothread_stats_t* stats)
+{
+	cothread_stats_t	all_stats[NB_STATS_MAX];
+	const size_t		nb_stats	= cothreadj_stats_snapshot(all_stats, NB_STATS_MAX);
+	assert(NB_STATS_MAX	>= nb_stats);
+	for (size_t i = 0; i < nb_stats; i++) {
+		if (cothread == all_stats[i].owner) {
+			stats[0]	= all_stats[i];
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	//---The callee sees its own resume---//
+	cothread_stats_t	stats;
+	assert(0		!= find_stats(cothread, &stats));
+	assert(1		== stats.nb_resumes);
+	assert(0		!= stats.last_resume);
+
+	//---Burn some ticks---//
+	volatile size_t	ctr	= 0;
+	while (100000 > ctr) {
+		ctr++;
+	}
+	return cothreadj_yield(cothread, user_val) + 1;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest5(void)
+{
+	//---Initialize two cothreads---//
+	static cothreadj_stack_t	stacks[2][64 * 1024 / sizeof(cothreadj_stack_t)];
+	static const char*			names[2]	= { "stats0", "stats1" };
+	cothreadj_t					cothreads[2];
+	for (size_t i = 0; i < 2; i++) {
+		cothreadj_attr_t	attr;
+		cothreadj_attr_init(&attr, stacks[i], sizeof(stacks[i]), user_cb);
+		cothreadj_attr_set_dbg_callee_name(&attr, names[i]);
+		cothreadj_init(&(cothreads[i]), &attr);
+	}
+
+	//---An unregistered cothread is not live, a registered one is---//
+	cothread_stats_t	stats;
+	assert(0	== find_stats(&(cothreads[0]), &stats));
+	for (size_t i = 0; i < 2; i++) {
+		assert(cothread_err_ok	== cothreadj_stats_register(&(cothreads[i])));
+	}
+	assert(cothread_err_ok	== cothreadj_stats_register(&(cothreads[0])));	// once.
+
+	//---Both cothreads are live, never resumed yet---//
+	for (size_t i = 0; i < 2; i++) {
+		assert(0			!= find_stats(&(cothreads[i]), &stats));
+		assert(names[i]		== stats.dbg_name);
+		assert(0			== stats.nb_resumes);
+		assert(0			== stats.nb_ticks);
+		assert(0			== stats.last_resume);
+	}
+	assert(2	<= cothreadj_stats_snapshot(NULL, 0));
+
+	//---Resume the first one---//
+	assert(100	== cothreadj_yield(&(cothreads[0]), 100));
+	assert(0	!= find_stats(&(cothreads[0]), &stats));
+	assert(1	== stats.nb_resumes);
+	assert(0	!= stats.nb_ticks);
+	assert(0	!= find_stats(&(cothreads[1]), &stats));
+	assert(0	== stats.nb_resumes);
+
+	//---The first one is not live anymore once returned---//
+	assert(102	== cothreadj_yield(&(cothreads[0]), 101));
+	assert(0	== find_stats(&(cothreads[0]), &stats));
+
+	//---The second one is not live anymore once uninitialized---//
+	cothreadj_uninit(&(cothreads[1]));
+	assert(0	== find_stats(&(cothreads[1]), &stats));
+	cothreadj_uninit(&(cothreads[0]));
+}
+#else
+/**
+ * @brief		The callee entry point, never resumed.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	return user_val;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest5(void)
+{
+	//---Nothing is recorded---//
+	static cothreadj_stack_t	stack[16 * 1024 / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothread;
+	cothread_stats_t			stats;
+	cothreadj_attr_init(&attr, stack, sizeof(stack), user_cb);
+	cothreadj_init_lazy(&cothread, &attr);
+	assert(0	== cothreadj_stats_snapshot(NULL, 0));
+	assert(0	== cothreadj_stats_snapshot(&stats, 1));
+	assert(cothread_err_notsup	== cothreadj_stats_register(&cothread));
+}
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_prof.h>
+
+#if		(COTHREAD_WITH_PROFILER	\
+		&& (COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID)	\
+		&& ((COTHREAD_ARCH_ID_X86 == COTHREAD_ARCH_ID) || (COTHREAD_ARCH_ID_X86_64 == COTHREAD_ARCH_ID))	\
+		)
+#include <string.h>
+#include <time.h>
+
+/// @cond
+static const char	dbg_name_g[]	= "unittest6_callee";
+/// @endcond
+
+/**
+ * @brief		Consumes the specified CPU time.
+ * @param		[in]	ms		The CPU time to consume, in milliseconds.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+burn(clock_t ms)
+{
+	const clock_t	end	= clock() + ms * (CLOCKS_PER_SEC / 1000);
+	while (clock() < end);
+}
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	burn(200);
+	return user_val;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest6(void)
+{
+	//---Initialize the cothread---//
+	static cothreadj_stack_t	stack[64 * 1024 / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothread;
+	cothreadj_attr_init(&attr, stack, sizeof(stack), user_cb);
+	cothreadj_attr_set_dbg_callee_name(&attr, dbg_name_g);
+	cothreadj_init(&cothread, &attr);
+
+	//---Sample the callee, then the OS thread---//
+	assert(cothread_err_ok	== cothreadj_prof_start(4096, 1000));
+	assert(100	== cothreadj_yield(&cothread, 100));
+	burn(50);
+	cothreadj_prof_stop();
+
+	//---Dump the samples---//
+	FILE*	strm	= tmpfile();
+	assert(NULL				!= strm);
+	assert(cothread_err_ok	== cothreadj_prof_dump(strm));
+	cothreadj_prof_release();
+
+	//---Count the samples of each side---//
+	char			line[4096];
+	unsigned long	nb_callee	= 0;
+	unsigned long	nb_thread	= 0;
+	rewind(strm);
+	while (NULL != fgets(line, sizeof(line), strm)) {
+		const char*		count	= strrchr(line, ' ');
+		assert(NULL	!= count);
+		if (0 == strncmp(line, dbg_name_g, sizeof(dbg_name_g) - 1)) {
+			assert(';'	== line[sizeof(dbg_name_g) - 1]);
+			nb_callee	+= strtoul(count + 1, NULL, 10);
+		} else if (0 == strncmp(line, "[thread];", 9)) {
+			nb_thread	+= strtoul(count + 1, NULL, 10);
+		}
+	}
+	fclose(strm);
+	assert(0	!= nb_callee);
+	assert(0	!= nb_thread);
+	assert(nb_callee	> nb_thread);
+}
+#else
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest6(void)
+{
+	//---The profiler is not available---//
+	assert(cothread_err_notsup	== cothreadj_prof_start(1, 1000));
+	assert(cothread_err_notsup	== cothreadj_prof_dump(stdout));
+}
+#endif
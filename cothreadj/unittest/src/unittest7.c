@@ -0,0 +1,125 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <string.h>
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	user_val	= cothreadj_yield(cothread, user_val);
+	user_val	= cothreadj_yield(cothread, user_val);
+	return user_val;
+}
+
+#if COTHREAD_WITH_TRACE
+/**
+ * @brief		Counts the occurrences of the specified pattern in the specified stream.
+ * @param		[in]	strm	The stream to look for the pattern in.
+ * @param		[in]	pattern	The pattern to look for.
+ * @return		Returns the number of lines containing the pattern.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static size_t COTHREAD_CALL
+count_lines(FILE* strm, const char* pattern)
+{
+	char	line[512];
+	size_t	nb_lines	= 0;
+	rewind(strm);
+	while (NULL != fgets(line, sizeof(line), strm)) {
+		if (NULL != strstr(line, pattern)) {
+			nb_lines++;
+		}
+	}
+	return nb_lines;
+}
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest7(void)
+{
+	//---Initialize two cothreads---//
+	static cothreadj_stack_t	stacks[2][64 * 1024 / sizeof(cothreadj_stack_t)];
+	static const char*			names[2]	= { "trace0", "trace1" };
+	cothreadj_t					cothreads[2];
+	for (size_t i = 0; i < 2; i++) {
+		cothreadj_attr_t	attr;
+		cothreadj_attr_init(&attr, stacks[i], sizeof(stacks[i]), user_cb);
+		cothreadj_attr_set_dbg_callee_name(&attr, names[i]);
+		cothreadj_init(&(cothreads[i]), &attr);
+	}
+
+#if !COTHREAD_WITH_TRACE
+	//---The tracing is not available---//
+	assert(cothread_err_notsup	== cothreadj_trace_start());
+	assert(cothread_err_notsup	== cothreadj_trace_dump(stdout));
+	cothreadj_uninit(&(cothreads[0]));
+	cothreadj_uninit(&(cothreads[1]));
+#else
+	//---Start the tracing---//
+	assert(cothread_err_ok	== cothreadj_trace_start());
+
+	//---Interleave the cothreads until they complete---//
+	for (int i = 0; i < 3; i++) {
+		assert(100 + i	== cothreadj_yield(&(cothreads[0]), 100 + i));
+		assert(200 + i	== cothreadj_yield(&(cothreads[1]), 200 + i));
+	}
+	cothreadj_trace_stop();
+
+	//---Once stopped, nothing is recorded---//
+	static cothreadj_stack_t	stack[64 * 1024 / sizeof(cothreadj_stack_t)];
+	cothreadj_attr_t			attr;
+	cothreadj_t					cothread;
+	cothreadj_attr_init(&attr, stack, sizeof(stack), user_cb);
+	cothreadj_attr_set_dbg_callee_name(&attr, "untraced");
+	cothreadj_init(&cothread, &attr);
+	assert(1	== cothreadj_yield(&cothread, 1));
+	cothreadj_uninit(&cothread);
+
+	//---Dump the events---//
+	FILE*	strm	= tmpfile();
+	assert(NULL				!= strm);
+	assert(cothread_err_ok	== cothreadj_trace_dump(strm));
+
+	//---Each cothread has its own track, 3 resumes, 2 pauses, a start & a completion---//
+	assert(1	== count_lines(strm, "\"process_name\""));
+	assert(2	== count_lines(strm, "\"thread_name\""));
+	assert(1	== count_lines(strm, "\"name\":\"trace0\""));
+	assert(1	== count_lines(strm, "\"name\":\"trace1\""));
+	assert(0	== count_lines(strm, "untraced"));
+	assert(6	== count_lines(strm, "\"ph\":\"B\""));
+	assert(6	== count_lines(strm, "\"ph\":\"E\""));
+	assert(2	== count_lines(strm, "\"name\":\"start\""));
+	assert(2	== count_lines(strm, "\"name\":\"complete\""));
+	fclose(strm);
+
+	//---Once released, the events are gone & the next ones are recorded in a new ring---//
+	cothreadj_trace_release();
+	assert(cothread_err_ok	== cothreadj_trace_start());
+	cothreadj_attr_set_dbg_callee_name(&attr, "retraced");
+	cothreadj_init(&cothread, &attr);
+	assert(1	== cothreadj_yield(&cothread, 1));
+	cothreadj_uninit(&cothread);
+	cothreadj_trace_stop();
+	strm	= tmpfile();
+	assert(NULL				!= strm);
+	assert(cothread_err_ok	== cothreadj_trace_dump(strm));
+	assert(1	== count_lines(strm, "\"thread_name\""));
+	assert(1	== count_lines(strm, "\"name\":\"retraced\""));
+	fclose(strm);
+	cothreadj_trace_release();
+#endif
+}
@@ -0,0 +1,134 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+
+#if		(COTHREAD_WITH_USDT && (COTHREAD_OS_ID_GNU_LINUX == COTHREAD_OS_ID))
+#include <link.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief		Finds the path of the object mapping the specified address.
+ * @param		[in]	addr	The address to look for.
+ * @param		[out]	path	The buffer to store the path in.
+ * @param		[in]	path_sz	The buffer size, in bytes.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+find_object(const void* addr, char* path, size_t path_sz)
+{
+	//---Look for the mapping in the memory map of the process---//
+	char	line[1024];
+	FILE*	strm	= fopen("/proc/self/maps", "r");
+	assert(NULL	!= strm);
+	path[0]	= '\0';
+	while (('\0' == path[0]) && (NULL != fgets(line, sizeof(line), strm))) {
+		uintptr_t	start;
+		uintptr_t	end;
+		int			path_pos	= 0;
+		if ((2 == sscanf(line, "%" SCNxPTR "-%" SCNxPTR " %*s %*s %*s %*s %n", &start, &end, &path_pos)) && (0 != path_pos)) {
+			if ((start <= (uintptr_t)addr) && ((uintptr_t)addr < end)) {
+				line[strcspn(line, "\n")]	= '\0';
+				assert(strlen(line + path_pos) < path_sz);
+				strcpy(path, line + path_pos);
+			}
+		}
+	}
+	fclose(strm);
+	assert('\0'	!= path[0]);
+}
+
+/**
+ * @brief		Checks the specified cothreadj probe is described in the specified .note.stapsdt section.
+ * @param		[in]	notes		The section content.
+ * @param		[in]	notes_sz	The section size, in bytes.
+ * @param		[in]	name		The probe name.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+check_probe(const char* notes, size_t notes_sz, const char* name)
+{
+	//---Walk the notes---//
+	// each note is: the header, the owner ("stapsdt") & the description (3 addresses, the provider, the name & the arguments.)
+	size_t	nb_found	= 0;
+	size_t	pos			= 0;
+	while (pos + sizeof(ElfW(Nhdr)) <= notes_sz) {
+		const ElfW(Nhdr)*	nhdr	= (const ElfW(Nhdr)*)(notes + pos);
+		const char*			owner	= notes + pos + sizeof(ElfW(Nhdr));
+		const char*			desc	= owner + ((nhdr->n_namesz + 3) & ~3);
+		if ((3 == nhdr->n_type) && (0 == strcmp(owner, "stapsdt"))) {
+			const char*	provider	= desc + 3 * sizeof(ElfW(Addr));
+			const char*	probe		= provider + strlen(provider) + 1;
+			const char*	args		= probe + strlen(probe) + 1;
+			if ((0 == strcmp(provider, "cothreadj")) && (0 == strcmp(probe, name))) {
+				assert(NULL	!= strchr(args, ' '));	// two arguments.
+				nb_found++;
+			}
+		}
+		pos	= (desc + ((nhdr->n_descsz + 3) & ~3)) - notes;
+	}
+
+	//---The probe may be inlined several times---//
+	assert(0	!= nb_found);
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest8(void)
+{
+	//---Load the object defining the library (the shared library, or the executable if static)---//
+	char	path[1024];
+	find_object((const void*)cothreadj_yield, path, sizeof(path));
+	FILE*	strm	= fopen(path, "rb");
+	assert(NULL	!= strm);
+	assert(0	== fseek(strm, 0, SEEK_END));
+	const long	image_sz	= ftell(strm);
+	assert(0	< image_sz);
+	rewind(strm);
+	char*	image	= (char*)malloc(image_sz);
+	assert(NULL	!= image);
+	assert(1	== fread(image, image_sz, 1, strm));
+	fclose(strm);
+
+	//---Look for the .note.stapsdt section---//
+	const ElfW(Ehdr)*	ehdr		= (const ElfW(Ehdr)*)image;
+	const ElfW(Shdr)*	shdrs		= (const ElfW(Shdr)*)(image + ehdr->e_shoff);
+	const char*			shstrtab	= image + shdrs[ehdr->e_shstrndx].sh_offset;
+	const ElfW(Shdr)*	shdr		= NULL;
+	assert(0	== memcmp(ehdr->e_ident, ELFMAG, SELFMAG));
+	for (ElfW(Half) i = 0; (NULL == shdr) && (i < ehdr->e_shnum); i++) {
+		if (0 == strcmp(shstrtab + shdrs[i].sh_name, ".note.stapsdt")) {
+			shdr	= shdrs + i;
+		}
+	}
+	assert(NULL	!= shdr);
+
+	//---Check the probes---//
+	const char*	notes		= image + shdr->sh_offset;
+	const char*	names[]		= { "init", "yield_out", "yield_in", "cb_start", "cb_return" };
+	for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+		check_probe(notes, shdr->sh_size, names[i]);
+	}
+
+	//---Release---//
+	free(image);
+}
+#else
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest8(void)
+{
+	//---The USDT probes are placed on GNU/Linux only, if sys/sdt.h is found: fail if they were required---//
+	assert(!COTHREAD_REQUIRE_USDT);
+}
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <cothread/cothreadj_arena.h>
+#include <stdint.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 2 * 1024)
+/// @endcond
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the other endpoint.
+ * @return		Returns any user value (except zero) to send to the other endpoint.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadj_t* cothread, int user_val)
+{
+	return cothreadj_yield(cothread, user_val + 1) + 1;
+}
+
+/**
+ * @brief		Checks the specified arena.
+ * @param		[in]	flags	The arena flags.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+static void COTHREAD_CALL
+check_arena(unsigned int flags)
+{
+	//---Initialize the arena---//
+	cothreadj_arena_t	arena;
+	cothreadj_arena_init(&arena, STACK_SZ, flags);
+	assert(STACK_SZ	<= arena.stack_sz);
+	assert(0		== (arena.slot_sz % COTHREADJ_ARENA_SLOT_ALIGN));
+	assert(NULL		== arena.regions);
+
+	//---Carve enough slots to map a second region---//
+	const size_t	nb_slots	= arena.region_sz / arena.slot_sz + 1;
+	cothreadj_t**	cothreads	= (cothreadj_t**)malloc(nb_slots * sizeof(cothreadj_t*));
+	cothreadj_t*	stack_cothread;
+	assert(NULL	!= cothreads);
+	cothreadj_stack_t*	first	= cothreadj_arena_alloc(&arena, &stack_cothread);
+	assert(NULL	!= first);
+	assert(0	== ((COTHREADJ_ARENA_REGION_ALIGN - 1) & (uintptr_t)first));
+	for (size_t i = 1; i < nb_slots; i++) {
+		cothreadj_stack_t*	stack	= cothreadj_arena_alloc(&arena, cothreads + i);
+		assert(NULL	!= stack);
+		if (nb_slots - 1 != i) {
+			assert((char*)first + i * arena.slot_sz	== (char*)stack);
+		} else {
+			assert(NULL	!= arena.regions->next);
+			assert(0	== ((COTHREADJ_ARENA_REGION_ALIGN - 1) & (uintptr_t)stack));
+		}
+		if (0 != (COTHREADJ_ARENA_FLAG_COLOCATE & flags)) {
+			assert((char*)stack + arena.stack_sz	== (char*)cothreads[i]);
+		} else {
+			assert(NULL	== cothreads[i]);
+		}
+	}
+
+	//---Run a cothread on the first stack (on its colocated control block if any)---//
+	cothreadj_attr_t	attr;
+	cothreadj_t			cothread;
+	cothreadj_t*		cothd	= (0 != (COTHREADJ_ARENA_FLAG_COLOCATE & flags)) ? stack_cothread : &cothread;
+	cothreadj_attr_init(&attr, first, arena.stack_sz, user_cb);
+	cothreadj_init(cothd, &attr);
+	assert(11	== cothreadj_yield(cothd, 10));
+	assert(21	== cothreadj_yield(cothd, 20));
+	cothreadj_uninit(cothd);
+
+	//---The last released slot is reused first---//
+	cothreadj_arena_free(&arena, first);
+	assert(first	== cothreadj_arena_alloc(&arena, &stack_cothread));
+
+	//---Release---//
+	free(cothreads);
+	cothreadj_arena_uninit(&arena);
+	assert(NULL	== arena.regions);
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadj_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest9(void)
+{
+	check_arena(0);
+	check_arena(COTHREADJ_ARENA_FLAG_COLOCATE);
+}
@@ -12,7 +12,10 @@
 #define __COTHREAD_COTHREADT_H__
 
 #include <cothread/config.h>
+#include <cothread/hooks.h>
+#include <cothread/stats.h>
 #include <cothread/types.h>
+#include <stdio.h>
 
 //---Forward declarations---//
 /// @ingroup doxy_cothreadt
@@ -127,6 +130,82 @@ extern COTHREAD_LINK void*	COTHREAD_CALL cothreadt_get_user_data	(const cothread
  */
 extern COTHREAD_LINK void				COTHREAD_CALL cothreadt_yield	(cothreadt_t* cothread);
 
+/**
+ * @brief		Sets the hooks called each time the callee of the specified cothread is resumed or suspended.
+ * @param		[in]	cothread	The cothread, whose callee must not be running.
+ * @param		[in]	hooks		The hooks, kept alive until replaced (no internal copy is done), NULL to remove them.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_HOOKS.
+ *				.
+ * @note		The hooks get the cothread as first argument, and run in the OS thread of the callee.
+ * @relates		_cothreadt_t
+ */
+extern COTHREAD_LINK cothread_err_t		COTHREAD_CALL cothreadt_set_hooks	(cothreadt_t* cothread, const cothread_hooks_t* hooks);
+
+/**
+ * @brief		Sets the hooks called each time the callee of any cothread is resumed or suspended.
+ * @param		[in]	hooks		The hooks, kept alive until replaced (no internal copy is done), NULL to remove them.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_HOOKS.
+ *				.
+ * @note		The global resume hook runs before the per-cothread one, the global suspend hook after it.
+ *				The hooks should be set while no callee runs, since the switches read them without synchronization.
+ * @ingroup		doxy_cothreadt
+ */
+extern COTHREAD_LINK cothread_err_t		COTHREAD_CALL cothreadt_set_global_hooks	(const cothread_hooks_t* hooks);
+
+/**
+ * @brief		Copies the statistics of the live cothreads (initialized, not returned nor uninitialized yet.)
+ * @param		[out]	stats		The array to copy the statistics to, may be NULL if @e nb_stats is zero.
+ * @param		[in]	nb_stats	The number of entries of the array.
+ * @return		Returns the number of live cothreads, which may be greater than @e nb_stats,
+ *				always zero if the library is built without @ref COTHREAD_WITH_STATS.
+ * @note		This function may be called from any thread, the statistics of the running callees may be slightly stale.
+ * @ingroup		doxy_cothreadt
+ */
+extern COTHREAD_LINK size_t				COTHREAD_CALL cothreadt_stats_snapshot	(cothread_stats_t* stats, size_t nb_stats);
+
+/**
+ * @brief		Starts recording the switch events, the previously recorded ones are discarded.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_TRACE.
+ *				.
+ * @note		The events are recorded by the OS thread of each callee, in its own ring which keeps the
+ *				4096 most recent ones.
+ * @ingroup		doxy_cothreadt
+ */
+extern COTHREAD_LINK cothread_err_t		COTHREAD_CALL cothreadt_trace_start	(void);
+
+/**
+ * @brief		Stops recording the switch events, the recorded ones are kept until the next start.
+ * @ingroup		doxy_cothreadt
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothreadt_trace_stop	(void);
+
+/**
+ * @brief		Writes the recorded switch events to the specified stream, in the Chrome trace event JSON format.
+ * @param		[in]	strm	The stream to write the events to.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_nomem if the events cannot be gathered ;
+ *				- @ref cothread_err_notsup if the library is built without @ref COTHREAD_WITH_TRACE.
+ *				.
+ * @note		Each cothread gets its own track. The output may be loaded in @c chrome://tracing or in the Perfetto UI.
+ * @ingroup		doxy_cothreadt
+ */
+extern COTHREAD_LINK cothread_err_t		COTHREAD_CALL cothreadt_trace_dump	(FILE* strm);
+
+/**
+ * @brief		Frees the rings of the switch events, including the ones of the OS threads which have exited.
+ * @note		This function shall not be called while recording: each OS thread allocates a new ring on its
+ *				next recorded event.
+ * @ingroup		doxy_cothreadt
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothreadt_trace_release	(void);
+
 #ifdef __cplusplus
 } /* extern "C" { */
 #endif
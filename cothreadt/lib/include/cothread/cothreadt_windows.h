@@ -22,6 +22,12 @@ struct _cothreadt_t
 
 	cothreadt_cb_t		user_cb;	///< @brief	The cothread entry point.
 	void*				user_data;	///< @brief	Any user data.
+#if COTHREAD_WITH_HOOKS
+	const cothread_hooks_t*	hooks;	///< @brief	The hooks called when the callee is resumed or suspended, NULL if none.
+#endif
+#if COTHREAD_WITH_STATS
+	cothread_stats_t	stats;		///< @brief	The statistics, linked in the list of live ones until the callee returns.
+#endif
 };
 
 #ifdef __cplusplus
@@ -4,6 +4,8 @@
  */
 
 #include <cothread/cothreadt.h>
+#include <cothread/probes.h>
+#include <cothread/trace.h>
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,6 +16,34 @@
 #define COTHREADT_FLAG_ABORTING		(1 << 1)	///< @brief	Says whether the cothread shall abort or not.
 /// @}
 
+#if COTHREAD_WITH_HOOKS
+/// @cond
+static const cothread_hooks_t*	cothreadt_hooks_global	= NULL;	// the hooks of all the cothreads.
+/// @endcond
+#endif
+
+#if COTHREAD_WITH_STATS
+/// @cond
+static cothread_stats_list_t	cothreadt_stats_live	= COTHREAD_STATS_LIST_INITIALIZER;	// the statistics of the live cothreads.
+/// @endcond
+#endif
+
+#if COTHREAD_WITH_TRACE
+/// @cond
+static cothread_trace_t								cothreadt_trace			= COTHREAD_TRACE_INITIALIZER;	// the tracer.
+static COTHREAD_THREAD_LOCAL cothread_trace_slot_t	cothreadt_trace_slot	= { NULL, 0 };						// the ring of the OS thread.
+/// @endcond
+#endif
+
+/**
+ * @brief		Records the specified switch event.
+ * @param		[in]	_type		The event type (see @ref COTHREAD_TRACE_RESUME.)
+ * @param		[in]	_cothread	The cothread.
+ * @ingroup		doxy_cothreadt
+ */
+#define COTHREADT_TRACE(_type, _cothread)	\
+	COTHREAD_TRACE(&cothreadt_trace, &cothreadt_trace_slot, (_type), (_cothread), NULL)
+
 /**
  * @brief		Unlocks the specified cothread.
  * @param		[in]	cothread	The cothread to unlock.
@@ -111,7 +141,19 @@ cothreadt_thd_cb(void* arg)
 	//---Run the user callback if no abortion is pending---//
 	if (0 == (COTHREADT_FLAG_ABORTING & cothread->flags)) {
 		cothread->flags	&= ~COTHREADT_FLAG_ABORTABLE;
+		COTHREAD_STATS_RESUME(&(cothread->stats));
+		COTHREADT_TRACE(COTHREAD_TRACE_RESUME, cothread);
+		COTHREADT_TRACE(COTHREAD_TRACE_START, cothread);
+		COTHREAD_HOOKS_RESUME(cothreadt_hooks_global, cothread->hooks, cothread);
+		COTHREAD_PROBE(cothreadt, cb_start, cothread, cothread->user_data);
 		cothread->user_cb(cothread);
+		COTHREAD_PROBE(cothreadt, cb_return, cothread, cothread->user_data);
+		COTHREAD_HOOKS_SUSPEND(cothreadt_hooks_global, cothread->hooks, cothread);
+		COTHREADT_TRACE(COTHREAD_TRACE_COMPLETE, cothread);
+		COTHREAD_STATS_PAUSE(&(cothread->stats));
+#if COTHREAD_WITH_STATS
+		cothread_stats_unregister(&cothreadt_stats_live, &(cothread->stats));
+#endif
 	}
 
 	//---Return to caller---//
@@ -159,6 +201,11 @@ cothreadt_uninit(cothreadt_t* cothread)
 	//---Check arguments---//
 	assert(NULL	!= cothread);
 
+	//---Unlink the statistics if the callee has not returned---//
+#if COTHREAD_WITH_STATS
+	cothread_stats_unregister(&cothreadt_stats_live, &(cothread->stats));
+#endif
+
 	//---May the cothread be aborted ?---//
 	if (COTHREADT_FLAG_ABORTABLE == (COTHREADT_FLAG_ABORTABLE & cothread->flags)) {
 		cothreadt_abort(cothread);
@@ -195,6 +242,9 @@ cothreadt_init(cothreadt_t* cothread, const cothreadt_attr_t* attr)
 	cothread->state		= cothreadt_state_paused;
 	cothread->flags		= COTHREADT_FLAG_ABORTABLE;
 	cothread->user_cb	= attr->user_cb;
+#if COTHREAD_WITH_HOOKS
+	cothread->hooks		= NULL;
+#endif
 
 	//---Initialize the mutex---//
 	if (0 != (pthread_ret = pthread_mutex_init(&(cothread->mtx), NULL))) {
@@ -210,6 +260,11 @@ cothreadt_init(cothreadt_t* cothread, const cothreadt_attr_t* attr)
 			} else {
 				//---Update the error code---//
 				err	= cothread_err_ok;
+				COTHREAD_PROBE(cothreadt, init, cothread, attr->user_cb);
+#if COTHREAD_WITH_STATS
+				cothread_stats_init(&(cothread->stats), cothread, NULL);
+				cothread_stats_register(&cothreadt_stats_live, &(cothread->stats));
+#endif
 			}
 
 			//---Error Management---//
@@ -262,14 +317,111 @@ cothreadt_yield(cothreadt_t* cothread)
 	assert((cothreadt_state_paused	== cothread->state) || (0 != is_callee));
 
 	//---Switch the current state---//
+	if (0 != is_callee) {
+		COTHREAD_HOOKS_SUSPEND(cothreadt_hooks_global, cothread->hooks, cothread);
+		COTHREAD_STATS_PAUSE(&(cothread->stats));
+		COTHREADT_TRACE(COTHREAD_TRACE_PAUSE, cothread);
+	}
 	cothread->state	= cothreadt_state_resumed == cothread->state ? cothreadt_state_paused : cothreadt_state_resumed;
+	COTHREAD_PROBE(cothreadt, yield_out, cothread, cothread->user_data);
 	cothreadt_signal(cothread);
 
 	//---Wait for the running state---//
 	while (running_state != cothread->state) {
 		cothreadt_wait(cothread);
 	}
+	COTHREAD_PROBE(cothreadt, yield_in, cothread, cothread->user_data);
+	if (0 != is_callee) {
+		COTHREADT_TRACE(COTHREAD_TRACE_RESUME, cothread);
+		COTHREAD_STATS_RESUME(&(cothread->stats));
+		COTHREAD_HOOKS_RESUME(cothreadt_hooks_global, cothread->hooks, cothread);
+	}
 
 	//---Unlock---//
 	cothreadt_unlock(cothread);
 }
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadt_set_hooks(cothreadt_t* cothread, const cothread_hooks_t* hooks)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+
+	//---Set---//
+#if COTHREAD_WITH_HOOKS
+	cothread->hooks	= hooks;
+	return cothread_err_ok;
+#else
+	(void)hooks;
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadt_set_global_hooks(const cothread_hooks_t* hooks)
+{
+#if COTHREAD_WITH_HOOKS
+	cothreadt_hooks_global	= hooks;
+	return cothread_err_ok;
+#else
+	(void)hooks;
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK size_t COTHREAD_CALL
+cothreadt_stats_snapshot(cothread_stats_t* stats, size_t nb_stats)
+{
+	//---Check arguments---//
+	assert((NULL != stats) || (0 == nb_stats));
+
+	//---Copy---//
+#if COTHREAD_WITH_STATS
+	return cothread_stats_copy(&cothreadt_stats_live, stats, nb_stats);
+#else
+	(void)stats;
+	(void)nb_stats;
+	return 0;
+#endif
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadt_trace_start(void)
+{
+#if COTHREAD_WITH_TRACE
+	cothread_trace_start(&cothreadt_trace);
+	return cothread_err_ok;
+#else
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadt_trace_stop(void)
+{
+#if COTHREAD_WITH_TRACE
+	cothread_trace_stop(&cothreadt_trace);
+#endif
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadt_trace_dump(FILE* strm)
+{
+	//---Check arguments---//
+	assert(NULL	!= strm);
+
+	//---Dump---//
+#if COTHREAD_WITH_TRACE
+	return cothread_trace_dump(&cothreadt_trace, strm, 2, "cothreadt");
+#else
+	return cothread_err_notsup;
+#endif
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadt_trace_release(void)
+{
+#if COTHREAD_WITH_TRACE
+	cothread_trace_release(&cothreadt_trace);
+#endif
+}
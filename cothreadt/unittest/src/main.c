@@ -20,6 +20,9 @@ main(int argc, char* argv[])
 
 	unittest0();
 	unittest1();
+	unittest2();
+	unittest3();
+	unittest4();
 
 	printf("%s terminated\n", __func__);
 	return 0;
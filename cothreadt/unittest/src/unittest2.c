@@ -0,0 +1,95 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+
+#if COTHREAD_WITH_STATS
+/// @cond
+#define NB_STATS_MAX	16
+/// @endcond
+
+/**
+ * @brief		Returns the statistics of the specified cothread among the live ones.
+ * @param		[in]	cothread	The cothread to return the statistics of.
+ * @param		[out]	stats		The statistics of the cothread.
+ * @return		Returns non-zero if the cothread is live, zero otherwise.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+static int COTHREAD_CALL
+find_stats(const cothreadt_t* cothread, cothread_stats_t* stats)
+{
+	cothread_stats_t	all_stats[NB_STATS_MAX];
+	const size_t		nb_stats	= cothreadt_stats_snapshot(all_stats, NB_STATS_MAX);
+	assert(NB_STATS_MAX	>= nb_stats);
+	for (size_t i = 0; i < nb_stats; i++) {
+		if (cothread == all_stats[i].owner) {
+			stats[0]	= all_stats[i];
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief		The cothread entry point.
+ * @param		[in]	cothread	The cothread.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+static void COTHREAD_CALL
+user_cb(cothreadt_t* cothread)
+{
+	//---Burn some ticks---//
+	volatile size_t	ctr	= 0;
+	while (100000 > ctr) {
+		ctr++;
+	}
+	cothreadt_yield(cothread);
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest2(void)
+{
+	//---Initialize the cothread---//
+	cothreadt_attr_t	attr;
+	cothreadt_t			cothread;
+	cothreadt_attr_init(&attr, user_cb);
+	assert(cothread_err_ok	== cothreadt_init(&cothread, &attr));
+
+	//---The cothread is live, never resumed yet---//
+	cothread_stats_t	stats;
+	assert(0	!= find_stats(&cothread, &stats));
+	assert(0	== stats.nb_resumes);
+	assert(0	== stats.nb_ticks);
+
+	//---Resume it once---//
+	cothreadt_yield(&cothread);
+	assert(0	!= find_stats(&cothread, &stats));
+	assert(1	== stats.nb_resumes);
+	assert(0	!= stats.nb_ticks);
+	assert(0	!= stats.last_resume);
+
+	//---The cothread is not live anymore once returned---//
+	cothreadt_yield(&cothread);
+	assert(0	== find_stats(&cothread, &stats));
+	cothreadt_uninit(&cothread);
+}
+#else
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest2(void)
+{
+	//---Nothing is recorded---//
+	cothread_stats_t	stats;
+	assert(0	== cothreadt_stats_snapshot(NULL, 0));
+	assert(0	== cothreadt_stats_snapshot(&stats, 1));
+}
+#endif
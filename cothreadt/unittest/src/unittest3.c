@@ -0,0 +1,77 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <string.h>
+
+#if COTHREAD_WITH_TRACE
+/**
+ * @brief		The cothread entry point.
+ * @param		[in]	cothread	The cothread.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+static void COTHREAD_CALL
+user_cb(cothreadt_t* cothread)
+{
+	cothreadt_yield(cothread);
+}
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest3(void)
+{
+#if !COTHREAD_WITH_TRACE
+	//---The tracing is not available---//
+	assert(cothread_err_notsup	== cothreadt_trace_start());
+	assert(cothread_err_notsup	== cothreadt_trace_dump(stdout));
+#else
+	//---Run a cothread while tracing---//
+	cothreadt_attr_t	attr;
+	cothreadt_t			cothread;
+	cothreadt_attr_init(&attr, user_cb);
+	assert(cothread_err_ok	== cothreadt_trace_start());
+	assert(cothread_err_ok	== cothreadt_init(&cothread, &attr));
+	cothreadt_yield(&cothread);
+	cothreadt_yield(&cothread);
+	cothreadt_uninit(&cothread);
+	cothreadt_trace_stop();
+
+	//---Dump the events: 2 resumes, a pause, a start & a completion---//
+	FILE*	strm	= tmpfile();
+	assert(NULL				!= strm);
+	assert(cothread_err_ok	== cothreadt_trace_dump(strm));
+	char	line[512];
+	size_t	nb_tracks	= 0;
+	size_t	nb_begins	= 0;
+	size_t	nb_ends		= 0;
+	rewind(strm);
+	while (NULL != fgets(line, sizeof(line), strm)) {
+		nb_tracks	+= (NULL != strstr(line, "\"thread_name\"")) ? 1 : 0;
+		nb_begins	+= (NULL != strstr(line, "\"ph\":\"B\"")) ? 1 : 0;
+		nb_ends		+= (NULL != strstr(line, "\"ph\":\"E\"")) ? 1 : 0;
+	}
+	fclose(strm);
+	assert(1	== nb_tracks);
+	assert(2	== nb_begins);
+	assert(2	== nb_ends);
+
+	//---Once released, no event is left---//
+	cothreadt_trace_release();
+	strm	= tmpfile();
+	assert(NULL				!= strm);
+	assert(cothread_err_ok	== cothreadt_trace_dump(strm));
+	nb_tracks	= 0;
+	rewind(strm);
+	while (NULL != fgets(line, sizeof(line), strm)) {
+		nb_tracks	+= (NULL != strstr(line, "\"thread_name\"")) ? 1 : 0;
+	}
+	fclose(strm);
+	assert(0	== nb_tracks);
+#endif
+}
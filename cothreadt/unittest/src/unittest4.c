@@ -0,0 +1,87 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+#include <string.h>
+
+#if COTHREAD_WITH_HOOKS
+/// @cond
+#define NB_EVENTS	16
+/// @endcond
+
+/// @cond
+typedef struct
+{
+	char			events[NB_EVENTS];	// the hooks called, in order ('R'/'S' for the global ones, 'r'/'s' for the local ones.)
+	size_t			nb_events;			// the number of hooks called.
+	cothreadt_t*	cothread;			// the cothread the hooks are expected to be called with.
+} log_t;
+/// @endcond
+
+/**
+ * @brief		Logs the specified event.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	hook_log	The log.
+ * @param		[in]	event		The event.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+static void COTHREAD_CALL
+log_event(void* cothread, log_t* hook_log, char event)
+{
+	assert(hook_log->cothread	== cothread);
+	assert(hook_log->nb_events	< NB_EVENTS);
+	hook_log->events[hook_log->nb_events++]	= event;
+}
+
+/// @cond
+static void COTHREAD_CALL global_resume_cb	(void* cothread, void* user_data)	{ log_event(cothread, (log_t*)user_data, 'R'); }
+static void COTHREAD_CALL global_suspend_cb	(void* cothread, void* user_data)	{ log_event(cothread, (log_t*)user_data, 'S'); }
+static void COTHREAD_CALL local_resume_cb	(void* cothread, void* user_data)	{ log_event(cothread, (log_t*)user_data, 'r'); }
+static void COTHREAD_CALL local_suspend_cb	(void* cothread, void* user_data)	{ log_event(cothread, (log_t*)user_data, 's'); }
+/// @endcond
+
+/**
+ * @brief		The cothread entry point.
+ * @param		[in]	cothread	The cothread.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+static void COTHREAD_CALL
+user_cb(cothreadt_t* cothread)
+{
+	cothreadt_yield(cothread);
+}
+#endif
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadt_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest4(void)
+{
+#if !COTHREAD_WITH_HOOKS
+	//---The hooks are not available---//
+	assert(cothread_err_notsup	== cothreadt_set_global_hooks(NULL));
+#else
+	//---Run a cothread, the global hooks wrapping the local ones, on the start, pause, resume & completion---//
+	log_t					hook_log;
+	const cothread_hooks_t	global_hooks	= { global_resume_cb, global_suspend_cb, &hook_log };
+	const cothread_hooks_t	local_hooks		= { local_resume_cb, local_suspend_cb, &hook_log };
+	cothreadt_attr_t		attr;
+	cothreadt_t				cothread;
+	cothreadt_attr_init(&attr, user_cb);
+	assert(cothread_err_ok	== cothreadt_init(&cothread, &attr));
+	hook_log.nb_events	= 0;
+	hook_log.cothread	= &cothread;
+	assert(cothread_err_ok	== cothreadt_set_global_hooks(&global_hooks));
+	assert(cothread_err_ok	== cothreadt_set_hooks(&cothread, &local_hooks));
+	cothreadt_yield(&cothread);
+	cothreadt_yield(&cothread);
+	cothreadt_uninit(&cothread);
+	assert(cothread_err_ok	== cothreadt_set_global_hooks(NULL));
+	assert(8	== hook_log.nb_events);
+	assert(0	== memcmp("RrsSRrsS", hook_log.events, 8));
+#endif
+}
@@ -0,0 +1,129 @@
+/**
+ * @brief		This file contains the public declarations.
+ * @file
+ *
+ * @defgroup	doxy_cothreadu		cothread - ucontext
+ * @{
+ *		@defgroup	doxy_cothreadu_unittest			C unittest
+ * @}
+ */
+
+#ifndef __COTHREAD_COTHREADU_H__
+#define __COTHREAD_COTHREADU_H__
+
+#include <cothread/config.h>
+#include <cothread/types.h>
+#include <stddef.h>
+#include <ucontext.h>
+
+//---Forward declarations---//
+/// @ingroup doxy_cothreadu
+/// @{
+typedef struct _cothreadu_attr_t	cothreadu_attr_t;	///< @brief	The cothread attribute type.
+typedef struct _cothreadu_t			cothreadu_t;		///< @brief	The cothread type.
+/// @}
+
+/// @ingroup doxy_cothreadu
+/// @{
+#define COTHREADU_FLAG_RUNNING		(1 << 0)	///< @brief	Says whether the callee is running or not.
+#define COTHREADU_FLAG_COMPLETED	(1 << 1)	///< @brief	Says whether the callee has returned or not.
+/// @}
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns any user value (except zero) to send to the caller.
+ * @ingroup		doxy_cothreadu
+ */
+typedef int (COTHREAD_CALL * cothreadu_cb_t) (cothreadu_t* cothread, int user_val);
+
+/**
+ * @brief		The cothread attribute type.
+ * @ingroup		doxy_cothreadu
+ */
+struct _cothreadu_attr_t
+{
+	void*			stack;		///< @brief	The lowest address of the callee stack.
+	size_t			stack_sz;	///< @brief	The size of the callee stack, in bytes.
+	cothreadu_cb_t	user_cb;	///< @brief	The callee entry point.
+};
+
+/**
+ * @brief		The cothread type.
+ * @ingroup		doxy_cothreadu
+ */
+struct _cothreadu_t
+{
+	ucontext_t		caller;		///< @brief	The caller context.
+	ucontext_t		callee;		///< @brief	The callee context.
+	unsigned int	flags;		///< @brief	Several flags (see @ref COTHREADU_FLAG_RUNNING.)
+	int				user_val;	///< @brief	The user value sent to the other context.
+	cothreadu_cb_t	user_cb;	///< @brief	The callee entry point.
+	void*			user_data;	///< @brief	Any user data.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief		Initializes the specified attributes.
+ * @param		[in]	attr		The attributes to initialize.
+ * @param		[in]	stack		The lowest address of the callee stack.
+ * @param		[in]	stack_sz	The size of the callee stack, in bytes.
+ * @param		[in]	user_cb		The callee entry point.
+ * @relates		_cothreadu_attr_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothreadu_attr_init	(cothreadu_attr_t* attr, void* stack, size_t stack_sz, cothreadu_cb_t user_cb);
+
+/**
+ * @brief		Initializes the specified cothread.
+ * @param		[in]	cothread	The cothread to initialize.
+ * @param		[in]	attr		The attributes to initialize the cothread with.
+ * @note		Modifying @e attr after calling this function has no effect on the initialized @e cothread.
+ * @return		Returns
+ *				- @ref cothread_err_ok in case of success ;
+ *				- @ref cothread_err_notsup if the callee context cannot be created.
+ *				.
+ * @relates		_cothreadu_t
+ */
+extern COTHREAD_LINK cothread_err_t		COTHREAD_CALL cothreadu_init	(cothreadu_t* cothread, const cothreadu_attr_t* attr);
+
+/**
+ * @brief		Uninitializes the specified cothread.
+ * @param		[in]	cothread	The cothread to uninitialize.
+ * @relates		_cothreadu_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothreadu_uninit	(cothreadu_t* cothread);
+
+/**
+ * @brief		Stores the specified user data in the specified cothread.
+ * @param		[in]	cothread	The cothread to store the user data in.
+ * @param		[in]	user_data	Any user data to store in the cothread.
+ * @relates		_cothreadu_t
+ */
+extern COTHREAD_LINK void				COTHREAD_CALL cothreadu_set_user_data	(cothreadu_t* cothread, void* user_data);
+
+/**
+ * @brief		Returns the user data stored in the specified cothread.
+ * @param		[in]	cothread	The cothread to return the user data stored in.
+ * @return		Returns the user data.
+ * @relates		_cothreadu_t
+ */
+extern COTHREAD_LINK void*				COTHREAD_CALL cothreadu_get_user_data	(const cothreadu_t* cothread);
+
+/**
+ * @brief		Switches from the current context to the other one.
+ * @param		[in]	cothread	The cothread to switch.
+ * @param		[in]	user_val	Any user value (except zero) to send to the other context.
+ * @return		Returns the @e user_val received from the other context.
+ * @relates		_cothreadu_t
+ */
+extern COTHREAD_LINK int				COTHREAD_CALL cothreadu_yield	(cothreadu_t* cothread, int user_val);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __COTHREAD_COTHREADU_H__ */
@@ -0,0 +1,136 @@
+/**
+ * @brief		This file contains the C functions definitions.
+ * @file
+ */
+
+/**
+ * @page		doxy_p_cothreadu		cothread - ucontext
+ * @tableofcontents
+ *
+ * @section		doxy_p_cothreadu_def	Definitions
+ *				The [cothread](@ref _cothreadu_t) is an object that contains two execution contexts:
+ *				the @e caller and the @e callee, switched with the @c swapcontext function.
+ *				Unlike @c longjmp, @c swapcontext saves & restores the signal mask, which costs a system call
+ *				per switch: this implementation is mostly a reference to compare the other ones with.
+ *
+ * @section		doxy_p_cothreadu_use	Usage
+ *				-# First of all, a @e stack should be allocated ;
+ *				-# Once the stack is allocated, some [attributes](@ref _cothreadu_attr_t) have to be initialized
+ *				with the @ref cothreadu_attr_init function ;
+ *				-# Once the attributes are initialized, the @ref cothreadu_init function should be called
+ *				to initialize the [cothread](@ref _cothreadu_t) itself (note that this function may fail
+ *				so its return value @b MUST be checked) ;
+ *				-# From this point, calling the @ref cothreadu_yield function pauses the current execution context
+ *				and resumes the other one ;
+ *				-# Finally, the @ref cothreadu_uninit function has to be called to release the cothread.
+ *				.
+ */
+
+#include <cothread/cothreadu.h>
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * @brief		The callee context entry point.
+ * @param		[in]	hi	The upper half of the cothread address.
+ * @param		[in]	lo	The lower half of the cothread address.
+ * @note		The @c makecontext function passes @c int arguments only, hence the split address.
+ *				Returning resumes the caller context (see @c uc_link.)
+ * @relates		_cothreadu_t
+ */
+static void
+cothreadu_core(unsigned int hi, unsigned int lo)
+{
+	cothreadu_t*	cothread	= (cothreadu_t*)(uintptr_t)(((uint64_t)hi << 32) | (uint64_t)lo);
+	cothread->user_val	= cothread->user_cb(cothread, cothread->user_val);
+	cothread->flags		= (cothread->flags & ~COTHREADU_FLAG_RUNNING) | COTHREADU_FLAG_COMPLETED;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadu_attr_init(cothreadu_attr_t* attr, void* stack, size_t stack_sz, cothreadu_cb_t user_cb)
+{
+	//---Check arguments---//
+	assert(NULL	!= attr);
+	assert(NULL	!= stack);
+	assert(0	!= stack_sz);
+	assert(NULL	!= user_cb);
+
+	//---Init---//
+	attr->stack		= stack;
+	attr->stack_sz	= stack_sz;
+	attr->user_cb	= user_cb;
+}
+
+extern COTHREAD_LINK cothread_err_t COTHREAD_CALL
+cothreadu_init(cothreadu_t* cothread, const cothreadu_attr_t* attr)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(NULL	!= attr);
+
+	//---Zero---//
+	cothread->flags		= 0;
+	cothread->user_val	= 0;
+	cothread->user_cb	= attr->user_cb;
+	cothread->user_data	= NULL;
+
+	//---Create the callee context, which resumes the caller one once returned---//
+	if (0 != getcontext(&(cothread->callee))) {
+		return cothread_err_notsup;
+	}
+	const uint64_t	addr	= (uint64_t)(uintptr_t)cothread;
+	cothread->callee.uc_stack.ss_sp		= attr->stack;
+	cothread->callee.uc_stack.ss_size	= attr->stack_sz;
+	cothread->callee.uc_link			= &(cothread->caller);
+	makecontext(&(cothread->callee), (void (*)(void))cothreadu_core, 2, (unsigned int)(addr >> 32), (unsigned int)addr);
+	return cothread_err_ok;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadu_uninit(cothreadu_t* cothread)
+{
+	assert(NULL	!= cothread);
+	assert(0	== (COTHREADU_FLAG_RUNNING & cothread->flags));
+	cothread->flags	= 0;
+}
+
+extern COTHREAD_LINK void COTHREAD_CALL
+cothreadu_set_user_data(cothreadu_t* cothread, void* user_data)
+{
+	assert(NULL	!= cothread);
+	cothread->user_data	= user_data;
+}
+
+extern COTHREAD_LINK void* COTHREAD_CALL
+cothreadu_get_user_data(const cothreadu_t* cothread)
+{
+	assert(NULL	!= cothread);
+	return cothread->user_data;
+}
+
+extern COTHREAD_LINK int COTHREAD_CALL
+cothreadu_yield(cothreadu_t* cothread, int user_val)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(0	!= user_val);
+
+	//---Switch to the other context---//
+	int	ret;
+	cothread->user_val	= user_val;
+	if (0 != (COTHREADU_FLAG_RUNNING & cothread->flags)) {
+		cothread->flags	&= ~COTHREADU_FLAG_RUNNING;
+		ret				= swapcontext(&(cothread->callee), &(cothread->caller));
+	} else {
+		assert(0	== (COTHREADU_FLAG_COMPLETED & cothread->flags));
+		cothread->flags	|= COTHREADU_FLAG_RUNNING;
+		ret				= swapcontext(&(cothread->caller), &(cothread->callee));
+	}
+	if (0 != ret) {
+		abort();	// the callee cannot go on, nor can the caller be told.
+	}
+
+	//---Return the value sent by the other context---//
+	return cothread->user_val;
+}
@@ -0,0 +1,24 @@
+/**
+ * @brief		This file contains the unittest declarations.
+ * @file
+ */
+
+#ifndef __UNITTEST_H__
+#define __UNITTEST_H__
+
+#include <cothread/cothreadu.h>
+#include <assert.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @cond
+extern COTHREAD_LINK_HIDDEN void			COTHREAD_CALL unittest0	(void);
+/// @endcond
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* __UNITTEST_H__ */
@@ -0,0 +1,65 @@
+/**
+ * @brief		This file contains a unittest.
+ * @file
+ */
+
+#include <unittest.h>
+
+/// @cond
+#define STACK_SZ	(sizeof(void*) * 8 * 1024)
+/// @endcond
+
+/**
+ * @brief		The callee entry point.
+ * @param		[in]	cothread	The cothread.
+ * @param		[in]	user_val	Any user value (except zero) received from the caller.
+ * @return		Returns any user value (except zero) to send to the caller.
+ * @ingroup		doxy_cothreadu_unittest
+ */
+static int COTHREAD_CALL
+user_cb(cothreadu_t* cothread, int user_val)
+{
+	//---Check arguments---//
+	assert(NULL	!= cothread);
+	assert(1	== user_val);
+
+	//---Switch from callee to caller---//
+	size_t*	ctr	= (size_t*)cothreadu_get_user_data(cothread);
+	assert(101	== ctr[0]++);
+	assert(3	== cothreadu_yield(cothread, 2));
+	assert(0	!= (COTHREADU_FLAG_RUNNING & cothread->flags));
+
+	//---Return to caller---//
+	assert(103	== ctr[0]++);
+	return 4;
+}
+
+/**
+ * @brief		The unittest entry point.
+ * @ingroup		doxy_cothreadu_unittest
+ */
+extern COTHREAD_LINK_HIDDEN void COTHREAD_CALL
+unittest0(void)
+{
+	//---Definitions---//
+	static char			stack[STACK_SZ];
+	cothreadu_attr_t	attr;
+	cothreadu_t			cothread;
+	size_t				ctr	= 100;
+
+	//---Initialize the cothread---//
+	cothreadu_attr_init(&attr, stack, sizeof(stack), user_cb);
+	assert(cothread_err_ok	== cothreadu_init(&cothread, &attr));
+	cothreadu_set_user_data(&cothread, &ctr);
+
+	//---Exchange values with the callee, until it returns---//
+	assert(100	== ctr++);
+	assert(2	== cothreadu_yield(&cothread, 1));
+	assert(102	== ctr++);
+	assert(4	== cothreadu_yield(&cothread, 3));
+	assert(104	== ctr++);
+	assert(COTHREADU_FLAG_COMPLETED	== cothread.flags);
+
+	//---Uninitialize the cothread---//
+	cothreadu_uninit(&cothread);
+}